@@ -0,0 +1,580 @@
+#include <renoir/Renoir.h>
+
+#if RENOIR_BENCH_BACKEND_GL450
+#include <renoir-gl450/Renoir-gl450.h>
+#else
+#include <renoir-null/Renoir-null.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// renoir-bench measures the cpu overhead of the renoir api, every benchmark is run once for warmup then
+// repeated and we report the median run, the results are written as json so they can be tracked over time
+//
+// the gl450 build runs headless, there's no window so the frames are rendered into an offscreen target
+// and submitted with flush instead of swapchain_present
+//
+// usage: renoir-bench [--out path.json] [--repetitions n] [--scale n] [--filter name] [--immediate]
+
+const char *vertex_shader = R"""(
+#version 450 core
+
+layout (location = 0) in vec2 pos;
+layout (location = 1) in vec3 color;
+
+out vec3 v_color;
+
+void main()
+{
+	gl_Position = vec4(pos, 0.0, 1.0);
+	v_color = color;
+}
+)""";
+
+const char *pixel_shader = R"""(
+#version 450 core
+
+in vec3 v_color;
+
+out vec4 out_color;
+
+void main()
+{
+	out_color = vec4(v_color, 1.0);
+}
+)""";
+
+struct Bench_Result
+{
+	const char* name;
+	int repetitions;
+	int64_t ops;
+	size_t bytes;
+	uint64_t median_ns;
+	uint64_t min_ns;
+	uint64_t max_ns;
+};
+
+struct Bench
+{
+	Renoir* gfx;
+	bool headless;
+	Renoir_Swapchain swapchain;
+	Renoir_Texture target;
+	Renoir_Program program;
+	Renoir_Buffer vertices;
+	Renoir_Buffer indices;
+	Renoir_Texture texture;
+	bool defer_api_calls;
+	int repetitions;
+	int scale;
+	const char* filter;
+	std::vector<Bench_Result> results;
+};
+
+static uint64_t
+bench_now()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+static Renoir_Pass
+bench_pass_new(Bench& self)
+{
+	if (self.headless == false)
+		return self.gfx->pass_swapchain_new(self.gfx, self.swapchain);
+
+	Renoir_Pass_Offscreen_Desc desc{};
+	desc.color[0].texture = self.target;
+	return self.gfx->pass_offscreen_new(self.gfx, desc);
+}
+
+static void
+bench_present(Bench& self)
+{
+	if (self.headless)
+		self.gfx->flush(self.gfx, nullptr, nullptr);
+	else
+		self.gfx->swapchain_present(self.gfx, self.swapchain);
+}
+
+// runs the given function which returns the measured nanoseconds of a single run
+template<typename F>
+static void
+bench_run(Bench& self, const char* name, int64_t ops, size_t bytes, F&& f)
+{
+	if (self.filter && strstr(name, self.filter) == nullptr)
+		return;
+
+	// warmup
+	f();
+
+	std::vector<uint64_t> samples;
+	samples.reserve(self.repetitions);
+	for (int i = 0; i < self.repetitions; ++i)
+		samples.push_back(f());
+	std::sort(samples.begin(), samples.end());
+
+	Bench_Result result{};
+	result.name = name;
+	result.repetitions = self.repetitions;
+	result.ops = ops;
+	result.bytes = bytes;
+	result.median_ns = samples[samples.size() / 2];
+	result.min_ns = samples.front();
+	result.max_ns = samples.back();
+	self.results.push_back(result);
+
+	fprintf(stderr, "%-32s %12.2f ns/op\n", name, double(result.median_ns) / double(ops > 0 ? ops : 1));
+}
+
+static Renoir_Draw_Desc
+bench_draw_desc(Bench& self)
+{
+	Renoir_Draw_Desc draw{};
+	draw.primitive = RENOIR_PRIMITIVE_TRIANGLES;
+	draw.elements_count = 3;
+	// position
+	draw.vertex_buffers[0].buffer = self.vertices;
+	draw.vertex_buffers[0].type = RENOIR_TYPE_FLOAT_2;
+	draw.vertex_buffers[0].stride = 5 * sizeof(float);
+	// color
+	draw.vertex_buffers[1].buffer = self.vertices;
+	draw.vertex_buffers[1].type = RENOIR_TYPE_FLOAT_3;
+	draw.vertex_buffers[1].stride = 5 * sizeof(float);
+	draw.vertex_buffers[1].offset = 8;
+
+	draw.index_buffer = self.indices;
+	draw.index_type = RENOIR_TYPE_UINT16;
+	return draw;
+}
+
+static void
+bench_record_draws(Bench& self, Renoir_Pass pass, int64_t count)
+{
+	auto gfx = self.gfx;
+	auto draw = bench_draw_desc(self);
+
+	gfx->pass_begin(gfx, pass);
+	gfx->use_pipeline(gfx, pass, Renoir_Pipeline_Desc{});
+	gfx->use_program(gfx, pass, self.program);
+	for (int64_t i = 0; i < count; ++i)
+		gfx->draw(gfx, pass, draw);
+	gfx->pass_end(gfx, pass);
+}
+
+static void
+bench_record(Bench& self)
+{
+	auto gfx = self.gfx;
+	int64_t draws = 10000 * self.scale;
+
+	auto pass = bench_pass_new(self);
+	bench_run(self, "record_draws", draws, 0, [&]{
+		auto start = bench_now();
+		bench_record_draws(self, pass, draws);
+		auto end = bench_now();
+		bench_present(self);
+		return end - start;
+	});
+	gfx->pass_free(gfx, pass);
+
+	int threads_count = std::thread::hardware_concurrency();
+	if (threads_count < 2)
+		threads_count = 2;
+	if (threads_count > 8)
+		threads_count = 8;
+
+	std::vector<Renoir_Pass> passes;
+	for (int i = 0; i < threads_count; ++i)
+		passes.push_back(bench_pass_new(self));
+
+	bench_run(self, "record_draws_multithreaded", draws, 0, [&]{
+		// the threads are started before the timed region and wait for the go signal, so thread creation
+		// isn't measured as recording overhead
+		std::atomic<int> ready = 0;
+		std::atomic<bool> go = false;
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threads_count; ++i)
+		{
+			auto pass = passes[i];
+			threads.emplace_back([&self, &ready, &go, pass, draws, threads_count]{
+				ready.fetch_add(1);
+				while (go.load() == false)
+					std::this_thread::yield();
+				bench_record_draws(self, pass, draws / threads_count);
+			});
+		}
+		while (ready.load() < threads_count)
+			std::this_thread::yield();
+
+		auto start = bench_now();
+		go.store(true);
+		for (auto& thread: threads)
+			thread.join();
+		auto end = bench_now();
+		bench_present(self);
+		return end - start;
+	});
+
+	for (auto pass: passes)
+		gfx->pass_free(gfx, pass);
+}
+
+static void
+bench_present_cost(Bench& self)
+{
+	auto gfx = self.gfx;
+	int64_t draws = 10000 * self.scale;
+
+	auto pass = bench_pass_new(self);
+	bench_run(self, "present_draws", draws, 0, [&]{
+		bench_record_draws(self, pass, draws);
+		auto start = bench_now();
+		bench_present(self);
+		return bench_now() - start;
+	});
+
+	// a single empty frame is too short to measure, so we time a batch of them
+	int64_t frames = 1000 * self.scale;
+	bench_run(self, "present_empty", frames, 0, [&]{
+		auto start = bench_now();
+		for (int64_t i = 0; i < frames; ++i)
+			bench_present(self);
+		return bench_now() - start;
+	});
+
+	bench_run(self, "flush_empty", frames, 0, [&]{
+		auto start = bench_now();
+		for (int64_t i = 0; i < frames; ++i)
+			gfx->flush(gfx, nullptr, nullptr);
+		return bench_now() - start;
+	});
+	gfx->pass_free(gfx, pass);
+}
+
+static void
+bench_handle_churn(Bench& self)
+{
+	auto gfx = self.gfx;
+	int64_t count = 1000 * self.scale;
+
+	bench_run(self, "handle_churn_buffer", count, 0, [&]{
+		auto start = bench_now();
+		for (int64_t i = 0; i < count; ++i)
+		{
+			Renoir_Buffer_Desc desc{};
+			desc.type = RENOIR_BUFFER_UNIFORM;
+			desc.usage = RENOIR_USAGE_DYNAMIC;
+			desc.access = RENOIR_ACCESS_WRITE;
+			desc.data_size = 256;
+			auto buffer = gfx->buffer_new(gfx, desc);
+			gfx->buffer_free(gfx, buffer);
+		}
+		gfx->flush(gfx, nullptr, nullptr);
+		return bench_now() - start;
+	});
+
+	bench_run(self, "handle_churn_texture", count, 0, [&]{
+		auto start = bench_now();
+		for (int64_t i = 0; i < count; ++i)
+		{
+			Renoir_Texture_Desc desc{};
+			desc.size.width = 4;
+			desc.size.height = 4;
+			desc.usage = RENOIR_USAGE_DYNAMIC;
+			desc.access = RENOIR_ACCESS_WRITE;
+			desc.pixel_format = RENOIR_PIXELFORMAT_RGBA8;
+			auto texture = gfx->texture_new(gfx, desc);
+			gfx->texture_free(gfx, texture);
+		}
+		gfx->flush(gfx, nullptr, nullptr);
+		return bench_now() - start;
+	});
+
+	bench_run(self, "handle_churn_pass", count, 0, [&]{
+		auto start = bench_now();
+		for (int64_t i = 0; i < count; ++i)
+		{
+			auto pass = gfx->pass_compute_new(gfx);
+			gfx->pass_free(gfx, pass);
+		}
+		gfx->flush(gfx, nullptr, nullptr);
+		return bench_now() - start;
+	});
+}
+
+static void
+bench_buffer_write(Bench& self)
+{
+	auto gfx = self.gfx;
+
+	static const char* names[] = {
+		"buffer_write_64b",
+		"buffer_write_1kb",
+		"buffer_write_16kb",
+		"buffer_write_256kb",
+		"buffer_write_4mb",
+	};
+	static const size_t sizes[] = {64, 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024};
+
+	// we write the same amount of bytes in every size so that the results are comparable
+	const size_t total_bytes = size_t(16 * 1024 * 1024) * self.scale;
+	std::vector<uint8_t> payload(sizes[4], 0xAB);
+
+	auto pass = bench_pass_new(self);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+	{
+		auto size = sizes[i];
+		int64_t count = total_bytes / size;
+
+		Renoir_Buffer_Desc desc{};
+		desc.type = RENOIR_BUFFER_UNIFORM;
+		desc.usage = RENOIR_USAGE_DYNAMIC;
+		desc.access = RENOIR_ACCESS_WRITE;
+		desc.data_size = size;
+		auto buffer = gfx->buffer_new(gfx, desc);
+
+		bench_run(self, names[i], count, total_bytes, [&]{
+			auto start = bench_now();
+			gfx->pass_begin(gfx, pass);
+			for (int64_t j = 0; j < count; ++j)
+				gfx->buffer_write(gfx, pass, buffer, 0, payload.data(), size);
+			gfx->pass_end(gfx, pass);
+			bench_present(self);
+			return bench_now() - start;
+		});
+
+		gfx->buffer_free(gfx, buffer);
+	}
+	gfx->pass_free(gfx, pass);
+}
+
+static void
+bench_caches(Bench& self)
+{
+	auto gfx = self.gfx;
+	int64_t count = 10000 * self.scale;
+
+	auto sampler_binds = [&](int distinct_samplers) {
+		return [&self, gfx, count, distinct_samplers]{
+			auto pass = bench_pass_new(self);
+			auto start = bench_now();
+			gfx->pass_begin(gfx, pass);
+			for (int64_t i = 0; i < count; ++i)
+			{
+				Renoir_Sampler_Desc sampler{};
+				sampler.border = Renoir_Color{float(i % distinct_samplers), 0.0f, 0.0f, 1.0f};
+				gfx->texture_sampler_bind(gfx, pass, self.texture, RENOIR_SHADER_PIXEL, 0, sampler);
+			}
+			gfx->pass_end(gfx, pass);
+			bench_present(self);
+			auto end = bench_now();
+			gfx->pass_free(gfx, pass);
+			return end - start;
+		};
+	};
+
+	// all the samplers fit in the default sampler cache
+	bench_run(self, "sampler_cache_hit", count, 0, sampler_binds(RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE / 4));
+	// the samplers thrash the default sampler cache
+	bench_run(self, "sampler_cache_miss", count, 0, sampler_binds(RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE * 4));
+
+	bench_run(self, "pipeline_switch", count, 0, [&]{
+		auto pass = bench_pass_new(self);
+		auto start = bench_now();
+		gfx->pass_begin(gfx, pass);
+		for (int64_t i = 0; i < count; ++i)
+		{
+			Renoir_Pipeline_Desc pipeline{};
+			pipeline.rasterizer.cull = (i % 2) ? RENOIR_SWITCH_ENABLE : RENOIR_SWITCH_DISABLE;
+			pipeline.blend[0].enabled = (i % 4) < 2 ? RENOIR_SWITCH_ENABLE : RENOIR_SWITCH_DISABLE;
+			gfx->use_pipeline(gfx, pass, pipeline);
+		}
+		gfx->pass_end(gfx, pass);
+		bench_present(self);
+		auto end = bench_now();
+		gfx->pass_free(gfx, pass);
+		return end - start;
+	});
+}
+
+static void
+bench_write_json(Bench& self, FILE* out)
+{
+	fprintf(out, "{\n");
+	fprintf(out, "\t\"backend\": \"%s\",\n", self.gfx->name());
+	fprintf(out, "\t\"defer_api_calls\": %s,\n", self.defer_api_calls ? "true" : "false");
+	fprintf(out, "\t\"headless\": %s,\n", self.headless ? "true" : "false");
+	fprintf(out, "\t\"repetitions\": %d,\n", self.repetitions);
+	fprintf(out, "\t\"scale\": %d,\n", self.scale);
+	fprintf(out, "\t\"results\": [\n");
+	for (size_t i = 0; i < self.results.size(); ++i)
+	{
+		auto& r = self.results[i];
+		double seconds = double(r.median_ns) / 1e9;
+		fprintf(out, "\t\t{");
+		fprintf(out, "\"name\": \"%s\", ", r.name);
+		fprintf(out, "\"ops\": %lld, ", (long long)r.ops);
+		fprintf(out, "\"median_ns\": %llu, ", (unsigned long long)r.median_ns);
+		fprintf(out, "\"min_ns\": %llu, ", (unsigned long long)r.min_ns);
+		fprintf(out, "\"max_ns\": %llu, ", (unsigned long long)r.max_ns);
+		fprintf(out, "\"ns_per_op\": %.3f, ", double(r.median_ns) / double(r.ops > 0 ? r.ops : 1));
+		fprintf(out, "\"ops_per_sec\": %.1f", seconds > 0 ? double(r.ops) / seconds : 0.0);
+		if (r.bytes > 0)
+			fprintf(out, ", \"bytes_per_sec\": %.1f", seconds > 0 ? double(r.bytes) / seconds : 0.0);
+		fprintf(out, "}%s\n", i + 1 < self.results.size() ? "," : "");
+	}
+	fprintf(out, "\t]\n");
+	fprintf(out, "}\n");
+}
+
+int main(int argc, char** argv)
+{
+	Bench self{};
+	self.defer_api_calls = true;
+	self.repetitions = 9;
+	self.scale = 1;
+
+	const char* out_path = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			out_path = argv[++i];
+		else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+			self.repetitions = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+			self.scale = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			self.filter = argv[++i];
+		else if (strcmp(argv[i], "--immediate") == 0)
+			self.defer_api_calls = false;
+		else
+		{
+			fprintf(stderr, "usage: %s [--out path.json] [--repetitions n] [--scale n] [--filter name] [--immediate]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (self.repetitions < 1)
+		self.repetitions = 1;
+	if (self.scale < 1)
+		self.scale = 1;
+
+	auto gfx = renoir_api();
+	self.gfx = gfx;
+
+	Renoir_Settings settings{};
+	settings.defer_api_calls = self.defer_api_calls;
+#if RENOIR_BENCH_BACKEND_GL450
+	// measure the api overhead without a window system or vsync in the way
+	settings.headless = true;
+#endif
+	self.headless = settings.headless;
+
+	bool ok = gfx->init(gfx, settings, nullptr);
+	if (ok == false)
+	{
+		fprintf(stderr, "failed to initialize '%s' backend\n", gfx->name());
+		return 1;
+	}
+
+	if (self.headless)
+	{
+		Renoir_Texture_Desc target_desc{};
+		target_desc.size.width = 800;
+		target_desc.size.height = 600;
+		target_desc.pixel_format = RENOIR_PIXELFORMAT_RGBA8;
+		target_desc.render_target = true;
+		self.target = gfx->texture_new(gfx, target_desc);
+	}
+	else
+	{
+		self.swapchain = gfx->swapchain_new(gfx, 800, 600, nullptr, nullptr);
+	}
+
+	Renoir_Program_Desc program_desc{};
+	program_desc.vertex.bytes = vertex_shader;
+	program_desc.pixel.bytes = pixel_shader;
+	self.program = gfx->program_new(gfx, program_desc);
+
+	float triangle_data[] = {
+		 -1, -1,
+		  1,  0,  0,
+
+		  1, -1,
+		  0,  1,  0,
+
+		  0,  1,
+		  0,  0,  1,
+	};
+	Renoir_Buffer_Desc vertices_desc{};
+	vertices_desc.type = RENOIR_BUFFER_VERTEX;
+	vertices_desc.data = triangle_data;
+	vertices_desc.data_size = sizeof(triangle_data);
+	self.vertices = gfx->buffer_new(gfx, vertices_desc);
+
+	uint16_t triangle_indices[] = {
+		0, 1, 2
+	};
+	Renoir_Buffer_Desc indices_desc{};
+	indices_desc.type = RENOIR_BUFFER_INDEX;
+	indices_desc.data = triangle_indices;
+	indices_desc.data_size = sizeof(triangle_indices);
+	self.indices = gfx->buffer_new(gfx, indices_desc);
+
+	uint32_t pixels[16];
+	memset(pixels, 0xFF, sizeof(pixels));
+	Renoir_Texture_Desc texture_desc{};
+	texture_desc.size.width = 4;
+	texture_desc.size.height = 4;
+	texture_desc.pixel_format = RENOIR_PIXELFORMAT_RGBA8;
+	texture_desc.data[0] = pixels;
+	texture_desc.data_size = sizeof(pixels);
+	self.texture = gfx->texture_new(gfx, texture_desc);
+
+	// make sure all the resources are created before we start measuring
+	bench_present(self);
+
+	bench_record(self);
+	bench_present_cost(self);
+	bench_handle_churn(self);
+	bench_buffer_write(self);
+	bench_caches(self);
+
+	if (out_path)
+	{
+		auto out = fopen(out_path, "w");
+		if (out == nullptr)
+		{
+			fprintf(stderr, "failed to open '%s'\n", out_path);
+			return 1;
+		}
+		bench_write_json(self, out);
+		fclose(out);
+	}
+	else
+	{
+		bench_write_json(self, stdout);
+	}
+
+	gfx->texture_free(gfx, self.texture);
+	gfx->program_free(gfx, self.program);
+	gfx->buffer_free(gfx, self.vertices);
+	gfx->buffer_free(gfx, self.indices);
+	if (self.headless)
+		gfx->texture_free(gfx, self.target);
+	else
+		gfx->swapchain_free(gfx, self.swapchain);
+	gfx->dispose(gfx);
+	return 0;
+}
@@ -83,26 +83,39 @@ int main()
 
 	Renoir_Pass pass = gfx->pass_swapchain_new(gfx, swapchain);
 
-	while(true)
+	bool running = true;
+	while(running)
 	{
-		Renoir_Event event = renoir_window_poll(window);
-		if(event.kind == RENOIR_EVENT_KIND_WINDOW_CLOSE)
-			break;
+		// the triangle doesn't change so we only redraw when something happens to the window
+		renoir_window_wait(window, -1);
 
-		if (event.kind == RENOIR_EVENT_KIND_MOUSE_MOVE)
-		{
-			printf("position: %d, %d\n", event.mouse_move.x, event.mouse_move.y);
-		}
-		else if(event.kind == RENOIR_EVENT_KIND_MOUSE_WHEEL)
+		Renoir_Event events[64];
+		int events_count = renoir_window_poll_all(window, events, 64);
+		for (int i = 0; i < events_count; ++i)
 		{
-			printf("wheel: %f\n", event.wheel);
-		}
-		else if(event.kind == RENOIR_EVENT_KIND_WINDOW_RESIZE)
-		{
-			printf("resize: %d %d\n", event.resize.width, event.resize.height);
-			gfx->swapchain_resize(gfx, swapchain, event.resize.width, event.resize.height);
+			auto& event = events[i];
+			if(event.kind == RENOIR_EVENT_KIND_WINDOW_CLOSE)
+			{
+				running = false;
+			}
+			else if (event.kind == RENOIR_EVENT_KIND_MOUSE_MOVE)
+			{
+				printf("position: %d, %d\n", event.mouse_move.x, event.mouse_move.y);
+			}
+			else if(event.kind == RENOIR_EVENT_KIND_MOUSE_WHEEL)
+			{
+				printf("wheel: %f\n", event.wheel);
+			}
+			else if(event.kind == RENOIR_EVENT_KIND_WINDOW_RESIZE)
+			{
+				printf("resize: %d %d\n", event.resize.width, event.resize.height);
+				gfx->swapchain_resize(gfx, swapchain, event.resize.width, event.resize.height);
+			}
 		}
 
+		if (running == false)
+			break;
+
 		gfx->pass_begin(gfx, pass);
 
 		Renoir_Clear_Desc clear{};
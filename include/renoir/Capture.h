@@ -0,0 +1,127 @@
+#pragma once
+
+#include "renoir/Renoir.h"
+
+#if __cplusplus
+extern "C" {
+#endif
+
+// Capture file format (see capture_path setting)
+// the file starts with a Renoir_Capture_Header followed by a stream of records, each record starts with a
+// Renoir_Capture_Record followed by size bytes of payload, the payload of each record kind is listed below
+// handles are written as 64-bit ids (the value of the handle at capture time), they are only meaningful as keys
+// descs are written as raw structs with their handle fields holding ids and their data pointers set to 1 if the
+// data follows the desc and null otherwise, and their tag pointers set to null, so a capture can only be replayed
+// by a build with the same ABI
+#define RENOIR_CAPTURE_MAGIC 0x50414352 // "RCAP"
+#define RENOIR_CAPTURE_VERSION 5
+
+typedef enum RENOIR_CAPTURE {
+	RENOIR_CAPTURE_NONE,
+	// u64 uniform ring buffer id, uniform buffer binds of this id are uniform_bind calls
+	RENOIR_CAPTURE_UNIFORM_RING,
+	// u64 swapchain id, 0 in case of flush
+	RENOIR_CAPTURE_FRAME,
+	// u64 id, i32 width, i32 height
+	RENOIR_CAPTURE_SWAPCHAIN_NEW,
+	// u64 id
+	RENOIR_CAPTURE_SWAPCHAIN_FREE,
+	// u64 id, u64 swapchain id
+	RENOIR_CAPTURE_PASS_SWAPCHAIN_NEW,
+	// u64 id, Renoir_Pass_Offscreen_Desc
+	RENOIR_CAPTURE_PASS_OFFSCREEN_NEW,
+	// u64 id
+	RENOIR_CAPTURE_PASS_COMPUTE_NEW,
+	// u64 id
+	RENOIR_CAPTURE_PASS_FREE,
+	// u64 id, Renoir_Buffer_Desc, data_size bytes if data is set
+	RENOIR_CAPTURE_BUFFER_NEW,
+	// u64 id
+	RENOIR_CAPTURE_BUFFER_FREE,
+	// u64 id, Renoir_Texture_Desc, data_size bytes for each data pointer which is set
+	RENOIR_CAPTURE_TEXTURE_NEW,
+	// u64 id
+	RENOIR_CAPTURE_TEXTURE_FREE,
+	// u64 id, Renoir_Program_Desc, vertex bytes, pixel bytes, geometry bytes (sizes are in the desc)
+	RENOIR_CAPTURE_PROGRAM_NEW,
+	// u64 id
+	RENOIR_CAPTURE_PROGRAM_FREE,
+	// u64 id, Renoir_Compute_Desc, compute bytes
+	RENOIR_CAPTURE_COMPUTE_NEW,
+	// u64 id
+	RENOIR_CAPTURE_COMPUTE_FREE,
+	// u64 id
+	RENOIR_CAPTURE_TIMER_NEW,
+	// u64 id
+	RENOIR_CAPTURE_TIMER_FREE,
+	// u64 id, i32 RENOIR_QUERY
+	RENOIR_CAPTURE_QUERY_NEW,
+	// u64 id
+	RENOIR_CAPTURE_QUERY_FREE,
+	// u64 pass id
+	RENOIR_CAPTURE_PASS_BEGIN,
+	// u64 pass id
+	RENOIR_CAPTURE_PASS_END,
+	// Renoir_Clear_Desc
+	RENOIR_CAPTURE_PASS_CLEAR,
+	// Renoir_Pipeline_Desc
+	RENOIR_CAPTURE_USE_PIPELINE,
+	// u64 program id
+	RENOIR_CAPTURE_USE_PROGRAM,
+	// u64 compute id
+	RENOIR_CAPTURE_USE_COMPUTE,
+	// i32 x, i32 y, i32 width, i32 height
+	RENOIR_CAPTURE_SCISSOR,
+	// u64 buffer id
+	RENOIR_CAPTURE_BUFFER_CLEAR,
+	// u64 buffer id, u64 offset, bytes (the rest of the payload)
+	RENOIR_CAPTURE_BUFFER_WRITE,
+	// u64 texture id, Renoir_Texture_Edit_Desc, bytes_size bytes
+	RENOIR_CAPTURE_TEXTURE_WRITE,
+	// u64 buffer id, i32 RENOIR_SHADER, i32 slot, i32 RENOIR_ACCESS, u64 offset, u64 size
+	RENOIR_CAPTURE_BUFFER_BIND,
+	// Renoir_Buffer_Storage_Bind_Desc
+	RENOIR_CAPTURE_BUFFER_STORAGE_BIND,
+	// u64 texture id, i32 RENOIR_SHADER, i32 slot, i32 level, i32 RENOIR_ACCESS, i32 has_sampler, Renoir_Sampler_Desc
+	RENOIR_CAPTURE_TEXTURE_BIND,
+	// Renoir_Draw_Desc
+	RENOIR_CAPTURE_DRAW,
+	// i32 x, i32 y, i32 z
+	RENOIR_CAPTURE_DISPATCH,
+	// u64 timer id
+	RENOIR_CAPTURE_TIMER_BEGIN,
+	// u64 timer id
+	RENOIR_CAPTURE_TIMER_END,
+	// u64 query id
+	RENOIR_CAPTURE_QUERY_BEGIN,
+	// u64 query id
+	RENOIR_CAPTURE_QUERY_END,
+	// u64 query id, i32 wait
+	RENOIR_CAPTURE_CONDITIONAL_BEGIN,
+	// empty
+	RENOIR_CAPTURE_CONDITIONAL_END,
+	// u64 offset in the uniform ring, bytes (the rest of the payload)
+	RENOIR_CAPTURE_UNIFORM_WRITE,
+	// u64 dst buffer id, u64 dst offset, u64 src buffer id, u64 src offset, u64 size
+	RENOIR_CAPTURE_BUFFER_COPY,
+	// empty
+	RENOIR_CAPTURE_MEMORY_BARRIER,
+	RENOIR_CAPTURE_COUNT
+} RENOIR_CAPTURE;
+
+typedef struct Renoir_Capture_Header {
+	uint32_t magic; // RENOIR_CAPTURE_MAGIC
+	uint32_t version; // RENOIR_CAPTURE_VERSION
+	// used to reject captures written by a build with a different pointer size
+	uint32_t pointer_size;
+	uint32_t reserved;
+} Renoir_Capture_Header;
+
+typedef struct Renoir_Capture_Record {
+	uint32_t kind; // RENOIR_CAPTURE
+	uint32_t size; // payload size in bytes
+} Renoir_Capture_Record;
+
+#if __cplusplus
+}
+#endif
@@ -12,7 +12,12 @@ typedef enum RENOIR_CONSTANT {
 	RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE = 10,
 	RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE = 4,
 	RENOIR_CONSTANT_BUFFER_STORAGE_SIZE = 8,
-	RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE = 64
+	RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE = 64,
+	RENOIR_CONSTANT_SHADER_CONSTANT_SIZE = 16,
+	RENOIR_CONSTANT_DEFAULT_UNIFORM_RING_SIZE = 4 * 1024 * 1024,
+	RENOIR_CONSTANT_DEFAULT_MAX_FRAMES_IN_FLIGHT = 2,
+	RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT = 4,
+	RENOIR_CONSTANT_STATS_COUNTER_SIZE = 128
 } RENOIR_CONSTANT;
 
 // Enums
@@ -29,6 +34,13 @@ typedef enum RENOIR_SHADER {
 	RENOIR_SHADER_COMPUTE
 } RENOIR_SHADER;
 
+typedef enum RENOIR_SHADER_FORMAT {
+	// shader blob contains source code in the backend's native shading language (GLSL, HLSL)
+	RENOIR_SHADER_FORMAT_SOURCE,
+	// shader blob contains a SPIR-V binary module with a "main" entry point
+	RENOIR_SHADER_FORMAT_SPIRV
+} RENOIR_SHADER_FORMAT;
+
 typedef enum RENOIR_BUFFER {
 	RENOIR_BUFFER_NONE,
 	RENOIR_BUFFER_VERTEX,
@@ -201,7 +213,45 @@ typedef enum RENOIR_COLOR_MASK
 							RENOIR_COLOR_MASK_ALPHA,
 } RENOIR_COLOR_MASK;
 
-// Handles
+// what happens to the attachment contents at pass_begin
+typedef enum RENOIR_LOAD {
+	// keep the previous contents of the attachment
+	RENOIR_LOAD_LOAD,
+	// clear the attachment to the clear value of the attachment
+	RENOIR_LOAD_CLEAR,
+	// previous contents are undefined, use this when the pass will overwrite the whole attachment
+	RENOIR_LOAD_DONT_CARE
+} RENOIR_LOAD;
+
+// what happens to the attachment contents at pass_end
+//
+// migration note: multisampled offscreen attachments used to be resolved into their textures at every pass_end,
+// now they're only resolved with RENOIR_STORE_RESOLVE, with the default RENOIR_STORE_STORE the samples are kept
+// in the multisampled renderbuffer and the texture is left untouched, so code which samples or reads back a
+// multisampled render target after the pass should set store = RENOIR_STORE_RESOLVE on that attachment
+typedef enum RENOIR_STORE {
+	// keep the contents, multisampled attachments keep their samples and are not resolved into the texture
+	RENOIR_STORE_STORE,
+	// contents are not needed after the pass
+	RENOIR_STORE_DISCARD,
+	// multisampled attachments are resolved into the texture and their samples are discarded, it's the same as
+	// RENOIR_STORE_STORE for non multisampled attachments and textures with msaa_sampled set
+	RENOIR_STORE_RESOLVE
+} RENOIR_STORE;
+
+typedef enum RENOIR_QUERY {
+	RENOIR_QUERY_NONE,
+	// number of samples that passed the depth and stencil tests
+	RENOIR_QUERY_SAMPLES_PASSED,
+	// whether any sample passed (conservatively), this is the cheapest one to use with conditional rendering
+	RENOIR_QUERY_ANY_SAMPLES_PASSED,
+	// vertex, primitive, and shader invocation counters
+	RENOIR_QUERY_PIPELINE_STATISTICS
+} RENOIR_QUERY;
+
+// Handles, the handle field is an opaque id which is null for invalid handles, using an id after its handle is
+// freed is detected by the backend instead of aliasing the handle which reused its slot, it's reported as an error
+// (and asserts in debug builds) and the call is ignored, functions which return a value return an empty one
 typedef struct Renoir_Buffer { void* handle; } Renoir_Buffer;
 typedef struct Renoir_Texture { void* handle; } Renoir_Texture;
 typedef struct Renoir_Program { void* handle; } Renoir_Program;
@@ -209,6 +259,7 @@ typedef struct Renoir_Compute { void* handle; } Renoir_Compute;
 typedef struct Renoir_Pass { void* handle; } Renoir_Pass;
 typedef struct Renoir_Swapchain { void* handle; } Renoir_Swapchain;
 typedef struct Renoir_Timer { void* handle; } Renoir_Timer;
+typedef struct Renoir_Query { void* handle; } Renoir_Query;
 
 
 // Descriptons
@@ -220,6 +271,10 @@ typedef struct Renoir_Size {
 	int width, height, depth;
 } Renoir_Size;
 
+typedef struct Renoir_Rect {
+	int x, y, width, height;
+} Renoir_Rect;
+
 typedef struct Renoir_Color {
 	float r, g, b, a;
 } Renoir_Color;
@@ -227,10 +282,17 @@ typedef struct Renoir_Color {
 typedef struct Renoir_Settings {
 	bool defer_api_calls; // default: false
 	bool external_context; // default: false
+	bool headless; // default: false, creates a context without a window system (EGL on linux), only offscreen passes are supported
 	RENOIR_MSAA_MODE msaa; // default: RENOIR_MSAA_MODE_NONE
 	RENOIR_VSYNC_MODE vsync; // default: RENOIR_VSYNC_MODE_ON
 	int sampler_cache_size; // default: RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE
 	int pipeline_cache_size; // default: RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE
+	size_t uniform_ring_size; // default: RENOIR_CONSTANT_DEFAULT_UNIFORM_RING_SIZE (bytes per frame)
+	int max_frames_in_flight; // default: RENOIR_CONSTANT_DEFAULT_MAX_FRAMES_IN_FLIGHT, up to RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT frames are submitted before the cpu waits for the gpu
+	bool profiler; // default: false, automatically timestamps every pass (see profiler_frame_results), dx11 doesn't support it and disables it at init with an error
+	bool trace; // default: false, records cpu events (and gpu events if the profiler is enabled), see trace_export, dx11 doesn't support it and disables it at init with an error
+	const char* capture_path; // default: nullptr, if set all the executed commands are written to this file (see renoir/Capture.h), dx11 doesn't support it and ignores it at init with an error
+	bool async_uploads; // default: false, buffers and textures with initial data are uploaded by a background thread which uses a shared context (see handle_ready)
 } Renoir_Settings;
 
 typedef struct Renoir_Depth_Desc {
@@ -270,6 +332,8 @@ typedef struct Renoir_Buffer_Desc {
 	void* data; // you can pass null here to only allocate buffer without initializing it
 	size_t data_size;
 	size_t compute_buffer_stride;
+	// default: null, groups the buffer memory under this tag in memory_stats
+	const char* tag;
 } Renoir_Buffer_Desc;
 
 typedef struct Renoir_Sampler_Desc {
@@ -293,24 +357,46 @@ typedef struct Renoir_Texture_Desc {
 	// render target
 	bool render_target; // default: false
 	RENOIR_MSAA_MODE msaa; // default: RENOIR_MSAA_MODE_NONE
+	// multisampled render targets are sampled directly in shaders (sampler2DMS/Texture2DMS) so they never need a resolve,
+	// such textures can't be cube maps, have mipmaps, initial data, or be read/written from the cpu
+	bool msaa_sampled; // default: false
 	// cube map
 	bool cube_map; // default: false, should be true in case of a cube map texture
 	Renoir_Sampler_Desc sampler; // default: see sampler default
+	// default: null, groups the texture memory under this tag in memory_stats
+	const char* tag;
 } Renoir_Texture_Desc;
 
 typedef struct Renoir_Shader_Blob {
 	const char* bytes;
-	size_t size; // you can set size = 0 it will assume it's a null terminating string and will calc its strlen
+	// you can set size = 0 it will assume it's a null terminating string and will calc its strlen
+	// in case of RENOIR_SHADER_FORMAT_SPIRV size is required and should be a multiple of 4, otherwise program_new and
+	// compute_new log an error and return an empty handle
+	size_t size;
 } Renoir_Shader_Blob;
 
+// specialization constant value, the value is the raw 32-bit pattern of the constant
+// (use memcpy to store a float in it), it's only used with RENOIR_SHADER_FORMAT_SPIRV
+typedef struct Renoir_Shader_Constant {
+	uint32_t id; // constant_id in the shader
+	uint32_t value;
+} Renoir_Shader_Constant;
+
 typedef struct Renoir_Program_Desc {
 	Renoir_Shader_Blob vertex;
 	Renoir_Shader_Blob pixel;
 	Renoir_Shader_Blob geometry;
+	RENOIR_SHADER_FORMAT format; // default: RENOIR_SHADER_FORMAT_SOURCE
+	// constants are shared among all the stages, each stage will only get the constants it declares
+	Renoir_Shader_Constant constants[RENOIR_CONSTANT_SHADER_CONSTANT_SIZE];
+	int constants_count;
 } Renoir_Program_Desc;
 
 typedef struct Renoir_Compute_Desc {
 	Renoir_Shader_Blob compute;
+	RENOIR_SHADER_FORMAT format; // default: RENOIR_SHADER_FORMAT_SOURCE
+	Renoir_Shader_Constant constants[RENOIR_CONSTANT_SHADER_CONSTANT_SIZE];
+	int constants_count;
 } Renoir_Compute_Desc;
 
 typedef struct Renoir_Clear_Desc {
@@ -333,6 +419,9 @@ typedef struct Renoir_Draw_Desc {
 	int base_element;
 	int elements_count;
 	int instances_count;
+	// default: 0, it's added to each index before fetching the vertex so that meshes which live in the same vertex
+	// buffer can share the same vertex bindings, it's ignored when there's no index buffer
+	int base_vertex;
 	Renoir_Vertex_Desc vertex_buffers[RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE];
 	Renoir_Buffer index_buffer;
 	RENOIR_TYPE index_type; // default: RENOIR_TYPE_UINT16
@@ -351,18 +440,184 @@ typedef struct Renoir_Pass_Attachment {
 	int subresource;
 	// this is used to choose which mip map level you want to be attached to the pass
 	int level;
+	RENOIR_LOAD load; // default: RENOIR_LOAD_LOAD
+	RENOIR_STORE store; // default: RENOIR_STORE_STORE, which doesn't resolve multisampled attachments (see RENOIR_STORE)
+	// used with RENOIR_LOAD_CLEAR, color attachments use clear_color and depth attachments use the rest
+	Renoir_Color clear_color; // default: {0, 0, 0, 0}
+	float clear_depth; // default: 0
+	int clear_stencil; // default: 0
 } Renoir_Pass_Attachment;
 
 typedef struct Renoir_Pass_Offscreen_Desc {
 	Renoir_Pass_Attachment color[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE];
 	Renoir_Pass_Attachment depth_stencil;
+	// region of the attachments with RENOIR_STORE_RESOLVE which gets resolved at pass_end
+	Renoir_Rect resolve_rect; // default: {0, 0, 0, 0} which resolves the whole pass
 } Renoir_Pass_Offscreen_Desc;
 
+// a transient range in the per-frame uniform ring buffer, it's valid until the end of the current frame
+typedef struct Renoir_Uniform {
+	Renoir_Buffer buffer;
+	size_t offset;
+	size_t size;
+} Renoir_Uniform;
+
 typedef struct Renoir_Buffer_Storage_Bind_Desc {
 	Renoir_Buffer buffers[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
 	int start_slot;
+	// optional ranges inside each buffer, a size of 0 binds the whole buffer
+	size_t offsets[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE]; // default: 0
+	size_t sizes[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE]; // default: 0
 } Renoir_Buffer_Storage_Bind_Desc;
 
+// Reflection
+// all the reflection pointers (names, members) are owned by the backend and are valid until the program is freed
+// in dx11 bindings are the hlsl register numbers of each resource type, and storage blocks are structured buffers
+// so their size is the element stride and their members are the element fields
+typedef struct Renoir_Reflect_Member {
+	const char* name;
+	int offset;
+	int array_size; // 1 if member is not an array
+	int array_stride; // 0 if member is not an array
+} Renoir_Reflect_Member;
+
+typedef struct Renoir_Reflect_Block {
+	const char* name;
+	int binding;
+	size_t size;
+	const Renoir_Reflect_Member* members;
+	int members_count;
+} Renoir_Reflect_Block;
+
+typedef struct Renoir_Reflect_Texture {
+	const char* name;
+	int binding;
+	int array_size;
+} Renoir_Reflect_Texture;
+
+typedef struct Renoir_Reflect {
+	const Renoir_Reflect_Block* uniform_blocks;
+	int uniform_blocks_count;
+	const Renoir_Reflect_Block* storage_blocks;
+	int storage_blocks_count;
+	// sampled textures
+	const Renoir_Reflect_Texture* samplers;
+	int samplers_count;
+	// textures used as images (texture_compute_bind with write access)
+	const Renoir_Reflect_Texture* images;
+	int images_count;
+	// compute workgroup size, zero for non compute programs
+	int workgroup_size[3];
+} Renoir_Reflect;
+
+typedef struct Renoir_Query_Result {
+	// RENOIR_QUERY_SAMPLES_PASSED: number of samples, RENOIR_QUERY_ANY_SAMPLES_PASSED: 0 or 1
+	uint64_t samples_passed;
+	// RENOIR_QUERY_PIPELINE_STATISTICS
+	uint64_t vertices_submitted;
+	uint64_t primitives_submitted;
+	uint64_t vertex_shader_invocations;
+	uint64_t geometry_shader_invocations;
+	uint64_t fragment_shader_invocations;
+	uint64_t compute_shader_invocations;
+	uint64_t clipping_input_primitives;
+	uint64_t clipping_output_primitives;
+} Renoir_Query_Result;
+
+// Profiler
+// all the profiler pointers are owned by the backend and are valid until the next flush/swapchain_present
+typedef struct Renoir_Profiler_Scope {
+	// pass scopes are named "raster pass"/"compute pass", other scopes use the name given to profiler_scope_begin
+	const char* name;
+	Renoir_Pass pass;
+	// nesting level, pass scopes are at depth 0
+	int depth;
+	// relative to the beginning of the first scope in the frame
+	uint64_t begin_time_in_nanos;
+	uint64_t elapsed_time_in_nanos;
+} Renoir_Profiler_Scope;
+
+typedef struct Renoir_Profiler_Frame {
+	uint64_t frame_index;
+	const Renoir_Profiler_Scope* scopes;
+	int scopes_count;
+} Renoir_Profiler_Frame;
+
+// Stats
+typedef struct Renoir_Stats_Counter {
+	const char* name;
+	int count;
+} Renoir_Stats_Counter;
+
+typedef struct Renoir_Stats {
+	// the following counters are for the last completed frame (between two flush/swapchain_present calls)
+	uint64_t frame_index;
+	int draws;
+	int dispatches;
+	// number of executed commands which change the gpu state (pipeline, program, bindings, scissor, pass begin)
+	int state_changes;
+	// bytes written to the gpu using buffer/texture/uniform writes and initial data
+	size_t bytes_uploaded;
+	// bytes read back from the gpu using buffer/texture reads
+	size_t bytes_read;
+	int sampler_cache_hits;
+	int sampler_cache_misses;
+	int sampler_cache_evictions;
+	// offscreen passes share framebuffers with the same attachment set, a miss creates a new framebuffer
+	int framebuffer_cache_hits;
+	int framebuffer_cache_misses;
+	// time the api mutex has been held, gl450 always measures it, dx11 and null report 0
+	uint64_t mutex_hold_time_in_nanos;
+	// time the cpu waited for the gpu to finish an old frame (see max_frames_in_flight setting)
+	uint64_t frame_wait_time_in_nanos;
+	// number of freed handles whose gpu objects were destroyed after the gpu finished the frame they were freed in
+	int retired_handles;
+	// number of executed commands per command kind, only non zero counters are listed
+	Renoir_Stats_Counter commands[RENOIR_CONSTANT_STATS_COUNTER_SIZE];
+	int commands_count;
+
+	// the following are for the lifetime of the renoir instance
+	size_t command_pool_high_water_mark;
+	size_t handle_pool_high_water_mark;
+	// currently alive handles per handle kind, only non zero counters are listed
+	Renoir_Stats_Counter live_handles[RENOIR_CONSTANT_STATS_COUNTER_SIZE];
+	int live_handles_count;
+} Renoir_Stats;
+
+// Memory
+typedef enum RENOIR_MEMORY {
+	RENOIR_MEMORY_BUFFER,
+	RENOIR_MEMORY_TEXTURE,
+	// multisampled storage of msaa render targets which are not sampled directly (see msaa_sampled)
+	RENOIR_MEMORY_RENDERBUFFER,
+	// framebuffers don't own any storage so they only have a count
+	RENOIR_MEMORY_FRAMEBUFFER,
+	RENOIR_MEMORY_COUNT
+} RENOIR_MEMORY;
+
+typedef struct Renoir_Memory_Counter {
+	const char* name;
+	// currently alive resources
+	int count;
+	size_t bytes;
+	// peak of bytes over the lifetime of the renoir instance
+	size_t high_water_mark;
+} Renoir_Memory_Counter;
+
+// memory footprints are estimated from the resource descriptions (size, pixel format, mipmaps, cube faces, msaa samples),
+// the driver may add padding and alignment on top of them
+typedef struct Renoir_Memory_Stats {
+	Renoir_Memory_Counter total;
+	// indexed by RENOIR_MEMORY
+	Renoir_Memory_Counter kinds[RENOIR_MEMORY_COUNT];
+	// per tag given in buffer/texture desc, resources without a tag are counted under "untagged"
+	Renoir_Memory_Counter tags[RENOIR_CONSTANT_STATS_COUNTER_SIZE];
+	int tags_count;
+	// video memory reported by the driver (gl450 samples it at the end of each frame), 0 if it's not available
+	size_t device_total_bytes;
+	size_t device_available_bytes;
+} Renoir_Memory_Stats;
+
 struct IRenoir;
 
 typedef struct Renoir
@@ -374,8 +629,14 @@ typedef struct Renoir
 
 	const char* (*name)();
 	RENOIR_TEXTURE_ORIGIN (*texture_origin)();
+	Renoir_Stats (*stats)(struct Renoir* api);
+	// the tag names are owned by the backend and are valid until dispose
+	Renoir_Memory_Stats (*memory_stats)(struct Renoir* api);
 
 	void (*handle_ref)(struct Renoir* self, void* handle);
+	// returns false while the handle's initial data is still being uploaded in the background (see async_uploads setting),
+	// it never blocks, using a handle which is not ready is valid but its first use waits for the upload to finish
+	bool (*handle_ready)(struct Renoir* self, void* handle);
 	void (*flush)(struct Renoir* self, void* device, void* context);
 
 	Renoir_Swapchain (*swapchain_new)(struct Renoir* api, int width, int height, void* window, void* display);
@@ -392,6 +653,14 @@ typedef struct Renoir
 	void* (*texture_native_handle)(struct Renoir* api, Renoir_Texture texture);
 	Renoir_Size (*texture_size)(struct Renoir* api, Renoir_Texture texture);
 	Renoir_Texture_Desc (*texture_desc)(struct Renoir* api, Renoir_Texture texture);
+	// returns a render target from the transient pool which is valid until the end of the current frame (flush/swapchain_present),
+	// the pool is a recycle pool not a memory aliaser, a pooled texture is only reused by a request with the exact same desc so
+	// textures with different descs never share memory, and the ones which stay unused for a few frames are freed,
+	// transient textures should not be freed with texture_free
+	Renoir_Texture (*texture_transient)(struct Renoir* api, Renoir_Texture_Desc desc);
+	// returns a transient texture to the pool before the end of the frame so that later requests in the same frame with the same
+	// desc can reuse it, the texture should not be used after this call
+	void (*texture_transient_free)(struct Renoir* api, Renoir_Texture texture);
 
 	Renoir_Program (*program_new)(struct Renoir* api, Renoir_Program_Desc desc);
 	void (*program_free)(struct Renoir* api, Renoir_Program program);
@@ -399,6 +668,10 @@ typedef struct Renoir
 	Renoir_Compute (*compute_new)(struct Renoir* api, Renoir_Compute_Desc desc);
 	void (*compute_free)(struct Renoir* api, Renoir_Compute compute);
 
+	// returns false if the program is not created yet (in case of deferred api calls it will be created at flush)
+	bool (*program_reflect)(struct Renoir* api, Renoir_Program program, Renoir_Reflect* reflect);
+	bool (*compute_reflect)(struct Renoir* api, Renoir_Compute compute, Renoir_Reflect* reflect);
+
 	Renoir_Pass (*pass_swapchain_new)(struct Renoir* api, Renoir_Swapchain view);
 	Renoir_Pass (*pass_offscreen_new)(struct Renoir* api, Renoir_Pass_Offscreen_Desc desc);
 	Renoir_Pass (*pass_compute_new)(struct Renoir* api);
@@ -410,6 +683,22 @@ typedef struct Renoir
 	void (*timer_free)(struct Renoir* api, Renoir_Timer timer);
 	bool (*timer_elapsed)(struct Renoir* api, Renoir_Timer timer, uint64_t* elapsed_time_in_nanos);
 
+	// dx11 doesn't support queries, query_new logs an error and returns an empty query which the other query functions
+	// ignore, so draws between conditional_begin and conditional_end are always rendered
+	Renoir_Query (*query_new)(struct Renoir* api, RENOIR_QUERY kind);
+	void (*query_free)(struct Renoir* api, Renoir_Query query);
+	// works like timer_elapsed, it never blocks, it returns true once the result is ready, a query can be issued again
+	// before its result is read (up to 4 begin/end pairs in gl450), the results are returned in the order they were
+	// issued, and a query_begin is dropped with a warning when none of them is read yet
+	bool (*query_result)(struct Renoir* api, Renoir_Query query, Renoir_Query_Result* result);
+
+	// returns the last frame that the GPU has completed, it never blocks, and it returns false if the profiler
+	// is disabled or no frame has completed yet
+	bool (*profiler_frame_results)(struct Renoir* api, Renoir_Profiler_Frame* frame);
+	// writes the recorded trace events to the given path in chrome trace event json format (chrome://tracing, perfetto),
+	// returns false if the trace setting is disabled or the file cannot be opened
+	bool (*trace_export)(struct Renoir* api, const char* path);
+
 	// Graphics Commands
 	void (*pass_begin)(struct Renoir* api, Renoir_Pass pass);
 	void (*pass_end)(struct Renoir* api, Renoir_Pass pass);
@@ -427,28 +716,57 @@ typedef struct Renoir
 	void (*buffer_zero_global)(struct Renoir* api, Renoir_Buffer buffer);
 	// queues a buffer write command in the global command list (without a pass)
 	void (*buffer_write_global)(struct Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size);
+	// queues a copy of the [src_offset, src_offset + size) range of src into dst at dst_offset in the global command
+	// list (without a pass), src and dst should be different buffers
+	void (*buffer_copy_global)(struct Renoir* api, Renoir_Buffer dst, size_t dst_offset, Renoir_Buffer src, size_t src_offset, size_t size);
 	// queues a texture write command in the global command list (without a pass)
 	void (*texture_write_global)(struct Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc);
+	// allocates bytes_size bytes from the per-frame uniform ring buffer and writes the given bytes into it,
+	// the returned range is valid until the end of the frame (swapchain_present/flush), you should bind it using uniform_bind
+	// dx11 needs d3d11.1 constant buffer offsetting (windows 8+), without it the uniform writes and binds are dropped
+	// with an error
+	Renoir_Uniform (*uniform_alloc)(struct Renoir* api, Renoir_Pass pass, void* bytes, size_t bytes_size);
 	// Read Functions
 	void (*buffer_read)(struct Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size);
 	void (*texture_read)(struct Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc);
 	// Bind Functions
 	void (*buffer_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot);
+	// binds the [offset, offset + size) range of the buffer, offset should respect the device's uniform offset alignment
+	// (or the storage offset alignment for compute buffers), gl450 asserts it, dx11 asserts a 256 bytes offset for
+	// uniform buffers and a range which is a multiple of the buffer stride for compute buffers
+	void (*buffer_bind_range)(struct Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot, size_t offset, size_t size);
 	// TODO(Moustapha): consider making buffer_bind work like buffer_storage_bind, which means providing all the bindings
 	// at once, if you do that then there will be no need for separate buffer_storage_bind function
 	void (*buffer_storage_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Buffer_Storage_Bind_Desc desc);
 	void (*texture_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot);
+	void (*uniform_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Uniform uniform, RENOIR_SHADER shader, int slot);
 	void (*texture_sampler_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot, Renoir_Sampler_Desc sampler);
 	// Compute Bind Functions
 	void (*buffer_compute_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access);
+	void (*buffer_compute_bind_range)(struct Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access, size_t offset, size_t size);
 	void (*texture_compute_bind)(struct Renoir* api, Renoir_Pass pass, Renoir_Texture texture, int slot, int mip_level, RENOIR_ACCESS gpu_access);
 	// Draw
 	void (*draw)(struct Renoir* api, Renoir_Pass pass, Renoir_Draw_Desc desc);
 	// Dispatch
+	// no barrier is issued after the dispatch, use memory_barrier before the commands which read its writes
 	void (*dispatch)(struct Renoir* api, Renoir_Pass pass, int x, int y, int z);
+	// makes the writes of the commands before it (e.g. compute/storage writes) visible to the commands after it in the
+	// same pass or in the following passes, in gl450 it's a glMemoryBarrier, in dx11 it does nothing because the
+	// driver tracks these hazards itself
+	void (*memory_barrier)(struct Renoir* api, Renoir_Pass pass);
 	// Timer
 	void (*timer_begin)(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer);
 	void (*timer_end)(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer);
+	// Query
+	void (*query_begin)(struct Renoir* api, Renoir_Pass pass, Renoir_Query query);
+	void (*query_end)(struct Renoir* api, Renoir_Pass pass, Renoir_Query query);
+	// draws between conditional_begin and conditional_end are discarded by the GPU if the given occlusion query
+	// has no samples passed, if wait is false the GPU will render anyway if the query result is not ready yet
+	void (*conditional_begin)(struct Renoir* api, Renoir_Pass pass, Renoir_Query query, bool wait);
+	void (*conditional_end)(struct Renoir* api, Renoir_Pass pass);
+	// Profiler, these are no-ops if the profiler setting is disabled
+	void (*profiler_scope_begin)(struct Renoir* api, Renoir_Pass pass, const char* name);
+	void (*profiler_scope_end)(struct Renoir* api, Renoir_Pass pass);
 } Renoir;
 
 #define RENOIR_API "renoir"
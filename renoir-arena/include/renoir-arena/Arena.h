@@ -0,0 +1,75 @@
+#pragma once
+
+#include "renoir-arena/Exports.h"
+#include "renoir/Renoir.h"
+
+// renoir-arena is an optional layer on top of the renoir api which suballocates many small vertex/index ranges (e.g.
+// one per mesh) from a few large backing buffers using a buddy allocator, meshes which live in the same backing buffer
+// share the same vertex/index bindings and are drawn using base_vertex/base_element so they can be batched
+
+typedef struct Renoir_Arena Renoir_Arena;
+
+// allocation handles stay valid across renoir_arena_defrag, 0 is the invalid handle
+typedef struct Renoir_Arena_Alloc { int id; } Renoir_Arena_Alloc;
+
+typedef struct Renoir_Arena_Desc {
+	RENOIR_BUFFER type; // default: RENOIR_BUFFER_VERTEX, it should be RENOIR_BUFFER_VERTEX or RENOIR_BUFFER_INDEX
+	// size of one element in bytes (the vertex stride or the index size), all the allocations start at a multiple of
+	// it so they can be addressed in elements
+	size_t element_size;
+	// default: 1 << 20, number of elements in each backing buffer, it's rounded up to a power of two
+	size_t block_elements;
+	// default: 64, number of elements in the smallest allocation, it's rounded up to a power of two
+	size_t min_elements;
+	const char* tag; // default: null, memory stats tag of the backing buffers
+} Renoir_Arena_Desc;
+
+typedef struct Renoir_Arena_Range {
+	Renoir_Buffer buffer;
+	size_t offset; // in bytes
+	size_t size; // in bytes, it's the requested size
+	// offset in elements, use it as base_vertex for vertex ranges and add it to base_element for index ranges
+	int base;
+} Renoir_Arena_Range;
+
+typedef struct Renoir_Arena_Stats {
+	int blocks;
+	int allocations;
+	// bytes requested by the alive allocations
+	size_t used_bytes;
+	// bytes reserved for the alive allocations, it's larger than used_bytes since allocations are rounded up to a
+	// power of two of min_elements
+	size_t allocated_bytes;
+	// size of all the backing buffers
+	size_t capacity_bytes;
+} Renoir_Arena_Stats;
+
+RENOIR_ARENA_EXPORT Renoir_Arena*
+renoir_arena_new(Renoir* api, Renoir_Arena_Desc desc);
+
+RENOIR_ARENA_EXPORT void
+renoir_arena_free(Renoir_Arena* self);
+
+// allocates size bytes and uploads data into them if it's not null, size should fit in one backing buffer
+RENOIR_ARENA_EXPORT Renoir_Arena_Alloc
+renoir_arena_alloc(Renoir_Arena* self, const void* data, size_t size);
+
+// the range can be reused by the next allocation, so it should be released after the passes which draw it have ended
+RENOIR_ARENA_EXPORT void
+renoir_arena_release(Renoir_Arena* self, Renoir_Arena_Alloc alloc);
+
+RENOIR_ARENA_EXPORT void
+renoir_arena_write(Renoir_Arena* self, Renoir_Arena_Alloc alloc, size_t offset, const void* data, size_t size);
+
+// returns the current location of the allocation, it changes when renoir_arena_defrag moves it
+RENOIR_ARENA_EXPORT Renoir_Arena_Range
+renoir_arena_range(Renoir_Arena* self, Renoir_Arena_Alloc alloc);
+
+// moves the allocations out of the least used backing buffers into the free space of the other ones using gpu copies
+// and frees the backing buffers which become empty, it should be called outside of the passes and the ranges should
+// be queried again after it, returns the number of moved allocations
+RENOIR_ARENA_EXPORT int
+renoir_arena_defrag(Renoir_Arena* self);
+
+RENOIR_ARENA_EXPORT Renoir_Arena_Stats
+renoir_arena_stats(Renoir_Arena* self);
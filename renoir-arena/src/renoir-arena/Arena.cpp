@@ -0,0 +1,402 @@
+#include "renoir-arena/Arena.h"
+
+#include <mn/Memory.h>
+#include <mn/Buf.h>
+
+#include <assert.h>
+
+// max number of buddy orders in a backing buffer, order k holds ranges of (min_elements << k) elements
+constexpr int RENOIR_ARENA_MAX_ORDERS = 32;
+
+struct Renoir_Arena_Block
+{
+	// null if the block was freed, its slot is reused by the next block
+	Renoir_Buffer buffer;
+	// free ranges of each order, they're offsets in min_elements units
+	mn::Buf<size_t> free_lists[RENOIR_ARENA_MAX_ORDERS];
+	// min_elements units reserved by the alive allocations
+	size_t allocated_units;
+};
+
+struct Renoir_Arena_Allocation
+{
+	// -1 if the allocation was released, its slot is reused by the next allocation
+	int block;
+	size_t unit;
+	int order;
+	size_t size;
+};
+
+struct Renoir_Arena
+{
+	Renoir* api;
+	Renoir_Arena_Desc desc;
+	int orders;
+	size_t unit_size;
+	mn::Buf<Renoir_Arena_Block> blocks;
+	mn::Buf<Renoir_Arena_Allocation> allocations;
+	mn::Buf<int> free_allocations;
+};
+
+inline static size_t
+_renoir_arena_pow2(size_t v)
+{
+	size_t res = 1;
+	while (res < v)
+		res <<= 1;
+	return res;
+}
+
+inline static int
+_renoir_arena_order(size_t units)
+{
+	int res = 0;
+	while ((size_t(1) << res) < units)
+		++res;
+	return res;
+}
+
+inline static Renoir_Arena_Allocation&
+_renoir_arena_allocation(Renoir_Arena* self, Renoir_Arena_Alloc alloc)
+{
+	assert(alloc.id > 0 && size_t(alloc.id) <= self->allocations.count && "invalid arena allocation");
+	auto& res = self->allocations[alloc.id - 1];
+	assert(res.block >= 0 && "arena allocation is already released");
+	return res;
+}
+
+inline static size_t
+_renoir_arena_block_units(Renoir_Arena* self)
+{
+	return size_t(1) << (self->orders - 1);
+}
+
+static int
+_renoir_arena_block_new(Renoir_Arena* self)
+{
+	Renoir_Buffer_Desc desc{};
+	desc.type = self->desc.type;
+	desc.usage = RENOIR_USAGE_DYNAMIC;
+	desc.access = RENOIR_ACCESS_WRITE;
+	desc.data_size = _renoir_arena_block_units(self) * self->unit_size;
+	desc.tag = self->desc.tag;
+
+	size_t index = self->blocks.count;
+	for (size_t i = 0; i < self->blocks.count; ++i)
+	{
+		if (self->blocks[i].buffer.handle == nullptr)
+		{
+			index = i;
+			break;
+		}
+	}
+	if (index == self->blocks.count)
+	{
+		Renoir_Arena_Block block{};
+		for (auto& list: block.free_lists)
+			list = mn::buf_new<size_t>();
+		mn::buf_push(self->blocks, block);
+	}
+
+	auto& block = self->blocks[index];
+	block.buffer = self->api->buffer_new(self->api, desc);
+	block.allocated_units = 0;
+	for (auto& list: block.free_lists)
+		mn::buf_clear(list);
+	mn::buf_push(block.free_lists[self->orders - 1], size_t(0));
+	return int(index);
+}
+
+static void
+_renoir_arena_block_free(Renoir_Arena* self, Renoir_Arena_Block& block)
+{
+	assert(block.allocated_units == 0);
+	self->api->buffer_free(self->api, block.buffer);
+	block.buffer = Renoir_Buffer{};
+	for (auto& list: block.free_lists)
+		mn::buf_clear(list);
+}
+
+// finds the smallest free range which fits the given order and splits it down to that order
+static bool
+_renoir_arena_block_alloc(Renoir_Arena* self, Renoir_Arena_Block& block, int order, size_t& unit)
+{
+	int found = order;
+	while (found < self->orders && block.free_lists[found].count == 0)
+		++found;
+	if (found == self->orders)
+		return false;
+
+	unit = mn::buf_top(block.free_lists[found]);
+	mn::buf_pop(block.free_lists[found]);
+	while (found > order)
+	{
+		--found;
+		mn::buf_push(block.free_lists[found], unit + (size_t(1) << found));
+	}
+	block.allocated_units += size_t(1) << order;
+	return true;
+}
+
+// returns the range to its free list merging it with its buddy as long as the buddy is free
+static void
+_renoir_arena_block_release(Renoir_Arena* self, Renoir_Arena_Block& block, size_t unit, int order)
+{
+	block.allocated_units -= size_t(1) << order;
+	while (order < self->orders - 1)
+	{
+		auto buddy = unit ^ (size_t(1) << order);
+		auto& list = block.free_lists[order];
+		size_t index = list.count;
+		for (size_t i = 0; i < list.count; ++i)
+		{
+			if (list[i] == buddy)
+			{
+				index = i;
+				break;
+			}
+		}
+		if (index == list.count)
+			break;
+
+		mn::buf_remove(list, index);
+		if (buddy < unit)
+			unit = buddy;
+		++order;
+	}
+	mn::buf_push(block.free_lists[order], unit);
+}
+
+// returns the least used block which is worth emptying, -1 if there is none
+static int
+_renoir_arena_defrag_candidate(Renoir_Arena* self)
+{
+	int res = -1;
+	size_t blocks_count = 0;
+	for (size_t i = 0; i < self->blocks.count; ++i)
+	{
+		auto& block = self->blocks[i];
+		if (block.buffer.handle == nullptr)
+			continue;
+		++blocks_count;
+		if (res == -1 || block.allocated_units < self->blocks[res].allocated_units)
+			res = int(i);
+	}
+
+	// empty blocks are always freed, otherwise we need another block to move the allocations into
+	if (res != -1 && self->blocks[res].allocated_units > 0 && blocks_count < 2)
+		return -1;
+	return res;
+}
+
+Renoir_Arena*
+renoir_arena_new(Renoir* api, Renoir_Arena_Desc desc)
+{
+	if (desc.type == RENOIR_BUFFER_NONE)
+		desc.type = RENOIR_BUFFER_VERTEX;
+	if (desc.block_elements == 0)
+		desc.block_elements = 1 << 20;
+	if (desc.min_elements == 0)
+		desc.min_elements = 64;
+
+	assert((desc.type == RENOIR_BUFFER_VERTEX || desc.type == RENOIR_BUFFER_INDEX) && "arena should be vertex or index");
+	assert(desc.element_size > 0 && "arena element_size should be set");
+
+	desc.block_elements = _renoir_arena_pow2(desc.block_elements);
+	desc.min_elements = _renoir_arena_pow2(desc.min_elements);
+	assert(desc.min_elements <= desc.block_elements);
+
+	auto self = mn::alloc_zerod<Renoir_Arena>();
+	self->api = api;
+	self->desc = desc;
+	self->orders = _renoir_arena_order(desc.block_elements / desc.min_elements) + 1;
+	assert(self->orders <= RENOIR_ARENA_MAX_ORDERS && "arena block_elements is too large relative to min_elements");
+	self->unit_size = desc.element_size * desc.min_elements;
+	self->blocks = mn::buf_new<Renoir_Arena_Block>();
+	self->allocations = mn::buf_new<Renoir_Arena_Allocation>();
+	self->free_allocations = mn::buf_new<int>();
+	return self;
+}
+
+void
+renoir_arena_free(Renoir_Arena* self)
+{
+	if (self == nullptr)
+		return;
+
+	for (auto& block: self->blocks)
+	{
+		if (block.buffer.handle != nullptr)
+			self->api->buffer_free(self->api, block.buffer);
+		for (auto& list: block.free_lists)
+			mn::buf_free(list);
+	}
+	mn::buf_free(self->blocks);
+	mn::buf_free(self->allocations);
+	mn::buf_free(self->free_allocations);
+	mn::free(self);
+}
+
+Renoir_Arena_Alloc
+renoir_arena_alloc(Renoir_Arena* self, const void* data, size_t size)
+{
+	assert(size > 0);
+	auto units = (size + self->unit_size - 1) / self->unit_size;
+	auto order = _renoir_arena_order(units);
+	assert(order < self->orders && "arena allocation doesn't fit in a backing buffer");
+
+	Renoir_Arena_Allocation allocation{};
+	allocation.order = order;
+	allocation.size = size;
+	allocation.block = -1;
+	for (size_t i = 0; i < self->blocks.count; ++i)
+	{
+		auto& block = self->blocks[i];
+		if (block.buffer.handle == nullptr)
+			continue;
+		if (_renoir_arena_block_alloc(self, block, order, allocation.unit))
+		{
+			allocation.block = int(i);
+			break;
+		}
+	}
+	if (allocation.block == -1)
+	{
+		allocation.block = _renoir_arena_block_new(self);
+		auto ok = _renoir_arena_block_alloc(self, self->blocks[allocation.block], order, allocation.unit);
+		assert(ok && "a new backing buffer should fit any allocation");
+	}
+
+	Renoir_Arena_Alloc res{};
+	if (self->free_allocations.count > 0)
+	{
+		res.id = mn::buf_top(self->free_allocations);
+		mn::buf_pop(self->free_allocations);
+		self->allocations[res.id - 1] = allocation;
+	}
+	else
+	{
+		mn::buf_push(self->allocations, allocation);
+		res.id = int(self->allocations.count);
+	}
+
+	if (data)
+		renoir_arena_write(self, res, 0, data, size);
+	return res;
+}
+
+void
+renoir_arena_release(Renoir_Arena* self, Renoir_Arena_Alloc alloc)
+{
+	if (alloc.id == 0)
+		return;
+
+	auto& allocation = _renoir_arena_allocation(self, alloc);
+	_renoir_arena_block_release(self, self->blocks[allocation.block], allocation.unit, allocation.order);
+	allocation.block = -1;
+	mn::buf_push(self->free_allocations, alloc.id);
+}
+
+void
+renoir_arena_write(Renoir_Arena* self, Renoir_Arena_Alloc alloc, size_t offset, const void* data, size_t size)
+{
+	auto& allocation = _renoir_arena_allocation(self, alloc);
+	assert(offset + size <= allocation.size && "arena write is out of range");
+	auto& block = self->blocks[allocation.block];
+	self->api->buffer_write_global(self->api, block.buffer, allocation.unit * self->unit_size + offset, (void*)data, size);
+}
+
+Renoir_Arena_Range
+renoir_arena_range(Renoir_Arena* self, Renoir_Arena_Alloc alloc)
+{
+	auto& allocation = _renoir_arena_allocation(self, alloc);
+	Renoir_Arena_Range res{};
+	res.buffer = self->blocks[allocation.block].buffer;
+	res.offset = allocation.unit * self->unit_size;
+	res.size = allocation.size;
+	res.base = int(allocation.unit * self->desc.min_elements);
+	return res;
+}
+
+int
+renoir_arena_defrag(Renoir_Arena* self)
+{
+	int moved = 0;
+	while (true)
+	{
+		auto source = _renoir_arena_defrag_candidate(self);
+		if (source == -1)
+			break;
+
+		// move the largest allocations first so that the small ones fill the gaps
+		bool emptied = true;
+		for (int order = self->orders - 1; order >= 0 && emptied; --order)
+		{
+			for (auto& allocation: self->allocations)
+			{
+				if (allocation.block != source || allocation.order != order)
+					continue;
+
+				int target = -1;
+				size_t unit = 0;
+				for (size_t i = 0; i < self->blocks.count; ++i)
+				{
+					auto& block = self->blocks[i];
+					if (int(i) == source || block.buffer.handle == nullptr)
+						continue;
+					if (_renoir_arena_block_alloc(self, block, order, unit))
+					{
+						target = int(i);
+						break;
+					}
+				}
+				if (target == -1)
+				{
+					emptied = false;
+					break;
+				}
+
+				auto& src = self->blocks[source];
+				self->api->buffer_copy_global(
+					self->api,
+					self->blocks[target].buffer,
+					unit * self->unit_size,
+					src.buffer,
+					allocation.unit * self->unit_size,
+					allocation.size
+				);
+				_renoir_arena_block_release(self, src, allocation.unit, allocation.order);
+				allocation.block = target;
+				allocation.unit = unit;
+				++moved;
+			}
+		}
+
+		if (emptied == false)
+			break;
+		_renoir_arena_block_free(self, self->blocks[source]);
+	}
+	return moved;
+}
+
+Renoir_Arena_Stats
+renoir_arena_stats(Renoir_Arena* self)
+{
+	Renoir_Arena_Stats res{};
+	for (const auto& block: self->blocks)
+	{
+		if (block.buffer.handle == nullptr)
+			continue;
+		++res.blocks;
+		res.allocated_bytes += block.allocated_units * self->unit_size;
+		res.capacity_bytes += _renoir_arena_block_units(self) * self->unit_size;
+	}
+	for (const auto& allocation: self->allocations)
+	{
+		if (allocation.block == -1)
+			continue;
+		++res.allocations;
+		res.used_bytes += allocation.size;
+	}
+	return res;
+}
@@ -1,10 +1,12 @@
 #include "renoir-dx11/Exports.h"
 
 #include <renoir/Renoir.h>
+#include <renoir-backend/Transient.h>
 
 #include <mn/Thread.h>
 #include <mn/Pool.h>
 #include <mn/Buf.h>
+#include <mn/Ring.h>
 #include <mn/Defer.h>
 #include <mn/Log.h>
 #include <mn/Map.h>
@@ -19,9 +21,11 @@
 #include <stdio.h>
 
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcommon.h>
 #include <d3dcompiler.h>
 #include <dxgi.h>
+#include <dxgi1_4.h>
 
 inline static int
 _renoir_buffer_type_to_dx(RENOIR_BUFFER type)
@@ -324,11 +328,290 @@ enum RENOIR_HANDLE_KIND
 	RENOIR_HANDLE_KIND_COMPUTE,
 	RENOIR_HANDLE_KIND_PIPELINE,
 	RENOIR_HANDLE_KIND_TIMER,
+	RENOIR_HANDLE_KIND_COUNT,
 };
 
+// program/compute reflection, it's collected from every shader stage when the program is created, a resource which is
+// used by more than one stage is reported once
+struct Renoir_DX11_Reflect
+{
+	mn::Buf<mn::Str> names;
+	mn::Buf<Renoir_Reflect_Member> uniform_members;
+	mn::Buf<Renoir_Reflect_Member> storage_members;
+	mn::Buf<Renoir_Reflect_Block> uniform_blocks;
+	mn::Buf<Renoir_Reflect_Block> storage_blocks;
+	mn::Buf<Renoir_Reflect_Texture> samplers;
+	mn::Buf<Renoir_Reflect_Texture> images;
+	int workgroup_size[3];
+};
+
+inline static const char*
+_renoir_dx11_reflect_name(Renoir_DX11_Reflect* self, const char* name)
+{
+	// the string content doesn't move when the names buffer grows so it's safe to hand out the pointer
+	mn::buf_push(self->names, mn::str_from_c(name));
+	return mn::buf_top(self->names).ptr;
+}
+
+template<typename T>
+inline static bool
+_renoir_dx11_reflect_contains(const mn::Buf<T>& list, const char* name, int binding)
+{
+	for (const auto& it: list)
+		if (it.binding == binding && ::strcmp(it.name, name) == 0)
+			return true;
+	return false;
+}
+
+// size of one element of the given type inside a structured buffer, structured buffers are tightly packed
+inline static UINT
+_renoir_dx11_reflect_type_size(ID3D11ShaderReflectionType* type)
+{
+	D3D11_SHADER_TYPE_DESC desc{};
+	type->GetDesc(&desc);
+	if (desc.Class != D3D_SVC_STRUCT)
+		return desc.Rows * desc.Columns * (desc.Type == D3D_SVT_DOUBLE ? 8 : 4);
+
+	UINT size = 0;
+	for (UINT i = 0; i < desc.Members; ++i)
+	{
+		auto member_type = type->GetMemberTypeByIndex(i);
+		D3D11_SHADER_TYPE_DESC member_desc{};
+		member_type->GetDesc(&member_desc);
+		auto end = member_desc.Offset + _renoir_dx11_reflect_type_size(member_type) * (member_desc.Elements > 0 ? member_desc.Elements : 1);
+		if (end > size)
+			size = end;
+	}
+	return size;
+}
+
+inline static void
+_renoir_dx11_reflect_uniform_block(Renoir_DX11_Reflect* self, ID3D11ShaderReflection* reflection, const D3D11_SHADER_INPUT_BIND_DESC& bind)
+{
+	if (_renoir_dx11_reflect_contains(self->uniform_blocks, bind.Name, int(bind.BindPoint)))
+		return;
+
+	auto buffer = reflection->GetConstantBufferByName(bind.Name);
+	D3D11_SHADER_BUFFER_DESC buffer_desc{};
+	buffer->GetDesc(&buffer_desc);
+
+	Renoir_Reflect_Block block{};
+	block.name = _renoir_dx11_reflect_name(self, bind.Name);
+	block.binding = int(bind.BindPoint);
+	block.size = buffer_desc.Size;
+	block.members_count = int(buffer_desc.Variables);
+	for (UINT i = 0; i < buffer_desc.Variables; ++i)
+	{
+		auto variable = buffer->GetVariableByIndex(i);
+		D3D11_SHADER_VARIABLE_DESC variable_desc{};
+		variable->GetDesc(&variable_desc);
+		D3D11_SHADER_TYPE_DESC type_desc{};
+		variable->GetType()->GetDesc(&type_desc);
+
+		Renoir_Reflect_Member member{};
+		member.name = _renoir_dx11_reflect_name(self, variable_desc.Name);
+		member.offset = int(variable_desc.StartOffset);
+		member.array_size = 1;
+		if (type_desc.Elements > 0)
+		{
+			// constant buffer array elements start at 16 bytes boundaries and only the last element isn't padded
+			member.array_size = int(type_desc.Elements);
+			member.array_stride = int((variable_desc.Size + 15) / 16 * 16 / type_desc.Elements);
+		}
+		mn::buf_push(self->uniform_members, member);
+	}
+	mn::buf_push(self->uniform_blocks, block);
+}
+
+inline static void
+_renoir_dx11_reflect_storage_block(Renoir_DX11_Reflect* self, ID3D11ShaderReflection* reflection, const D3D11_SHADER_INPUT_BIND_DESC& bind)
+{
+	if (_renoir_dx11_reflect_contains(self->storage_blocks, bind.Name, int(bind.BindPoint)))
+		return;
+
+	Renoir_Reflect_Block block{};
+	block.name = _renoir_dx11_reflect_name(self, bind.Name);
+	block.binding = int(bind.BindPoint);
+
+	// byte address buffers have no layout, structured buffers describe their element type in a constant buffer with
+	// the same name, so the block size is the element stride and the members are the element fields
+	if (bind.Type != D3D_SIT_BYTEADDRESS && bind.Type != D3D_SIT_UAV_RWBYTEADDRESS)
+	{
+		auto element_type = reflection->GetConstantBufferByName(bind.Name)->GetVariableByIndex(0)->GetType();
+		D3D11_SHADER_TYPE_DESC element_desc{};
+		element_type->GetDesc(&element_desc);
+
+		block.size = _renoir_dx11_reflect_type_size(element_type);
+		block.members_count = int(element_desc.Members);
+		for (UINT i = 0; i < element_desc.Members; ++i)
+		{
+			auto member_type = element_type->GetMemberTypeByIndex(i);
+			D3D11_SHADER_TYPE_DESC member_desc{};
+			member_type->GetDesc(&member_desc);
+
+			Renoir_Reflect_Member member{};
+			member.name = _renoir_dx11_reflect_name(self, element_type->GetMemberTypeName(i));
+			member.offset = int(member_desc.Offset);
+			member.array_size = 1;
+			if (member_desc.Elements > 0)
+			{
+				member.array_size = int(member_desc.Elements);
+				member.array_stride = int(_renoir_dx11_reflect_type_size(member_type));
+			}
+			mn::buf_push(self->storage_members, member);
+		}
+	}
+	mn::buf_push(self->storage_blocks, block);
+}
+
+inline static void
+_renoir_dx11_reflect_texture(Renoir_DX11_Reflect* self, mn::Buf<Renoir_Reflect_Texture>& textures, const D3D11_SHADER_INPUT_BIND_DESC& bind)
+{
+	if (_renoir_dx11_reflect_contains(textures, bind.Name, int(bind.BindPoint)))
+		return;
+
+	Renoir_Reflect_Texture texture{};
+	texture.name = _renoir_dx11_reflect_name(self, bind.Name);
+	texture.binding = int(bind.BindPoint);
+	texture.array_size = int(bind.BindCount);
+	mn::buf_push(textures, texture);
+}
+
+inline static Renoir_DX11_Reflect*
+_renoir_dx11_reflect_new()
+{
+	auto self = mn::alloc_zerod<Renoir_DX11_Reflect>();
+	self->names = mn::buf_new<mn::Str>();
+	self->uniform_members = mn::buf_new<Renoir_Reflect_Member>();
+	self->storage_members = mn::buf_new<Renoir_Reflect_Member>();
+	self->uniform_blocks = mn::buf_new<Renoir_Reflect_Block>();
+	self->storage_blocks = mn::buf_new<Renoir_Reflect_Block>();
+	self->samplers = mn::buf_new<Renoir_Reflect_Texture>();
+	self->images = mn::buf_new<Renoir_Reflect_Texture>();
+	return self;
+}
+
+inline static void
+_renoir_dx11_reflect_free(Renoir_DX11_Reflect* self)
+{
+	if (self == nullptr)
+		return;
+
+	for (auto& name: self->names)
+		mn::str_free(name);
+	mn::buf_free(self->names);
+	mn::buf_free(self->uniform_members);
+	mn::buf_free(self->storage_members);
+	mn::buf_free(self->uniform_blocks);
+	mn::buf_free(self->storage_blocks);
+	mn::buf_free(self->samplers);
+	mn::buf_free(self->images);
+	mn::free(self);
+}
+
+// adds the resources of the given compiled shader stage to the reflection
+inline static void
+_renoir_dx11_reflect_shader(Renoir_DX11_Reflect* self, ID3D10Blob* blob, bool compute)
+{
+	ID3D11ShaderReflection* reflection = nullptr;
+	auto res = D3DReflect(
+		blob->GetBufferPointer(),
+		blob->GetBufferSize(),
+		__uuidof(ID3D11ShaderReflection),
+		(void**)&reflection
+	);
+	if (FAILED(res))
+	{
+		mn::log_error("dx11: shader reflection failed");
+		return;
+	}
+	mn_defer(reflection->Release());
+
+	D3D11_SHADER_DESC shader_desc{};
+	res = reflection->GetDesc(&shader_desc);
+	assert(SUCCEEDED(res));
+
+	for (UINT i = 0; i < shader_desc.BoundResources; ++i)
+	{
+		D3D11_SHADER_INPUT_BIND_DESC bind{};
+		res = reflection->GetResourceBindingDesc(i, &bind);
+		assert(SUCCEEDED(res));
+
+		switch (bind.Type)
+		{
+		case D3D_SIT_CBUFFER:
+			_renoir_dx11_reflect_uniform_block(self, reflection, bind);
+			break;
+		case D3D_SIT_STRUCTURED:
+		case D3D_SIT_BYTEADDRESS:
+		case D3D_SIT_UAV_RWSTRUCTURED:
+		case D3D_SIT_UAV_RWBYTEADDRESS:
+		case D3D_SIT_UAV_APPEND_STRUCTURED:
+		case D3D_SIT_UAV_CONSUME_STRUCTURED:
+		case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+			_renoir_dx11_reflect_storage_block(self, reflection, bind);
+			break;
+		case D3D_SIT_TEXTURE:
+			_renoir_dx11_reflect_texture(self, self->samplers, bind);
+			break;
+		case D3D_SIT_UAV_RWTYPED:
+			_renoir_dx11_reflect_texture(self, self->images, bind);
+			break;
+		default:
+			// sampler states are bound along with their textures in renoir
+			break;
+		}
+	}
+
+	if (compute)
+	{
+		UINT x = 0, y = 0, z = 0;
+		reflection->GetThreadGroupSize(&x, &y, &z);
+		self->workgroup_size[0] = int(x);
+		self->workgroup_size[1] = int(y);
+		self->workgroup_size[2] = int(z);
+	}
+
+	// members are pushed in block order so we can fix their pointers now, the members buffers might have grown
+	// so the blocks of the previous stages are fixed again
+	size_t members_offset = 0;
+	for (auto& block: self->uniform_blocks)
+	{
+		block.members = self->uniform_members.ptr + members_offset;
+		members_offset += block.members_count;
+	}
+	members_offset = 0;
+	for (auto& block: self->storage_blocks)
+	{
+		block.members = self->storage_members.ptr + members_offset;
+		members_offset += block.members_count;
+	}
+}
+
+inline static Renoir_Reflect
+_renoir_dx11_reflect_desc(Renoir_DX11_Reflect* self)
+{
+	Renoir_Reflect res{};
+	res.uniform_blocks = self->uniform_blocks.ptr;
+	res.uniform_blocks_count = (int)self->uniform_blocks.count;
+	res.storage_blocks = self->storage_blocks.ptr;
+	res.storage_blocks_count = (int)self->storage_blocks.count;
+	res.samplers = self->samplers.ptr;
+	res.samplers_count = (int)self->samplers.count;
+	res.images = self->images.ptr;
+	res.images_count = (int)self->images.count;
+	res.workgroup_size[0] = self->workgroup_size[0];
+	res.workgroup_size[1] = self->workgroup_size[1];
+	res.workgroup_size[2] = self->workgroup_size[2];
+	return res;
+}
+
 struct Renoir_Handle
 {
 	RENOIR_HANDLE_KIND kind;
+	// public id of the handle (see Renoir_DX11_Handle_Table), 0 once the handle is freed, it's atomic because
+	// ids are resolved without locking
+	std::atomic<uint32_t> id;
 	std::atomic<int> rc;
 	union
 	{
@@ -372,8 +655,12 @@ struct Renoir_Handle
 			RENOIR_ACCESS access;
 			size_t size;
 			ID3D11Buffer* buffer_staging;
+			// index of the memory stats tag
+			int memory_tag;
 			ID3D11ShaderResourceView* srv;
 			ID3D11UnorderedAccessView* uav;
+			// element stride of compute buffers, ranged views are measured in elements
+			UINT compute_stride;
 		} buffer;
 
 		struct
@@ -391,6 +678,8 @@ struct Renoir_Handle
 			// render target part
 			ID3D11Texture2D* render_color_buffer;
 			Renoir_Texture_Desc desc;
+			// index of the memory stats tag
+			int memory_tag;
 		} texture;
 
 		struct
@@ -406,11 +695,13 @@ struct Renoir_Handle
 			ID3D10Blob* vertex_shader_blob;
 			ID3D11PixelShader* pixel_shader;
 			ID3D11GeometryShader* geometry_shader;
+			Renoir_DX11_Reflect* reflect;
 		} program;
 
 		struct
 		{
 			ID3D11ComputeShader* compute_shader;
+			Renoir_DX11_Reflect* reflect;
 		} compute;
 
 		struct
@@ -447,10 +738,24 @@ _renoir_handle_kind_name(RENOIR_HANDLE_KIND kind)
 	case RENOIR_HANDLE_KIND_PROGRAM: return "program";
 	case RENOIR_HANDLE_KIND_COMPUTE: return "compute";
 	case RENOIR_HANDLE_KIND_PIPELINE: return "pipeline";
+	case RENOIR_HANDLE_KIND_TIMER: return "timer";
 	default: assert(false && "invalid handle kind"); return "<INVALID>";
 	}
 }
 
+inline static const char*
+_renoir_memory_name(RENOIR_MEMORY kind)
+{
+	switch(kind)
+	{
+	case RENOIR_MEMORY_BUFFER: return "buffer";
+	case RENOIR_MEMORY_TEXTURE: return "texture";
+	case RENOIR_MEMORY_RENDERBUFFER: return "renderbuffer";
+	case RENOIR_MEMORY_FRAMEBUFFER: return "framebuffer";
+	default: assert(false && "invalid memory kind"); return "<INVALID>";
+	}
+}
+
 inline static bool
 _renoir_handle_kind_should_track(RENOIR_HANDLE_KIND kind)
 {
@@ -550,6 +855,7 @@ enum RENOIR_COMMAND_KIND
 	RENOIR_COMMAND_KIND_SCISSOR,
 	RENOIR_COMMAND_KIND_BUFFER_CLEAR,
 	RENOIR_COMMAND_KIND_BUFFER_WRITE,
+	RENOIR_COMMAND_KIND_BUFFER_COPY,
 	RENOIR_COMMAND_KIND_TEXTURE_WRITE,
 	RENOIR_COMMAND_KIND_BUFFER_READ,
 	RENOIR_COMMAND_KIND_TEXTURE_READ,
@@ -560,8 +866,64 @@ enum RENOIR_COMMAND_KIND
 	RENOIR_COMMAND_KIND_DISPATCH,
 	RENOIR_COMMAND_KIND_TIMER_BEGIN,
 	RENOIR_COMMAND_KIND_TIMER_END,
+	RENOIR_COMMAND_KIND_UNIFORM_WRITE,
+	RENOIR_COMMAND_KIND_COUNT,
 };
 
+inline static const char*
+_renoir_command_kind_name(RENOIR_COMMAND_KIND kind)
+{
+	switch(kind)
+	{
+	case RENOIR_COMMAND_KIND_NONE: return "none";
+	case RENOIR_COMMAND_KIND_INIT: return "init";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW: return "swapchain_new";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE: return "swapchain_free";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_RESIZE: return "swapchain_resize";
+	case RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW: return "pass_swapchain_new";
+	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW: return "pass_offscreen_new";
+	case RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW: return "pass_compute_new";
+	case RENOIR_COMMAND_KIND_PASS_FREE: return "pass_free";
+	case RENOIR_COMMAND_KIND_BUFFER_NEW: return "buffer_new";
+	case RENOIR_COMMAND_KIND_BUFFER_FREE: return "buffer_free";
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW: return "texture_new";
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE: return "texture_free";
+	case RENOIR_COMMAND_KIND_SAMPLER_NEW: return "sampler_new";
+	case RENOIR_COMMAND_KIND_SAMPLER_FREE: return "sampler_free";
+	case RENOIR_COMMAND_KIND_PROGRAM_NEW: return "program_new";
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE: return "program_free";
+	case RENOIR_COMMAND_KIND_COMPUTE_NEW: return "compute_new";
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE: return "compute_free";
+	case RENOIR_COMMAND_KIND_PIPELINE_NEW: return "pipeline_new";
+	case RENOIR_COMMAND_KIND_PIPELINE_FREE: return "pipeline_free";
+	case RENOIR_COMMAND_KIND_TIMER_NEW: return "timer_new";
+	case RENOIR_COMMAND_KIND_TIMER_FREE: return "timer_free";
+	case RENOIR_COMMAND_KIND_TIMER_ELAPSED: return "timer_elapsed";
+	case RENOIR_COMMAND_KIND_PASS_BEGIN: return "pass_begin";
+	case RENOIR_COMMAND_KIND_PASS_END: return "pass_end";
+	case RENOIR_COMMAND_KIND_PASS_CLEAR: return "pass_clear";
+	case RENOIR_COMMAND_KIND_USE_PIPELINE: return "use_pipeline";
+	case RENOIR_COMMAND_KIND_USE_PROGRAM: return "use_program";
+	case RENOIR_COMMAND_KIND_USE_COMPUTE: return "use_compute";
+	case RENOIR_COMMAND_KIND_SCISSOR: return "scissor";
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR: return "buffer_clear";
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE: return "buffer_write";
+	case RENOIR_COMMAND_KIND_BUFFER_COPY: return "buffer_copy";
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE: return "texture_write";
+	case RENOIR_COMMAND_KIND_BUFFER_READ: return "buffer_read";
+	case RENOIR_COMMAND_KIND_TEXTURE_READ: return "texture_read";
+	case RENOIR_COMMAND_KIND_BUFFER_BIND: return "buffer_bind";
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND: return "buffer_storage_bind";
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND: return "texture_bind";
+	case RENOIR_COMMAND_KIND_DRAW: return "draw";
+	case RENOIR_COMMAND_KIND_DISPATCH: return "dispatch";
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN: return "timer_begin";
+	case RENOIR_COMMAND_KIND_TIMER_END: return "timer_end";
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE: return "uniform_write";
+	default: assert(false && "invalid command kind"); return "<INVALID>";
+	}
+}
+
 struct Renoir_Command
 {
 	Renoir_Command *prev, *next;
@@ -741,6 +1103,22 @@ struct Renoir_Command
 			size_t bytes_size;
 		} buffer_write;
 
+		struct
+		{
+			size_t offset;
+			void* bytes;
+			size_t bytes_size;
+		} uniform_write;
+
+		struct
+		{
+			Renoir_Handle* dst;
+			size_t dst_offset;
+			Renoir_Handle* src;
+			size_t src_offset;
+			size_t size;
+		} buffer_copy;
+
 		struct
 		{
 			Renoir_Handle* handle;
@@ -767,12 +1145,18 @@ struct Renoir_Command
 			RENOIR_SHADER shader;
 			int slot;
 			RENOIR_ACCESS gpu_access;
+			// bound range of the buffer, a size of 0 binds the whole buffer
+			size_t offset;
+			size_t size;
 		} buffer_bind;
 
 		struct
 		{
 			Renoir_Handle* handle[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
 			int start_slot;
+			// bound range of each buffer, a size of 0 binds the whole buffer
+			size_t offsets[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
+			size_t sizes[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
 		} buffer_storage_bind;
 
 		struct
@@ -813,6 +1197,93 @@ struct Renoir_Leak_Info
 	size_t callstack_size;
 };
 
+struct Renoir_DX11_Memory_Tag
+{
+	mn::Str name;
+	Renoir_Memory_Counter counter;
+};
+
+// estimated memory footprint of the alive resources, it's updated with the mutex locked
+struct Renoir_DX11_Memory
+{
+	Renoir_Memory_Counter total;
+	Renoir_Memory_Counter kinds[RENOIR_MEMORY_COUNT];
+	// tags are never removed so that handles can refer to them by index, the first one is for untagged resources
+	mn::Buf<Renoir_DX11_Memory_Tag> tags;
+};
+
+struct Renoir_DX11_Vertex_Binding
+{
+	ID3D11Buffer* buffer;
+	UINT stride;
+	UINT offset;
+};
+
+struct Renoir_DX11_Input_State
+{
+	Renoir_DX11_Vertex_Binding vertex_buffers[RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE];
+	ID3D11Buffer* index_buffer;
+	DXGI_FORMAT index_format;
+};
+
+struct Renoir_DX11_Stats
+{
+	// current frame counters, they are moved to last_frame in flush/swapchain_present
+	Renoir_Stats frame;
+	int command_counts[RENOIR_COMMAND_KIND_COUNT];
+	Renoir_Stats last_frame;
+
+	// lifetime counters
+	int live_handles[RENOIR_HANDLE_KIND_COUNT];
+	size_t alive_handles;
+	size_t alive_commands;
+	size_t command_pool_high_water_mark;
+	size_t handle_pool_high_water_mark;
+};
+
+// the uniform ring is a single dynamic constant buffer, the first write of each frame maps it with
+// D3D11_MAP_WRITE_DISCARD so the driver renames it instead of waiting for the frames in flight, and the rest of the
+// frame writes map it with D3D11_MAP_WRITE_NO_OVERWRITE since they never overlap
+struct Renoir_DX11_Uniform_Ring
+{
+	Renoir_Handle* buffer;
+	size_t alignment;
+	// allocation offset in the current frame, it's only accessed on the api side
+	size_t offset;
+	// true until the first write of the current frame executes
+	bool discard;
+};
+
+// public handles are 32-bit ids which pack the handle kind, the slot index and the slot generation, the generation is
+// bumped when the slot is freed so that stale ids are detected in O(1) instead of aliasing the handle which reused it
+constexpr uint32_t RENOIR_DX11_HANDLE_INDEX_BITS = 18;
+constexpr uint32_t RENOIR_DX11_HANDLE_GENERATION_BITS = 10;
+constexpr uint32_t RENOIR_DX11_HANDLE_KIND_SHIFT = RENOIR_DX11_HANDLE_INDEX_BITS + RENOIR_DX11_HANDLE_GENERATION_BITS;
+constexpr uint32_t RENOIR_DX11_HANDLE_INDEX_MASK = (1u << RENOIR_DX11_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t RENOIR_DX11_HANDLE_GENERATION_MASK = (1u << RENOIR_DX11_HANDLE_GENERATION_BITS) - 1;
+// freed slots are reused in fifo order once there are RENOIR_DX11_HANDLE_MIN_FREE_SLOTS of them like in gl450, so the
+// generation of a slot doesn't wrap after a few seconds of create/free churn
+constexpr uint32_t RENOIR_DX11_HANDLE_MIN_FREE_SLOTS = 1024;
+constexpr uint32_t RENOIR_DX11_HANDLE_CHUNK_SIZE = 128;
+constexpr uint32_t RENOIR_DX11_HANDLE_CHUNKS_COUNT = (1u << RENOIR_DX11_HANDLE_INDEX_BITS) / RENOIR_DX11_HANDLE_CHUNK_SIZE;
+static_assert(RENOIR_HANDLE_KIND_COUNT <= (1u << (32 - RENOIR_DX11_HANDLE_KIND_SHIFT)), "handle kind doesn't fit in the id");
+
+struct Renoir_DX11_Handle_Chunk
+{
+	Renoir_Handle handles[RENOIR_DX11_HANDLE_CHUNK_SIZE];
+	// generations live outside of the handles because the handles are cleared when they're reused
+	uint32_t generations[RENOIR_DX11_HANDLE_CHUNK_SIZE];
+};
+
+// dense table of the handles of one kind, chunks never move once they're allocated and the chunk pointers and the
+// handle ids are atomic so ids can be resolved without locking the mutex, free slots are reused in fifo order
+struct Renoir_DX11_Handle_Table
+{
+	std::atomic<Renoir_DX11_Handle_Chunk*> chunks[RENOIR_DX11_HANDLE_CHUNKS_COUNT];
+	uint32_t slots_count;
+	mn::Ring<uint32_t> free_slots;
+};
+
 struct IRenoir
 {
 	mn::Mutex mtx;
@@ -820,7 +1291,7 @@ struct IRenoir
 	IDXGIAdapter* adapter;
 	ID3D11Device* device;
 	ID3D11DeviceContext* context;
-	mn::Pool handle_pool;
+	Renoir_DX11_Handle_Table handles[RENOIR_HANDLE_KIND_COUNT];
 	mn::Pool command_pool;
 	Renoir_Settings settings;
 
@@ -834,33 +1305,200 @@ struct IRenoir
 	Renoir_Handle* current_compute;
 	Renoir_Handle* current_pass;
 
+	// input assembler state, it's used to skip redundant binds between draws which share the same vertex and index
+	// buffers (e.g. meshes suballocated from the same buffer using base_vertex)
+	Renoir_DX11_Input_State input_state;
+
+	// d3d11.1 context used for ranged constant buffer binds, it's nullptr if the runtime doesn't support it
+	ID3D11DeviceContext1* context1;
+	// ranged constant buffer binds and the uniform ring need d3d11.1 constant buffer offsetting and no overwrite maps
+	// of dynamic constant buffers, it's checked at init and reported the first time it's needed
+	bool constant_buffer_offsetting;
+	bool constant_buffer_offsetting_reported;
+	Renoir_DX11_Uniform_Ring uniform_ring;
+
 	// caches
 	mn::Buf<Renoir_Handle*> sampler_cache;
 	mn::Buf<Renoir_Handle*> pipeline_cache;
+	Renoir_Transient_Pool transient_pool;
+
+	// backend statistics, they are updated with the mutex locked
+	Renoir_DX11_Stats stats;
+
+	// resources memory accounting
+	Renoir_DX11_Memory memory;
 
-	// leak detection
+	// leak detection callstacks, alive handles are found by walking the handle tables
+	#if RENOIR_LEAK
 	mn::Map<Renoir_Handle*, Renoir_Leak_Info> alive_handles;
+	#endif
 };
 
 static void
 _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command);
 
+inline static void
+_renoir_dx11_memory_counter_update(Renoir_Memory_Counter& counter, size_t bytes, bool alloc)
+{
+	if (alloc)
+	{
+		++counter.count;
+		counter.bytes += bytes;
+		if (counter.bytes > counter.high_water_mark)
+			counter.high_water_mark = counter.bytes;
+	}
+	else
+	{
+		--counter.count;
+		counter.bytes -= bytes;
+	}
+}
+
+// returns the index of the given memory tag, null is the untagged resources tag
+static int
+_renoir_dx11_memory_tag(IRenoir* self, const char* tag)
+{
+	if (tag == nullptr)
+		return 0;
+
+	auto& tags = self->memory.tags;
+	for (size_t i = 1; i < tags.count; ++i)
+		if (::strcmp(tags[i].name.ptr, tag) == 0)
+			return int(i);
+
+	mn::buf_push(tags, Renoir_DX11_Memory_Tag{mn::str_from_c(tag), Renoir_Memory_Counter{}});
+	return int(tags.count - 1);
+}
+
+// estimated footprint of the texture storage (all mipmaps and cube faces), and of its msaa render target, msaa_sampled
+// textures keep their single sample storage next to the msaa one
+static void
+_renoir_dx11_texture_memory(const Renoir_Texture_Desc& desc, size_t& texture_bytes, size_t& renderbuffer_bytes)
+{
+	auto pixel_size = _renoir_pixelformat_to_size(desc.pixel_format);
+	size_t width = desc.size.width;
+	size_t height = desc.size.height > 0 ? desc.size.height : 1;
+	size_t depth = desc.size.depth > 0 ? desc.size.depth : 1;
+	size_t faces = desc.cube_map ? 6 : 1;
+
+	texture_bytes = 0;
+	renderbuffer_bytes = 0;
+
+	if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE && desc.size.height > 0 && desc.size.depth == 0)
+		renderbuffer_bytes = width * height * pixel_size * size_t(desc.msaa) * faces;
+
+	for (int i = 0; i < desc.mipmaps; ++i)
+	{
+		texture_bytes += width * height * depth * pixel_size * faces;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		depth = depth > 1 ? depth / 2 : 1;
+	}
+}
+
+// accounts the memory of buffer and texture handles, alloc is true when they're created and false when they're freed
+static void
+_renoir_dx11_memory_handle(IRenoir* self, Renoir_Handle* h, bool alloc)
+{
+	auto& memory = self->memory;
+
+	size_t bytes = 0;
+	int tag = 0;
+	if (h->kind == RENOIR_HANDLE_KIND_BUFFER)
+	{
+		bytes = h->buffer.size;
+		tag = h->buffer.memory_tag;
+		_renoir_dx11_memory_counter_update(memory.kinds[RENOIR_MEMORY_BUFFER], bytes, alloc);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_TEXTURE)
+	{
+		size_t texture_bytes = 0, renderbuffer_bytes = 0;
+		_renoir_dx11_texture_memory(h->texture.desc, texture_bytes, renderbuffer_bytes);
+		_renoir_dx11_memory_counter_update(memory.kinds[RENOIR_MEMORY_TEXTURE], texture_bytes, alloc);
+		if (renderbuffer_bytes > 0)
+			_renoir_dx11_memory_counter_update(memory.kinds[RENOIR_MEMORY_RENDERBUFFER], renderbuffer_bytes, alloc);
+		bytes = texture_bytes + renderbuffer_bytes;
+		tag = h->texture.memory_tag;
+	}
+	else
+	{
+		return;
+	}
+
+	_renoir_dx11_memory_counter_update(memory.total, bytes, alloc);
+	_renoir_dx11_memory_counter_update(memory.tags[tag].counter, bytes, alloc);
+}
+
+// queries the adapter video memory, the available memory needs IDXGIAdapter3 (windows 10) so it stays 0 without it
+static void
+_renoir_dx11_memory_device(IRenoir* self, size_t& total, size_t& available)
+{
+	IDXGIDevice* dxgi_device = nullptr;
+	if (FAILED(self->device->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgi_device)))
+		return;
+	mn_defer(dxgi_device->Release());
+
+	IDXGIAdapter* dxgi_adapter = nullptr;
+	if (FAILED(dxgi_device->GetAdapter(&dxgi_adapter)))
+		return;
+	mn_defer(dxgi_adapter->Release());
+
+	DXGI_ADAPTER_DESC dxgi_adapter_desc{};
+	if (SUCCEEDED(dxgi_adapter->GetDesc(&dxgi_adapter_desc)))
+		total = dxgi_adapter_desc.DedicatedVideoMemory;
+
+	IDXGIAdapter3* dxgi_adapter3 = nullptr;
+	if (FAILED(dxgi_adapter->QueryInterface(__uuidof(IDXGIAdapter3), (void**)&dxgi_adapter3)))
+		return;
+	mn_defer(dxgi_adapter3->Release());
+
+	DXGI_QUERY_VIDEO_MEMORY_INFO info{};
+	if (SUCCEEDED(dxgi_adapter3->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info)))
+		available = info.Budget > info.CurrentUsage ? info.Budget - info.CurrentUsage : 0;
+}
+
 static Renoir_Handle*
 _renoir_dx11_handle_new(IRenoir* self, RENOIR_HANDLE_KIND kind)
 {
-	auto handle = (Renoir_Handle*)mn::pool_get(self->handle_pool);
+	auto& table = self->handles[kind];
+	uint32_t index = 0;
+	// the queue is drained below its minimum depth only when the table is full
+	if (table.free_slots.count >= RENOIR_DX11_HANDLE_MIN_FREE_SLOTS || (table.free_slots.count > 0 && table.slots_count > RENOIR_DX11_HANDLE_INDEX_MASK))
+	{
+		index = mn::ring_front(table.free_slots);
+		mn::ring_pop_front(table.free_slots);
+	}
+	else
+	{
+		assert(table.slots_count <= RENOIR_DX11_HANDLE_INDEX_MASK && "renoir handle table is full");
+		index = table.slots_count++;
+		auto& chunk = table.chunks[index / RENOIR_DX11_HANDLE_CHUNK_SIZE];
+		if (chunk == nullptr)
+			chunk.store(mn::alloc_zerod<Renoir_DX11_Handle_Chunk>(), std::memory_order_release);
+	}
+
+	auto chunk = table.chunks[index / RENOIR_DX11_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_DX11_HANDLE_CHUNK_SIZE;
+	// generation 0 is never used so that no id is 0
+	if (chunk->generations[slot] == 0)
+		chunk->generations[slot] = 1;
+
+	auto handle = &chunk->handles[slot];
 	memset(handle, 0, sizeof(*handle));
 	handle->kind = kind;
 	handle->rc = 1;
+	// the id is published last so that a concurrent handle_get never sees a half initialized handle
+	handle->id.store((uint32_t(kind) << RENOIR_DX11_HANDLE_KIND_SHIFT) | (chunk->generations[slot] << RENOIR_DX11_HANDLE_INDEX_BITS) | index, std::memory_order_release);
+
+	++self->stats.live_handles[kind];
+	if (++self->stats.alive_handles > self->stats.handle_pool_high_water_mark)
+		self->stats.handle_pool_high_water_mark = self->stats.alive_handles;
 
-	#ifdef DEBUG
+	#if RENOIR_LEAK
 	if (_renoir_handle_kind_should_track(kind))
 	{
-		assert(mn::map_lookup(self->alive_handles, handle) == nullptr && "reuse of already alive renoir handle");
 		Renoir_Leak_Info info{};
-		#if RENOIR_LEAK
-			info.callstack_size = mn::callstack_capture(info.callstack, 20);
-		#endif
+		info.callstack_size = mn::callstack_capture(info.callstack, 20);
 		mn::map_insert(self->alive_handles, handle, info);
 	}
 	#endif
@@ -868,17 +1506,62 @@ _renoir_dx11_handle_new(IRenoir* self, RENOIR_HANDLE_KIND kind)
 	return handle;
 }
 
+// resolves a public id to its handle, it returns null for the null id and for stale ids of freed handles
+static Renoir_Handle*
+_renoir_dx11_handle_get(IRenoir* self, const void* handle)
+{
+	if (handle == nullptr)
+		return nullptr;
+
+	auto value = uintptr_t(handle);
+	auto id = uint32_t(value);
+	auto kind = id >> RENOIR_DX11_HANDLE_KIND_SHIFT;
+	auto index = id & RENOIR_DX11_HANDLE_INDEX_MASK;
+	Renoir_Handle* res = nullptr;
+	if (value == id && kind < RENOIR_HANDLE_KIND_COUNT)
+	{
+		if (auto chunk = self->handles[kind].chunks[index / RENOIR_DX11_HANDLE_CHUNK_SIZE].load(std::memory_order_acquire))
+			res = &chunk->handles[index % RENOIR_DX11_HANDLE_CHUNK_SIZE];
+	}
+
+	if (res == nullptr || res->id.load(std::memory_order_acquire) != id)
+	{
+		mn::log_error("dx11: invalid renoir handle {:#x}, it might have been freed already", value);
+		assert(false && "invalid renoir handle");
+		return nullptr;
+	}
+	return res;
+}
+
+inline static void*
+_renoir_dx11_handle_public(Renoir_Handle* h)
+{
+	if (h == nullptr)
+		return nullptr;
+	return (void*)uintptr_t(h->id);
+}
+
 static void
 _renoir_dx11_handle_free(IRenoir* self, Renoir_Handle* h)
 {
-	#ifdef DEBUG
+	auto index = h->id & RENOIR_DX11_HANDLE_INDEX_MASK;
+	auto& table = self->handles[h->kind];
+	auto chunk = table.chunks[index / RENOIR_DX11_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_DX11_HANDLE_CHUNK_SIZE;
+	assert(h->id != 0 && chunk != nullptr && &chunk->handles[slot] == h && "free was called with an invalid renoir handle");
+
+	_renoir_dx11_memory_handle(self, h, false);
+	#if RENOIR_LEAK
 	if (_renoir_handle_kind_should_track(h->kind))
-	{
-		auto removed = mn::map_remove(self->alive_handles, h);
-		assert(removed && "free was called with an invalid renoir handle");
-	}
+		mn::map_remove(self->alive_handles, h);
 	#endif
-	mn::pool_put(self->handle_pool, h);
+
+	--self->stats.live_handles[h->kind];
+	--self->stats.alive_handles;
+
+	chunk->generations[slot] = (chunk->generations[slot] + 1) & RENOIR_DX11_HANDLE_GENERATION_MASK;
+	h->id.store(0, std::memory_order_release);
+	mn::ring_push_back(table.free_slots, index);
 }
 
 static Renoir_Handle*
@@ -901,6 +1584,8 @@ _renoir_dx11_command_new(T* self, RENOIR_COMMAND_KIND kind)
 	auto command = (Renoir_Command*)mn::pool_get(self->command_pool);
 	memset(command, 0, sizeof(*command));
 	command->kind = kind;
+	if (++self->stats.alive_commands > self->stats.command_pool_high_water_mark)
+		self->stats.command_pool_high_water_mark = self->stats.alive_commands;
 	return command;
 }
 
@@ -954,6 +1639,11 @@ _renoir_dx11_command_free(T* self, Renoir_Command* command)
 		mn::free(mn::Block{(void*)command->buffer_write.bytes, command->buffer_write.bytes_size});
 		break;
 	}
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+	{
+		mn::free(mn::Block{(void*)command->uniform_write.bytes, command->uniform_write.bytes_size});
+		break;
+	}
 	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
 	{
 		mn::free(mn::Block{(void*)command->texture_write.desc.bytes, command->texture_write.desc.bytes_size});
@@ -989,6 +1679,7 @@ _renoir_dx11_command_free(T* self, Renoir_Command* command)
 	case RENOIR_COMMAND_KIND_BUFFER_READ:
 	case RENOIR_COMMAND_KIND_TEXTURE_READ:
 	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
 	case RENOIR_COMMAND_KIND_BUFFER_BIND:
 	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
 	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
@@ -1000,6 +1691,7 @@ _renoir_dx11_command_free(T* self, Renoir_Command* command)
 		// do nothing
 		break;
 	}
+	--self->stats.alive_commands;
 	mn::pool_put(self->command_pool, command);
 }
 
@@ -1180,10 +1872,170 @@ _renoir_dx11_input_layout_create(IRenoir* self, Renoir_Handle* h, const Renoir_D
 	assert(SUCCEEDED(res));
 }
 
+// returns false and logs an error the first time if constant buffer offsetting is not supported, should be called with
+// the mutex locked
+static bool
+_renoir_dx11_constant_buffer_offsetting_check(IRenoir* self)
+{
+	if (self->constant_buffer_offsetting && self->context1 != nullptr)
+		return true;
+
+	if (self->constant_buffer_offsetting_reported == false)
+	{
+		mn::log_error("dx11: ranged constant buffer binds and the uniform ring need d3d11.1 constant buffer offsetting, they are dropped");
+		self->constant_buffer_offsetting_reported = true;
+	}
+	return false;
+}
+
+// d3d11.1 binds constant buffer ranges in 16 bytes constants, the first constant should be a multiple of 16 (256 bytes)
+// and the constants count should be a multiple of 16 as well so the size is rounded up
+static void
+_renoir_dx11_constant_buffer_bind_range(IRenoir* self, Renoir_Handle* h, RENOIR_SHADER shader, int slot, size_t offset, size_t size)
+{
+	if (_renoir_dx11_constant_buffer_offsetting_check(self) == false)
+		return;
+
+	assert(offset % 256 == 0 && "dx11: constant buffer range offset should be a multiple of 256 bytes");
+	auto first_constant = UINT(offset / 16);
+	auto constants_count = UINT((size + 255) / 256 * 16);
+	switch(shader)
+	{
+	case RENOIR_SHADER_VERTEX:
+		self->context1->VSSetConstantBuffers1(slot, 1, &h->buffer.buffer, &first_constant, &constants_count);
+		break;
+	case RENOIR_SHADER_PIXEL:
+		self->context1->PSSetConstantBuffers1(slot, 1, &h->buffer.buffer, &first_constant, &constants_count);
+		break;
+	case RENOIR_SHADER_GEOMETRY:
+		self->context1->GSSetConstantBuffers1(slot, 1, &h->buffer.buffer, &first_constant, &constants_count);
+		break;
+	case RENOIR_SHADER_COMPUTE:
+		self->context1->CSSetConstantBuffers1(slot, 1, &h->buffer.buffer, &first_constant, &constants_count);
+		break;
+	default:
+		assert(false && "unreachable");
+		break;
+	}
+}
+
+// ranged compute buffer binds create views over the [offset, offset + size) elements range, the caller binds them
+// and releases them right away since the context keeps its bound views alive
+static ID3D11ShaderResourceView*
+_renoir_dx11_buffer_range_srv(IRenoir* self, Renoir_Handle* h, size_t offset, size_t size)
+{
+	auto stride = h->buffer.compute_stride;
+	assert(offset % stride == 0 && size % stride == 0 && "dx11: compute buffer range should be a multiple of the buffer stride");
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc{};
+	srv_desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+	srv_desc.Format = DXGI_FORMAT_UNKNOWN;
+	srv_desc.BufferEx.FirstElement = UINT(offset / stride);
+	srv_desc.BufferEx.NumElements = UINT(size / stride);
+	ID3D11ShaderResourceView* srv = nullptr;
+	auto res = self->device->CreateShaderResourceView(h->buffer.buffer, &srv_desc, &srv);
+	assert(SUCCEEDED(res));
+	return srv;
+}
+
+static ID3D11UnorderedAccessView*
+_renoir_dx11_buffer_range_uav(IRenoir* self, Renoir_Handle* h, size_t offset, size_t size)
+{
+	auto stride = h->buffer.compute_stride;
+	assert(offset % stride == 0 && size % stride == 0 && "dx11: compute buffer range should be a multiple of the buffer stride");
+
+	D3D11_UNORDERED_ACCESS_VIEW_DESC uav_desc{};
+	uav_desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+	uav_desc.Format = DXGI_FORMAT_UNKNOWN;
+	uav_desc.Buffer.FirstElement = UINT(offset / stride);
+	uav_desc.Buffer.NumElements = UINT(size / stride);
+	ID3D11UnorderedAccessView* uav = nullptr;
+	auto res = self->device->CreateUnorderedAccessView(h->buffer.buffer, &uav_desc, &uav);
+	assert(SUCCEEDED(res));
+	return uav;
+}
+
+static void
+_renoir_dx11_stats_command(IRenoir* self, Renoir_Command* command)
+{
+	auto& stats = self->stats.frame;
+	++self->stats.command_counts[command->kind];
+
+	switch (command->kind)
+	{
+	case RENOIR_COMMAND_KIND_DRAW:
+		++stats.draws;
+		break;
+	case RENOIR_COMMAND_KIND_DISPATCH:
+		++stats.dispatches;
+		break;
+	case RENOIR_COMMAND_KIND_PASS_BEGIN:
+	case RENOIR_COMMAND_KIND_USE_PIPELINE:
+	case RENOIR_COMMAND_KIND_USE_PROGRAM:
+	case RENOIR_COMMAND_KIND_USE_COMPUTE:
+	case RENOIR_COMMAND_KIND_SCISSOR:
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+		++stats.state_changes;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+		if (command->buffer_new.desc.data)
+			stats.bytes_uploaded += command->buffer_new.desc.data_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+		for (int i = 0; i < 6; ++i)
+			if (command->texture_new.desc.data[i])
+				stats.bytes_uploaded += command->texture_new.desc.data_size;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+		stats.bytes_uploaded += command->buffer_write.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+		stats.bytes_uploaded += command->uniform_write.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+		stats.bytes_uploaded += command->texture_write.desc.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+		stats.bytes_read += command->buffer_read.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+		stats.bytes_read += command->texture_read.desc.bytes_size;
+		break;
+	default:
+		// do nothing
+		break;
+	}
+}
+
+// snapshots the current frame counters, should be called with the mutex locked
+static void
+_renoir_dx11_stats_frame(IRenoir* self)
+{
+	auto& stats = self->stats;
+	for (int i = 0; i < RENOIR_COMMAND_KIND_COUNT; ++i)
+	{
+		if (stats.command_counts[i] == 0 || stats.frame.commands_count >= RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			continue;
+		stats.frame.commands[stats.frame.commands_count++] = Renoir_Stats_Counter{
+			_renoir_command_kind_name(RENOIR_COMMAND_KIND(i)),
+			stats.command_counts[i]
+		};
+	}
+
+	auto frame_index = stats.frame.frame_index;
+	stats.last_frame = stats.frame;
+	stats.frame = Renoir_Stats{};
+	stats.frame.frame_index = frame_index + 1;
+	::memset(stats.command_counts, 0, sizeof(stats.command_counts));
+}
 
 static void
 _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 {
+	_renoir_dx11_stats_command(self, command);
+
 	switch(command->kind)
 	{
 	case RENOIR_COMMAND_KIND_INIT:
@@ -1220,6 +2072,24 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			mn::log_info("D3D11 Renderer: {}", description);
 			mn::log_info("D3D11 Video Memory: {}Mb", dxgi_adapter_desc.DedicatedVideoMemory / 1024 / 1024);
 		}
+
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+		auto res = self->device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+		if (SUCCEEDED(res))
+			self->constant_buffer_offsetting = options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+
+		// constant buffers bigger than 64KB can't be created without constant buffer offsetting
+		if (self->constant_buffer_offsetting)
+		{
+			auto ring_buffer = self->uniform_ring.buffer;
+			D3D11_BUFFER_DESC buffer_desc{};
+			buffer_desc.ByteWidth = UINT(ring_buffer->buffer.size);
+			buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+			buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+			buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			res = self->device->CreateBuffer(&buffer_desc, nullptr, &ring_buffer->buffer.buffer);
+			assert(SUCCEEDED(res));
+		}
 		break;
 	}
 	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW:
@@ -1271,7 +2141,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 
 		for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 		{
-			auto color = (Renoir_Handle*)desc.color[i].texture.handle;
+			auto color = _renoir_dx11_handle_get(self, desc.color[i].texture.handle);
 			if (color == nullptr)
 				continue;
 			assert(color->texture.desc.render_target);
@@ -1337,7 +2207,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			}
 		}
 
-		auto depth = (Renoir_Handle*)desc.depth_stencil.texture.handle;
+		auto depth = _renoir_dx11_handle_get(self, desc.depth_stencil.texture.handle);
 		if (depth)
 		{
 			assert(depth->texture.desc.render_target);
@@ -1430,7 +2300,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			{
 				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 				{
-					auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
+					auto color = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
 					if (color == nullptr)
 						continue;
 
@@ -1442,7 +2312,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 					_renoir_dx11_command_free(self, command);
 				}
 
-				auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
+				auto depth = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
 				if (depth)
 				{
 					h->raster_pass.depth_stencil_view->Release();
@@ -1541,6 +2411,8 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->buffer_free.handle;
 		if (_renoir_dx11_handle_unref(h) == false)
 			break;
+		// the buffer address can be reused by the next buffer so we forget the cached input assembler state
+		self->input_state = Renoir_DX11_Input_State{};
 		h->buffer.buffer->Release();
 		if (h->buffer.buffer_staging) h->buffer.buffer_staging->Release();
 		if (h->buffer.srv) h->buffer.srv->Release();
@@ -1725,6 +2597,8 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 					texture_desc.BindFlags = D3D11_BIND_RENDER_TARGET;
 				else
 					texture_desc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+				if (desc.msaa_sampled)
+					texture_desc.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
 				texture_desc.MipLevels = 1;
 				texture_desc.Width = desc.size.width;
 				texture_desc.Height = desc.size.height;
@@ -1734,6 +2608,18 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 				texture_desc.SampleDesc.Count = dx_msaa;
 				res = self->device->CreateTexture2D(&texture_desc, nullptr, &h->texture.render_color_buffer);
 				assert(SUCCEEDED(res));
+
+				// shaders sample the multisampled texture directly so we replace the shader view with one on it
+				if (desc.msaa_sampled)
+				{
+					assert(_renoir_pixelformat_is_depth(desc.pixel_format) == false && "dx11 only supports msaa_sampled color textures");
+					h->texture.shader_view->Release();
+					D3D11_SHADER_RESOURCE_VIEW_DESC msaa_view_desc{};
+					msaa_view_desc.Format = dx_pixelformat;
+					msaa_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DMS;
+					res = self->device->CreateShaderResourceView(h->texture.render_color_buffer, &msaa_view_desc, &h->texture.shader_view);
+					assert(SUCCEEDED(res));
+				}
 			}
 
 			if (desc.usage == RENOIR_USAGE_DYNAMIC && desc.access != RENOIR_ACCESS_NONE)
@@ -1874,6 +2760,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		auto& desc = command->program_new.desc;
 
 		ID3D10Blob* error = nullptr;
+		h->program.reflect = _renoir_dx11_reflect_new();
 
 		auto res = D3DCompile(
 			desc.vertex.bytes,
@@ -1900,6 +2787,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			&h->program.vertex_shader
 		);
 		assert(SUCCEEDED(res));
+		_renoir_dx11_reflect_shader(h->program.reflect, h->program.vertex_shader_blob, false);
 
 		ID3D10Blob* pixel_shader_blob = nullptr;
 		res = D3DCompile(
@@ -1927,6 +2815,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			&h->program.pixel_shader
 		);
 		assert(SUCCEEDED(res));
+		_renoir_dx11_reflect_shader(h->program.reflect, pixel_shader_blob, false);
 		pixel_shader_blob->Release();
 
 		if (desc.geometry.bytes)
@@ -1957,6 +2846,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 				&h->program.geometry_shader
 			);
 			assert(SUCCEEDED(res));
+			_renoir_dx11_reflect_shader(h->program.reflect, geometry_shader_blob, false);
 			geometry_shader_blob->Release();
 		}
 		break;
@@ -1971,6 +2861,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		if (h->program.pixel_shader) h->program.pixel_shader->Release();
 		if (h->program.geometry_shader) h->program.geometry_shader->Release();
 		if (h->program.input_layout) h->program.input_layout->Release();
+		_renoir_dx11_reflect_free(h->program.reflect);
 		_renoir_dx11_handle_free(self, h);
 		break;
 	}
@@ -1980,6 +2871,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		auto& desc = command->compute_new.desc;
 
 		ID3D10Blob* error = nullptr;
+		h->compute.reflect = _renoir_dx11_reflect_new();
 
 		ID3D10Blob* compute_shader_blob = nullptr;
 		auto res = D3DCompile(
@@ -2007,6 +2899,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			&h->compute.compute_shader
 		);
 		assert(SUCCEEDED(res));
+		_renoir_dx11_reflect_shader(h->compute.reflect, compute_shader_blob, true);
 		compute_shader_blob->Release();
 		break;
 	}
@@ -2016,6 +2909,7 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		if (_renoir_dx11_handle_unref(h) == false)
 			break;
 		if (h->compute.compute_shader) h->compute.compute_shader->Release();
+		_renoir_dx11_reflect_free(h->compute.reflect);
 		_renoir_dx11_handle_free(self, h);
 		break;
 	}
@@ -2218,6 +3112,26 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 				scissor.top = 0;
 				scissor.bottom = viewport.Height;
 				self->context->RSSetScissorRects(1, &scissor);
+
+				// apply the load actions, dx11 has no way to express don't care on load so we treat it as load
+				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+				{
+					auto& attachment = h->raster_pass.offscreen.color[i];
+					if (attachment.texture.handle == nullptr || attachment.load != RENOIR_LOAD_CLEAR)
+						continue;
+					self->context->ClearRenderTargetView(h->raster_pass.render_target_view[i], &attachment.clear_color.r);
+				}
+
+				auto& depth_attachment = h->raster_pass.offscreen.depth_stencil;
+				if (depth_attachment.texture.handle && depth_attachment.load == RENOIR_LOAD_CLEAR)
+				{
+					self->context->ClearDepthStencilView(
+						h->raster_pass.depth_stencil_view,
+						D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL,
+						depth_attachment.clear_depth,
+						depth_attachment.clear_stencil
+					);
+				}
 			}
 		}
 		else if (self->current_pass->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
@@ -2239,12 +3153,14 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			// from renderbuffer to the texture
 			for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 			{
-				auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
+				auto color = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
 				if (color == nullptr)
 					continue;
 
-				// only resolve msaa textures
-				if (color->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
+				// only resolve msaa textures which asked for it, ResolveSubresource has no region so resolve_rect is ignored
+				if (color->texture.desc.msaa != RENOIR_MSAA_MODE_NONE &&
+					color->texture.desc.msaa_sampled == false &&
+					h->raster_pass.offscreen.color[i].store == RENOIR_STORE_RESOLVE)
 				{
 					auto dx_pixel_format = _renoir_pixelformat_to_dx(color->texture.desc.pixel_format);
 					self->context->ResolveSubresource(
@@ -2291,10 +3207,12 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			}
 
 			// resolve depth textures as well
-			auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
+			auto depth = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
 			if (depth)
 			{
-				if (depth->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
+				if (depth->texture.desc.msaa != RENOIR_MSAA_MODE_NONE &&
+					depth->texture.desc.msaa_sampled == false &&
+					h->raster_pass.offscreen.depth_stencil.store == RENOIR_STORE_RESOLVE)
 				{
 					auto dx_pixel_format = _renoir_pixelformat_to_dx(depth->texture.desc.pixel_format);
 					self->context->ResolveSubresource(
@@ -2511,6 +3429,27 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		);
 		break;
 	}
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+	{
+		auto& copy = command->buffer_copy;
+
+		D3D11_BOX src_box{};
+		src_box.left = copy.src_offset;
+		src_box.right = copy.src_offset + copy.size;
+		src_box.bottom = 1;
+		src_box.back = 1;
+		self->context->CopySubresourceRegion(
+			copy.dst->buffer.buffer,
+			0,
+			copy.dst_offset,
+			0,
+			0,
+			copy.src->buffer.buffer,
+			0,
+			&src_box
+		);
+		break;
+	}
 	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
 	{
 		auto h = command->texture_write.handle;
@@ -2730,8 +3669,17 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 	case RENOIR_COMMAND_KIND_BUFFER_BIND:
 	{
 		auto h = command->buffer_bind.handle;
+		auto offset = command->buffer_bind.offset;
+		auto size = command->buffer_bind.size;
+		// a range which covers the whole buffer is bound like the whole buffer
+		if (offset == 0 && size == h->buffer.size)
+			size = 0;
 
-		if (h->buffer.type == RENOIR_BUFFER_UNIFORM)
+		if (h->buffer.type == RENOIR_BUFFER_UNIFORM && size > 0)
+		{
+			_renoir_dx11_constant_buffer_bind_range(self, h, command->buffer_bind.shader, command->buffer_bind.slot, offset, size);
+		}
+		else if (h->buffer.type == RENOIR_BUFFER_UNIFORM)
 		{
 			switch(command->buffer_bind.shader)
 			{
@@ -2756,12 +3704,30 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		{
 			if (command->buffer_bind.gpu_access == RENOIR_ACCESS_READ)
 			{
-				self->context->CSSetShaderResources(command->buffer_bind.slot, 1, &h->buffer.srv);
+				if (size > 0)
+				{
+					auto srv = _renoir_dx11_buffer_range_srv(self, h, offset, size);
+					self->context->CSSetShaderResources(command->buffer_bind.slot, 1, &srv);
+					if (srv) srv->Release();
+				}
+				else
+				{
+					self->context->CSSetShaderResources(command->buffer_bind.slot, 1, &h->buffer.srv);
+				}
 			}
 			else if (command->buffer_bind.gpu_access == RENOIR_ACCESS_WRITE ||
 					 command->buffer_bind.gpu_access == RENOIR_ACCESS_READ_WRITE)
 			{
-				self->context->CSSetUnorderedAccessViews(command->buffer_bind.slot, 1, &h->buffer.uav, nullptr);
+				if (size > 0)
+				{
+					auto uav = _renoir_dx11_buffer_range_uav(self, h, offset, size);
+					self->context->CSSetUnorderedAccessViews(command->buffer_bind.slot, 1, &uav, nullptr);
+					if (uav) uav->Release();
+				}
+				else
+				{
+					self->context->CSSetUnorderedAccessViews(command->buffer_bind.slot, 1, &h->buffer.uav, nullptr);
+				}
 				Renoir_Compute_Write_Slot write_slot{};
 				write_slot.resource = h;
 				write_slot.slot = command->buffer_bind.slot;
@@ -2777,13 +3743,26 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
 	{
 		ID3D11UnorderedAccessView *uavs[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE] = {};
+		bool ranged[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE] = {};
 		for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
 		{
 			auto h = command->buffer_storage_bind.handle[i];
 			if (h == nullptr)
 				continue;
 
-			uavs[i] = h->buffer.uav;
+			auto offset = command->buffer_storage_bind.offsets[i];
+			auto size = command->buffer_storage_bind.sizes[i];
+			if (offset == 0 && size == 0)
+			{
+				uavs[i] = h->buffer.uav;
+			}
+			else
+			{
+				if (size == 0)
+					size = h->buffer.size - offset;
+				uavs[i] = _renoir_dx11_buffer_range_uav(self, h, offset, size);
+				ranged[i] = true;
+			}
 		}
 
 		self->context->OMSetRenderTargetsAndUnorderedAccessViews(
@@ -2796,6 +3775,10 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			0
 		);
 
+		for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
+			if (ranged[i] && uavs[i])
+				uavs[i]->Release();
+
 		break;
 	}
 	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
@@ -2881,10 +3864,16 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			if (vertex_buffer.stride == 0)
 				vertex_buffer.stride = _renoir_type_to_size(vertex_buffer.type);
 
-			auto hbuffer = (Renoir_Handle*)vertex_buffer.buffer.handle;
+			auto hbuffer = _renoir_dx11_handle_get(self, vertex_buffer.buffer.handle);
 			UINT offset = vertex_buffer.offset;
 			UINT stride = vertex_buffer.stride;
+
+			auto& binding = self->input_state.vertex_buffers[i];
+			if (binding.buffer == hbuffer->buffer.buffer && binding.stride == stride && binding.offset == offset)
+				continue;
+
 			self->context->IASetVertexBuffers(i, 1, &hbuffer->buffer.buffer, &stride, &offset);
+			binding = Renoir_DX11_Vertex_Binding{hbuffer->buffer.buffer, stride, offset};
 		}
 
 		if (desc.index_buffer.handle != nullptr)
@@ -2893,17 +3882,25 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 				desc.index_type = RENOIR_TYPE_UINT16;
 
 			auto dx_type = _renoir_type_to_dx(desc.index_type);
-			auto dx_type_size = _renoir_type_to_size(desc.index_type);
-			auto hbuffer = (Renoir_Handle*)desc.index_buffer.handle;
-			self->context->IASetIndexBuffer(hbuffer->buffer.buffer, dx_type, desc.base_element * dx_type_size);
+			auto hbuffer = _renoir_dx11_handle_get(self, desc.index_buffer.handle);
+
+			// the index buffer is bound at offset 0 and base_element is passed as the start index so that draws
+			// from the same index buffer don't need to rebind it
+			auto& state = self->input_state;
+			if (state.index_buffer != hbuffer->buffer.buffer || state.index_format != dx_type)
+			{
+				self->context->IASetIndexBuffer(hbuffer->buffer.buffer, dx_type, 0);
+				state.index_buffer = hbuffer->buffer.buffer;
+				state.index_format = dx_type;
+			}
 
 			if (desc.instances_count > 1)
 			{
 				self->context->DrawIndexedInstanced(
 					desc.elements_count,
 					desc.instances_count,
-					0,
-					0,
+					desc.base_element,
+					desc.base_vertex,
 					0
 				);
 			}
@@ -2911,8 +3908,8 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 			{
 				self->context->DrawIndexed(
 					desc.elements_count,
-					0,
-					0
+					desc.base_element,
+					desc.base_vertex
 				);
 			}
 		}
@@ -2954,6 +3951,23 @@ _renoir_dx11_command_execute(IRenoir* self, Renoir_Command* command)
 		self->context->End(h->timer.frequency);
 		break;
 	}
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+	{
+		auto& ring = self->uniform_ring;
+		if (_renoir_dx11_constant_buffer_offsetting_check(self) == false)
+			break;
+
+		auto map_type = ring.discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+		D3D11_MAPPED_SUBRESOURCE mapped_resource{};
+		auto res = self->context->Map(ring.buffer->buffer.buffer, 0, map_type, 0, &mapped_resource);
+		assert(SUCCEEDED(res));
+		if (FAILED(res))
+			break;
+		::memcpy((char*)mapped_resource.pData + command->uniform_write.offset, command->uniform_write.bytes, command->uniform_write.bytes_size);
+		self->context->Unmap(ring.buffer->buffer.buffer, 0);
+		ring.discard = false;
+		break;
+	}
 	default:
 		assert(false && "unreachable");
 		break;
@@ -3214,10 +4228,12 @@ _renoir_dx11_sampler_get(IRenoir* self, Renoir_Sampler_Desc desc)
 			self->sampler_cache[index + 1] = self->sampler_cache[index];
 		}
 		self->sampler_cache[0] = res;
+		++self->stats.frame.sampler_cache_hits;
 		return res;
 	}
 
 	// we didn't find a matching sampler, so create new one
+	++self->stats.frame.sampler_cache_misses;
 	size_t sampler_ix = first_empty_ix;
 
 	// we didn't find an empty slot for the new sampler so we'll have to make one for it
@@ -3230,6 +4246,7 @@ _renoir_dx11_sampler_get(IRenoir* self, Renoir_Sampler_Desc desc)
 			self->sampler_cache[index] = self->sampler_cache[index - 1];
 		}
 		_renoir_dx11_sampler_free(self, to_be_evicted);
+		++self->stats.frame.sampler_cache_evictions;
 		mn::log_warning("dx11: sampler evicted");
 		sampler_ix = 0;
 	}
@@ -3265,7 +4282,7 @@ _renoir_dx11_handle_leak_free(IRenoir* self, Renoir_Command* command)
 			{
 				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 				{
-					auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
+					auto color = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
 					if (color == nullptr)
 						continue;
 
@@ -3275,7 +4292,7 @@ _renoir_dx11_handle_leak_free(IRenoir* self, Renoir_Command* command)
 					_renoir_dx11_handle_leak_free(self, command);
 				}
 
-				auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
+				auto depth = _renoir_dx11_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
 				if (depth)
 				{
 					// issue command to free the depth texture
@@ -3317,6 +4334,7 @@ _renoir_dx11_handle_leak_free(IRenoir* self, Renoir_Command* command)
 		auto h = command->program_free.handle;
 		if (_renoir_dx11_handle_unref(h) == false)
 			break;
+		_renoir_dx11_reflect_free(h->program.reflect);
 		_renoir_dx11_handle_free(self, h);
 		break;
 	}
@@ -3325,6 +4343,7 @@ _renoir_dx11_handle_leak_free(IRenoir* self, Renoir_Command* command)
 		auto h = command->compute_free.handle;
 		if (_renoir_dx11_handle_unref(h) == false)
 			break;
+		_renoir_dx11_reflect_free(h->compute.reflect);
 		_renoir_dx11_handle_free(self, h);
 		break;
 	}
@@ -3358,6 +4377,33 @@ _renoir_dx11_init(Renoir* api, Renoir_Settings settings, void*)
 		settings.sampler_cache_size = RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE;
 	if (settings.pipeline_cache_size <= 0)
 		settings.pipeline_cache_size = RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE;
+	if (settings.uniform_ring_size == 0)
+		settings.uniform_ring_size = RENOIR_CONSTANT_DEFAULT_UNIFORM_RING_SIZE;
+	// command capture is not implemented in dx11, the path is dropped so nothing is written like with a nullptr path
+	if (settings.capture_path)
+	{
+		mn::log_error("dx11: command capture is not supported, capture_path setting is ignored");
+		settings.capture_path = nullptr;
+	}
+	// the profiler is not implemented in dx11, it's disabled so that profiler_frame_results returns false and the
+	// profiler scopes are no-ops like they are documented for the disabled setting
+	if (settings.profiler)
+	{
+		mn::log_error("dx11: profiler is not supported, profiler setting is disabled");
+		settings.profiler = false;
+	}
+	// the trace recorder is not implemented in dx11, it's disabled so that trace_export returns false
+	if (settings.trace)
+	{
+		mn::log_error("dx11: trace recorder is not supported, trace setting is disabled");
+		settings.trace = false;
+	}
+	// d3d11 device creation calls are free threaded, resources are created on the calling thread
+	settings.async_uploads = false;
+	if (settings.max_frames_in_flight <= 0)
+		settings.max_frames_in_flight = RENOIR_CONSTANT_DEFAULT_MAX_FRAMES_IN_FLIGHT;
+	if (settings.max_frames_in_flight > RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT)
+		settings.max_frames_in_flight = RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT;
 
 	IDXGIFactory* factory = nullptr;
 	IDXGIAdapter* adapter = nullptr;
@@ -3406,6 +4452,15 @@ _renoir_dx11_init(Renoir* api, Renoir_Settings settings, void*)
 		);
 		if (FAILED(res))
 			return false;
+
+		// dxgi does the frame pacing for us, present blocks once max_frames_in_flight frames are queued
+		IDXGIDevice1* dxgi_device = nullptr;
+		res = device->QueryInterface(__uuidof(IDXGIDevice1), (void**)&dxgi_device);
+		if (SUCCEEDED(res))
+		{
+			dxgi_device->SetMaximumFrameLatency(settings.max_frames_in_flight);
+			dxgi_device->Release();
+		}
 	}
 
 	auto self = mn::alloc_zerod<IRenoir>();
@@ -3414,15 +4469,34 @@ _renoir_dx11_init(Renoir* api, Renoir_Settings settings, void*)
 	self->adapter = adapter; adapter = nullptr;
 	self->device = device; device = nullptr;
 	self->context = context; context = nullptr;
-	self->handle_pool = mn::pool_new(sizeof(Renoir_Handle), 128);
+	if (self->context)
+		self->context->QueryInterface(__uuidof(ID3D11DeviceContext1), (void**)&self->context1);
+	for (auto& table: self->handles)
+		table.free_slots = mn::ring_new<uint32_t>();
 	self->command_pool = mn::pool_new(sizeof(Renoir_Command), 128);
 	self->settings = settings;
 	self->sampler_cache = mn::buf_new<Renoir_Handle*>();
 	self->pipeline_cache = mn::buf_new<Renoir_Handle*>();
+	self->transient_pool = _renoir_transient_pool_new();
+	self->memory.tags = mn::buf_new<Renoir_DX11_Memory_Tag>();
+	mn::buf_push(self->memory.tags, Renoir_DX11_Memory_Tag{mn::str_from_c("untagged"), Renoir_Memory_Counter{}});
+	#if RENOIR_LEAK
 	self->alive_handles = mn::map_new<Renoir_Handle*, Renoir_Leak_Info>();
+	#endif
 	mn::buf_resize_fill(self->sampler_cache, self->settings.sampler_cache_size, nullptr);
 	mn::buf_resize_fill(self->pipeline_cache, self->settings.pipeline_cache_size, nullptr);
 
+	// the ring's constant buffer is created by the init command once constant buffer offsetting is checked
+	self->uniform_ring.alignment = 256;
+	self->uniform_ring.discard = true;
+	self->uniform_ring.buffer = _renoir_dx11_handle_new(self, RENOIR_HANDLE_KIND_BUFFER);
+	self->uniform_ring.buffer->buffer.type = RENOIR_BUFFER_UNIFORM;
+	self->uniform_ring.buffer->buffer.usage = RENOIR_USAGE_DYNAMIC;
+	self->uniform_ring.buffer->buffer.access = RENOIR_ACCESS_WRITE;
+	self->uniform_ring.buffer->buffer.size = (settings.uniform_ring_size + 255) & ~size_t(255);
+	self->uniform_ring.buffer->buffer.memory_tag = _renoir_dx11_memory_tag(self, "uniform_ring");
+	_renoir_dx11_memory_handle(self, self->uniform_ring.buffer, true);
+
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_INIT);
 	_renoir_dx11_command_process(self, command);
 
@@ -3437,6 +4511,24 @@ _renoir_dx11_dispose(Renoir* api)
 	// process these commands for frees to give correct leak report
 	for (auto it = self->command_list_head; it != nullptr; it = it->next)
 		_renoir_dx11_handle_leak_free(self, it);
+	if (self->uniform_ring.buffer->buffer.buffer)
+		self->uniform_ring.buffer->buffer.buffer->Release();
+	_renoir_dx11_handle_free(self, self->uniform_ring.buffer);
+	for (const auto& transient: self->transient_pool.textures)
+		_renoir_dx11_handle_free(self, transient.handle);
+	size_t leak_count = 0;
+	for (int kind = 0; kind < RENOIR_HANDLE_KIND_COUNT; ++kind)
+	{
+		if (_renoir_handle_kind_should_track(RENOIR_HANDLE_KIND(kind)) == false)
+			continue;
+		auto& table = self->handles[kind];
+		for (uint32_t i = 0; i < table.slots_count; ++i)
+		{
+			auto chunk = table.chunks[i / RENOIR_DX11_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+			if (chunk->handles[i % RENOIR_DX11_HANDLE_CHUNK_SIZE].id != 0)
+				++leak_count;
+		}
+	}
 	#if RENOIR_LEAK
 		for(auto[handle, info]: self->alive_handles)
 		{
@@ -3444,11 +4536,11 @@ _renoir_dx11_dispose(Renoir* api)
 			mn::callstack_print_to(info.callstack, info.callstack_size, mn::file_stderr());
 			::fprintf(stderr, "\n\n");
 		}
-		if (self->alive_handles.count > 0)
-			::fprintf(stderr, "renoir leak count: %zu\n", self->alive_handles.count);
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu\n", leak_count);
 	#else
-		if (self->alive_handles.count > 0)
-			::fprintf(stderr, "renoir leak count: %zu, for callstack turn on 'RENOIR_LEAK' flag\n", self->alive_handles.count);
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu, for callstack turn on 'RENOIR_LEAK' flag\n", leak_count);
 	#endif
 	mn::mutex_free(self->mtx);
 	if (self->settings.external_context == false)
@@ -3457,12 +4549,25 @@ _renoir_dx11_dispose(Renoir* api)
 		self->adapter->Release();
 		self->device->Release();
 		self->context->Release();
+		if (self->context1) self->context1->Release();
+	}
+	for (auto& table: self->handles)
+	{
+		for (auto& chunk: table.chunks)
+			if (auto ptr = chunk.load(std::memory_order_relaxed))
+				mn::free(ptr);
+		mn::ring_free(table.free_slots);
 	}
-	mn::pool_free(self->handle_pool);
 	mn::pool_free(self->command_pool);
 	mn::buf_free(self->sampler_cache);
 	mn::buf_free(self->pipeline_cache);
+	_renoir_transient_pool_free(self->transient_pool);
+	for (auto& tag: self->memory.tags)
+		mn::str_free(tag.name);
+	mn::buf_free(self->memory.tags);
+	#if RENOIR_LEAK
 	mn::map_free(self->alive_handles);
+	#endif
 	mn::free(self);
 }
 
@@ -3478,13 +4583,96 @@ _renoir_dx11_texture_origin()
 	return RENOIR_TEXTURE_ORIGIN_TOP_LEFT;
 }
 
+static Renoir_Stats
+_renoir_dx11_stats(Renoir* api)
+{
+	auto self = api->ctx;
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	// mutex_hold_time_in_nanos and frame_wait_time_in_nanos are not measured in dx11, the driver paces the frames
+	auto res = self->stats.last_frame;
+	res.command_pool_high_water_mark = self->stats.command_pool_high_water_mark;
+	res.handle_pool_high_water_mark = self->stats.handle_pool_high_water_mark;
+	for (int i = 0; i < RENOIR_HANDLE_KIND_COUNT; ++i)
+	{
+		if (self->stats.live_handles[i] == 0 || res.live_handles_count >= RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			continue;
+		res.live_handles[res.live_handles_count++] = Renoir_Stats_Counter{
+			_renoir_handle_kind_name(RENOIR_HANDLE_KIND(i)),
+			self->stats.live_handles[i]
+		};
+	}
+	return res;
+}
+
+static Renoir_Memory_Stats
+_renoir_dx11_memory_stats(Renoir* api)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto& memory = self->memory;
+
+	// framebuffers don't exist in dx11, the passes keep views to the textures instead
+	Renoir_Memory_Stats res{};
+	res.total = memory.total;
+	res.total.name = "total";
+	for (int i = 0; i < RENOIR_MEMORY_COUNT; ++i)
+	{
+		res.kinds[i] = memory.kinds[i];
+		res.kinds[i].name = _renoir_memory_name(RENOIR_MEMORY(i));
+	}
+	for (const auto& tag: memory.tags)
+	{
+		if (res.tags_count == RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			break;
+		res.tags[res.tags_count] = tag.counter;
+		res.tags[res.tags_count].name = tag.name.ptr;
+		++res.tags_count;
+	}
+	_renoir_dx11_memory_device(self, res.device_total_bytes, res.device_available_bytes);
+	return res;
+}
+
 static void
 _renoir_dx11_handle_ref(Renoir* api, void* handle)
 {
-	auto h = (Renoir_Handle*)handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, handle);
+	if (h == nullptr)
+		return;
 	h->rc.fetch_add(1);
 }
 
+static bool
+_renoir_dx11_handle_ready(Renoir*, void*)
+{
+	return true;
+}
+
+// resets the per-frame uniform allocator, should be called with the mutex locked after the frame commands are processed
+static void
+_renoir_dx11_uniform_ring_frame(IRenoir* self)
+{
+	self->uniform_ring.offset = 0;
+	self->uniform_ring.discard = true;
+}
+
+// returns all the transient textures to the pool at the end of the frame, and frees the ones which have been
+// unused for a while, it should be called before the frame commands are processed
+static void
+_renoir_dx11_transient_frame(IRenoir* self)
+{
+	_renoir_transient_pool_frame(self->transient_pool, [self](Renoir_Handle* handle) {
+		auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+		command->texture_free.handle = handle;
+		_renoir_dx11_command_process(self, command);
+	});
+}
+
 static void
 _renoir_dx11_flush(Renoir* api, void* device, void* context)
 {
@@ -3495,11 +4683,16 @@ _renoir_dx11_flush(Renoir* api, void* device, void* context)
 
 	self->device = (ID3D11Device*)device;
 	self->context = (ID3D11DeviceContext*)context;
+	self->context->QueryInterface(__uuidof(ID3D11DeviceContext1), (void**)&self->context1);
 	mn_defer({
+		if (self->context1) self->context1->Release();
 		self->device = nullptr;
 		self->context = nullptr;
+		self->context1 = nullptr;
 	});
 
+	_renoir_dx11_transient_frame(self);
+
 	// process commands
 	for(auto it = self->command_list_head; it != nullptr; it = it->next)
 	{
@@ -3509,6 +4702,8 @@ _renoir_dx11_flush(Renoir* api, void* device, void* context)
 
 	self->command_list_head = nullptr;
 	self->command_list_tail = nullptr;
+	_renoir_dx11_uniform_ring_frame(self);
+	_renoir_dx11_stats_frame(self);
 }
 
 static Renoir_Swapchain
@@ -3527,15 +4722,17 @@ _renoir_dx11_swapchain_new(Renoir* api, int width, int height, void* window, voi
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_SWAPCHAIN_NEW);
 	command->swapchain_new.handle = h;
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Swapchain{h};
+	return Renoir_Swapchain{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_swapchain_free(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)swapchain.handle;
+	auto h = _renoir_dx11_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3549,8 +4746,10 @@ static void
 _renoir_dx11_swapchain_resize(Renoir* api, Renoir_Swapchain swapchain, int width, int height)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)swapchain.handle;
+	auto h = _renoir_dx11_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3566,12 +4765,16 @@ static void
 _renoir_dx11_swapchain_present(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)swapchain.handle;
+	auto h = _renoir_dx11_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
 
+	_renoir_dx11_transient_frame(self);
+
 	// process commands
 	for(auto it = self->command_list_head; it != nullptr; it = it->next)
 	{
@@ -3581,6 +4784,8 @@ _renoir_dx11_swapchain_present(Renoir* api, Renoir_Swapchain swapchain)
 
 	self->command_list_head = nullptr;
 	self->command_list_tail = nullptr;
+	_renoir_dx11_uniform_ring_frame(self);
+	_renoir_dx11_stats_frame(self);
 
 	if (self->settings.vsync == RENOIR_VSYNC_MODE_ON)
 		h->swapchain.swapchain->Present(1, 0);
@@ -3619,6 +4824,9 @@ _renoir_dx11_buffer_new(Renoir* api, Renoir_Buffer_Desc desc)
 	h->buffer.usage = desc.usage;
 	h->buffer.access = desc.access;
 	h->buffer.size = desc.data_size;
+	h->buffer.compute_stride = UINT(desc.compute_buffer_stride);
+	h->buffer.memory_tag = _renoir_dx11_memory_tag(self, desc.tag);
+	_renoir_dx11_memory_handle(self, h, true);
 
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_BUFFER_NEW);
 	command->buffer_new.handle = h;
@@ -3633,15 +4841,17 @@ _renoir_dx11_buffer_new(Renoir* api, Renoir_Buffer_Desc desc)
 		}
 	}
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Buffer{h};
+	return Renoir_Buffer{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_buffer_free(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)buffer.handle;
+	auto h = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3654,8 +4864,10 @@ static size_t
 _renoir_dx11_buffer_size(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)buffer.handle;
+	auto h = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_BUFFER);
+	if (h == nullptr)
+		return {};
 
 	return h->buffer.size;
 }
@@ -3695,6 +4907,10 @@ _renoir_dx11_texture_new(Renoir* api, Renoir_Texture_Desc desc)
 	h->texture.desc = desc;
 	::memset(h->texture.desc.data, 0, sizeof(h->texture.desc.data));
 	h->texture.desc.data_size = 0;
+	// the desc keeps the backend owned copy of the tag name
+	h->texture.memory_tag = _renoir_dx11_memory_tag(self, desc.tag);
+	h->texture.desc.tag = h->texture.memory_tag ? self->memory.tags[h->texture.memory_tag].name.ptr : nullptr;
+	_renoir_dx11_memory_handle(self, h, true);
 
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_NEW);
 	command->texture_new.handle = h;
@@ -3712,15 +4928,17 @@ _renoir_dx11_texture_new(Renoir* api, Renoir_Texture_Desc desc)
 		}
 	}
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Texture{h};
+	return Renoir_Texture{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_texture_free(Renoir* api, Renoir_Texture texture)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)texture.handle;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3732,8 +4950,11 @@ _renoir_dx11_texture_free(Renoir* api, Renoir_Texture texture)
 static void*
 _renoir_dx11_texture_native_handle(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return nullptr;
 	if (h->texture.texture1d)
 		return h->texture.texture1d;
 	else if (h->texture.texture2d)
@@ -3746,24 +4967,73 @@ _renoir_dx11_texture_native_handle(Renoir* api, Renoir_Texture texture)
 static Renoir_Size
 _renoir_dx11_texture_size(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
 	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_TEXTURE);
+	if (h == nullptr)
+		return {};
 	return h->texture.desc.size;
 }
 
 static Renoir_Texture_Desc
 _renoir_dx11_texture_desc(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_TEXTURE);
 	return h->texture.desc;
 }
 
+static Renoir_Texture
+_renoir_dx11_texture_transient(Renoir* api, Renoir_Texture_Desc desc)
+{
+	assert(desc.render_target && "transient textures should be render targets");
+	assert(desc.data[0] == nullptr && "transient textures can't have initial data");
+
+	desc = _renoir_transient_texture_desc_normalize(desc);
+
+	auto self = api->ctx;
+
+	{
+		mn::mutex_lock(self->mtx);
+		mn_defer(mn::mutex_unlock(self->mtx));
+
+		if (auto h = _renoir_transient_pool_acquire(self->transient_pool, desc))
+			return Renoir_Texture{_renoir_dx11_handle_public(h)};
+	}
+
+	auto texture = _renoir_dx11_texture_new(api, desc);
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_transient_pool_push(self->transient_pool, _renoir_dx11_handle_get(self, texture.handle), desc);
+	return texture;
+}
+
+static void
+_renoir_dx11_texture_transient_free(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+	bool pooled = _renoir_transient_pool_release(self->transient_pool, h);
+	assert(pooled && "texture is not a transient texture");
+	(void)pooled;
+}
+
 static Renoir_Program
 _renoir_dx11_program_new(Renoir* api, Renoir_Program_Desc desc)
 {
 	assert(desc.vertex.bytes != nullptr && desc.pixel.bytes != nullptr);
+	assert(desc.format == RENOIR_SHADER_FORMAT_SOURCE && "dx11 only supports HLSL source shaders");
 	if (desc.vertex.size == 0)
 		desc.vertex.size = ::strlen(desc.vertex.bytes);
 	if (desc.pixel.size == 0)
@@ -3797,15 +5067,17 @@ _renoir_dx11_program_new(Renoir* api, Renoir_Program_Desc desc)
 		command->program_new.owns_data = true;
 	}
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Program{h};
+	return Renoir_Program{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_program_free(Renoir* api, Renoir_Program program)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)program.handle;
+	auto h = _renoir_dx11_handle_get(self, program.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3819,6 +5091,7 @@ static Renoir_Compute
 _renoir_dx11_compute_new(Renoir* api, Renoir_Compute_Desc desc)
 {
 	assert(desc.compute.bytes != nullptr);
+	assert(desc.format == RENOIR_SHADER_FORMAT_SOURCE && "dx11 only supports HLSL source shaders");
 	if (desc.compute.size == 0)
 		desc.compute.size = ::strlen(desc.compute.bytes);
 
@@ -3839,15 +5112,17 @@ _renoir_dx11_compute_new(Renoir* api, Renoir_Compute_Desc desc)
 		command->compute_new.owns_data = true;
 	}
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Compute{h};
+	return Renoir_Compute{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_compute_free(Renoir* api, Renoir_Compute compute)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)compute.handle;
+	auto h = _renoir_dx11_handle_get(self, compute.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -3857,21 +5132,65 @@ _renoir_dx11_compute_free(Renoir* api, Renoir_Compute compute)
 	_renoir_dx11_command_process(self, command);
 }
 
+static bool
+_renoir_dx11_program_reflect(Renoir* api, Renoir_Program program, Renoir_Reflect* reflect)
+{
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, program.handle);
+	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_PROGRAM);
+	if (h == nullptr)
+		return false;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	// this means that program creation didn't execute yet
+	if (h->program.reflect == nullptr)
+		return false;
+
+	if (reflect) *reflect = _renoir_dx11_reflect_desc(h->program.reflect);
+	return true;
+}
+
+static bool
+_renoir_dx11_compute_reflect(Renoir* api, Renoir_Compute compute, Renoir_Reflect* reflect)
+{
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, compute.handle);
+	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_COMPUTE);
+	if (h == nullptr)
+		return false;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	// this means that compute creation didn't execute yet
+	if (h->compute.reflect == nullptr)
+		return false;
+
+	if (reflect) *reflect = _renoir_dx11_reflect_desc(h->compute.reflect);
+	return true;
+}
+
 static Renoir_Pass
 _renoir_dx11_pass_swapchain_new(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
+	auto hswapchain = _renoir_dx11_handle_get(self, swapchain.handle);
+	assert(hswapchain != nullptr);
+	if (hswapchain == nullptr)
+		return Renoir_Pass{};
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
 
 	auto h = _renoir_dx11_handle_new(self, RENOIR_HANDLE_KIND_RASTER_PASS);
-	h->raster_pass.swapchain = (Renoir_Handle*)swapchain.handle;
+	h->raster_pass.swapchain = hswapchain;
 
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW);
 	command->pass_swapchain_new.handle = h;
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_dx11_handle_public(h)};
 }
 
 static Renoir_Pass
@@ -3883,9 +5202,14 @@ _renoir_dx11_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 	int width = -1, height = -1;
 	for (int i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 	{
-		auto color = (Renoir_Handle*)desc.color[i].texture.handle;
+		auto color = _renoir_dx11_handle_get(self, desc.color[i].texture.handle);
 		if (color == nullptr)
+		{
+			// stale attachment
+			if (desc.color[i].texture.handle != nullptr)
+				return Renoir_Pass{};
 			continue;
+		}
 
 		// first time getting the width/height
 		if (width == -1 && height == -1)
@@ -3900,7 +5224,9 @@ _renoir_dx11_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 		}
 	}
 
-	auto depth = (Renoir_Handle*)desc.depth_stencil.texture.handle;
+	auto depth = _renoir_dx11_handle_get(self, desc.depth_stencil.texture.handle);
+	if (depth == nullptr && desc.depth_stencil.texture.handle != nullptr)
+		return Renoir_Pass{};
 	if (depth)
 	{
 		// first time getting the width/height
@@ -3928,7 +5254,7 @@ _renoir_dx11_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 	command->pass_offscreen_new.handle = h;
 	command->pass_offscreen_new.desc = desc;
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_dx11_handle_public(h)};
 }
 
 static Renoir_Pass
@@ -3943,7 +5269,7 @@ _renoir_dx11_pass_compute_new(Renoir* api)
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW);
 	command->pass_compute_new.handle = h;
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_dx11_handle_public(h)};
 }
 
 static void
@@ -3954,8 +5280,10 @@ _renoir_dx11_pass_free(Renoir* api, Renoir_Pass pass)
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
 
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_PASS_FREE);
 	command->pass_free.handle = h;
 	_renoir_dx11_command_process(self, command);
@@ -3965,8 +5293,11 @@ static Renoir_Size
 _renoir_dx11_pass_size(Renoir* api, Renoir_Pass pass)
 {
 	Renoir_Size res{};
-	auto h = (Renoir_Handle*)pass.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
 	// if this is an on screen/window
@@ -3987,8 +5318,11 @@ _renoir_dx11_pass_size(Renoir* api, Renoir_Pass pass)
 static Renoir_Pass_Offscreen_Desc
 _renoir_dx11_pass_offscreen_desc(Renoir* api, Renoir_Pass pass)
 {
-	auto h = (Renoir_Handle*)pass.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 	return h->raster_pass.offscreen;
 }
@@ -4006,15 +5340,17 @@ _renoir_dx11_timer_new(Renoir* api)
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_TIMER_NEW);
 	command->timer_new.handle = h;
 	_renoir_dx11_command_process(self, command);
-	return Renoir_Timer{h};
+	return Renoir_Timer{_renoir_dx11_handle_public(h)};
 }
 
 static void
 _renoir_dx11_timer_free(struct Renoir* api, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)timer.handle;
+	auto h = _renoir_dx11_handle_get(self, timer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	mn_defer(mn::mutex_unlock(self->mtx));
@@ -4028,8 +5364,10 @@ static bool
 _renoir_dx11_timer_elapsed(struct Renoir* api, Renoir_Timer timer, uint64_t* elapsed_time_in_nanos)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)timer.handle;
+	auto h = _renoir_dx11_handle_get(self, timer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return false;
 	assert(h->kind == RENOIR_HANDLE_KIND_TIMER);
 
 	if (h->timer.state == RENOIR_TIMER_STATE_READY)
@@ -4054,13 +5392,49 @@ _renoir_dx11_timer_elapsed(struct Renoir* api, Renoir_Timer timer, uint64_t* ela
 	return false;
 }
 
+// queries are not supported, query_new returns an empty handle so the other query functions only ever see empty
+// handles and ignore them
+static Renoir_Query
+_renoir_dx11_query_new(Renoir*, RENOIR_QUERY)
+{
+	mn::log_error("dx11: queries are not supported, query_new returns an empty query");
+	return Renoir_Query{};
+}
+
+static void
+_renoir_dx11_query_free(Renoir*, Renoir_Query)
+{
+}
+
+static bool
+_renoir_dx11_query_result(Renoir*, Renoir_Query, Renoir_Query_Result*)
+{
+	return false;
+}
+
+// the profiler setting is disabled at init
+static bool
+_renoir_dx11_profiler_frame_results(Renoir*, Renoir_Profiler_Frame*)
+{
+	return false;
+}
+
+// the trace setting is disabled at init
+static bool
+_renoir_dx11_trace_export(Renoir*, const char*)
+{
+	return false;
+}
+
 // Graphics Commands
 static void
 _renoir_dx11_pass_begin(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
 	{
 		h->raster_pass.command_list_head = nullptr;
@@ -4095,8 +5469,10 @@ static void
 _renoir_dx11_pass_end(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
 	{
@@ -4186,8 +5562,10 @@ static void
 _renoir_dx11_clear(Renoir* api, Renoir_Pass pass, Renoir_Clear_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
@@ -4206,8 +5584,10 @@ static void
 _renoir_dx11_use_pipeline(Renoir* api, Renoir_Pass pass, Renoir_Pipeline_Desc pipeline_desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 	_renoir_dx11_pipeline_desc_defaults(&pipeline_desc);
@@ -4225,16 +5605,22 @@ static void
 _renoir_dx11_use_program(Renoir* api, Renoir_Pass pass, Renoir_Program program)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
+	auto hprogram = _renoir_dx11_handle_get(self, program.handle);
+	if (hprogram == nullptr && program.handle != nullptr)
+		return;
+
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_USE_PROGRAM);
 	mn::mutex_unlock(self->mtx);
 
-	command->use_program.program = (Renoir_Handle*)program.handle;
+	command->use_program.program = hprogram;
 	_renoir_dx11_command_push(&h->raster_pass, command);
 }
 
@@ -4242,16 +5628,22 @@ static void
 _renoir_dx11_use_compute(Renoir* api, Renoir_Pass pass, Renoir_Compute compute)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 
+	auto hcompute = _renoir_dx11_handle_get(self, compute.handle);
+	if (hcompute == nullptr && compute.handle != nullptr)
+		return;
+
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_USE_COMPUTE);
 	mn::mutex_unlock(self->mtx);
 
-	command->use_compute.compute = (Renoir_Handle*)compute.handle;
+	command->use_compute.compute = hcompute;
 	_renoir_dx11_command_push(&h->compute_pass, command);
 }
 
@@ -4259,8 +5651,10 @@ static void
 _renoir_dx11_scissor(Renoir* api, Renoir_Pass pass, int x, int y, int width, int height)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
@@ -4279,10 +5673,14 @@ static void
 _renoir_dx11_buffer_zero(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 	assert(hbuffer->buffer.uav);
@@ -4315,10 +5713,14 @@ _renoir_dx11_buffer_write(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, s
 		return;
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
@@ -4355,10 +5757,15 @@ _renoir_dx11_texture_write(Renoir* api, Renoir_Pass pass, Renoir_Texture texture
 		return;
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htexture = (Renoir_Handle*)texture.handle;
+	auto htexture = _renoir_dx11_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
 	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
 
 	mn::mutex_lock(self->mtx);
@@ -4388,8 +5795,10 @@ static void
 _renoir_dx11_buffer_zero_global(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
@@ -4409,8 +5818,10 @@ _renoir_dx11_buffer_write_global(Renoir* api, Renoir_Buffer buffer, size_t offse
 		return;
 
 	auto self = api->ctx;
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
@@ -4426,6 +5837,35 @@ _renoir_dx11_buffer_write_global(Renoir* api, Renoir_Buffer buffer, size_t offse
 	_renoir_dx11_command_process(self, command);
 }
 
+static void
+_renoir_dx11_buffer_copy_global(Renoir* api, Renoir_Buffer dst, size_t dst_offset, Renoir_Buffer src, size_t src_offset, size_t size)
+{
+	// this means he's trying to copy nothing so no-op
+	if (size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto hdst = _renoir_dx11_handle_get(self, dst.handle);
+	auto hsrc = _renoir_dx11_handle_get(self, src.handle);
+	assert(hdst != nullptr && hsrc != nullptr);
+	if (hdst == nullptr || hsrc == nullptr)
+		return;
+
+	assert(hdst->buffer.usage != RENOIR_USAGE_STATIC);
+	assert(hdst != hsrc && "buffer copy source and destination should be different buffers");
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_BUFFER_COPY);
+	command->buffer_copy.dst = hdst;
+	command->buffer_copy.dst_offset = dst_offset;
+	command->buffer_copy.src = hsrc;
+	command->buffer_copy.src_offset = src_offset;
+	command->buffer_copy.size = size;
+	_renoir_dx11_command_process(self, command);
+}
+
 static void
 _renoir_dx11_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc)
 {
@@ -4435,7 +5875,10 @@ _renoir_dx11_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_Te
 
 	auto self = api->ctx;
 
-	auto htexture = (Renoir_Handle*)texture.handle;
+	auto htexture = _renoir_dx11_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
 	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
 
 	mn::mutex_lock(self->mtx);
@@ -4449,6 +5892,51 @@ _renoir_dx11_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_Te
 	_renoir_dx11_command_process(self, command);
 }
 
+static Renoir_Uniform
+_renoir_dx11_uniform_alloc(Renoir* api, Renoir_Pass pass, void* bytes, size_t bytes_size)
+{
+	assert(bytes_size > 0 && "uniform allocation size should be greater than 0");
+
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+
+	mn::mutex_lock(self->mtx);
+	auto& ring = self->uniform_ring;
+	auto offset = (ring.offset + ring.alignment - 1) & ~(ring.alignment - 1);
+	if (offset + bytes_size > ring.buffer->buffer.size)
+	{
+		mn::mutex_unlock(self->mtx);
+		mn::log_error("dx11: uniform ring is exhausted, consider increasing 'uniform_ring_size' setting");
+		return Renoir_Uniform{};
+	}
+	ring.offset = offset + bytes_size;
+	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_UNIFORM_WRITE);
+	mn::mutex_unlock(self->mtx);
+
+	command->uniform_write.offset = offset;
+	command->uniform_write.bytes = mn::alloc(bytes_size, alignof(char)).ptr;
+	command->uniform_write.bytes_size = bytes_size;
+	::memcpy(command->uniform_write.bytes, bytes, bytes_size);
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_dx11_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_dx11_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+
+	return Renoir_Uniform{Renoir_Buffer{_renoir_dx11_handle_public(ring.buffer)}, offset, bytes_size};
+}
+
 static void
 _renoir_dx11_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size)
 {
@@ -4456,8 +5944,11 @@ _renoir_dx11_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void*
 	if (bytes_size == 0)
 		return;
 
-	auto h = (Renoir_Handle*)buffer.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, buffer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	// this means that buffer creation didn't execute yet
 	if (h->buffer.buffer == nullptr)
 	{
@@ -4465,8 +5956,6 @@ _renoir_dx11_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void*
 		return;
 	}
 
-	auto self = api->ctx;
-
 	Renoir_Command command{};
 	command.kind = RENOIR_COMMAND_KIND_BUFFER_READ;
 	command.buffer_read.handle = h;
@@ -4486,8 +5975,11 @@ _renoir_dx11_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_Ed
 	if (desc.bytes_size == 0)
 		return;
 
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	// this means that texture creation didn't execute yet
 	if (h->texture.texture1d == nullptr && h->texture.texture2d == nullptr && h->texture.texture3d == nullptr)
 	{
@@ -4495,8 +5987,6 @@ _renoir_dx11_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_Ed
 		return;
 	}
 
-	auto self = api->ctx;
-
 	Renoir_Command command{};
 	command.kind = RENOIR_COMMAND_KIND_TEXTURE_READ;
 	command.texture_read.handle = h;
@@ -4508,32 +5998,48 @@ _renoir_dx11_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_Ed
 }
 
 static void
-_renoir_dx11_buffer_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot)
+_renoir_dx11_buffer_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot, size_t offset, size_t size)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
 	mn::mutex_unlock(self->mtx);
 
-	command->buffer_bind.handle = (Renoir_Handle*)buffer.handle;
+	command->buffer_bind.handle = hbuffer;
 	command->buffer_bind.shader = shader;
 	command->buffer_bind.slot = slot;
 	command->buffer_bind.gpu_access = RENOIR_ACCESS_NONE;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
 
 	_renoir_dx11_command_push(&h->raster_pass, command);
 }
 
+static void
+_renoir_dx11_buffer_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot)
+{
+	_renoir_dx11_buffer_bind_range(api, pass, buffer, shader, slot, 0, 0);
+}
+
 static void
 _renoir_dx11_buffer_storage_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer_Storage_Bind_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
@@ -4561,11 +6067,13 @@ _renoir_dx11_buffer_storage_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer_St
 
 	for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
 	{
-		auto h = (Renoir_Handle*)desc.buffers[i].handle;
+		auto h = _renoir_dx11_handle_get(self, desc.buffers[i].handle);
 		if (desc.buffers[i].handle)
 		{
 			assert(h->buffer.uav);
 			command->buffer_storage_bind.handle[i] = h;
+			command->buffer_storage_bind.offsets[i] = desc.offsets[i];
+			command->buffer_storage_bind.sizes[i] = desc.sizes[i];
 		}
 	}
 	command->buffer_storage_bind.start_slot = desc.start_slot;
@@ -4577,11 +6085,15 @@ static void
 _renoir_dx11_texture_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_dx11_handle_get(self, texture.handle);
 	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	auto hsampler = _renoir_dx11_sampler_get(self, htex->texture.desc.sampler);
@@ -4596,15 +6108,61 @@ _renoir_dx11_texture_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture,
 	_renoir_dx11_command_push(&h->raster_pass, command);
 }
 
+static void
+_renoir_dx11_uniform_bind(Renoir* api, Renoir_Pass pass, Renoir_Uniform uniform, RENOIR_SHADER shader, int slot)
+{
+	auto self = api->ctx;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	// this means the allocation has failed, which is already reported by uniform_alloc
+	if (uniform.buffer.handle == nullptr)
+		return;
+
+	auto hbuffer = _renoir_dx11_handle_get(self, uniform.buffer.handle);
+	if (hbuffer == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = shader;
+	command->buffer_bind.slot = slot;
+	command->buffer_bind.gpu_access = RENOIR_ACCESS_NONE;
+	command->buffer_bind.offset = uniform.offset;
+	command->buffer_bind.size = uniform.size;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_dx11_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_dx11_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
 static void
 _renoir_dx11_texture_sampler_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot, Renoir_Sampler_Desc sampler)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_dx11_handle_get(self, texture.handle);
 	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	auto hsampler = _renoir_dx11_sampler_get(self, sampler);
@@ -4620,11 +6178,13 @@ _renoir_dx11_texture_sampler_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture
 }
 
 static void
-_renoir_dx11_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access)
+_renoir_dx11_buffer_compute_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access, size_t offset, size_t size)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 	assert(
@@ -4632,24 +6192,38 @@ _renoir_dx11_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer bu
 		"gpu should read, write, or both, it has no meaning to bind a buffer that the GPU cannot read or write from"
 	);
 
+	auto hbuffer = _renoir_dx11_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
 	mn::mutex_unlock(self->mtx);
 
-	command->buffer_bind.handle = (Renoir_Handle*)buffer.handle;
+	command->buffer_bind.handle = hbuffer;
 	command->buffer_bind.shader = RENOIR_SHADER_COMPUTE;
 	command->buffer_bind.slot = slot;
 	command->buffer_bind.gpu_access = gpu_access;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
 
 	_renoir_dx11_command_push(&h->raster_pass, command);
 }
 
+static void
+_renoir_dx11_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access)
+{
+	_renoir_dx11_buffer_compute_bind_range(api, pass, buffer, slot, gpu_access, 0, 0);
+}
+
 static void
 _renoir_dx11_texture_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, int slot, int mip_level, RENOIR_ACCESS gpu_access)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 	assert(
@@ -4662,7 +6236,9 @@ _renoir_dx11_texture_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture
 		assert(mip_level == 0 && "read only textures are bound as samplers, so you can't change mip level");
 	}
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_dx11_handle_get(self, texture.handle);
+	if (htex == nullptr && texture.handle != nullptr)
+		return;
 
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
@@ -4681,11 +6257,20 @@ static void
 _renoir_dx11_draw(Renoir* api, Renoir_Pass pass, Renoir_Draw_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
+	// the buffers are resolved again when the draw executes, so draws which use stale buffers are dropped here
+	for (const auto& vertex: desc.vertex_buffers)
+		if (vertex.buffer.handle != nullptr && _renoir_dx11_handle_get(self, vertex.buffer.handle) == nullptr)
+			return;
+	if (desc.index_buffer.handle != nullptr && _renoir_dx11_handle_get(self, desc.index_buffer.handle) == nullptr)
+		return;
+
 	mn::mutex_lock(self->mtx);
 	auto command = _renoir_dx11_command_new(self, RENOIR_COMMAND_KIND_DRAW);
 	mn::mutex_unlock(self->mtx);
@@ -4701,8 +6286,10 @@ _renoir_dx11_dispatch(Renoir* api, Renoir_Pass pass, int x, int y, int z)
 	assert(x >= 0 && y >= 0 && z >= 0);
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 
@@ -4717,15 +6304,25 @@ _renoir_dx11_dispatch(Renoir* api, Renoir_Pass pass, int x, int y, int z)
 	_renoir_dx11_command_push(&h->compute_pass, command);
 }
 
+static void
+_renoir_dx11_memory_barrier(Renoir*, Renoir_Pass)
+{
+	// d3d11 tracks the hazards between the resource views itself, so there's nothing to do here
+}
+
 static void
 _renoir_dx11_timer_begin(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htimer = (Renoir_Handle*)timer.handle;
+	auto htimer = _renoir_dx11_handle_get(self, timer.handle);
 	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
 
 	if(htimer->timer.state != RENOIR_TIMER_STATE_NONE)
 		return;
@@ -4751,15 +6348,52 @@ _renoir_dx11_timer_begin(struct Renoir* api, Renoir_Pass pass, Renoir_Timer time
 	}
 }
 
+// queries only exist as empty handles (see query_new), so there's nothing to begin or end, and conditional rendering
+// renders unconditionally
+static void
+_renoir_dx11_query_begin(Renoir*, Renoir_Pass, Renoir_Query)
+{
+}
+
+static void
+_renoir_dx11_query_end(Renoir*, Renoir_Pass, Renoir_Query)
+{
+}
+
+static void
+_renoir_dx11_conditional_begin(Renoir*, Renoir_Pass, Renoir_Query, bool)
+{
+}
+
+static void
+_renoir_dx11_conditional_end(Renoir*, Renoir_Pass)
+{
+}
+
+// the profiler setting is disabled at init so the scopes are no-ops
+static void
+_renoir_dx11_profiler_scope_begin(Renoir*, Renoir_Pass, const char*)
+{
+}
+
+static void
+_renoir_dx11_profiler_scope_end(Renoir*, Renoir_Pass)
+{
+}
+
 static void
 _renoir_dx11_timer_end(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_dx11_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htimer = (Renoir_Handle*)timer.handle;
+	auto htimer = _renoir_dx11_handle_get(self, timer.handle);
 	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
 	if (htimer->timer.state != RENOIR_TIMER_STATE_BEGIN)
 		return;
 
@@ -4793,8 +6427,11 @@ _renoir_load_api(Renoir* api)
 
 	api->name = _renoir_dx11_name;
 	api->texture_origin = _renoir_dx11_texture_origin;
+	api->stats = _renoir_dx11_stats;
+	api->memory_stats = _renoir_dx11_memory_stats;
 
 	api->handle_ref = _renoir_dx11_handle_ref;
+	api->handle_ready = _renoir_dx11_handle_ready;
 	api->flush = _renoir_dx11_flush;
 
 	api->swapchain_new = _renoir_dx11_swapchain_new;
@@ -4811,12 +6448,16 @@ _renoir_load_api(Renoir* api)
 	api->texture_native_handle = _renoir_dx11_texture_native_handle;
 	api->texture_size = _renoir_dx11_texture_size;
 	api->texture_desc = _renoir_dx11_texture_desc;
+	api->texture_transient = _renoir_dx11_texture_transient;
+	api->texture_transient_free = _renoir_dx11_texture_transient_free;
 
 	api->program_new = _renoir_dx11_program_new;
 	api->program_free = _renoir_dx11_program_free;
 
 	api->compute_new = _renoir_dx11_compute_new;
 	api->compute_free = _renoir_dx11_compute_free;
+	api->program_reflect = _renoir_dx11_program_reflect;
+	api->compute_reflect = _renoir_dx11_compute_reflect;
 
 	api->pass_swapchain_new = _renoir_dx11_pass_swapchain_new;
 	api->pass_offscreen_new = _renoir_dx11_pass_offscreen_new;
@@ -4829,6 +6470,13 @@ _renoir_load_api(Renoir* api)
 	api->timer_free = _renoir_dx11_timer_free;
 	api->timer_elapsed = _renoir_dx11_timer_elapsed;
 
+	api->query_new = _renoir_dx11_query_new;
+	api->query_free = _renoir_dx11_query_free;
+	api->query_result = _renoir_dx11_query_result;
+
+	api->profiler_frame_results = _renoir_dx11_profiler_frame_results;
+	api->trace_export = _renoir_dx11_trace_export;
+
 	api->pass_begin = _renoir_dx11_pass_begin;
 	api->pass_end = _renoir_dx11_pass_end;
 	api->clear = _renoir_dx11_clear;
@@ -4841,19 +6489,31 @@ _renoir_load_api(Renoir* api)
 	api->texture_write = _renoir_dx11_texture_write;
 	api->buffer_zero_global = _renoir_dx11_buffer_zero_global;
 	api->buffer_write_global = _renoir_dx11_buffer_write_global;
+	api->buffer_copy_global = _renoir_dx11_buffer_copy_global;
 	api->texture_write_global = _renoir_dx11_texture_write_global;
+	api->uniform_alloc = _renoir_dx11_uniform_alloc;
 	api->buffer_read = _renoir_dx11_buffer_read;
 	api->texture_read = _renoir_dx11_texture_read;
 	api->buffer_bind = _renoir_dx11_buffer_bind;
+	api->buffer_bind_range = _renoir_dx11_buffer_bind_range;
 	api->buffer_storage_bind = _renoir_dx11_buffer_storage_bind;
 	api->texture_bind = _renoir_dx11_texture_bind;
+	api->uniform_bind = _renoir_dx11_uniform_bind;
 	api->texture_sampler_bind = _renoir_dx11_texture_sampler_bind;
 	api->texture_compute_bind = _renoir_dx11_texture_compute_bind;
 	api->buffer_compute_bind = _renoir_dx11_buffer_compute_bind;
+	api->buffer_compute_bind_range = _renoir_dx11_buffer_compute_bind_range;
 	api->draw = _renoir_dx11_draw;
 	api->dispatch = _renoir_dx11_dispatch;
+	api->memory_barrier = _renoir_dx11_memory_barrier;
 	api->timer_begin = _renoir_dx11_timer_begin;
 	api->timer_end = _renoir_dx11_timer_end;
+	api->query_begin = _renoir_dx11_query_begin;
+	api->query_end = _renoir_dx11_query_end;
+	api->conditional_begin = _renoir_dx11_conditional_begin;
+	api->conditional_end = _renoir_dx11_conditional_end;
+	api->profiler_scope_begin = _renoir_dx11_profiler_scope_begin;
+	api->profiler_scope_end = _renoir_dx11_profiler_scope_end;
 }
 
 Renoir*
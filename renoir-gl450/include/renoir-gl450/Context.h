@@ -9,6 +9,11 @@ struct Renoir_Settings;
 Renoir_GL450_Context*
 renoir_gl450_context_new(Renoir_Settings* settings, void* display);
 
+// creates a context which shares objects with the given context, it has no default framebuffer so it's only
+// useful to create and upload resources from another thread, it should be freed using renoir_gl450_context_free
+Renoir_GL450_Context*
+renoir_gl450_context_shared_new(Renoir_GL450_Context* self);
+
 void
 renoir_gl450_context_free(Renoir_GL450_Context* self);
 
@@ -8,6 +8,8 @@
 
 struct Renoir_Command;
 
+struct Renoir_GL450_Reflect;
+
 enum RENOIR_TIMER_STATE
 {
 	// timer has not added begin
@@ -35,12 +37,25 @@ enum RENOIR_HANDLE_KIND
 	RENOIR_HANDLE_KIND_COMPUTE,
 	RENOIR_HANDLE_KIND_PIPELINE,
 	RENOIR_HANDLE_KIND_TIMER,
+	RENOIR_HANDLE_KIND_QUERY,
+	RENOIR_HANDLE_KIND_COUNT,
 };
 
+// pipeline statistics query uses a gl query object for each counter
+constexpr int RENOIR_GL450_QUERY_STATISTICS_COUNT = 8;
+// number of begin/end pairs a query can have in flight before its results are read back, the next begin is
+// dropped once all of them are in use
+constexpr int RENOIR_GL450_QUERY_RING = 4;
+
 struct Renoir_Handle
 {
 	RENOIR_HANDLE_KIND kind;
+	// public id of the handle (see Renoir_GL450_Handle_Table), 0 once the handle is freed, it's atomic because
+	// ids are resolved without locking
+	std::atomic<uint32_t> id;
 	std::atomic<int> rc;
+	// true while the handle is being created on the upload thread (see async_uploads setting)
+	std::atomic<bool> upload_pending;
 	union
 	{
 		struct
@@ -60,6 +75,8 @@ struct Renoir_Handle
 			Renoir_Handle* swapchain;
 			// used when rendering is done off screen
 			GLuint fb;
+			// holds the resolve textures of the attachments with RENOIR_STORE_RESOLVE, 0 if there are none
+			GLuint resolve_fb;
 			int width, height;
 			Renoir_Pass_Offscreen_Desc offscreen;
 		} raster_pass;
@@ -77,6 +94,8 @@ struct Renoir_Handle
 			RENOIR_USAGE usage;
 			RENOIR_ACCESS access;
 			size_t size;
+			// index of the memory stats tag
+			int memory_tag;
 		} buffer;
 
 		struct
@@ -84,6 +103,8 @@ struct Renoir_Handle
 			GLuint id;
 			GLuint render_buffer[6];
 			Renoir_Texture_Desc desc;
+			// index of the memory stats tag
+			int memory_tag;
 		} texture;
 
 		struct
@@ -95,11 +116,13 @@ struct Renoir_Handle
 		struct
 		{
 			GLuint id;
+			Renoir_GL450_Reflect* reflect;
 		} program;
 
 		struct
 		{
 			GLuint id;
+			Renoir_GL450_Reflect* reflect;
 		} compute;
 
 		struct
@@ -113,5 +136,22 @@ struct Renoir_Handle
 			uint64_t elapsed_time_in_nanos;
 			RENOIR_TIMER_STATE state;
 		} timer;
+
+		struct
+		{
+			RENOIR_QUERY kind;
+			// every begin/end pair uses the next slot of the ring, occlusion queries only use the first id of a slot
+			GLuint ids[RENOIR_GL450_QUERY_RING][RENOIR_GL450_QUERY_STATISTICS_COUNT];
+			// slots follow the same states as timers
+			RENOIR_TIMER_STATE states[RENOIR_GL450_QUERY_RING];
+			// oldest slot whose result is not read yet, results are returned in the order they were issued
+			int head;
+			// number of slots in use starting at head
+			int count;
+			// last slot which has ended, it's used in conditional rendering
+			int last;
+			// result of the head slot once it's ready
+			Renoir_Query_Result result;
+		} query;
 	};
 };
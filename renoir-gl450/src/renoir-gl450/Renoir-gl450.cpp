@@ -1,6 +1,8 @@
 #include "renoir-gl450/Renoir-gl450.h"
 #include "renoir-gl450/Context.h"
 #include "renoir-gl450/Handle.h"
+#include "renoir/Capture.h"
+#include "renoir-backend/Transient.h"
 
 #include <mn/Memory.h>
 #include <mn/Thread.h>
@@ -10,6 +12,9 @@
 #include <mn/OS.h>
 #include <mn/Log.h>
 #include <mn/Map.h>
+#include <mn/Buf.h>
+#include <mn/Ring.h>
+#include <mn/Str.h>
 #include <mn/Debug.h>
 
 #include <GL/glew.h>
@@ -17,6 +22,9 @@
 #include <math.h>
 #include <stdio.h>
 
+#include <atomic>
+#include <chrono>
+
 inline static bool
 _renoir_gl450_check()
 {
@@ -224,6 +232,43 @@ _renoir_blend_eq_to_gl(RENOIR_BLEND_EQ eq)
 	return res;
 }
 
+inline static GLenum
+_renoir_query_to_gl(RENOIR_QUERY kind)
+{
+	GLenum res = 0;
+	switch (kind)
+	{
+	case RENOIR_QUERY_SAMPLES_PASSED:
+		res = GL_SAMPLES_PASSED;
+		break;
+	case RENOIR_QUERY_ANY_SAMPLES_PASSED:
+		res = GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+		break;
+	default:
+		assert(false && "unreachable");
+		break;
+	}
+	return res;
+}
+
+// the order of these targets is the same as the order of the counters in Renoir_Query_Result
+static const GLenum RENOIR_GL450_QUERY_STATISTICS_TARGETS[RENOIR_GL450_QUERY_STATISTICS_COUNT] = {
+	GL_VERTICES_SUBMITTED,
+	GL_PRIMITIVES_SUBMITTED,
+	GL_VERTEX_SHADER_INVOCATIONS,
+	GL_GEOMETRY_SHADER_INVOCATIONS,
+	GL_FRAGMENT_SHADER_INVOCATIONS,
+	GL_COMPUTE_SHADER_INVOCATIONS,
+	GL_CLIPPING_INPUT_PRIMITIVES,
+	GL_CLIPPING_OUTPUT_PRIMITIVES,
+};
+
+inline static int
+_renoir_gl450_query_ids_count(RENOIR_QUERY kind)
+{
+	return kind == RENOIR_QUERY_PIPELINE_STATISTICS ? RENOIR_GL450_QUERY_STATISTICS_COUNT : 1;
+}
+
 inline static GLenum
 _renoir_buffer_type_to_gl(RENOIR_BUFFER type)
 {
@@ -449,6 +494,40 @@ _renoir_pixelformat_to_depth_attachment(RENOIR_PIXELFORMAT format)
 	return res;
 }
 
+inline static size_t
+_renoir_pixelformat_to_size(RENOIR_PIXELFORMAT format)
+{
+	size_t res = 0;
+	switch (format)
+	{
+	case RENOIR_PIXELFORMAT_R8:
+		res = 1;
+		break;
+	case RENOIR_PIXELFORMAT_R16I:
+	case RENOIR_PIXELFORMAT_R16UI:
+	case RENOIR_PIXELFORMAT_R16F:
+		res = 2;
+		break;
+	case RENOIR_PIXELFORMAT_RGBA8:
+	case RENOIR_PIXELFORMAT_R32F:
+	case RENOIR_PIXELFORMAT_D24S8:
+	case RENOIR_PIXELFORMAT_D32:
+		res = 4;
+		break;
+	case RENOIR_PIXELFORMAT_R16G16B16A16F:
+	case RENOIR_PIXELFORMAT_R32G32F:
+		res = 8;
+		break;
+	case RENOIR_PIXELFORMAT_R32G32B32A32F:
+		res = 16;
+		break;
+	default:
+		assert(false && "unreachable");
+		break;
+	}
+	return res;
+}
+
 inline static GLenum
 _renoir_type_to_gl(RENOIR_TYPE type)
 {
@@ -739,10 +818,25 @@ _renoir_handle_kind_name(RENOIR_HANDLE_KIND kind)
 	case RENOIR_HANDLE_KIND_PROGRAM: return "program";
 	case RENOIR_HANDLE_KIND_COMPUTE: return "compute";
 	case RENOIR_HANDLE_KIND_PIPELINE: return "pipeline";
+	case RENOIR_HANDLE_KIND_TIMER: return "timer";
+	case RENOIR_HANDLE_KIND_QUERY: return "query";
 	default: assert(false && "invalid handle kind"); return "<INVALID>";
 	}
 }
 
+inline static const char*
+_renoir_memory_name(RENOIR_MEMORY kind)
+{
+	switch(kind)
+	{
+	case RENOIR_MEMORY_BUFFER: return "buffer";
+	case RENOIR_MEMORY_TEXTURE: return "texture";
+	case RENOIR_MEMORY_RENDERBUFFER: return "renderbuffer";
+	case RENOIR_MEMORY_FRAMEBUFFER: return "framebuffer";
+	default: assert(false && "invalid memory kind"); return "<INVALID>";
+	}
+}
+
 inline static bool
 _renoir_handle_kind_should_track(RENOIR_HANDLE_KIND kind)
 {
@@ -756,7 +850,8 @@ _renoir_handle_kind_should_track(RENOIR_HANDLE_KIND kind)
 		// we ignore the samplers because they are cached not user created
 		// kind == RENOIR_HANDLE_KIND_SAMPLER ||
 		kind == RENOIR_HANDLE_KIND_PROGRAM ||
-		kind == RENOIR_HANDLE_KIND_COMPUTE
+		kind == RENOIR_HANDLE_KIND_COMPUTE ||
+		kind == RENOIR_HANDLE_KIND_QUERY
 		// we ignore the pipeline because they are cached not user created
 		// kind == RENOIR_HANDLE_KIND_PIPELINE
 	);
@@ -831,6 +926,9 @@ enum RENOIR_COMMAND_KIND
 	RENOIR_COMMAND_KIND_TIMER_NEW,
 	RENOIR_COMMAND_KIND_TIMER_FREE,
 	RENOIR_COMMAND_KIND_TIMER_ELAPSED,
+	RENOIR_COMMAND_KIND_QUERY_NEW,
+	RENOIR_COMMAND_KIND_QUERY_FREE,
+	RENOIR_COMMAND_KIND_QUERY_RESULT,
 	RENOIR_COMMAND_KIND_PASS_BEGIN,
 	RENOIR_COMMAND_KIND_PASS_END,
 	RENOIR_COMMAND_KIND_PASS_CLEAR,
@@ -840,6 +938,7 @@ enum RENOIR_COMMAND_KIND
 	RENOIR_COMMAND_KIND_SCISSOR,
 	RENOIR_COMMAND_KIND_BUFFER_CLEAR,
 	RENOIR_COMMAND_KIND_BUFFER_WRITE,
+	RENOIR_COMMAND_KIND_BUFFER_COPY,
 	RENOIR_COMMAND_KIND_TEXTURE_WRITE,
 	RENOIR_COMMAND_KIND_BUFFER_READ,
 	RENOIR_COMMAND_KIND_TEXTURE_READ,
@@ -848,10 +947,85 @@ enum RENOIR_COMMAND_KIND
 	RENOIR_COMMAND_KIND_TEXTURE_BIND,
 	RENOIR_COMMAND_KIND_DRAW,
 	RENOIR_COMMAND_KIND_DISPATCH,
+	RENOIR_COMMAND_KIND_MEMORY_BARRIER,
 	RENOIR_COMMAND_KIND_TIMER_BEGIN,
 	RENOIR_COMMAND_KIND_TIMER_END,
+	RENOIR_COMMAND_KIND_QUERY_BEGIN,
+	RENOIR_COMMAND_KIND_QUERY_END,
+	RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN,
+	RENOIR_COMMAND_KIND_CONDITIONAL_END,
+	RENOIR_COMMAND_KIND_UNIFORM_WRITE,
+	RENOIR_COMMAND_KIND_FRAME_FENCE,
+	RENOIR_COMMAND_KIND_PROFILER_SCOPE_BEGIN,
+	RENOIR_COMMAND_KIND_PROFILER_SCOPE_END,
+	RENOIR_COMMAND_KIND_PROFILER_FRAME,
+	RENOIR_COMMAND_KIND_COUNT,
 };
 
+inline static const char*
+_renoir_command_kind_name(RENOIR_COMMAND_KIND kind)
+{
+	switch(kind)
+	{
+	case RENOIR_COMMAND_KIND_NONE: return "none";
+	case RENOIR_COMMAND_KIND_INIT: return "init";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW: return "swapchain_new";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE: return "swapchain_free";
+	case RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW: return "pass_swapchain_new";
+	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW: return "pass_offscreen_new";
+	case RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW: return "pass_compute_new";
+	case RENOIR_COMMAND_KIND_PASS_FREE: return "pass_free";
+	case RENOIR_COMMAND_KIND_BUFFER_NEW: return "buffer_new";
+	case RENOIR_COMMAND_KIND_BUFFER_FREE: return "buffer_free";
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW: return "texture_new";
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE: return "texture_free";
+	case RENOIR_COMMAND_KIND_SAMPLER_NEW: return "sampler_new";
+	case RENOIR_COMMAND_KIND_SAMPLER_FREE: return "sampler_free";
+	case RENOIR_COMMAND_KIND_PROGRAM_NEW: return "program_new";
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE: return "program_free";
+	case RENOIR_COMMAND_KIND_COMPUTE_NEW: return "compute_new";
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE: return "compute_free";
+	case RENOIR_COMMAND_KIND_TIMER_NEW: return "timer_new";
+	case RENOIR_COMMAND_KIND_TIMER_FREE: return "timer_free";
+	case RENOIR_COMMAND_KIND_TIMER_ELAPSED: return "timer_elapsed";
+	case RENOIR_COMMAND_KIND_QUERY_NEW: return "query_new";
+	case RENOIR_COMMAND_KIND_QUERY_FREE: return "query_free";
+	case RENOIR_COMMAND_KIND_QUERY_RESULT: return "query_result";
+	case RENOIR_COMMAND_KIND_PASS_BEGIN: return "pass_begin";
+	case RENOIR_COMMAND_KIND_PASS_END: return "pass_end";
+	case RENOIR_COMMAND_KIND_PASS_CLEAR: return "pass_clear";
+	case RENOIR_COMMAND_KIND_USE_PIPELINE: return "use_pipeline";
+	case RENOIR_COMMAND_KIND_USE_PROGRAM: return "use_program";
+	case RENOIR_COMMAND_KIND_USE_COMPUTE: return "use_compute";
+	case RENOIR_COMMAND_KIND_SCISSOR: return "scissor";
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR: return "buffer_clear";
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE: return "buffer_write";
+	case RENOIR_COMMAND_KIND_BUFFER_COPY: return "buffer_copy";
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE: return "texture_write";
+	case RENOIR_COMMAND_KIND_BUFFER_READ: return "buffer_read";
+	case RENOIR_COMMAND_KIND_TEXTURE_READ: return "texture_read";
+	case RENOIR_COMMAND_KIND_BUFFER_BIND: return "buffer_bind";
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND: return "buffer_storage_bind";
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND: return "texture_bind";
+	case RENOIR_COMMAND_KIND_DRAW: return "draw";
+	case RENOIR_COMMAND_KIND_DISPATCH: return "dispatch";
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER: return "memory_barrier";
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN: return "timer_begin";
+	case RENOIR_COMMAND_KIND_TIMER_END: return "timer_end";
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN: return "query_begin";
+	case RENOIR_COMMAND_KIND_QUERY_END: return "query_end";
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN: return "conditional_begin";
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END: return "conditional_end";
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE: return "uniform_write";
+	case RENOIR_COMMAND_KIND_FRAME_FENCE: return "frame_fence";
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_BEGIN: return "profiler_scope_begin";
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_END: return "profiler_scope_end";
+	case RENOIR_COMMAND_KIND_PROFILER_FRAME: return "profiler_frame";
+	default: assert(false && "invalid command kind"); return "<INVALID>";
+	}
+}
+
+
 struct Renoir_Command
 {
 	Renoir_Command *prev, *next;
@@ -967,6 +1141,22 @@ struct Renoir_Command
 			Renoir_Handle* handle;
 		} timer_elapsed;
 
+		struct
+		{
+			Renoir_Handle* handle;
+		} query_new;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} query_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			int slot;
+		} query_result;
+
 		struct
 		{
 			Renoir_Handle* handle;
@@ -1015,6 +1205,15 @@ struct Renoir_Command
 			size_t bytes_size;
 		} buffer_write;
 
+		struct
+		{
+			Renoir_Handle* dst;
+			size_t dst_offset;
+			Renoir_Handle* src;
+			size_t src_offset;
+			size_t size;
+		} buffer_copy;
+
 		struct
 		{
 			Renoir_Handle* handle;
@@ -1041,11 +1240,16 @@ struct Renoir_Command
 			RENOIR_SHADER shader;
 			int slot;
 			RENOIR_ACCESS gpu_access;
+			// if size is 0 then the whole buffer is bound
+			size_t offset;
+			size_t size;
 		} buffer_bind;
 
 		struct
 		{
 			Renoir_Handle* handle[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
+			size_t offsets[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
+			size_t sizes[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE];
 			int start_slot;
 		} buffer_storage_bind;
 
@@ -1078,6 +1282,57 @@ struct Renoir_Command
 		{
 			Renoir_Handle* handle;
 		} timer_end;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			int slot;
+		} query_begin;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			int slot;
+		} query_end;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			int slot;
+			bool wait;
+		} conditional_begin;
+
+		struct
+		{
+		} conditional_end;
+
+		struct
+		{
+			size_t offset;
+			void* bytes;
+			size_t bytes_size;
+		} uniform_write;
+
+		struct
+		{
+			int finished_frame;
+			int next_frame;
+		} frame_fence;
+
+		struct
+		{
+			Renoir_Handle* pass;
+			mn::Str name;
+		} profiler_scope_begin;
+
+		struct
+		{
+			Renoir_Handle* pass;
+		} profiler_scope_end;
+
+		struct
+		{
+		} profiler_frame;
 	};
 };
 
@@ -1183,11 +1438,293 @@ struct Renoir_Leak_Info
 	size_t callstack_size;
 };
 
+// freed handle whose gl objects might still be used by the gpu
+struct Renoir_GL450_Retired_Handle
+{
+	Renoir_Handle* handle;
+	// slot index of the handle since its id is cleared when it's freed
+	uint32_t index;
+};
+
+struct Renoir_GL450_Retire_Batch
+{
+	mn::Buf<GLuint> buffers;
+	mn::Buf<GLuint> textures;
+	mn::Buf<GLuint> renderbuffers;
+	mn::Buf<GLuint> samplers;
+	mn::Buf<GLuint> queries;
+};
+
+// bounds how far the cpu runs ahead of the gpu, each frame in flight has a slot with a fence which is waited on
+// before the slot is reused, per frame resources (uniform ring segments) are indexed by the same slot
+struct Renoir_GL450_Frame_Pacer
+{
+	// max_frames_in_flight setting
+	int frames_count;
+	// slot of the frame being recorded, it's updated on the api side
+	int frame;
+	// the following are only accessed on the execution side
+	GLsync fences[RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT];
+	// slot of the frame being executed
+	int execute_frame;
+	// handles freed in each frame, they're destroyed after the fence of their frame is waited on
+	mn::Buf<Renoir_GL450_Retired_Handle> retired[RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT];
+	// scratch names of the gl objects which are deleted together by _renoir_gl450_retire_frame
+	Renoir_GL450_Retire_Batch batch;
+};
+
+struct Renoir_GL450_Uniform_Ring
+{
+	Renoir_Handle* buffer;
+	size_t alignment;
+	// each frame in flight gets its own segment
+	size_t segment_size;
+	size_t segment_offset;
+	// persistently mapped pointer, it's only accessed on the execution side
+	uint8_t* ptr;
+};
+
+// the profiler keeps a frame for each frame in flight plus the one being recorded (see Renoir_GL450_Profiler::frames_count)
+constexpr int RENOIR_GL450_PROFILER_FRAMES = RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT + 1;
+
+struct Renoir_GL450_Profiler_Scope
+{
+	mn::Str name;
+	Renoir_Handle* pass;
+	int depth;
+	GLuint timepoints[2];
+};
+
+struct Renoir_GL450_Profiler_Frame
+{
+	uint64_t index;
+	bool pending;
+	mn::Buf<Renoir_GL450_Profiler_Scope> scopes;
+	// indices of the currently open scopes
+	mn::Buf<size_t> stack;
+	// the last issued timestamp query, once it's available the whole frame is available
+	GLuint last_query;
+};
+
+struct Renoir_GL450_Profiler
+{
+	Renoir_GL450_Profiler_Frame frames[RENOIR_GL450_PROFILER_FRAMES];
+	// max_frames_in_flight + 1, the gpu can't be more than max_frames_in_flight frames behind so a frame's queries
+	// are available by the time its slot is reused, the oldest frame is only dropped if the results weren't ready
+	int frames_count;
+	int frame;
+	uint64_t frame_index;
+	mn::Buf<GLuint> free_queries;
+
+	// results of the last completed frame
+	bool has_results;
+	uint64_t results_frame_index;
+	mn::Buf<mn::Str> results_names;
+	mn::Buf<Renoir_Profiler_Scope> results;
+};
+
+// number of events each thread can hold before overwriting the oldest ones
+constexpr size_t RENOIR_GL450_TRACE_RING_SIZE = 64 * 1024;
+constexpr size_t RENOIR_GL450_TRACE_GPU_RING_SIZE = 16 * 1024;
+
+struct Renoir_GL450_Trace_Event
+{
+	// should point to a static string
+	const char* name;
+	uint64_t time_in_nanos;
+	char phase;
+};
+
+struct Renoir_GL450_Trace_Ring
+{
+	uint32_t thread_id;
+	// only the owning thread writes to the ring, it locks the mutex for each event so that trace_export can copy the
+	// ring without reading half written events, it's uncontended unless an export is running
+	mn::Mutex mtx;
+	Renoir_GL450_Trace_Event* events;
+	// total number of events ever written
+	size_t count;
+};
+
+// copy of a ring's events taken by trace_export
+struct Renoir_GL450_Trace_Snapshot
+{
+	uint32_t thread_id;
+	mn::Buf<Renoir_GL450_Trace_Event> events;
+};
+
+struct Renoir_GL450_Trace_Gpu_Event
+{
+	char name[64];
+	uint64_t begin_in_nanos;
+	uint64_t elapsed_in_nanos;
+	int depth;
+};
+
+struct Renoir_GL450_Trace
+{
+	// unique id for each renoir instance, used to invalidate the thread local ring cache
+	uint64_t id;
+	mn::Mutex mtx;
+	mn::Buf<Renoir_GL450_Trace_Ring*> rings;
+	// gpu events are written on the execution side with IRenoir::mtx locked
+	mn::Buf<Renoir_GL450_Trace_Gpu_Event> gpu_events;
+	size_t gpu_events_count;
+	// offset that maps gpu timestamps to cpu clock
+	int64_t gpu_to_cpu_offset;
+};
+
+struct Renoir_GL450_Stats
+{
+	// per frame counters, they are reset at the end of each frame
+	int commands[RENOIR_COMMAND_KIND_COUNT];
+	size_t bytes_uploaded;
+	size_t bytes_read;
+	int sampler_cache_hits;
+	int sampler_cache_misses;
+	int sampler_cache_evictions;
+	int framebuffer_cache_hits;
+	int framebuffer_cache_misses;
+	uint64_t mutex_hold_time_in_nanos;
+	uint64_t frame_wait_time_in_nanos;
+	int retired_handles;
+
+	// lifetime counters
+	size_t alive_commands;
+	size_t alive_handles;
+	size_t command_pool_high_water_mark;
+	size_t handle_pool_high_water_mark;
+	int live_handles[RENOIR_HANDLE_KIND_COUNT];
+
+	uint64_t mutex_lock_time_in_nanos;
+	uint64_t frame_index;
+	// stats of the last completed frame
+	Renoir_Stats last_frame;
+};
+
+struct Renoir_GL450_Capture
+{
+	// null if the capture_path setting is not set
+	FILE* file;
+	// payload of the record being written
+	mn::Buf<uint8_t> record;
+};
+
+// attachment set of an offscreen pass framebuffer, it's the key of the framebuffer cache
+struct Renoir_GL450_Framebuffer_Key
+{
+	Renoir_Handle* color[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE];
+	int color_level[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE];
+	int color_subresource[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE];
+	Renoir_Handle* depth;
+	int depth_level;
+	int depth_subresource;
+	// resolve framebuffers attach the textures of multisampled attachments instead of their renderbuffers
+	bool resolve;
+};
+
+// framebuffers are shared among all the passes with the same attachment set, and they live until one of their
+// textures is freed
+struct Renoir_GL450_Framebuffer
+{
+	Renoir_GL450_Framebuffer_Key key;
+	GLuint fb;
+};
+
+struct Renoir_GL450_Memory_Tag
+{
+	mn::Str name;
+	Renoir_Memory_Counter counter;
+};
+
+// estimated memory footprint of the alive resources, it's updated with the mutex locked
+struct Renoir_GL450_Memory
+{
+	Renoir_Memory_Counter total;
+	Renoir_Memory_Counter kinds[RENOIR_MEMORY_COUNT];
+	// tags are never removed so that handles can refer to them by index, the first one is for untagged resources
+	mn::Buf<Renoir_GL450_Memory_Tag> tags;
+	// sampled at the end of each frame using GL_NVX_gpu_memory_info or GL_ATI_meminfo
+	size_t device_total_bytes;
+	size_t device_available_bytes;
+};
+
+// public handles are 32-bit ids stored in the handle field of the api structs, each id packs the handle kind, the slot
+// index in the table of that kind, and the generation of the slot which is bumped when it's freed so that stale ids
+// are detected in O(1) instead of silently aliasing the handle which reused the slot
+constexpr uint32_t RENOIR_GL450_HANDLE_INDEX_BITS = 18;
+constexpr uint32_t RENOIR_GL450_HANDLE_GENERATION_BITS = 10;
+constexpr uint32_t RENOIR_GL450_HANDLE_KIND_SHIFT = RENOIR_GL450_HANDLE_INDEX_BITS + RENOIR_GL450_HANDLE_GENERATION_BITS;
+constexpr uint32_t RENOIR_GL450_HANDLE_INDEX_MASK = (1u << RENOIR_GL450_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t RENOIR_GL450_HANDLE_GENERATION_MASK = (1u << RENOIR_GL450_HANDLE_GENERATION_BITS) - 1;
+// freed slots are queued and only reused in fifo order once the queue holds RENOIR_GL450_HANDLE_MIN_FREE_SLOTS of them,
+// so a slot is reused at most once every RENOIR_GL450_HANDLE_MIN_FREE_SLOTS frees of its kind and its generation wraps
+// after ~1M frees of that kind instead of after 1023 reuses of the same slot
+constexpr uint32_t RENOIR_GL450_HANDLE_MIN_FREE_SLOTS = 1024;
+constexpr uint32_t RENOIR_GL450_HANDLE_CHUNK_SIZE = 128;
+constexpr uint32_t RENOIR_GL450_HANDLE_CHUNKS_COUNT = (1u << RENOIR_GL450_HANDLE_INDEX_BITS) / RENOIR_GL450_HANDLE_CHUNK_SIZE;
+static_assert(RENOIR_HANDLE_KIND_COUNT <= (1u << (32 - RENOIR_GL450_HANDLE_KIND_SHIFT)), "handle kind doesn't fit in the id");
+
+struct Renoir_GL450_Handle_Chunk
+{
+	Renoir_Handle handles[RENOIR_GL450_HANDLE_CHUNK_SIZE];
+	// generations live outside of the handles because the handles are cleared when they're reused
+	uint32_t generations[RENOIR_GL450_HANDLE_CHUNK_SIZE];
+};
+
+// dense table of the handles of one kind, chunks never move once they're allocated and the chunk pointers and the
+// handle ids are atomic so ids can be resolved without locking the mutex, free slots are reused in fifo order
+struct Renoir_GL450_Handle_Table
+{
+	std::atomic<Renoir_GL450_Handle_Chunk*> chunks[RENOIR_GL450_HANDLE_CHUNKS_COUNT];
+	uint32_t slots_count;
+	mn::Ring<uint32_t> free_slots;
+};
+
+struct Renoir_GL450_Vertex_Binding
+{
+	GLuint buffer;
+	RENOIR_TYPE type;
+	size_t stride;
+	size_t offset;
+};
+
+// mirrors the vertex array state of the vao so that draws which share the same vertex and index buffers (e.g. meshes
+// suballocated from the same buffer using base_vertex) don't rebind them, a zero buffer means the slot is unknown
+struct Renoir_GL450_Vertex_State
+{
+	Renoir_GL450_Vertex_Binding vertex_buffers[RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE];
+	GLuint index_buffer;
+};
+
+// background resource creation (see async_uploads setting), buffers and textures with initial data are created by
+// the upload thread using a context which shares objects with the main one
+struct Renoir_GL450_Upload
+{
+	// null if the async_uploads setting is disabled
+	Renoir_GL450_Context* ctx;
+	mn::Thread thread;
+	mn::Mutex mtx;
+	// signaled when a command is pushed or the thread should stop
+	mn::Cond_Var work_cv;
+	// signaled when an upload finishes
+	mn::Cond_Var done_cv;
+	bool stop;
+
+	// commands waiting for the upload thread
+	Renoir_Command *pending_list_head;
+	Renoir_Command *pending_list_tail;
+
+	// finished commands, they're retired (stats and free) on the execution side with the mutex locked
+	Renoir_Command *done_list_head;
+	Renoir_Command *done_list_tail;
+};
+
 struct IRenoir
 {
 	mn::Mutex mtx;
 	Renoir_GL450_Context* ctx;
-	mn::Pool handle_pool;
+	Renoir_GL450_Handle_Table handles[RENOIR_HANDLE_KIND_COUNT];
 	mn::Pool command_pool;
 	Renoir_Settings settings;
 
@@ -1201,67 +1738,439 @@ struct IRenoir
 	Renoir_Handle* current_compute;
 	Renoir_Handle* current_pass;
 
+	// frames in flight limiter
+	Renoir_GL450_Frame_Pacer pacer;
+
+	// per-frame transient uniform allocator
+	Renoir_GL450_Uniform_Ring uniform_ring;
+
+	// buffer range offset alignments of the device, they're 1 until the init command queries them so nothing is
+	// asserted before that
+	size_t uniform_offset_alignment;
+	size_t storage_offset_alignment;
+
+	// frame gpu profiler
+	Renoir_GL450_Profiler profiler;
+
+	// trace recorder
+	Renoir_GL450_Trace trace;
+
+	// backend statistics, they are updated with the mutex locked
+	Renoir_GL450_Stats stats;
+
+	// resources memory accounting
+	Renoir_GL450_Memory memory;
+
+	// command capture, it's written on the execution side with the mutex locked
+	Renoir_GL450_Capture capture;
+
+	// background upload thread
+	Renoir_GL450_Upload upload;
+
 	// caches
 	GLuint vao;
-	GLuint msaa_resolve_fb;
+	Renoir_GL450_Vertex_State vertex_state;
 	mn::Buf<Renoir_Handle*> sampler_cache;
+	mn::Buf<Renoir_GL450_Framebuffer> framebuffer_cache;
+	Renoir_Transient_Pool transient_pool;
 
 	// opengl state used to prevent state leaks in case of external opengl context
 	bool glewInited;
 	Renoir_GL450_State state;
 
-	// leak detection
+	// leak detection callstacks, alive handles are found by walking the handle tables
+	#if RENOIR_LEAK
 	mn::Map<Renoir_Handle*, Renoir_Leak_Info> alive_handles;
+	#endif
 };
 
 static void
 _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command);
 
-static Renoir_Handle*
-_renoir_gl450_handle_new(IRenoir* self, RENOIR_HANDLE_KIND kind)
+inline static uint64_t
+_renoir_gl450_time_in_nanos()
 {
-	auto handle = (Renoir_Handle*)mn::pool_get(self->handle_pool);
-	memset(handle, 0, sizeof(*handle));
-	handle->kind = kind;
-	handle->rc = 1;
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
 
-	#ifdef DEBUG
-	if (_renoir_handle_kind_should_track(kind))
+static Renoir_GL450_Trace_Ring*
+_renoir_gl450_trace_ring(IRenoir* self)
+{
+	static std::atomic<uint32_t> thread_id_generator{1};
+	thread_local uint32_t thread_id = thread_id_generator.fetch_add(1);
+	thread_local uint64_t cached_trace_id = 0;
+	thread_local Renoir_GL450_Trace_Ring* cached_ring = nullptr;
+
+	if (cached_trace_id == self->trace.id)
+		return cached_ring;
+
+	mn::mutex_lock(self->trace.mtx);
+	mn_defer(mn::mutex_unlock(self->trace.mtx));
+
+	Renoir_GL450_Trace_Ring* ring = nullptr;
+	for (auto it: self->trace.rings)
 	{
-		assert(mn::map_lookup(self->alive_handles, handle) == nullptr && "reuse of already alive renoir handle");
-		Renoir_Leak_Info info{};
-		#if RENOIR_LEAK
-			info.callstack_size = mn::callstack_capture(info.callstack, 20);
-		#endif
-		mn::map_insert(self->alive_handles, handle, info);
+		if (it->thread_id == thread_id)
+		{
+			ring = it;
+			break;
+		}
 	}
-	#endif
 
-	return handle;
+	if (ring == nullptr)
+	{
+		ring = mn::alloc_zerod<Renoir_GL450_Trace_Ring>();
+		ring->thread_id = thread_id;
+		ring->mtx = mn_mutex_new_with_srcloc("renoir gl450 trace ring");
+		ring->events = (Renoir_GL450_Trace_Event*)mn::alloc(
+			sizeof(Renoir_GL450_Trace_Event) * RENOIR_GL450_TRACE_RING_SIZE,
+			alignof(Renoir_GL450_Trace_Event)
+		).ptr;
+		mn::buf_push(self->trace.rings, ring);
+	}
+
+	cached_trace_id = self->trace.id;
+	cached_ring = ring;
+	return ring;
+}
+
+inline static void
+_renoir_gl450_trace_event(IRenoir* self, const char* name, char phase)
+{
+	if (self->settings.trace == false)
+		return;
+
+	auto ring = _renoir_gl450_trace_ring(self);
+	auto time_in_nanos = _renoir_gl450_time_in_nanos();
+	mn::mutex_lock(ring->mtx);
+	auto& event = ring->events[ring->count % RENOIR_GL450_TRACE_RING_SIZE];
+	event.name = name;
+	event.time_in_nanos = time_in_nanos;
+	event.phase = phase;
+	++ring->count;
+	mn::mutex_unlock(ring->mtx);
 }
 
+// records a begin event at construction and an end event at destruction
+struct Renoir_GL450_Trace_Scope
+{
+	IRenoir* self;
+	const char* name;
+
+	Renoir_GL450_Trace_Scope(IRenoir* self, const char* name)
+		: self(self), name(name)
+	{
+		_renoir_gl450_trace_event(self, name, 'B');
+	}
+
+	~Renoir_GL450_Trace_Scope()
+	{
+		_renoir_gl450_trace_event(self, name, 'E');
+	}
+};
+
 static void
-_renoir_gl450_handle_free(IRenoir* self, Renoir_Handle* h)
+_renoir_gl450_trace_gpu_event(IRenoir* self, const char* name, uint64_t gpu_begin, uint64_t gpu_elapsed, int depth)
 {
-	#ifdef DEBUG
-	if (_renoir_handle_kind_should_track(h->kind))
+	if (self->settings.trace == false)
+		return;
+
+	auto& trace = self->trace;
+	auto& event = trace.gpu_events[trace.gpu_events_count % RENOIR_GL450_TRACE_GPU_RING_SIZE];
+	::snprintf(event.name, sizeof(event.name), "%s", name ? name : "");
+	// user names end up in a json string so we make sure they don't break it
+	for (auto& c: event.name)
 	{
-		auto removed = mn::map_remove(self->alive_handles, h);
-		assert(removed && "free was called with an invalid renoir handle");
+		if (c == '"' || c == '\\')
+			c = '_';
 	}
-	#endif
-	mn::pool_put(self->handle_pool, h);
+	event.begin_in_nanos = uint64_t(int64_t(gpu_begin) + trace.gpu_to_cpu_offset);
+	event.elapsed_in_nanos = gpu_elapsed;
+	event.depth = depth;
+	++trace.gpu_events_count;
 }
 
-static Renoir_Handle*
-_renoir_gl450_handle_ref(Renoir_Handle* h)
+inline static void
+_renoir_gl450_mutex_lock(IRenoir* self)
 {
-	h->rc.fetch_add(1);
-	return h;
+	Renoir_GL450_Trace_Scope trace_scope{self, "mutex_wait"};
+	mn::mutex_lock(self->mtx);
+	self->stats.mutex_lock_time_in_nanos = _renoir_gl450_time_in_nanos();
 }
 
-static bool
-_renoir_gl450_handle_unref(Renoir_Handle* h)
+inline static void
+_renoir_gl450_mutex_unlock(IRenoir* self)
+{
+	self->stats.mutex_hold_time_in_nanos += _renoir_gl450_time_in_nanos() - self->stats.mutex_lock_time_in_nanos;
+	mn::mutex_unlock(self->mtx);
+}
+
+inline static void
+_renoir_gl450_memory_counter_update(Renoir_Memory_Counter& counter, size_t bytes, bool alloc)
+{
+	if (alloc)
+	{
+		++counter.count;
+		counter.bytes += bytes;
+		if (counter.bytes > counter.high_water_mark)
+			counter.high_water_mark = counter.bytes;
+	}
+	else
+	{
+		--counter.count;
+		counter.bytes -= bytes;
+	}
+}
+
+// returns the index of the given memory tag, null is the untagged resources tag
+static int
+_renoir_gl450_memory_tag(IRenoir* self, const char* tag)
+{
+	if (tag == nullptr)
+		return 0;
+
+	auto& tags = self->memory.tags;
+	for (size_t i = 1; i < tags.count; ++i)
+		if (::strcmp(tags[i].name.ptr, tag) == 0)
+			return int(i);
+
+	mn::buf_push(tags, Renoir_GL450_Memory_Tag{mn::str_from_c(tag), Renoir_Memory_Counter{}});
+	return int(tags.count - 1);
+}
+
+// estimated footprint of the texture storage (all mipmaps and cube faces), and of its msaa renderbuffers
+static void
+_renoir_gl450_texture_memory(const Renoir_Texture_Desc& desc, size_t& texture_bytes, size_t& renderbuffer_bytes)
+{
+	auto pixel_size = _renoir_pixelformat_to_size(desc.pixel_format);
+	size_t width = desc.size.width;
+	size_t height = desc.size.height > 0 ? desc.size.height : 1;
+	size_t depth = desc.size.depth > 0 ? desc.size.depth : 1;
+	size_t faces = desc.cube_map ? 6 : 1;
+
+	texture_bytes = 0;
+	renderbuffer_bytes = 0;
+
+	if (desc.msaa_sampled)
+	{
+		texture_bytes = width * height * pixel_size * size_t(desc.msaa);
+		return;
+	}
+
+	if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE && desc.size.height > 0 && desc.size.depth == 0)
+		renderbuffer_bytes = width * height * pixel_size * size_t(desc.msaa) * faces;
+
+	for (int i = 0; i < desc.mipmaps; ++i)
+	{
+		texture_bytes += width * height * depth * pixel_size * faces;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		depth = depth > 1 ? depth / 2 : 1;
+	}
+}
+
+// accounts the memory of buffer and texture handles, alloc is true when they're created and false when they're freed
+static void
+_renoir_gl450_memory_handle(IRenoir* self, Renoir_Handle* h, bool alloc)
+{
+	auto& memory = self->memory;
+
+	size_t bytes = 0;
+	int tag = 0;
+	if (h->kind == RENOIR_HANDLE_KIND_BUFFER)
+	{
+		bytes = h->buffer.size;
+		tag = h->buffer.memory_tag;
+		_renoir_gl450_memory_counter_update(memory.kinds[RENOIR_MEMORY_BUFFER], bytes, alloc);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_TEXTURE)
+	{
+		size_t texture_bytes = 0, renderbuffer_bytes = 0;
+		_renoir_gl450_texture_memory(h->texture.desc, texture_bytes, renderbuffer_bytes);
+		_renoir_gl450_memory_counter_update(memory.kinds[RENOIR_MEMORY_TEXTURE], texture_bytes, alloc);
+		if (renderbuffer_bytes > 0)
+			_renoir_gl450_memory_counter_update(memory.kinds[RENOIR_MEMORY_RENDERBUFFER], renderbuffer_bytes, alloc);
+		bytes = texture_bytes + renderbuffer_bytes;
+		tag = h->texture.memory_tag;
+	}
+	else
+	{
+		return;
+	}
+
+	_renoir_gl450_memory_counter_update(memory.total, bytes, alloc);
+	_renoir_gl450_memory_counter_update(memory.tags[tag].counter, bytes, alloc);
+}
+
+// samples the device memory at the end of the frame, the values are reported in KB
+static void
+_renoir_gl450_memory_frame(IRenoir* self)
+{
+	if (self->glewInited == false)
+		return;
+
+	if (GLEW_NVX_gpu_memory_info)
+	{
+		GLint total = 0, available = 0;
+		glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total);
+		glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+		self->memory.device_total_bytes = size_t(total) * 1024;
+		self->memory.device_available_bytes = size_t(available) * 1024;
+	}
+	else if (GLEW_ATI_meminfo)
+	{
+		// total free memory in the pool, largest free block, total auxiliary free memory, largest auxiliary free block
+		GLint info[4]{};
+		glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, info);
+		self->memory.device_available_bytes = size_t(info[0]) * 1024;
+	}
+}
+
+static Renoir_Handle*
+_renoir_gl450_handle_new(IRenoir* self, RENOIR_HANDLE_KIND kind)
+{
+	auto& table = self->handles[kind];
+	uint32_t index = 0;
+	// the queue is drained below its minimum depth only when the table is full
+	if (table.free_slots.count >= RENOIR_GL450_HANDLE_MIN_FREE_SLOTS || (table.free_slots.count > 0 && table.slots_count > RENOIR_GL450_HANDLE_INDEX_MASK))
+	{
+		index = mn::ring_front(table.free_slots);
+		mn::ring_pop_front(table.free_slots);
+	}
+	else
+	{
+		assert(table.slots_count <= RENOIR_GL450_HANDLE_INDEX_MASK && "renoir handle table is full");
+		index = table.slots_count++;
+		auto& chunk = table.chunks[index / RENOIR_GL450_HANDLE_CHUNK_SIZE];
+		if (chunk == nullptr)
+			chunk.store(mn::alloc_zerod<Renoir_GL450_Handle_Chunk>(), std::memory_order_release);
+	}
+
+	auto chunk = table.chunks[index / RENOIR_GL450_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_GL450_HANDLE_CHUNK_SIZE;
+	// generation 0 is never used so that no id is 0
+	if (chunk->generations[slot] == 0)
+		chunk->generations[slot] = 1;
+
+	auto handle = &chunk->handles[slot];
+	memset(handle, 0, sizeof(*handle));
+	handle->kind = kind;
+	handle->rc = 1;
+	// the id is published last so that a concurrent handle_get never sees a half initialized handle
+	handle->id.store((uint32_t(kind) << RENOIR_GL450_HANDLE_KIND_SHIFT) | (chunk->generations[slot] << RENOIR_GL450_HANDLE_INDEX_BITS) | index, std::memory_order_release);
+
+	++self->stats.live_handles[kind];
+	if (++self->stats.alive_handles > self->stats.handle_pool_high_water_mark)
+		self->stats.handle_pool_high_water_mark = self->stats.alive_handles;
+
+	#if RENOIR_LEAK
+	if (_renoir_handle_kind_should_track(kind))
+	{
+		Renoir_Leak_Info info{};
+		info.callstack_size = mn::callstack_capture(info.callstack, 20);
+		mn::map_insert(self->alive_handles, handle, info);
+	}
+	#endif
+
+	return handle;
+}
+
+// resolves a public id to its handle, it returns null for the null id and for stale ids of freed handles
+static Renoir_Handle*
+_renoir_gl450_handle_get(IRenoir* self, const void* handle)
+{
+	if (handle == nullptr)
+		return nullptr;
+
+	auto value = uintptr_t(handle);
+	auto id = uint32_t(value);
+	auto kind = id >> RENOIR_GL450_HANDLE_KIND_SHIFT;
+	auto index = id & RENOIR_GL450_HANDLE_INDEX_MASK;
+	Renoir_Handle* res = nullptr;
+	if (value == id && kind < RENOIR_HANDLE_KIND_COUNT)
+	{
+		if (auto chunk = self->handles[kind].chunks[index / RENOIR_GL450_HANDLE_CHUNK_SIZE].load(std::memory_order_acquire))
+			res = &chunk->handles[index % RENOIR_GL450_HANDLE_CHUNK_SIZE];
+	}
+
+	if (res == nullptr || res->id.load(std::memory_order_acquire) != id)
+	{
+		mn::log_error("gl450: invalid renoir handle {:#x}, it might have been freed already", value);
+		assert(false && "invalid renoir handle");
+		return nullptr;
+	}
+	return res;
+}
+
+inline static void*
+_renoir_gl450_handle_public(Renoir_Handle* h)
+{
+	if (h == nullptr)
+		return nullptr;
+	return (void*)uintptr_t(h->id);
+}
+
+// invalidates the id of the handle so it can't be resolved anymore, the handle content is kept intact and its slot is
+// not reused until it's released, returns the slot index
+static uint32_t
+_renoir_gl450_handle_kill(IRenoir* self, Renoir_Handle* h)
+{
+	auto index = h->id & RENOIR_GL450_HANDLE_INDEX_MASK;
+	auto chunk = self->handles[h->kind].chunks[index / RENOIR_GL450_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_GL450_HANDLE_CHUNK_SIZE;
+	assert(h->id != 0 && chunk != nullptr && &chunk->handles[slot] == h && "free was called with an invalid renoir handle");
+
+	#if RENOIR_LEAK
+	if (_renoir_handle_kind_should_track(h->kind))
+		mn::map_remove(self->alive_handles, h);
+	#endif
+	--self->stats.live_handles[h->kind];
+	--self->stats.alive_handles;
+
+	chunk->generations[slot] = (chunk->generations[slot] + 1) & RENOIR_GL450_HANDLE_GENERATION_MASK;
+	h->id.store(0, std::memory_order_release);
+	return index;
+}
+
+// returns the slot of a killed handle to its table
+static void
+_renoir_gl450_handle_release(IRenoir* self, Renoir_Handle* h, uint32_t index)
+{
+	auto& table = self->handles[h->kind];
+	assert(h->id == 0 && &table.chunks[index / RENOIR_GL450_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed)->handles[index % RENOIR_GL450_HANDLE_CHUNK_SIZE] == h);
+	_renoir_gl450_memory_handle(self, h, false);
+	mn::ring_push_back(table.free_slots, index);
+}
+
+static void
+_renoir_gl450_handle_free(IRenoir* self, Renoir_Handle* h)
+{
+	auto index = _renoir_gl450_handle_kill(self, h);
+	_renoir_gl450_handle_release(self, h, index);
+}
+
+// kills the handle and queues it in the frame being executed, its gl objects are destroyed and its slot is released
+// once the gpu finishes that frame (see _renoir_gl450_retire_frame)
+static void
+_renoir_gl450_handle_retire(IRenoir* self, Renoir_Handle* h)
+{
+	auto& pacer = self->pacer;
+	Renoir_GL450_Retired_Handle retired{};
+	retired.handle = h;
+	retired.index = _renoir_gl450_handle_kill(self, h);
+	mn::buf_push(pacer.retired[pacer.execute_frame], retired);
+}
+
+static Renoir_Handle*
+_renoir_gl450_handle_ref(Renoir_Handle* h)
+{
+	h->rc.fetch_add(1);
+	return h;
+}
+
+static bool
+_renoir_gl450_handle_unref(Renoir_Handle* h)
 {
 	return h->rc.fetch_sub(1) == 1;
 }
@@ -1273,6 +2182,8 @@ _renoir_gl450_command_new(T* self, RENOIR_COMMAND_KIND kind)
 	auto command = (Renoir_Command*)mn::pool_get(self->command_pool);
 	memset(command, 0, sizeof(*command));
 	command->kind = kind;
+	if (++self->stats.alive_commands > self->stats.command_pool_high_water_mark)
+		self->stats.command_pool_high_water_mark = self->stats.alive_commands;
 	return command;
 }
 
@@ -1331,6 +2242,16 @@ _renoir_gl450_command_free(T* self, Renoir_Command* command)
 		mn::free(mn::Block{(void*)command->texture_write.desc.bytes, command->texture_write.desc.bytes_size});
 		break;
 	}
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+	{
+		mn::free(mn::Block{(void*)command->uniform_write.bytes, command->uniform_write.bytes_size});
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_BEGIN:
+	{
+		mn::str_free(command->profiler_scope_begin.name);
+		break;
+	}
 	case RENOIR_COMMAND_KIND_NONE:
 	case RENOIR_COMMAND_KIND_INIT:
 	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW:
@@ -1347,6 +2268,9 @@ _renoir_gl450_command_free(T* self, Renoir_Command* command)
 	case RENOIR_COMMAND_KIND_TIMER_NEW:
 	case RENOIR_COMMAND_KIND_TIMER_FREE:
 	case RENOIR_COMMAND_KIND_TIMER_ELAPSED:
+	case RENOIR_COMMAND_KIND_QUERY_NEW:
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+	case RENOIR_COMMAND_KIND_QUERY_RESULT:
 	case RENOIR_COMMAND_KIND_PASS_BEGIN:
 	case RENOIR_COMMAND_KIND_PASS_END:
 	case RENOIR_COMMAND_KIND_PASS_CLEAR:
@@ -1357,17 +2281,27 @@ _renoir_gl450_command_free(T* self, Renoir_Command* command)
 	case RENOIR_COMMAND_KIND_BUFFER_READ:
 	case RENOIR_COMMAND_KIND_TEXTURE_READ:
 	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
 	case RENOIR_COMMAND_KIND_BUFFER_BIND:
 	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
 	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
 	case RENOIR_COMMAND_KIND_DRAW:
 	case RENOIR_COMMAND_KIND_DISPATCH:
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER:
 	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
 	case RENOIR_COMMAND_KIND_TIMER_END:
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN:
+	case RENOIR_COMMAND_KIND_QUERY_END:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END:
+	case RENOIR_COMMAND_KIND_FRAME_FENCE:
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_END:
+	case RENOIR_COMMAND_KIND_PROFILER_FRAME:
 	default:
 		// do nothing
 		break;
 	}
+	--self->stats.alive_commands;
 	mn::pool_put(self->command_pool, command);
 }
 
@@ -1401,120 +2335,1553 @@ _renoir_gl450_command_process(IRenoir* self, Renoir_Command* command)
 	}
 }
 
-static void
-_renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
+struct Renoir_GL450_Reflect
 {
-	switch(command->kind)
-	{
-	case RENOIR_COMMAND_KIND_INIT:
+	mn::Buf<mn::Str> names;
+	mn::Buf<Renoir_Reflect_Member> members;
+	mn::Buf<Renoir_Reflect_Block> uniform_blocks;
+	mn::Buf<Renoir_Reflect_Block> storage_blocks;
+	mn::Buf<Renoir_Reflect_Texture> samplers;
+	mn::Buf<Renoir_Reflect_Texture> images;
+	int workgroup_size[3];
+};
+
+inline static bool
+_renoir_gl450_type_is_sampler(GLenum type)
+{
+	switch (type)
 	{
-		renoir_gl450_context_bind(self->ctx);
-		if (self->settings.external_context)
-		{
-			// we just need to init glew in case of external context
-			GLenum glew_result = glewInit();
-			assert(glew_result == GLEW_OK && "glewInit failed");
+	case GL_SAMPLER_1D:
+	case GL_SAMPLER_2D:
+	case GL_SAMPLER_3D:
+	case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_1D_SHADOW:
+	case GL_SAMPLER_2D_SHADOW:
+	case GL_SAMPLER_1D_ARRAY:
+	case GL_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_1D_ARRAY_SHADOW:
+	case GL_SAMPLER_2D_ARRAY_SHADOW:
+	case GL_SAMPLER_2D_MULTISAMPLE:
+	case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+	case GL_SAMPLER_CUBE_SHADOW:
+	case GL_SAMPLER_CUBE_MAP_ARRAY:
+	case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+	case GL_SAMPLER_BUFFER:
+	case GL_SAMPLER_2D_RECT:
+	case GL_SAMPLER_2D_RECT_SHADOW:
+	case GL_INT_SAMPLER_1D:
+	case GL_INT_SAMPLER_2D:
+	case GL_INT_SAMPLER_3D:
+	case GL_INT_SAMPLER_CUBE:
+	case GL_INT_SAMPLER_1D_ARRAY:
+	case GL_INT_SAMPLER_2D_ARRAY:
+	case GL_INT_SAMPLER_2D_MULTISAMPLE:
+	case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+	case GL_INT_SAMPLER_BUFFER:
+	case GL_INT_SAMPLER_2D_RECT:
+	case GL_UNSIGNED_INT_SAMPLER_1D:
+	case GL_UNSIGNED_INT_SAMPLER_2D:
+	case GL_UNSIGNED_INT_SAMPLER_3D:
+	case GL_UNSIGNED_INT_SAMPLER_CUBE:
+	case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+	case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+	case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+		return true;
+	default:
+		return false;
+	}
+}
 
-			mn::log_info("OpenGL Renderer: {}", glGetString(GL_RENDERER));
-			mn::log_info("OpenGL Version: {}", glGetString(GL_VERSION));
-			mn::log_info("GLSL Version: {}", glGetString(GL_SHADING_LANGUAGE_VERSION));
+inline static bool
+_renoir_gl450_type_is_image(GLenum type)
+{
+	switch (type)
+	{
+	case GL_IMAGE_1D:
+	case GL_IMAGE_2D:
+	case GL_IMAGE_3D:
+	case GL_IMAGE_2D_RECT:
+	case GL_IMAGE_CUBE:
+	case GL_IMAGE_BUFFER:
+	case GL_IMAGE_1D_ARRAY:
+	case GL_IMAGE_2D_ARRAY:
+	case GL_IMAGE_CUBE_MAP_ARRAY:
+	case GL_IMAGE_2D_MULTISAMPLE:
+	case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_INT_IMAGE_1D:
+	case GL_INT_IMAGE_2D:
+	case GL_INT_IMAGE_3D:
+	case GL_INT_IMAGE_2D_RECT:
+	case GL_INT_IMAGE_CUBE:
+	case GL_INT_IMAGE_BUFFER:
+	case GL_INT_IMAGE_1D_ARRAY:
+	case GL_INT_IMAGE_2D_ARRAY:
+	case GL_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_INT_IMAGE_2D_MULTISAMPLE:
+	case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_1D:
+	case GL_UNSIGNED_INT_IMAGE_2D:
+	case GL_UNSIGNED_INT_IMAGE_3D:
+	case GL_UNSIGNED_INT_IMAGE_2D_RECT:
+	case GL_UNSIGNED_INT_IMAGE_CUBE:
+	case GL_UNSIGNED_INT_IMAGE_BUFFER:
+	case GL_UNSIGNED_INT_IMAGE_1D_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+	case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+		return true;
+	default:
+		return false;
+	}
+}
 
-			GLint major = 0, minor = 0;
-			glGetIntegerv(GL_MAJOR_VERSION, &major);
-			glGetIntegerv(GL_MINOR_VERSION, &minor);
+inline static const char*
+_renoir_gl450_reflect_name(Renoir_GL450_Reflect* self, GLuint program, GLenum interface, GLuint index)
+{
+	char name[256] = {};
+	glGetProgramResourceName(program, interface, index, sizeof(name), nullptr, name);
+	// the string content doesn't move when the names buffer grows so it's safe to hand out the pointer
+	mn::buf_push(self->names, mn::str_from_c(name));
+	return mn::buf_top(self->names).ptr;
+}
 
-			mn::log_ensure(major >= 4 && minor >= 5, "incompatibile OpenGL Context");
-			_renoir_gl450_state_capture(self->state);
+inline static void
+_renoir_gl450_reflect_blocks(
+	Renoir_GL450_Reflect* self,
+	GLuint program,
+	GLenum block_interface,
+	GLenum member_interface,
+	mn::Buf<Renoir_Reflect_Block>& blocks)
+{
+	GLint blocks_count = 0;
+	glGetProgramInterfaceiv(program, block_interface, GL_ACTIVE_RESOURCES, &blocks_count);
+	for (GLint i = 0; i < blocks_count; ++i)
+	{
+		const GLenum block_props[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES};
+		GLint block_values[3] = {};
+		glGetProgramResourceiv(program, block_interface, i, 3, block_props, 3, nullptr, block_values);
+
+		Renoir_Reflect_Block block{};
+		block.name = _renoir_gl450_reflect_name(self, program, block_interface, i);
+		block.binding = block_values[0];
+		block.size = block_values[1];
+		block.members_count = block_values[2];
+
+		auto members_index = mn::buf_with_count<GLint>(block.members_count);
+		mn_defer(mn::buf_free(members_index));
+
+		const GLenum active_variables_prop = GL_ACTIVE_VARIABLES;
+		glGetProgramResourceiv(program, block_interface, i, 1, &active_variables_prop, block.members_count, nullptr, members_index.ptr);
+		for (auto member_index: members_index)
+		{
+			const GLenum member_props[] = {GL_OFFSET, GL_ARRAY_SIZE, GL_ARRAY_STRIDE};
+			GLint member_values[3] = {};
+			glGetProgramResourceiv(program, member_interface, member_index, 3, member_props, 3, nullptr, member_values);
+
+			Renoir_Reflect_Member member{};
+			member.name = _renoir_gl450_reflect_name(self, program, member_interface, member_index);
+			member.offset = member_values[0];
+			member.array_size = member_values[1];
+			member.array_stride = member_values[2];
+			mn::buf_push(self->members, member);
 		}
-		self->glewInited = true;
-		// During init, enable debug output
-		#if RENOIR_DEBUG_LAYER
-		glEnable(GL_DEBUG_OUTPUT);
-		glDebugMessageCallback(_renoir_gl450_error_log, nullptr);
-		#endif
 
-		glCreateVertexArrays(1, &self->vao);
-		glCreateFramebuffers(1, &self->msaa_resolve_fb);
-		assert(_renoir_gl450_check());
-		break;
+		mn::buf_push(blocks, block);
 	}
-	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW:
+}
+
+inline static Renoir_GL450_Reflect*
+_renoir_gl450_reflect_new(GLuint program, bool compute)
+{
+	auto self = mn::alloc_zerod<Renoir_GL450_Reflect>();
+	self->names = mn::buf_new<mn::Str>();
+	self->members = mn::buf_new<Renoir_Reflect_Member>();
+	self->uniform_blocks = mn::buf_new<Renoir_Reflect_Block>();
+	self->storage_blocks = mn::buf_new<Renoir_Reflect_Block>();
+	self->samplers = mn::buf_new<Renoir_Reflect_Texture>();
+	self->images = mn::buf_new<Renoir_Reflect_Texture>();
+
+	_renoir_gl450_reflect_blocks(self, program, GL_UNIFORM_BLOCK, GL_UNIFORM, self->uniform_blocks);
+	_renoir_gl450_reflect_blocks(self, program, GL_SHADER_STORAGE_BLOCK, GL_BUFFER_VARIABLE, self->storage_blocks);
+
+	// members are pushed in block order (uniform blocks then storage blocks) so we can fix their pointers now
+	// that the members buffer will not grow anymore
+	size_t members_offset = 0;
+	for (auto& block: self->uniform_blocks)
 	{
-		renoir_gl450_context_window_init(self->ctx, command->swapchain_new.handle, &self->settings);
-		assert(_renoir_gl450_check());
-		break;
+		block.members = self->members.ptr + members_offset;
+		members_offset += block.members_count;
 	}
-	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+	for (auto& block: self->storage_blocks)
 	{
-		auto h = command->swapchain_free.handle;
-		if (_renoir_gl450_handle_unref(h) == false)
-			break;
-		renoir_gl450_context_window_free(self->ctx, h);
-		assert(_renoir_gl450_check());
-		_renoir_gl450_handle_free(self, h);
-		break;
+		block.members = self->members.ptr + members_offset;
+		members_offset += block.members_count;
 	}
-	case RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW:
+
+	// textures are the uniforms which doesn't belong to any block
+	GLint uniforms_count = 0;
+	glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniforms_count);
+	for (GLint i = 0; i < uniforms_count; ++i)
 	{
-		// do nothing
-		assert(_renoir_gl450_check());
-		break;
+		const GLenum uniform_props[] = {GL_BLOCK_INDEX, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE};
+		GLint uniform_values[4] = {};
+		glGetProgramResourceiv(program, GL_UNIFORM, i, 4, uniform_props, 4, nullptr, uniform_values);
+		if (uniform_values[0] != -1)
+			continue;
+
+		auto is_sampler = _renoir_gl450_type_is_sampler(uniform_values[1]);
+		auto is_image = _renoir_gl450_type_is_image(uniform_values[1]);
+		if (is_sampler == false && is_image == false)
+			continue;
+
+		Renoir_Reflect_Texture texture{};
+		texture.name = _renoir_gl450_reflect_name(self, program, GL_UNIFORM, i);
+		texture.array_size = uniform_values[3];
+		glGetUniformiv(program, uniform_values[2], &texture.binding);
+		if (is_sampler)
+			mn::buf_push(self->samplers, texture);
+		else
+			mn::buf_push(self->images, texture);
 	}
-	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW:
+
+	if (compute)
+		glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, self->workgroup_size);
+
+	return self;
+}
+
+inline static void
+_renoir_gl450_reflect_free(Renoir_GL450_Reflect* self)
+{
+	if (self == nullptr)
+		return;
+
+	for (auto& name: self->names)
+		mn::str_free(name);
+	mn::buf_free(self->names);
+	mn::buf_free(self->members);
+	mn::buf_free(self->uniform_blocks);
+	mn::buf_free(self->storage_blocks);
+	mn::buf_free(self->samplers);
+	mn::buf_free(self->images);
+	mn::free(self);
+}
+
+inline static Renoir_Reflect
+_renoir_gl450_reflect_desc(Renoir_GL450_Reflect* self)
+{
+	Renoir_Reflect res{};
+	res.uniform_blocks = self->uniform_blocks.ptr;
+	res.uniform_blocks_count = (int)self->uniform_blocks.count;
+	res.storage_blocks = self->storage_blocks.ptr;
+	res.storage_blocks_count = (int)self->storage_blocks.count;
+	res.samplers = self->samplers.ptr;
+	res.samplers_count = (int)self->samplers.count;
+	res.images = self->images.ptr;
+	res.images_count = (int)self->images.count;
+	res.workgroup_size[0] = self->workgroup_size[0];
+	res.workgroup_size[1] = self->workgroup_size[1];
+	res.workgroup_size[2] = self->workgroup_size[2];
+	return res;
+}
+
+inline static bool
+_renoir_gl450_spirv_has_constant(const Renoir_Shader_Blob& blob, uint32_t constant_id)
+{
+	constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+	constexpr uint32_t SPIRV_HEADER_WORDS = 5;
+	constexpr uint32_t SPIRV_OP_DECORATE = 71;
+	constexpr uint32_t SPIRV_DECORATION_SPEC_ID = 1;
+
+	auto words = (const uint32_t*)blob.bytes;
+	auto words_count = blob.size / sizeof(uint32_t);
+	if (words_count < SPIRV_HEADER_WORDS || words[0] != SPIRV_MAGIC)
+		return false;
+
+	// each instruction starts with a word containing its word count in the high 16 bits and its opcode in the low 16 bits
+	// we look for OpDecorate %target SpecId constant_id
+	for (size_t i = SPIRV_HEADER_WORDS; i < words_count;)
 	{
-		auto h = command->pass_offscreen_new.handle;
-		auto& desc = command->pass_offscreen_new.desc;
+		auto opcode = words[i] & 0xFFFF;
+		auto instruction_words_count = words[i] >> 16;
+		if (instruction_words_count == 0)
+			break;
 
-		int msaa = -1;
+		if (opcode == SPIRV_OP_DECORATE &&
+			instruction_words_count >= 4 &&
+			i + 3 < words_count &&
+			words[i + 2] == SPIRV_DECORATION_SPEC_ID &&
+			words[i + 3] == constant_id)
+		{
+			return true;
+		}
+		i += instruction_words_count;
+	}
+	return false;
+}
 
-		glCreateFramebuffers(1, &h->raster_pass.fb);
-		// we want to initialize this to GL_NONE which is 0 so this initialization is safe
-		GLenum attachments[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE] = {};
-		for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+// compiles the given shader blob, in case of failure it will write the error log into the provided error buffer and return 0
+inline static GLuint
+_renoir_gl450_shader_new(
+	GLenum type,
+	const Renoir_Shader_Blob& blob,
+	RENOIR_SHADER_FORMAT format,
+	const Renoir_Shader_Constant* constants,
+	int constants_count,
+	char* error,
+	GLsizei error_length)
+{
+	auto shader = glCreateShader(type);
+	if (format == RENOIR_SHADER_FORMAT_SPIRV)
+	{
+		// glSpecializeShader will fail if we pass constants which are not declared in this stage's module
+		GLuint constants_index[RENOIR_CONSTANT_SHADER_CONSTANT_SIZE];
+		GLuint constants_value[RENOIR_CONSTANT_SHADER_CONSTANT_SIZE];
+		GLuint stage_constants_count = 0;
+		for (int i = 0; i < constants_count; ++i)
 		{
-			auto color = (Renoir_Handle*)desc.color[i].texture.handle;
-			if (color == nullptr)
+			if (_renoir_gl450_spirv_has_constant(blob, constants[i].id) == false)
 				continue;
-			assert(color->texture.desc.render_target);
-			attachments[i] = GL_COLOR_ATTACHMENT0 + i;
+			constants_index[stage_constants_count] = constants[i].id;
+			constants_value[stage_constants_count] = constants[i].value;
+			++stage_constants_count;
+		}
 
-			_renoir_gl450_handle_ref(color);
-			if (color->texture.desc.cube_map == false)
-			{
-				if (color->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
-				{
-					assert(desc.color[i].level == 0 && "multisampled textures does not support mipmaps");
-					glNamedFramebufferRenderbuffer(h->raster_pass.fb, GL_COLOR_ATTACHMENT0+i,  GL_RENDERBUFFER, color->texture.render_buffer[0]);
-				}
-				else
-				{
-					assert(desc.color[i].level < color->texture.desc.mipmaps && "out of range mip level");
-					glNamedFramebufferTexture(h->raster_pass.fb, GL_COLOR_ATTACHMENT0+i, color->texture.id, desc.color[i].level);
-				}
+		glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, blob.bytes, (GLsizei)blob.size);
+		// specialization failures are reported through the compile status like compile errors
+		glSpecializeShader(shader, "main", stage_constants_count, constants_index, constants_value);
+	}
+	else
+	{
+		GLint size = (GLint)blob.size;
+		glShaderSource(shader, 1, &blob.bytes, &size);
+		glCompileShader(shader);
+	}
+
+	GLint success = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (success == GL_FALSE)
+	{
+		::memset(error, 0, error_length);
+		glGetShaderInfoLog(shader, error_length, nullptr, error);
+		// some drivers leave the info log empty when the SPIR-V specialization fails
+		if (error[0] == '\0' && format == RENOIR_SHADER_FORMAT_SPIRV)
+			::strncpy(error, "SPIR-V specialization failed, check the entry point and the specialization constants", error_length - 1);
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+// SPIR-V blobs are binary so their size can't be deduced with strlen, and the module is made of 32-bit words
+inline static bool
+_renoir_gl450_spirv_blob_valid(const Renoir_Shader_Blob& blob)
+{
+	return blob.size > 0 && blob.size % 4 == 0;
+}
+
+inline static bool
+_renoir_gl450_spirv_supported()
+{
+	return GLEW_VERSION_4_6 || GLEW_ARB_gl_spirv;
+}
+
+inline static GLuint
+_renoir_gl450_profiler_query_get(IRenoir* self)
+{
+	auto& profiler = self->profiler;
+	if (profiler.free_queries.count > 0)
+	{
+		auto query = mn::buf_top(profiler.free_queries);
+		mn::buf_pop(profiler.free_queries);
+		return query;
+	}
+
+	GLuint query = 0;
+	glGenQueries(1, &query);
+	return query;
+}
+
+// takes ownership of the given name
+static void
+_renoir_gl450_profiler_scope_push(IRenoir* self, Renoir_Handle* pass, mn::Str name)
+{
+	auto& frame = self->profiler.frames[self->profiler.frame];
+
+	Renoir_GL450_Profiler_Scope scope{};
+	scope.name = name;
+	scope.pass = pass;
+	scope.depth = int(frame.stack.count);
+	scope.timepoints[0] = _renoir_gl450_profiler_query_get(self);
+	scope.timepoints[1] = _renoir_gl450_profiler_query_get(self);
+	glQueryCounter(scope.timepoints[0], GL_TIMESTAMP);
+
+	mn::buf_push(frame.stack, frame.scopes.count);
+	mn::buf_push(frame.scopes, scope);
+}
+
+static void
+_renoir_gl450_profiler_scope_pop(IRenoir* self)
+{
+	auto& frame = self->profiler.frames[self->profiler.frame];
+	if (frame.stack.count == 0)
+	{
+		mn::log_warning("gl450: profiler scope end without a matching scope begin");
+		return;
+	}
+
+	auto& scope = frame.scopes[mn::buf_top(frame.stack)];
+	mn::buf_pop(frame.stack);
+	glQueryCounter(scope.timepoints[1], GL_TIMESTAMP);
+	frame.last_query = scope.timepoints[1];
+}
+
+// returns the scopes names and queries back to the pool, queries can be reused even if they are still in flight
+static void
+_renoir_gl450_profiler_frame_reset(IRenoir* self, Renoir_GL450_Profiler_Frame& frame)
+{
+	for (auto& scope: frame.scopes)
+	{
+		mn::str_free(scope.name);
+		mn::buf_push(self->profiler.free_queries, scope.timepoints[0]);
+		mn::buf_push(self->profiler.free_queries, scope.timepoints[1]);
+	}
+	mn::buf_clear(frame.scopes);
+	mn::buf_clear(frame.stack);
+	frame.last_query = 0;
+	frame.pending = false;
+}
+
+static void
+_renoir_gl450_profiler_frame_collect(IRenoir* self, Renoir_GL450_Profiler_Frame& frame)
+{
+	auto& profiler = self->profiler;
+
+	GLint result_available = 0;
+	glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &result_available);
+	if (result_available == 0)
+		return;
+
+	for (auto& name: profiler.results_names)
+		mn::str_free(name);
+	mn::buf_clear(profiler.results_names);
+	mn::buf_clear(profiler.results);
+
+	GLuint64 frame_begin = 0;
+	for (size_t i = 0; i < frame.scopes.count; ++i)
+	{
+		auto& scope = frame.scopes[i];
+
+		GLuint64 timepoint[2];
+		glGetQueryObjectui64v(scope.timepoints[0], GL_QUERY_RESULT, &timepoint[0]);
+		glGetQueryObjectui64v(scope.timepoints[1], GL_QUERY_RESULT, &timepoint[1]);
+		if (i == 0)
+			frame_begin = timepoint[0];
+
+		_renoir_gl450_trace_gpu_event(self, scope.name.ptr, timepoint[0], timepoint[1] - timepoint[0], scope.depth);
+
+		Renoir_Profiler_Scope result{};
+		result.pass = Renoir_Pass{_renoir_gl450_handle_public(scope.pass)};
+		result.depth = scope.depth;
+		result.begin_time_in_nanos = timepoint[0] - frame_begin;
+		result.elapsed_time_in_nanos = timepoint[1] - timepoint[0];
+		mn::buf_push(profiler.results, result);
+
+		// move the name to the results
+		mn::buf_push(profiler.results_names, scope.name);
+		scope.name = mn::Str{};
+	}
+	for (size_t i = 0; i < profiler.results.count; ++i)
+		profiler.results[i].name = profiler.results_names[i].ptr;
+
+	profiler.has_results = true;
+	profiler.results_frame_index = frame.index;
+	_renoir_gl450_profiler_frame_reset(self, frame);
+}
+
+// the pooled and in flight queries are deleted in one batch like the retired handles, so the context should be bound
+static void
+_renoir_gl450_profiler_free(IRenoir* self)
+{
+	auto& profiler = self->profiler;
+	for (auto& frame: profiler.frames)
+	{
+		_renoir_gl450_profiler_frame_reset(self, frame);
+		mn::buf_free(frame.scopes);
+		mn::buf_free(frame.stack);
+	}
+	if (self->glewInited && profiler.free_queries.count > 0)
+	{
+		glDeleteQueries(GLsizei(profiler.free_queries.count), profiler.free_queries.ptr);
+		assert(_renoir_gl450_check());
+	}
+	mn::buf_free(profiler.free_queries);
+	mn::destruct(profiler.results_names);
+	mn::buf_free(profiler.results);
+}
+
+static void
+_renoir_gl450_stats_command(IRenoir* self, Renoir_Command* command)
+{
+	auto& stats = self->stats;
+	++stats.commands[command->kind];
+
+	switch (command->kind)
+	{
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+		if (command->buffer_new.desc.data)
+			stats.bytes_uploaded += command->buffer_new.desc.data_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+		for (auto data: command->texture_new.desc.data)
+		{
+			if (data)
+				stats.bytes_uploaded += command->texture_new.desc.data_size;
+		}
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+		stats.bytes_uploaded += command->buffer_write.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+		stats.bytes_uploaded += command->texture_write.desc.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+		stats.bytes_uploaded += command->uniform_write.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+		stats.bytes_read += command->buffer_read.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+		stats.bytes_read += command->texture_read.desc.bytes_size;
+		break;
+	default:
+		// do nothing
+		break;
+	}
+}
+
+inline static void
+_renoir_gl450_capture_write(IRenoir* self, const void* data, size_t size)
+{
+	auto& record = self->capture.record;
+	auto offset = record.count;
+	mn::buf_resize(record, offset + size);
+	::memcpy(record.ptr + offset, data, size);
+}
+
+template<typename T>
+inline static void
+_renoir_gl450_capture_write(IRenoir* self, const T& value)
+{
+	_renoir_gl450_capture_write(self, &value, sizeof(value));
+}
+
+inline static void
+_renoir_gl450_capture_write_id(IRenoir* self, Renoir_Handle* h)
+{
+	_renoir_gl450_capture_write(self, uint64_t(h ? h->id.load() : 0));
+}
+
+inline static void
+_renoir_gl450_capture_begin(IRenoir* self)
+{
+	mn::buf_clear(self->capture.record);
+}
+
+static void
+_renoir_gl450_capture_end(IRenoir* self, RENOIR_CAPTURE kind)
+{
+	auto& capture = self->capture;
+	Renoir_Capture_Record header{};
+	header.kind = kind;
+	header.size = uint32_t(capture.record.count);
+	::fwrite(&header, sizeof(header), 1, capture.file);
+	if (capture.record.count > 0)
+		::fwrite(capture.record.ptr, 1, capture.record.count, capture.file);
+}
+
+// writes a record which only contains the id of the given handle
+static void
+_renoir_gl450_capture_handle(IRenoir* self, RENOIR_CAPTURE kind, Renoir_Handle* h)
+{
+	_renoir_gl450_capture_begin(self);
+	_renoir_gl450_capture_write_id(self, h);
+	_renoir_gl450_capture_end(self, kind);
+}
+
+// free records are only written when the handle is actually freed, refs taken by the user or by passes are replayed
+// by the same api calls so the replay ends up with the same reference counts
+inline static void
+_renoir_gl450_capture_handle_free(IRenoir* self, RENOIR_CAPTURE kind, Renoir_Handle* h)
+{
+	if (h->rc.load() == 1)
+		_renoir_gl450_capture_handle(self, kind, h);
+}
+
+static void
+_renoir_gl450_capture_frame(IRenoir* self, Renoir_Handle* swapchain)
+{
+	if (self->capture.file == nullptr)
+		return;
+
+	_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_FRAME, swapchain);
+	::fflush(self->capture.file);
+}
+
+// serializes the command into the capture file, it's called before the command executes so we capture the
+// commands in execution order regardless of the defer_api_calls setting
+static void
+_renoir_gl450_capture_command(IRenoir* self, Renoir_Command* command)
+{
+	if (self->capture.file == nullptr)
+		return;
+
+	switch (command->kind)
+	{
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW:
+	{
+		auto h = command->swapchain_new.handle;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, h);
+		_renoir_gl450_capture_write(self, int32_t(h->swapchain.width));
+		_renoir_gl450_capture_write(self, int32_t(h->swapchain.height));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_SWAPCHAIN_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_SWAPCHAIN_FREE, command->swapchain_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW:
+	{
+		auto h = command->pass_swapchain_new.handle;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, h);
+		_renoir_gl450_capture_write_id(self, h->raster_pass.swapchain);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_PASS_SWAPCHAIN_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->pass_offscreen_new.handle);
+		_renoir_gl450_capture_write(self, command->pass_offscreen_new.desc);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_PASS_OFFSCREEN_NEW);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_PASS_COMPUTE_NEW, command->pass_compute_new.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_PASS_FREE, command->pass_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+	{
+		auto desc = command->buffer_new.desc;
+		desc.data = desc.data ? (void*)1 : nullptr;
+		desc.tag = nullptr;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->buffer_new.handle);
+		_renoir_gl450_capture_write(self, desc);
+		if (desc.data)
+			_renoir_gl450_capture_write(self, command->buffer_new.desc.data, desc.data_size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_BUFFER_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_BUFFER_FREE, command->buffer_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+	{
+		auto desc = command->texture_new.desc;
+		for (auto& data: desc.data)
+			data = data ? (void*)1 : nullptr;
+		desc.tag = nullptr;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->texture_new.handle);
+		_renoir_gl450_capture_write(self, desc);
+		for (auto data: command->texture_new.desc.data)
+		{
+			if (data)
+				_renoir_gl450_capture_write(self, data, desc.data_size);
+		}
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_TEXTURE_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_TEXTURE_FREE, command->texture_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PROGRAM_NEW:
+	{
+		auto& desc = command->program_new.desc;
+		auto captured_desc = desc;
+		captured_desc.vertex.bytes = (const char*)1;
+		captured_desc.pixel.bytes = (const char*)1;
+		captured_desc.geometry.bytes = desc.geometry.bytes ? (const char*)1 : nullptr;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->program_new.handle);
+		_renoir_gl450_capture_write(self, captured_desc);
+		_renoir_gl450_capture_write(self, desc.vertex.bytes, desc.vertex.size);
+		_renoir_gl450_capture_write(self, desc.pixel.bytes, desc.pixel.size);
+		if (desc.geometry.bytes)
+			_renoir_gl450_capture_write(self, desc.geometry.bytes, desc.geometry.size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_PROGRAM_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_PROGRAM_FREE, command->program_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_COMPUTE_NEW:
+	{
+		auto& desc = command->compute_new.desc;
+		auto captured_desc = desc;
+		captured_desc.compute.bytes = (const char*)1;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->compute_new.handle);
+		_renoir_gl450_capture_write(self, captured_desc);
+		_renoir_gl450_capture_write(self, desc.compute.bytes, desc.compute.size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_COMPUTE_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_COMPUTE_FREE, command->compute_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TIMER_NEW:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_TIMER_NEW, command->timer_new.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TIMER_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_TIMER_FREE, command->timer_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_QUERY_NEW:
+	{
+		auto h = command->query_new.handle;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, h);
+		_renoir_gl450_capture_write(self, int32_t(h->query.kind));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_QUERY_NEW);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+		_renoir_gl450_capture_handle_free(self, RENOIR_CAPTURE_QUERY_FREE, command->query_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_BEGIN:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_PASS_BEGIN, command->pass_begin.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_END:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_PASS_END, command->pass_end.handle);
+		break;
+	case RENOIR_COMMAND_KIND_PASS_CLEAR:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, command->pass_clear.desc);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_PASS_CLEAR);
+		break;
+	case RENOIR_COMMAND_KIND_USE_PIPELINE:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, command->use_pipeline.pipeline_desc);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_USE_PIPELINE);
+		break;
+	case RENOIR_COMMAND_KIND_USE_PROGRAM:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_USE_PROGRAM, command->use_program.program);
+		break;
+	case RENOIR_COMMAND_KIND_USE_COMPUTE:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_USE_COMPUTE, command->use_compute.compute);
+		break;
+	case RENOIR_COMMAND_KIND_SCISSOR:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, int32_t(command->scissor.x));
+		_renoir_gl450_capture_write(self, int32_t(command->scissor.y));
+		_renoir_gl450_capture_write(self, int32_t(command->scissor.w));
+		_renoir_gl450_capture_write(self, int32_t(command->scissor.h));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_SCISSOR);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_BUFFER_CLEAR, command->buffer_clear.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->buffer_write.handle);
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_write.offset));
+		_renoir_gl450_capture_write(self, command->buffer_write.bytes, command->buffer_write.bytes_size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_BUFFER_WRITE);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->buffer_copy.dst);
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_copy.dst_offset));
+		_renoir_gl450_capture_write_id(self, command->buffer_copy.src);
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_copy.src_offset));
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_copy.size));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_BUFFER_COPY);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+	{
+		auto desc = command->texture_write.desc;
+		desc.bytes = (void*)1;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->texture_write.handle);
+		_renoir_gl450_capture_write(self, desc);
+		_renoir_gl450_capture_write(self, command->texture_write.desc.bytes, desc.bytes_size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_TEXTURE_WRITE);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->buffer_bind.handle);
+		_renoir_gl450_capture_write(self, int32_t(command->buffer_bind.shader));
+		_renoir_gl450_capture_write(self, int32_t(command->buffer_bind.slot));
+		_renoir_gl450_capture_write(self, int32_t(command->buffer_bind.gpu_access));
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_bind.offset));
+		_renoir_gl450_capture_write(self, uint64_t(command->buffer_bind.size));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_BUFFER_BIND);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+	{
+		Renoir_Buffer_Storage_Bind_Desc desc{};
+		for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
+		{
+			desc.buffers[i].handle = _renoir_gl450_handle_public(command->buffer_storage_bind.handle[i]);
+			desc.offsets[i] = command->buffer_storage_bind.offsets[i];
+			desc.sizes[i] = command->buffer_storage_bind.sizes[i];
+		}
+		desc.start_slot = command->buffer_storage_bind.start_slot;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, desc);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_BUFFER_STORAGE_BIND);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+	{
+		auto sampler = command->texture_bind.sampler;
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->texture_bind.handle);
+		_renoir_gl450_capture_write(self, int32_t(command->texture_bind.shader));
+		_renoir_gl450_capture_write(self, int32_t(command->texture_bind.slot));
+		_renoir_gl450_capture_write(self, int32_t(command->texture_bind.level));
+		_renoir_gl450_capture_write(self, int32_t(command->texture_bind.gpu_access));
+		_renoir_gl450_capture_write(self, int32_t(sampler != nullptr));
+		_renoir_gl450_capture_write(self, sampler ? sampler->sampler.desc : Renoir_Sampler_Desc{});
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_TEXTURE_BIND);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_DRAW:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, command->draw.desc);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_DRAW);
+		break;
+	case RENOIR_COMMAND_KIND_DISPATCH:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, int32_t(command->dispatch.x));
+		_renoir_gl450_capture_write(self, int32_t(command->dispatch.y));
+		_renoir_gl450_capture_write(self, int32_t(command->dispatch.z));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_DISPATCH);
+		break;
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_MEMORY_BARRIER);
+		break;
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_TIMER_BEGIN, command->timer_begin.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TIMER_END:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_TIMER_END, command->timer_end.handle);
+		break;
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_QUERY_BEGIN, command->query_begin.handle);
+		break;
+	case RENOIR_COMMAND_KIND_QUERY_END:
+		_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_QUERY_END, command->query_end.handle);
+		break;
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write_id(self, command->conditional_begin.handle);
+		_renoir_gl450_capture_write(self, int32_t(command->conditional_begin.wait));
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_CONDITIONAL_BEGIN);
+		break;
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_CONDITIONAL_END);
+		break;
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
+		_renoir_gl450_capture_begin(self);
+		_renoir_gl450_capture_write(self, uint64_t(command->uniform_write.offset));
+		_renoir_gl450_capture_write(self, command->uniform_write.bytes, command->uniform_write.bytes_size);
+		_renoir_gl450_capture_end(self, RENOIR_CAPTURE_UNIFORM_WRITE);
+		break;
+	// the rest of the commands are either internal (init, samplers, uniform ring, profiler) or reads which don't
+	// affect the rendered frame
+	default:
+		break;
+	}
+}
+
+// whether the attachment has a multisampled renderbuffer that gets resolved into its texture at pass_end
+static bool
+_renoir_gl450_attachment_resolves(IRenoir* self, const Renoir_Pass_Attachment& attachment)
+{
+	auto h = _renoir_gl450_handle_get(self, attachment.texture.handle);
+	if (h == nullptr || attachment.store != RENOIR_STORE_RESOLVE)
+		return false;
+	return h->texture.desc.msaa != RENOIR_MSAA_MODE_NONE && h->texture.desc.msaa_sampled == false;
+}
+
+// fills the framebuffer key of the pass attachments, resolve keys only hold the attachments which resolve,
+// returns false if the key has no attachments
+static bool
+_renoir_gl450_framebuffer_key(IRenoir* self, const Renoir_Pass_Offscreen_Desc& desc, bool resolve, Renoir_GL450_Framebuffer_Key& key)
+{
+	// keys are compared with memcmp so we clear the padding as well
+	::memset(&key, 0, sizeof(key));
+	key.resolve = resolve;
+
+	bool empty = true;
+	for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+	{
+		if (desc.color[i].texture.handle == nullptr)
+			continue;
+		if (resolve && _renoir_gl450_attachment_resolves(self, desc.color[i]) == false)
+			continue;
+
+		key.color[i] = _renoir_gl450_handle_get(self, desc.color[i].texture.handle);
+		key.color_level[i] = desc.color[i].level;
+		key.color_subresource[i] = desc.color[i].subresource;
+		empty = false;
+	}
+
+	if (desc.depth_stencil.texture.handle != nullptr &&
+		(resolve == false || _renoir_gl450_attachment_resolves(self, desc.depth_stencil)))
+	{
+		key.depth = _renoir_gl450_handle_get(self, desc.depth_stencil.texture.handle);
+		key.depth_level = desc.depth_stencil.level;
+		key.depth_subresource = desc.depth_stencil.subresource;
+		empty = false;
+	}
+	return empty == false;
+}
+
+static void
+_renoir_gl450_framebuffer_attach(GLuint fb, GLenum attachment, Renoir_Handle* h, int level, int subresource, bool resolve)
+{
+	if (h->texture.desc.msaa != RENOIR_MSAA_MODE_NONE && h->texture.desc.msaa_sampled == false && resolve == false)
+	{
+		assert(level == 0 && "multisampled textures does not support mipmaps");
+		auto render_buffer = h->texture.desc.cube_map ? h->texture.render_buffer[subresource] : h->texture.render_buffer[0];
+		glNamedFramebufferRenderbuffer(fb, attachment, GL_RENDERBUFFER, render_buffer);
+	}
+	else if (h->texture.desc.cube_map == false)
+	{
+		assert(level < h->texture.desc.mipmaps && "out of range mip level");
+		glNamedFramebufferTexture(fb, attachment, h->texture.id, level);
+	}
+	else
+	{
+		assert(level < h->texture.desc.mipmaps && "out of range mip level");
+		glNamedFramebufferTextureLayer(fb, attachment, h->texture.id, level, subresource);
+	}
+}
+
+// returns the framebuffer of the given attachment set, creating it if it's not in the cache
+static GLuint
+_renoir_gl450_framebuffer_get(IRenoir* self, const Renoir_GL450_Framebuffer_Key& key)
+{
+	for (const auto& framebuffer: self->framebuffer_cache)
+	{
+		if (::memcmp(&framebuffer.key, &key, sizeof(key)) == 0)
+		{
+			++self->stats.framebuffer_cache_hits;
+			return framebuffer.fb;
+		}
+	}
+	++self->stats.framebuffer_cache_misses;
+
+	GLuint fb = 0;
+	glCreateFramebuffers(1, &fb);
+	// we want to initialize this to GL_NONE which is 0 so this initialization is safe
+	GLenum attachments[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE] = {};
+	for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+	{
+		if (key.color[i] == nullptr)
+			continue;
+		attachments[i] = GL_COLOR_ATTACHMENT0 + i;
+		_renoir_gl450_framebuffer_attach(fb, attachments[i], key.color[i], key.color_level[i], key.color_subresource[i], key.resolve);
+	}
+	glNamedFramebufferDrawBuffers(fb, RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE, attachments);
+
+	if (key.depth)
+	{
+		auto attachment = _renoir_pixelformat_to_depth_attachment(key.depth->texture.desc.pixel_format);
+		_renoir_gl450_framebuffer_attach(fb, attachment, key.depth, key.depth_level, key.depth_subresource, key.resolve);
+	}
+	assert(_renoir_gl450_check());
+	// completeness is only checked once per attachment set
+	assert(glCheckNamedFramebufferStatus(fb, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+	mn::buf_push(self->framebuffer_cache, Renoir_GL450_Framebuffer{key, fb});
+	_renoir_gl450_memory_counter_update(self->memory.kinds[RENOIR_MEMORY_FRAMEBUFFER], 0, true);
+	return fb;
+}
+
+// removes the framebuffers which use the given texture from the cache, it's called when the texture is freed
+static void
+_renoir_gl450_framebuffer_evict(IRenoir* self, Renoir_Handle* h)
+{
+	for (size_t i = self->framebuffer_cache.count; i > 0; --i)
+	{
+		auto& framebuffer = self->framebuffer_cache[i - 1];
+
+		bool uses_texture = framebuffer.key.depth == h;
+		for (size_t j = 0; j < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++j)
+			uses_texture |= framebuffer.key.color[j] == h;
+
+		if (uses_texture == false)
+			continue;
+
+		glDeleteFramebuffers(1, &framebuffer.fb);
+		mn::buf_remove(self->framebuffer_cache, i - 1);
+		_renoir_gl450_memory_counter_update(self->memory.kinds[RENOIR_MEMORY_FRAMEBUFFER], 0, false);
+	}
+}
+
+// destroys the gl objects of the handles which were freed in the given frame and releases their slots, it's called
+// after the fence of the frame is waited on so the gpu is no longer using them, deletes of the same kind are batched
+static void
+_renoir_gl450_retire_frame(IRenoir* self, int frame)
+{
+	auto& retired = self->pacer.retired[frame];
+	if (retired.count == 0)
+		return;
+
+	Renoir_GL450_Trace_Scope trace_scope{self, "retire_frame"};
+	auto& batch = self->pacer.batch;
+	for (const auto& it: retired)
+	{
+		auto h = it.handle;
+		switch (h->kind)
+		{
+		case RENOIR_HANDLE_KIND_BUFFER:
+			mn::buf_push(batch.buffers, h->buffer.id);
+			break;
+		case RENOIR_HANDLE_KIND_TEXTURE:
+			if (h->texture.desc.render_target)
+				_renoir_gl450_framebuffer_evict(self, h);
+			mn::buf_push(batch.textures, h->texture.id);
+			for (int i = 0; i < 6; ++i)
+			{
+				if (h->texture.render_buffer[i] == 0)
+					continue;
+				mn::buf_push(batch.renderbuffers, h->texture.render_buffer[i]);
 			}
-			else
+			break;
+		case RENOIR_HANDLE_KIND_SAMPLER:
+			mn::buf_push(batch.samplers, h->sampler.id);
+			break;
+		case RENOIR_HANDLE_KIND_PROGRAM:
+			glDeleteProgram(h->program.id);
+			break;
+		case RENOIR_HANDLE_KIND_COMPUTE:
+			glDeleteProgram(h->compute.id);
+			break;
+		case RENOIR_HANDLE_KIND_TIMER:
+			mn::buf_push(batch.queries, h->timer.timepoints[0]);
+			mn::buf_push(batch.queries, h->timer.timepoints[1]);
+			break;
+		case RENOIR_HANDLE_KIND_QUERY:
+			for (auto& ids: h->query.ids)
+				for (int i = 0; i < _renoir_gl450_query_ids_count(h->query.kind); ++i)
+					mn::buf_push(batch.queries, ids[i]);
+			break;
+		default:
+			assert(false && "unexpected retired handle kind");
+			break;
+		}
+	}
+
+	if (batch.buffers.count > 0)
+	{
+		// the buffer names can be reused by the next buffers so we forget the cached vertex array state
+		self->vertex_state = Renoir_GL450_Vertex_State{};
+		glDeleteBuffers(GLsizei(batch.buffers.count), batch.buffers.ptr);
+	}
+	if (batch.textures.count > 0)
+		glDeleteTextures(GLsizei(batch.textures.count), batch.textures.ptr);
+	if (batch.renderbuffers.count > 0)
+		glDeleteRenderbuffers(GLsizei(batch.renderbuffers.count), batch.renderbuffers.ptr);
+	if (batch.samplers.count > 0)
+		glDeleteSamplers(GLsizei(batch.samplers.count), batch.samplers.ptr);
+	if (batch.queries.count > 0)
+		glDeleteQueries(GLsizei(batch.queries.count), batch.queries.ptr);
+
+	for (const auto& it: retired)
+		_renoir_gl450_handle_release(self, it.handle, it.index);
+	self->stats.retired_handles += int(retired.count);
+
+	mn::buf_clear(retired);
+	mn::buf_clear(batch.buffers);
+	mn::buf_clear(batch.textures);
+	mn::buf_clear(batch.renderbuffers);
+	mn::buf_clear(batch.samplers);
+	mn::buf_clear(batch.queries);
+	assert(_renoir_gl450_check());
+}
+
+// creates the gl buffer and uploads its initial data, it's called with either the main context bound or the
+// upload thread's shared context bound (see async_uploads setting)
+static void
+_renoir_gl450_buffer_create(Renoir_Handle* h, const Renoir_Buffer_Desc& desc)
+{
+	if (desc.type == RENOIR_BUFFER_COMPUTE)
+	{
+		assert(
+			desc.compute_buffer_stride > 0 && desc.compute_buffer_stride % 4 == 0 &&
+			"compute buffer stride should be greater than 0, no greater than 2048, and a multiple of 4"
+		);
+	}
+
+	auto gl_usage = _renoir_usage_to_gl(desc.usage);
+
+	glCreateBuffers(1, &h->buffer.id);
+	glNamedBufferData(h->buffer.id, desc.data_size, desc.data, gl_usage);
+}
+
+// same as _renoir_gl450_buffer_create but for textures
+static void
+_renoir_gl450_texture_create(Renoir_Handle* h, const Renoir_Texture_Desc& desc)
+{
+	auto gl_internal_format = _renoir_pixelformat_to_internal_gl(desc.pixel_format);
+	auto gl_format = _renoir_pixelformat_to_gl(desc.pixel_format);
+	auto gl_type = _renoir_pixelformat_to_type_gl(desc.pixel_format);
+
+	// change alignment to match pixel data
+	GLint original_pack_alignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &original_pack_alignment);
+	if (desc.pixel_format == RENOIR_PIXELFORMAT_R8)
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	mn_defer({
+		if (desc.pixel_format == RENOIR_PIXELFORMAT_R8)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, original_pack_alignment);
+	});
+
+	if (desc.size.height == 0 && desc.size.depth == 0)
+	{
+		glCreateTextures(GL_TEXTURE_1D, 1, &h->texture.id);
+		// 1D texture
+		glTextureStorage1D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width);
+		if (desc.data[0] != nullptr)
+		{
+			glTextureSubImage1D(
+				h->texture.id,
+				0,
+				0,
+				desc.size.width,
+				gl_format,
+				gl_type,
+				desc.data[0]
+			);
+			if (h->texture.desc.mipmaps > 1)
+				glGenerateTextureMipmap(h->texture.id);
+		}
+	}
+	else if (desc.size.height > 0 && desc.size.depth == 0)
+	{
+		if (desc.msaa_sampled)
+		{
+			// 2D multisampled texture which is sampled directly so it doesn't need a renderbuffer
+			glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &h->texture.id);
+			glTextureStorage2DMultisample(
+				h->texture.id,
+				(GLsizei)desc.msaa,
+				gl_internal_format,
+				desc.size.width,
+				desc.size.height,
+				GL_TRUE
+			);
+		}
+		else if (desc.cube_map == false)
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &h->texture.id);
+			// 2D texture
+			glTextureStorage2D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height);
+			if (desc.data[0] != nullptr)
 			{
-				if (color->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
-				{
-					assert(desc.color[i].level == 0 && "multisampled textures does not support mipmaps");
-					glNamedFramebufferRenderbuffer(h->raster_pass.fb, GL_COLOR_ATTACHMENT0+i,  GL_RENDERBUFFER, color->texture.render_buffer[desc.color[i].subresource]);
-				}
-				else
+				glTextureSubImage2D(
+					h->texture.id,
+					0,
+					0,
+					0,
+					desc.size.width,
+					desc.size.height,
+					gl_format,
+					gl_type,
+					desc.data[0]
+				);
+				if (h->texture.desc.mipmaps > 1)
+					glGenerateTextureMipmap(h->texture.id);
+			}
+
+			// create renderbuffer to handle msaa
+			if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE)
+			{
+				glCreateRenderbuffers(1, &h->texture.render_buffer[0]);
+				glNamedRenderbufferStorageMultisample(
+					h->texture.render_buffer[0],
+					(GLsizei)desc.msaa,
+					gl_internal_format,
+					desc.size.width,
+					desc.size.height
+				);
+			}
+		}
+		else
+		{
+			glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &h->texture.id);
+			glTextureStorage2D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height);
+			for (size_t i = 0; i < 6; ++i)
+			{
+				if (desc.data[i] == nullptr)
+					continue;
+				glTextureSubImage3D(
+					h->texture.id,
+					0,
+					0,
+					0,
+					i,
+					desc.size.width,
+					desc.size.height,
+					1,
+					gl_format,
+					gl_type,
+					desc.data[i]
+				);
+			}
+
+			// create renderbuffer to handle msaa
+			if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE)
+			{
+				for (int i = 0; i < 6; ++i)
 				{
-					assert(desc.color[i].level < color->texture.desc.mipmaps && "out of range mip level");
-					assert(_renoir_gl450_check());
-					glBindFramebuffer(GL_FRAMEBUFFER, h->raster_pass.fb);
-					glFramebufferTexture2D(
-						GL_FRAMEBUFFER,
-						GL_COLOR_ATTACHMENT0 + i,
-						GL_TEXTURE_CUBE_MAP_POSITIVE_X + desc.color[i].subresource,
-						color->texture.id,
-						desc.color[i].level
+					glCreateRenderbuffers(1, &h->texture.render_buffer[i]);
+					glNamedRenderbufferStorageMultisample(
+						h->texture.render_buffer[i],
+						(GLsizei)desc.msaa,
+						gl_internal_format,
+						desc.size.width,
+						desc.size.height
 					);
-					assert(_renoir_gl450_check());
 				}
 			}
 
+			if (h->texture.desc.mipmaps > 1)
+				glGenerateTextureMipmap(h->texture.id);
+		}
+	}
+	else if (desc.size.height > 0 && desc.size.depth > 0)
+	{
+		glCreateTextures(GL_TEXTURE_3D, 1, &h->texture.id);
+		// 3D texture
+		glTextureStorage3D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height, desc.size.depth);
+		if (desc.data[0] != nullptr)
+		{
+			glTextureSubImage3D(
+				h->texture.id,
+				0,
+				0,
+				0,
+				0,
+				desc.size.width,
+				desc.size.height,
+				desc.size.depth,
+				gl_format,
+				gl_type,
+				desc.data[0]
+			);
+			if (h->texture.desc.mipmaps > 1)
+				glGenerateTextureMipmap(h->texture.id);
+		}
+	}
+}
+
+inline static void
+_renoir_gl450_command_list_push(Renoir_Command*& head, Renoir_Command*& tail, Renoir_Command* command)
+{
+	command->prev = tail;
+	command->next = nullptr;
+	if (tail)
+		tail->next = command;
+	tail = command;
+	if (head == nullptr)
+		head = command;
+}
+
+static void
+_renoir_gl450_upload_main(void* arg)
+{
+	auto self = (IRenoir*)arg;
+	auto& upload = self->upload;
+
+	renoir_gl450_context_bind(upload.ctx);
+
+	mn::mutex_lock(upload.mtx);
+	while (true)
+	{
+		while (upload.pending_list_head == nullptr && upload.stop == false)
+			mn::cond_var_wait(upload.work_cv, upload.mtx);
+
+		// the queue is drained before stopping so every handle is created by the time dispose frees them
+		auto command = upload.pending_list_head;
+		if (command == nullptr)
+			break;
+		upload.pending_list_head = command->next;
+		if (upload.pending_list_head == nullptr)
+			upload.pending_list_tail = nullptr;
+		mn::mutex_unlock(upload.mtx);
+
+		Renoir_Handle* h = nullptr;
+		switch (command->kind)
+		{
+		case RENOIR_COMMAND_KIND_BUFFER_NEW:
+			h = command->buffer_new.handle;
+			_renoir_gl450_buffer_create(h, command->buffer_new.desc);
+			break;
+		case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+			h = command->texture_new.handle;
+			_renoir_gl450_texture_create(h, command->texture_new.desc);
+			break;
+		default:
+			assert(false && "unreachable");
+			break;
+		}
+		assert(_renoir_gl450_check());
+
+		// objects created in a shared context are only safe to use from the other context after the commands
+		// that created them finish, so the fence is waited for here instead of stalling the execution side
+		auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			auto res = glClientWaitSync(fence, flags, 1000000000);
+			if (res != GL_TIMEOUT_EXPIRED)
+			{
+				assert(res != GL_WAIT_FAILED && "glClientWaitSync failed");
+				break;
+			}
+			flags = 0;
+		}
+		glDeleteSync(fence);
+
+		mn::mutex_lock(upload.mtx);
+		_renoir_gl450_command_list_push(upload.done_list_head, upload.done_list_tail, command);
+		h->upload_pending.store(false, std::memory_order_release);
+		mn::cond_var_notify_all(upload.done_cv);
+	}
+	mn::mutex_unlock(upload.mtx);
+
+	renoir_gl450_context_unbind(upload.ctx);
+}
+
+static void
+_renoir_gl450_upload_push(IRenoir* self, Renoir_Handle* h, Renoir_Command* command)
+{
+	h->upload_pending.store(true, std::memory_order_relaxed);
+
+	mn::mutex_lock(self->upload.mtx);
+	_renoir_gl450_command_list_push(self->upload.pending_list_head, self->upload.pending_list_tail, command);
+	mn::cond_var_notify(self->upload.work_cv);
+	mn::mutex_unlock(self->upload.mtx);
+}
+
+static void
+_renoir_gl450_upload_wait(IRenoir* self, Renoir_Handle* h)
+{
+	if (h == nullptr || h->upload_pending.load(std::memory_order_acquire) == false)
+		return;
+
+	Renoir_GL450_Trace_Scope trace_scope{self, "upload_wait"};
+	mn::mutex_lock(self->upload.mtx);
+	while (h->upload_pending.load(std::memory_order_acquire))
+		mn::cond_var_wait(self->upload.done_cv, self->upload.mtx);
+	mn::mutex_unlock(self->upload.mtx);
+}
+
+// waits for the uploads of the handles used by the command, this only blocks if the user didn't check handle_ready
+static void
+_renoir_gl450_upload_wait_command(IRenoir* self, Renoir_Command* command)
+{
+	if (self->upload.ctx == nullptr)
+		return;
+
+	switch (command->kind)
+	{
+	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW:
+	{
+		auto& desc = command->pass_offscreen_new.desc;
+		for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+			_renoir_gl450_upload_wait(self, _renoir_gl450_handle_get(self, desc.color[i].texture.handle));
+		_renoir_gl450_upload_wait(self, _renoir_gl450_handle_get(self, desc.depth_stencil.texture.handle));
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+		_renoir_gl450_upload_wait(self, command->buffer_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE:
+		_renoir_gl450_upload_wait(self, command->texture_free.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+		_renoir_gl450_upload_wait(self, command->buffer_clear.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+		_renoir_gl450_upload_wait(self, command->buffer_write.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+		_renoir_gl450_upload_wait(self, command->buffer_copy.dst);
+		_renoir_gl450_upload_wait(self, command->buffer_copy.src);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+		_renoir_gl450_upload_wait(self, command->texture_write.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+		_renoir_gl450_upload_wait(self, command->buffer_read.handle);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+		_renoir_gl450_upload_wait(self, command->texture_read.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+		_renoir_gl450_upload_wait(self, command->buffer_bind.handle);
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+		for (auto h: command->buffer_storage_bind.handle)
+			_renoir_gl450_upload_wait(self, h);
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+		_renoir_gl450_upload_wait(self, command->texture_bind.handle);
+		break;
+	case RENOIR_COMMAND_KIND_DRAW:
+		for (const auto& vertex: command->draw.desc.vertex_buffers)
+			_renoir_gl450_upload_wait(self, _renoir_gl450_handle_get(self, vertex.buffer.handle));
+		_renoir_gl450_upload_wait(self, _renoir_gl450_handle_get(self, command->draw.desc.index_buffer.handle));
+		break;
+	default:
+		break;
+	}
+}
+
+// stats are counted when the upload is retired and not when it's pushed so bytes_uploaded matches the finished uploads
+static void
+_renoir_gl450_upload_retire(IRenoir* self)
+{
+	if (self->upload.ctx == nullptr)
+		return;
+
+	mn::mutex_lock(self->upload.mtx);
+	auto head = self->upload.done_list_head;
+	self->upload.done_list_head = nullptr;
+	self->upload.done_list_tail = nullptr;
+	mn::mutex_unlock(self->upload.mtx);
+
+	for (auto it = head; it != nullptr;)
+	{
+		auto next = it->next;
+		_renoir_gl450_stats_command(self, it);
+		_renoir_gl450_command_free(self, it);
+		it = next;
+	}
+}
+
+static void
+_renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
+{
+	Renoir_GL450_Trace_Scope trace_scope{self, _renoir_command_kind_name(command->kind)};
+	_renoir_gl450_stats_command(self, command);
+	_renoir_gl450_capture_command(self, command);
+	_renoir_gl450_upload_wait_command(self, command);
+
+	switch(command->kind)
+	{
+	case RENOIR_COMMAND_KIND_INIT:
+	{
+		renoir_gl450_context_bind(self->ctx);
+		if (self->settings.external_context)
+		{
+			// we just need to init glew in case of external context
+			GLenum glew_result = glewInit();
+			assert(glew_result == GLEW_OK && "glewInit failed");
+
+			mn::log_info("OpenGL Renderer: {}", glGetString(GL_RENDERER));
+			mn::log_info("OpenGL Version: {}", glGetString(GL_VERSION));
+			mn::log_info("GLSL Version: {}", glGetString(GL_SHADING_LANGUAGE_VERSION));
+
+			GLint major = 0, minor = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+			mn::log_ensure(major >= 4 && minor >= 5, "incompatibile OpenGL Context");
+			_renoir_gl450_state_capture(self->state);
+		}
+		self->glewInited = true;
+		// During init, enable debug output
+		#if RENOIR_DEBUG_LAYER
+		glEnable(GL_DEBUG_OUTPUT);
+		glDebugMessageCallback(_renoir_gl450_error_log, nullptr);
+		#endif
+
+		glCreateVertexArrays(1, &self->vao);
+
+		// the uniform ring is a single persistently mapped buffer split into a segment per frame in flight
+		auto& ring = self->uniform_ring;
+		GLint uniform_alignment = 0, storage_alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage_alignment);
+		if (uniform_alignment > 0)
+		{
+			ring.alignment = uniform_alignment;
+			self->uniform_offset_alignment = uniform_alignment;
+		}
+		if (storage_alignment > 0)
+			self->storage_offset_alignment = storage_alignment;
+		auto ring_size = ring.segment_size * self->pacer.frames_count;
+		auto ring_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &ring.buffer->buffer.id);
+		glNamedBufferStorage(ring.buffer->buffer.id, ring_size, nullptr, ring_flags);
+		ring.ptr = (uint8_t*)glMapNamedBufferRange(ring.buffer->buffer.id, 0, ring_size, ring_flags);
+		assert(ring.ptr != nullptr && "failed to map uniform ring buffer");
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_NEW:
+	{
+		renoir_gl450_context_window_init(self->ctx, command->swapchain_new.handle, &self->settings);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+	{
+		auto h = command->swapchain_free.handle;
+		if (_renoir_gl450_handle_unref(h) == false)
+			break;
+		renoir_gl450_context_window_free(self->ctx, h);
+		assert(_renoir_gl450_check());
+		_renoir_gl450_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW:
+	{
+		// do nothing
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_OFFSCREEN_NEW:
+	{
+		auto h = command->pass_offscreen_new.handle;
+		auto& desc = command->pass_offscreen_new.desc;
+
+		int msaa = -1;
+		for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+		{
+			auto color = _renoir_gl450_handle_get(self, desc.color[i].texture.handle);
+			if (color == nullptr)
+				continue;
+			assert(color->texture.desc.render_target);
+			_renoir_gl450_handle_ref(color);
+
 			// check that all of them has the same msaa
 			if (msaa == -1)
 			{
@@ -1525,51 +3892,13 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 				assert(msaa == color->texture.desc.msaa);
 			}
 		}
-		glNamedFramebufferDrawBuffers(h->raster_pass.fb, RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE, attachments);
-		assert(_renoir_gl450_check());
 
-		auto depth = (Renoir_Handle*)desc.depth_stencil.texture.handle;
+		auto depth = _renoir_gl450_handle_get(self, desc.depth_stencil.texture.handle);
 		if (depth)
 		{
 			assert(depth->texture.desc.render_target);
 			_renoir_gl450_handle_ref(depth);
 
-			auto attachment = _renoir_pixelformat_to_depth_attachment(depth->texture.desc.pixel_format);
-
-			if (depth->texture.desc.cube_map == false)
-			{
-				if (depth->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
-				{
-					assert(desc.depth_stencil.level == 0 && "multisampled textures does not support mipmaps");
-					glNamedFramebufferRenderbuffer(h->raster_pass.fb, attachment,  GL_RENDERBUFFER, depth->texture.render_buffer[0]);
-				}
-				else
-				{
-					assert(desc.depth_stencil.level < depth->texture.desc.mipmaps && "out of range mip level");
-					glNamedFramebufferTexture(h->raster_pass.fb, attachment, depth->texture.id, desc.depth_stencil.level);
-				}
-			}
-			else
-			{
-				if (depth->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
-				{
-					assert(desc.depth_stencil.level == 0 && "multisampled textures does not support mipmaps");
-					glNamedFramebufferRenderbuffer(h->raster_pass.fb, attachment,  GL_RENDERBUFFER, depth->texture.render_buffer[desc.depth_stencil.subresource]);
-				}
-				else
-				{
-					assert(desc.depth_stencil.level < depth->texture.desc.mipmaps && "out of range mip level");
-					glBindFramebuffer(GL_FRAMEBUFFER, h->raster_pass.fb);
-					glFramebufferTexture2D(
-						GL_FRAMEBUFFER,
-						attachment,
-						GL_TEXTURE_CUBE_MAP_POSITIVE_X + desc.depth_stencil.subresource,
-						depth->texture.id,
-						desc.depth_stencil.level
-					);
-				}
-			}
-
 			// check that all of them has the same msaa
 			if (msaa == -1)
 			{
@@ -1580,8 +3909,16 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 				assert(msaa == depth->texture.desc.msaa);
 			}
 		}
+
+		// framebuffers are cached by attachment set so passes which are created every frame for the same
+		// textures/levels/faces reuse the same framebuffer, the resolve framebuffer holds the resolve textures
+		// at the same attachment points as their renderbuffers so pass_end only switches the draw buffer
+		Renoir_GL450_Framebuffer_Key key;
+		if (_renoir_gl450_framebuffer_key(self, desc, false, key))
+			h->raster_pass.fb = _renoir_gl450_framebuffer_get(self, key);
+		if (_renoir_gl450_framebuffer_key(self, desc, true, key))
+			h->raster_pass.resolve_fb = _renoir_gl450_framebuffer_get(self, key);
 		assert(_renoir_gl450_check());
-		assert(glCheckNamedFramebufferStatus(h->raster_pass.fb, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW:
@@ -1603,218 +3940,64 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			// free all the bound textures if it's a framebuffer pass
 			if (h->raster_pass.fb != 0)
 			{
-				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
-				{
-					auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
-					if (color == nullptr)
-						continue;
-
-					// issue command to free the color texture
-					auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
-					command->texture_free.handle = color;
-					_renoir_gl450_command_process(self, command);
-				}
-
-				auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
-				if (depth)
-				{
-					// issue command to free the depth texture
-					auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
-					command->texture_free.handle = depth;
-					_renoir_gl450_command_process(self, command);
-				}
-
-				glDeleteFramebuffers(1, &h->raster_pass.fb);
-			}
-		}
-		else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
-		{
-			for(auto it = h->compute_pass.command_list_head; it != NULL; it = it->next)
-				_renoir_gl450_command_free(self, command);
-		}
-		else
-		{
-			assert(false && "invalid pass");
-		}
-
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
-		break;
-	}
-	case RENOIR_COMMAND_KIND_BUFFER_NEW:
-	{
-		auto h = command->buffer_new.handle;
-		auto& desc = command->buffer_new.desc;
-
-		if (desc.type == RENOIR_BUFFER_COMPUTE)
-		{
-			assert(
-				desc.compute_buffer_stride > 0 && desc.compute_buffer_stride % 4 == 0 &&
-				"compute buffer stride should be greater than 0, no greater than 2048, and a multiple of 4"
-			);
-		}
-
-		auto gl_usage = _renoir_usage_to_gl(desc.usage);
-
-		renoir_gl450_context_bind(self->ctx);
-		glCreateBuffers(1, &h->buffer.id);
-		glNamedBufferData(h->buffer.id, desc.data_size, desc.data, gl_usage);
-		assert(_renoir_gl450_check());
-		break;
-	}
-	case RENOIR_COMMAND_KIND_BUFFER_FREE:
-	{
-		auto h = command->buffer_free.handle;
-		if (_renoir_gl450_handle_unref(h) == false)
-			break;
-		glDeleteBuffers(1, &h->buffer.id);
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
-		break;
-	}
-	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
-	{
-		auto h = command->texture_new.handle;
-		auto& desc = command->texture_new.desc;
-
-		auto gl_internal_format = _renoir_pixelformat_to_internal_gl(desc.pixel_format);
-		auto gl_format = _renoir_pixelformat_to_gl(desc.pixel_format);
-		auto gl_type = _renoir_pixelformat_to_type_gl(desc.pixel_format);
-
-		// change alignment to match pixel data
-		GLint original_pack_alignment = 0;
-		glGetIntegerv(GL_UNPACK_ALIGNMENT, &original_pack_alignment);
-		if (desc.pixel_format == RENOIR_PIXELFORMAT_R8)
-			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-		mn_defer({
-			if (desc.pixel_format == RENOIR_PIXELFORMAT_R8)
-				glPixelStorei(GL_UNPACK_ALIGNMENT, original_pack_alignment);
-		});
-
-		if (desc.size.height == 0 && desc.size.depth == 0)
-		{
-			glCreateTextures(GL_TEXTURE_1D, 1, &h->texture.id);
-			// 1D texture
-			glTextureStorage1D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width);
-			if (desc.data[0] != nullptr)
-			{
-				glTextureSubImage1D(
-					h->texture.id,
-					0,
-					0,
-					desc.size.width,
-					gl_format,
-					gl_type,
-					desc.data[0]
-				);
-				if (h->texture.desc.mipmaps > 1)
-					glGenerateTextureMipmap(h->texture.id);
-			}
-		}
-		else if (desc.size.height > 0 && desc.size.depth == 0)
-		{
-			if (desc.cube_map == false)
-			{
-				glCreateTextures(GL_TEXTURE_2D, 1, &h->texture.id);
-				// 2D texture
-				glTextureStorage2D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height);
-				if (desc.data[0] != nullptr)
-				{
-					glTextureSubImage2D(
-						h->texture.id,
-						0,
-						0,
-						0,
-						desc.size.width,
-						desc.size.height,
-						gl_format,
-						gl_type,
-						desc.data[0]
-					);
-					if (h->texture.desc.mipmaps > 1)
-						glGenerateTextureMipmap(h->texture.id);
-				}
-
-				// create renderbuffer to handle msaa
-				if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE)
-				{
-					glCreateRenderbuffers(1, &h->texture.render_buffer[0]);
-					glNamedRenderbufferStorageMultisample(
-						h->texture.render_buffer[0],
-						(GLsizei)desc.msaa,
-						gl_internal_format,
-						desc.size.width,
-						desc.size.height
-					);
-				}
-			}
-			else
-			{
-				glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &h->texture.id);
-				glTextureStorage2D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height);
-				for (size_t i = 0; i < 6; ++i)
+				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 				{
-					if (desc.data[i] == nullptr)
+					auto color = _renoir_gl450_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
+					if (color == nullptr)
 						continue;
-					glTextureSubImage3D(
-						h->texture.id,
-						0,
-						0,
-						0,
-						i,
-						desc.size.width,
-						desc.size.height,
-						1,
-						gl_format,
-						gl_type,
-						desc.data[i]
-					);
+
+					// issue command to free the color texture
+					auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+					command->texture_free.handle = color;
+					_renoir_gl450_command_process(self, command);
 				}
 
-				// create renderbuffer to handle msaa
-				if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE)
+				auto depth = _renoir_gl450_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
+				if (depth)
 				{
-					for (int i = 0; i < 6; ++i)
-					{
-						glCreateRenderbuffers(1, &h->texture.render_buffer[i]);
-						glNamedRenderbufferStorageMultisample(
-							h->texture.render_buffer[i],
-							(GLsizei)desc.msaa,
-							gl_internal_format,
-							desc.size.width,
-							desc.size.height
-						);
-					}
+					// issue command to free the depth texture
+					auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+					command->texture_free.handle = depth;
+					_renoir_gl450_command_process(self, command);
 				}
 
-				if (h->texture.desc.mipmaps > 1)
-					glGenerateTextureMipmap(h->texture.id);
+				// the framebuffers are owned by the framebuffer cache
+				h->raster_pass.fb = 0;
+				h->raster_pass.resolve_fb = 0;
 			}
 		}
-		else if (desc.size.height > 0 && desc.size.depth > 0)
+		else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
 		{
-			glCreateTextures(GL_TEXTURE_3D, 1, &h->texture.id);
-			// 3D texture
-			glTextureStorage3D(h->texture.id, h->texture.desc.mipmaps, gl_internal_format, desc.size.width, desc.size.height, desc.size.depth);
-			if (desc.data[0] != nullptr)
-			{
-				glTextureSubImage3D(
-					h->texture.id,
-					0,
-					0,
-					0,
-					0,
-					desc.size.width,
-					desc.size.height,
-					desc.size.depth,
-					gl_format,
-					gl_type,
-					desc.data[0]
-				);
-				if (h->texture.desc.mipmaps > 1)
-					glGenerateTextureMipmap(h->texture.id);
-			}
+			for(auto it = h->compute_pass.command_list_head; it != NULL; it = it->next)
+				_renoir_gl450_command_free(self, command);
 		}
+		else
+		{
+			assert(false && "invalid pass");
+		}
+
+		_renoir_gl450_handle_free(self, h);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+	{
+		renoir_gl450_context_bind(self->ctx);
+		_renoir_gl450_buffer_create(command->buffer_new.handle, command->buffer_new.desc);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+	{
+		auto h = command->buffer_free.handle;
+		if (_renoir_gl450_handle_unref(h) == false)
+			break;
+		_renoir_gl450_handle_retire(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+	{
+		_renoir_gl450_texture_create(command->texture_new.handle, command->texture_new.desc);
 		assert(_renoir_gl450_check());
 		break;
 	}
@@ -1823,16 +4006,7 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->texture_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
-		glDeleteTextures(1, &h->texture.id);
-		for (int i = 0; i < 6; ++i)
-		{
-			if (h->texture.render_buffer[i] == 0)
-				continue;
-
-			glDeleteRenderbuffers(1, &h->texture.render_buffer[i]);
-		}
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
+		_renoir_gl450_handle_retire(self, h);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_SAMPLER_NEW:
@@ -1870,9 +4044,7 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->sampler_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
-		glDeleteSamplers(1, &h->sampler.id);
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
+		_renoir_gl450_handle_retire(self, h);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_PROGRAM_NEW:
@@ -1884,28 +4056,23 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		GLint size = 0;
 		GLint success = 0;
 
-		auto vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-		size = desc.vertex.size;
-		glShaderSource(vertex_shader, 1, &desc.vertex.bytes, &size);
-		glCompileShader(vertex_shader);
-		glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &success);
-		if (success == GL_FALSE)
+		if (desc.format == RENOIR_SHADER_FORMAT_SPIRV && _renoir_gl450_spirv_supported() == false)
+		{
+			mn::log_error("SPIR-V shaders are not supported by the current OpenGL context");
+			break;
+		}
+
+		auto vertex_shader = _renoir_gl450_shader_new(GL_VERTEX_SHADER, desc.vertex, desc.format, desc.constants, desc.constants_count, error, error_length);
+		if (vertex_shader == 0)
 		{
-			::memset(error, 0, sizeof(error));
-			glGetShaderInfoLog(vertex_shader, error_length, &size, error);
 			mn::log_error("vertex shader compile error\n{}", error);
 			break;
 		}
 
-		auto pixel_shader = glCreateShader(GL_FRAGMENT_SHADER);
-		size = desc.pixel.size;
-		glShaderSource(pixel_shader, 1, &desc.pixel.bytes, &size);
-		glCompileShader(pixel_shader);
-		glGetShaderiv(pixel_shader, GL_COMPILE_STATUS, &success);
-		if (success == GL_FALSE)
+		auto pixel_shader = _renoir_gl450_shader_new(GL_FRAGMENT_SHADER, desc.pixel, desc.format, desc.constants, desc.constants_count, error, error_length);
+		if (pixel_shader == 0)
 		{
-			::memset(error, 0, sizeof(error));
-			glGetShaderInfoLog(pixel_shader, error_length, &size, error);
+			glDeleteShader(vertex_shader);
 			mn::log_error("pixel shader compile error\n{}", error);
 			break;
 		}
@@ -1913,16 +4080,12 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		GLuint geometry_shader = 0;
 		if (desc.geometry.bytes != nullptr)
 		{
-			geometry_shader = glCreateShader(GL_GEOMETRY_SHADER);
-			size = desc.geometry.size;
-			glShaderSource(geometry_shader, 1, &desc.geometry.bytes, &size);
-			glCompileShader(geometry_shader);
-			glGetShaderiv(geometry_shader, GL_COMPILE_STATUS, &success);
-			if (success == GL_FALSE)
+			geometry_shader = _renoir_gl450_shader_new(GL_GEOMETRY_SHADER, desc.geometry, desc.format, desc.constants, desc.constants_count, error, error_length);
+			if (geometry_shader == 0)
 			{
-				::memset(error, 0, sizeof(error));
-				glGetShaderInfoLog(geometry_shader, error_length, &size, error);
-				mn::log_error("pixel shader compile error\n{}", error);
+				glDeleteShader(vertex_shader);
+				glDeleteShader(pixel_shader);
+				mn::log_error("geometry shader compile error\n{}", error);
 				break;
 			}
 		}
@@ -1953,6 +4116,8 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			glDeleteShader(geometry_shader);
 		}
 
+		h->program.reflect = _renoir_gl450_reflect_new(h->program.id, false);
+
 		assert(_renoir_gl450_check());
 		break;
 	}
@@ -1961,9 +4126,8 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->program_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
-		glDeleteProgram(h->program.id);
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
+		_renoir_gl450_reflect_free(h->program.reflect);
+		_renoir_gl450_handle_retire(self, h);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_COMPUTE_NEW:
@@ -1975,19 +4139,16 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		GLint size = 0;
 		GLint success = 0;
 
-		auto compute_shader = glCreateShader(GL_COMPUTE_SHADER);
-		size = desc.compute.size;
-		glShaderSource(compute_shader, 1, &desc.compute.bytes, &size);
-		glCompileShader(compute_shader);
-		glGetShaderiv(compute_shader, GL_COMPILE_STATUS, &success);
-		if (success == GL_FALSE)
+		if (desc.format == RENOIR_SHADER_FORMAT_SPIRV && _renoir_gl450_spirv_supported() == false)
 		{
-			glGetShaderiv(compute_shader, GL_INFO_LOG_LENGTH, &size);
-			size = size > error_length ? error_length : size;
-			glGetShaderInfoLog(compute_shader, size, &size, error);
-			mn::panic("compute shader compile error\n{}", error);
+			mn::log_error("SPIR-V shaders are not supported by the current OpenGL context");
+			break;
 		}
 
+		auto compute_shader = _renoir_gl450_shader_new(GL_COMPUTE_SHADER, desc.compute, desc.format, desc.constants, desc.constants_count, error, error_length);
+		if (compute_shader == 0)
+			mn::panic("compute shader compile error\n{}", error);
+
 		h->compute.id = glCreateProgram();
 		glAttachShader(h->compute.id, compute_shader);
 
@@ -2003,6 +4164,8 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 
 		glDetachShader(h->compute.id, compute_shader);
 		glDeleteShader(compute_shader);
+
+		h->compute.reflect = _renoir_gl450_reflect_new(h->compute.id, true);
 		assert(_renoir_gl450_check());
 		break;
 	}
@@ -2011,9 +4174,8 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->compute_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
-		glDeleteProgram(h->compute.id);
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
+		_renoir_gl450_reflect_free(h->compute.reflect);
+		_renoir_gl450_handle_retire(self, h);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_TIMER_NEW:
@@ -2028,9 +4190,7 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->timer_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
-		glDeleteQueries(2, h->timer.timepoints);
-		_renoir_gl450_handle_free(self, h);
-		assert(_renoir_gl450_check());
+		_renoir_gl450_handle_retire(self, h);
 		break;
 	}
 	case RENOIR_COMMAND_KIND_TIMER_ELAPSED:
@@ -2054,6 +4214,79 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		assert(_renoir_gl450_check());
 		break;
 	}
+	case RENOIR_COMMAND_KIND_QUERY_NEW:
+	{
+		auto h = command->query_new.handle;
+		if (h->query.kind == RENOIR_QUERY_PIPELINE_STATISTICS &&
+			(GLEW_VERSION_4_6 || GLEW_ARB_pipeline_statistics_query) == false)
+		{
+			mn::log_error("gl450: pipeline statistics query is not supported, it requires ARB_pipeline_statistics_query extension");
+			break;
+		}
+		for (auto& ids: h->query.ids)
+			glGenQueries(_renoir_gl450_query_ids_count(h->query.kind), ids);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+	{
+		auto h = command->query_free.handle;
+		if (_renoir_gl450_handle_unref(h) == false)
+			break;
+		_renoir_gl450_handle_retire(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_RESULT:
+	{
+		auto h = command->query_result.handle;
+		auto slot = command->query_result.slot;
+		auto& state = h->query.states[slot];
+		auto ids = h->query.ids[slot];
+		assert(state == RENOIR_TIMER_STATE_READ_SCHEDULED);
+		auto count = _renoir_gl450_query_ids_count(h->query.kind);
+
+		// unsupported queries are always ready with zero result
+		if (ids[0] == 0)
+		{
+			h->query.result = Renoir_Query_Result{};
+			state = RENOIR_TIMER_STATE_READY;
+			break;
+		}
+
+		GLint result_available = 0;
+		glGetQueryObjectiv(ids[count - 1], GL_QUERY_RESULT_AVAILABLE, &result_available);
+		if (result_available)
+		{
+			GLuint64 values[RENOIR_GL450_QUERY_STATISTICS_COUNT]{};
+			for (int i = 0; i < count; ++i)
+				glGetQueryObjectui64v(ids[i], GL_QUERY_RESULT, &values[i]);
+
+			auto& result = h->query.result;
+			result = Renoir_Query_Result{};
+			if (h->query.kind == RENOIR_QUERY_PIPELINE_STATISTICS)
+			{
+				result.vertices_submitted = values[0];
+				result.primitives_submitted = values[1];
+				result.vertex_shader_invocations = values[2];
+				result.geometry_shader_invocations = values[3];
+				result.fragment_shader_invocations = values[4];
+				result.compute_shader_invocations = values[5];
+				result.clipping_input_primitives = values[6];
+				result.clipping_output_primitives = values[7];
+			}
+			else
+			{
+				result.samples_passed = values[0];
+			}
+			state = RENOIR_TIMER_STATE_READY;
+		}
+		else
+		{
+			state = RENOIR_TIMER_STATE_END;
+		}
+		assert(_renoir_gl450_check());
+		break;
+	}
 	case RENOIR_COMMAND_KIND_PASS_BEGIN:
 	{
 		auto h = command->pass_begin.handle;
@@ -2075,6 +4308,64 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 				glViewport(0, 0, h->raster_pass.width, h->raster_pass.height);
 				glDisable(GL_SCISSOR_TEST);
 				self->current_pass = h;
+
+				// apply the load actions, the write masks affect the clear as well so they're enabled for the clear and
+				// restored afterwards to keep the state the current pipeline expects
+				GLenum invalidate[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE + 1] = {};
+				GLsizei invalidate_count = 0;
+				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+				{
+					auto& attachment = h->raster_pass.offscreen.color[i];
+					if (attachment.texture.handle == nullptr)
+						continue;
+
+					if (attachment.load == RENOIR_LOAD_CLEAR)
+					{
+						GLboolean color_mask[4] = {};
+						glGetBooleani_v(GL_COLOR_WRITEMASK, GLuint(i), color_mask);
+						glColorMaski(i, true, true, true, true);
+						glClearNamedFramebufferfv(h->raster_pass.fb, GL_COLOR, i, &attachment.clear_color.r);
+						glColorMaski(i, color_mask[0], color_mask[1], color_mask[2], color_mask[3]);
+					}
+					else if (attachment.load == RENOIR_LOAD_DONT_CARE)
+					{
+						invalidate[invalidate_count++] = GL_COLOR_ATTACHMENT0 + i;
+					}
+				}
+
+				auto& depth_attachment = h->raster_pass.offscreen.depth_stencil;
+				if (auto depth = _renoir_gl450_handle_get(self, depth_attachment.texture.handle))
+				{
+					auto attachment = _renoir_pixelformat_to_depth_attachment(depth->texture.desc.pixel_format);
+					if (depth_attachment.load == RENOIR_LOAD_CLEAR)
+					{
+						GLboolean depth_mask = GL_TRUE;
+						glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_mask);
+						glDepthMask(GL_TRUE);
+						if (attachment == GL_DEPTH_STENCIL_ATTACHMENT)
+						{
+							GLint stencil_front_mask = 0, stencil_back_mask = 0;
+							glGetIntegerv(GL_STENCIL_WRITEMASK, &stencil_front_mask);
+							glGetIntegerv(GL_STENCIL_BACK_WRITEMASK, &stencil_back_mask);
+							glStencilMask(0xFFFFFFFF);
+							glClearNamedFramebufferfi(h->raster_pass.fb, GL_DEPTH_STENCIL, 0, depth_attachment.clear_depth, depth_attachment.clear_stencil);
+							glStencilMaskSeparate(GL_FRONT, GLuint(stencil_front_mask));
+							glStencilMaskSeparate(GL_BACK, GLuint(stencil_back_mask));
+						}
+						else
+						{
+							glClearNamedFramebufferfv(h->raster_pass.fb, GL_DEPTH, 0, &depth_attachment.clear_depth);
+						}
+						glDepthMask(depth_mask);
+					}
+					else if (depth_attachment.load == RENOIR_LOAD_DONT_CARE)
+					{
+						invalidate[invalidate_count++] = attachment;
+					}
+				}
+
+				if (invalidate_count > 0)
+					glInvalidateNamedFramebufferData(h->raster_pass.fb, invalidate_count, invalidate);
 			}
 			else
 			{
@@ -2090,6 +4381,12 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		{
 			assert(false && "invalid pass");
 		}
+
+		if (self->settings.profiler)
+		{
+			auto name = h->kind == RENOIR_HANDLE_KIND_RASTER_PASS ? "raster pass" : "compute pass";
+			_renoir_gl450_profiler_scope_push(self, h, mn::str_from_c(name));
+		}
 		assert(_renoir_gl450_check());
 		break;
 	}
@@ -2103,83 +4400,79 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			auto scissor_enabled = glIsEnabled(GL_SCISSOR_TEST);
 			glDisable(GL_SCISSOR_TEST);
 
-			// if this is an off screen view with msaa we'll need to issue a read command to move the data
-			// from renderbuffer to the texture
+			auto& offscreen = h->raster_pass.offscreen;
+
+			// attachments whose pass framebuffer contents are not needed after the pass, we invalidate them after the
+			// resolve, that's RENOIR_STORE_DISCARD attachments and the multisampled renderbuffers of RENOIR_STORE_RESOLVE
+			// attachments, RENOIR_STORE_STORE keeps the samples and doesn't resolve them into the texture
+			GLenum invalidate[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE + 1] = {};
+			GLsizei invalidate_count = 0;
 			for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 			{
-				auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
-				if (color == nullptr)
+				if (offscreen.color[i].texture.handle == nullptr)
 					continue;
+				if (offscreen.color[i].store == RENOIR_STORE_DISCARD || _renoir_gl450_attachment_resolves(self, offscreen.color[i]))
+					invalidate[invalidate_count++] = GL_COLOR_ATTACHMENT0 + i;
+			}
 
-				// only resolve msaa textures
-				if (color->texture.desc.msaa == RENOIR_MSAA_MODE_NONE)
-					continue;
+			auto depth = _renoir_gl450_handle_get(self, offscreen.depth_stencil.texture.handle);
+			auto depth_attachment = depth ? _renoir_pixelformat_to_depth_attachment(depth->texture.desc.pixel_format) : GL_NONE;
+			if (depth && (offscreen.depth_stencil.store == RENOIR_STORE_DISCARD || _renoir_gl450_attachment_resolves(self, offscreen.depth_stencil)))
+				invalidate[invalidate_count++] = depth_attachment;
+
+			// resolve the multisampled renderbuffers into their textures, the blit reads from a single color buffer
+			// so we issue one blit per color attachment and resolve the depth along with the first one
+			if (h->raster_pass.resolve_fb != 0)
+			{
+				auto rect = offscreen.resolve_rect;
+				if (rect.width == 0 || rect.height == 0)
+					rect = Renoir_Rect{0, 0, h->raster_pass.width, h->raster_pass.height};
 
-				if (color->texture.desc.cube_map == false)
+				GLbitfield depth_bits = 0;
+				if (_renoir_gl450_attachment_resolves(self, offscreen.depth_stencil))
 				{
-					glNamedFramebufferTexture(self->msaa_resolve_fb, GL_COLOR_ATTACHMENT0, color->texture.id, 0);
-					glNamedFramebufferDrawBuffer(self->msaa_resolve_fb, GL_COLOR_ATTACHMENT0);
+					depth_bits = GL_DEPTH_BUFFER_BIT;
+					if (depth_attachment == GL_DEPTH_STENCIL_ATTACHMENT)
+						depth_bits |= GL_STENCIL_BUFFER_BIT;
 				}
-				else
+
+				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 				{
-					glBindFramebuffer(GL_FRAMEBUFFER, self->msaa_resolve_fb);
-					glFramebufferTexture2D(
-						GL_FRAMEBUFFER,
-						GL_COLOR_ATTACHMENT0,
-						GL_TEXTURE_CUBE_MAP_POSITIVE_X + h->raster_pass.offscreen.color[i].subresource,
-						color->texture.id,
-						0
+					if (_renoir_gl450_attachment_resolves(self, offscreen.color[i]) == false)
+						continue;
+
+					GLenum draw_buffers[RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE] = {};
+					draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+					glNamedFramebufferDrawBuffers(h->raster_pass.resolve_fb, RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE, draw_buffers);
+					glNamedFramebufferReadBuffer(h->raster_pass.fb, GL_COLOR_ATTACHMENT0 + i);
+					glBlitNamedFramebuffer(
+						h->raster_pass.fb,
+						h->raster_pass.resolve_fb,
+						rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+						rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+						GL_COLOR_BUFFER_BIT | depth_bits,
+						GL_NEAREST
 					);
-					glNamedFramebufferDrawBuffer(self->msaa_resolve_fb, GL_COLOR_ATTACHMENT0);
+					depth_bits = 0;
 				}
 
-				glNamedFramebufferReadBuffer(h->raster_pass.fb, GL_COLOR_ATTACHMENT0 + i);
-				glBlitNamedFramebuffer(
-					h->raster_pass.fb,
-					self->msaa_resolve_fb,
-					0, 0, h->raster_pass.width, h->raster_pass.height,
-					0, 0, h->raster_pass.width, h->raster_pass.height,
-					GL_COLOR_BUFFER_BIT,
-					GL_LINEAR
-				);
-				// clear color attachment
-				glNamedFramebufferTexture(self->msaa_resolve_fb, GL_COLOR_ATTACHMENT0 + i, 0, 0);
-			}
-			assert(_renoir_gl450_check());
-
-			// resolve depth textures as well
-			auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
-			if (depth && depth->texture.desc.msaa != RENOIR_MSAA_MODE_NONE)
-			{
-				auto attachment = _renoir_pixelformat_to_depth_attachment(depth->texture.desc.pixel_format);
-
-				if (depth->texture.desc.cube_map == false)
+				if (depth_bits != 0)
 				{
-					glNamedFramebufferTexture(self->msaa_resolve_fb, attachment, depth->texture.id, 0);
-				}
-				else
-				{
-					glBindFramebuffer(GL_FRAMEBUFFER, self->msaa_resolve_fb);
-					glFramebufferTexture2D(
-						GL_FRAMEBUFFER,
-						attachment,
-						GL_TEXTURE_CUBE_MAP_POSITIVE_X + h->raster_pass.offscreen.depth_stencil.subresource,
-						depth->texture.id,
-						0
+					glBlitNamedFramebuffer(
+						h->raster_pass.fb,
+						h->raster_pass.resolve_fb,
+						rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+						rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+						depth_bits,
+						GL_NEAREST
 					);
 				}
-				glBlitNamedFramebuffer(
-					h->raster_pass.fb,
-					self->msaa_resolve_fb,
-					0, 0, h->raster_pass.width, h->raster_pass.height,
-					0, 0, h->raster_pass.width, h->raster_pass.height,
-					GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT,
-					GL_NEAREST
-				);
-				// clear depth attachment
-				glNamedFramebufferTexture(self->msaa_resolve_fb, attachment, 0, 0);
 			}
 
+			if (invalidate_count > 0)
+				glInvalidateNamedFramebufferData(h->raster_pass.fb, invalidate_count, invalidate);
+			assert(_renoir_gl450_check());
+
 			if (scissor_enabled)
 				glEnable(GL_SCISSOR_TEST);
 			else
@@ -2193,6 +4486,9 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		{
 			assert(false && "invalid pass");
 		}
+		if (self->settings.profiler)
+			_renoir_gl450_profiler_scope_pop(self);
+
 		self->current_pass = nullptr;
 		self->current_pipeline->pipeline.desc = Renoir_Pipeline_Desc{};
 		_renoir_gl450_pipeline_desc_defaults(&self->current_pipeline->pipeline.desc);
@@ -2420,6 +4716,18 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		assert(_renoir_gl450_check());
 		break;
 	}
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+	{
+		glCopyNamedBufferSubData(
+			command->buffer_copy.src->buffer.id,
+			command->buffer_copy.dst->buffer.id,
+			command->buffer_copy.src_offset,
+			command->buffer_copy.dst_offset,
+			command->buffer_copy.size
+		);
+		assert(_renoir_gl450_check());
+		break;
+	}
 	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
 	{
 		auto h = command->texture_write.handle;
@@ -2625,20 +4933,71 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto h = command->buffer_bind.handle;
 		assert(h->buffer.type == RENOIR_BUFFER_UNIFORM || h->buffer.type == RENOIR_BUFFER_COMPUTE);
 		auto gl_type = _renoir_buffer_type_to_gl(h->buffer.type);
-		glBindBufferBase(gl_type, command->buffer_bind.slot, h->buffer.id);
+		if (command->buffer_bind.size > 0)
+		{
+			glBindBufferRange(
+				gl_type,
+				command->buffer_bind.slot,
+				h->buffer.id,
+				command->buffer_bind.offset,
+				command->buffer_bind.size
+			);
+		}
+		else
+		{
+			glBindBufferBase(gl_type, command->buffer_bind.slot, h->buffer.id);
+		}
 		assert(_renoir_gl450_check());
 		break;
 	}
 	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
 	{
+		// we bind all the buffers in a single call if they are contiguous and of the same type
+		GLuint ids[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE]{};
+		GLintptr offsets[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE]{};
+		GLsizeiptr sizes[RENOIR_CONSTANT_BUFFER_STORAGE_SIZE]{};
+		GLenum gl_type = GL_NONE;
+		int count = 0;
+		bool batchable = true;
 		for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
 		{
 			auto h = command->buffer_storage_bind.handle[i];
 			if (h == nullptr)
 				continue;
 
-			auto gl_type = _renoir_buffer_type_to_gl(h->buffer.type);
-			glBindBufferBase(gl_type, command->buffer_storage_bind.start_slot + i, h->buffer.id);
+			auto h_type = _renoir_buffer_type_to_gl(h->buffer.type);
+			if (i != count || (gl_type != GL_NONE && gl_type != h_type))
+				batchable = false;
+
+			gl_type = h_type;
+			ids[i] = h->buffer.id;
+			offsets[i] = command->buffer_storage_bind.offsets[i];
+			sizes[i] = command->buffer_storage_bind.sizes[i];
+			if (sizes[i] == 0)
+				sizes[i] = h->buffer.size - offsets[i];
+			count = i + 1;
+		}
+
+		if (batchable && count > 0)
+		{
+			glBindBuffersRange(gl_type, command->buffer_storage_bind.start_slot, count, ids, offsets, sizes);
+		}
+		else
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				auto h = command->buffer_storage_bind.handle[i];
+				if (h == nullptr)
+					continue;
+
+				glBindBufferRange(
+					_renoir_buffer_type_to_gl(h->buffer.type),
+					command->buffer_storage_bind.start_slot + i,
+					ids[i],
+					offsets[i],
+					sizes[i]
+				);
+			}
 		}
 		assert(_renoir_gl450_check());
 		break;
@@ -2677,7 +5036,12 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			}
 			else if (h->texture.desc.size.height > 0 && h->texture.desc.size.depth == 0)
 			{
-				if (h->texture.desc.cube_map == false)
+				if (h->texture.desc.msaa_sampled)
+				{
+					// 2D multisampled texture
+					glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, h->texture.id);
+				}
+				else if (h->texture.desc.cube_map == false)
 				{
 					// 2D texture
 					glBindTexture(GL_TEXTURE_2D, h->texture.id);
@@ -2705,6 +5069,7 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 		auto& desc = command->draw.desc;
 		glBindVertexArray(self->vao);
 
+		auto& state = self->vertex_state;
 		for (size_t i = 0; i < RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE; ++i)
 		{
 			auto& vertex = desc.vertex_buffers[i];
@@ -2715,7 +5080,16 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			if (vertex.stride == 0)
 				vertex.stride = _renoir_type_to_size(vertex.type);
 
-			auto h = (Renoir_Handle*)vertex.buffer.handle;
+			auto h = _renoir_gl450_handle_get(self, vertex.buffer.handle);
+
+			auto& binding = state.vertex_buffers[i];
+			if (binding.buffer == h->buffer.id &&
+				binding.type == vertex.type &&
+				binding.stride == vertex.stride &&
+				binding.offset == vertex.offset)
+			{
+				continue;
+			}
 
 			glBindBuffer(GL_ARRAY_BUFFER, h->buffer.id);
 
@@ -2730,7 +5104,13 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 				vertex.stride,
 				(void*)vertex.offset
 			);
-			glEnableVertexAttribArray(i);
+			if (binding.buffer == 0)
+				glEnableVertexAttribArray(i);
+
+			binding.buffer = h->buffer.id;
+			binding.type = vertex.type;
+			binding.stride = vertex.stride;
+			binding.offset = vertex.offset;
 		}
 
 		auto gl_primitive = _renoir_primitive_to_gl(desc.primitive);
@@ -2742,59 +5122,205 @@ _renoir_gl450_command_execute(IRenoir* self, Renoir_Command* command)
 			auto gl_index_type = _renoir_type_to_gl(desc.index_type);
 			auto gl_index_type_size = _renoir_type_to_size(desc.index_type);
 
-			auto h = (Renoir_Handle*)desc.index_buffer.handle;
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, h->buffer.id);
+			auto h = _renoir_gl450_handle_get(self, desc.index_buffer.handle);
+			if (state.index_buffer != h->buffer.id)
+			{
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, h->buffer.id);
+				state.index_buffer = h->buffer.id;
+			}
 
 			if (desc.instances_count > 1)
 			{
-				glDrawElementsInstanced(
+				glDrawElementsInstancedBaseVertex(
 					gl_primitive,
 					desc.elements_count,
 					gl_index_type,
 					(void*)(desc.base_element * gl_index_type_size),
-					desc.instances_count
+					desc.instances_count,
+					desc.base_vertex
 				);
 			}
 			else
 			{
-				glDrawElements(
+				glDrawElementsBaseVertex(
 					gl_primitive,
 					desc.elements_count,
 					gl_index_type,
-					(void*)(desc.base_element * gl_index_type_size)
+					(void*)(desc.base_element * gl_index_type_size),
+					desc.base_vertex
 				);
 			}
 		}
 		else
 		{
-			if (desc.instances_count > 1)
-				glDrawArraysInstanced(gl_primitive, desc.base_element, desc.elements_count, desc.instances_count);
-			else
-				glDrawArrays(gl_primitive, desc.base_element, desc.elements_count);
+			if (desc.instances_count > 1)
+				glDrawArraysInstanced(gl_primitive, desc.base_element, desc.elements_count, desc.instances_count);
+			else
+				glDrawArrays(gl_primitive, desc.base_element, desc.elements_count);
+		}
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_DISPATCH:
+	{
+		assert(self->current_compute && "you should use a compute before dispatching it");
+		glDispatchCompute(command->dispatch.x, command->dispatch.y, command->dispatch.z);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER:
+	{
+		glMemoryBarrier(GL_ALL_BARRIER_BITS);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
+	{
+		auto h = command->timer_begin.handle;
+		glQueryCounter(h->timer.timepoints[0], GL_TIMESTAMP);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TIMER_END:
+	{
+		auto h = command->timer_begin.handle;
+		glQueryCounter(h->timer.timepoints[1], GL_TIMESTAMP);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN:
+	{
+		auto h = command->query_begin.handle;
+		auto ids = h->query.ids[command->query_begin.slot];
+		if (ids[0] == 0)
+			break;
+
+		if (h->query.kind == RENOIR_QUERY_PIPELINE_STATISTICS)
+		{
+			for (int i = 0; i < RENOIR_GL450_QUERY_STATISTICS_COUNT; ++i)
+				glBeginQuery(RENOIR_GL450_QUERY_STATISTICS_TARGETS[i], ids[i]);
+		}
+		else
+		{
+			glBeginQuery(_renoir_query_to_gl(h->query.kind), ids[0]);
+		}
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_END:
+	{
+		auto h = command->query_end.handle;
+		if (h->query.ids[command->query_end.slot][0] == 0)
+			break;
+
+		if (h->query.kind == RENOIR_QUERY_PIPELINE_STATISTICS)
+		{
+			for (int i = 0; i < RENOIR_GL450_QUERY_STATISTICS_COUNT; ++i)
+				glEndQuery(RENOIR_GL450_QUERY_STATISTICS_TARGETS[i]);
+		}
+		else
+		{
+			glEndQuery(_renoir_query_to_gl(h->query.kind));
 		}
 		assert(_renoir_gl450_check());
 		break;
 	}
-	case RENOIR_COMMAND_KIND_DISPATCH:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN:
 	{
-		assert(self->current_compute && "you should use a compute before dispatching it");
-		glDispatchCompute(command->dispatch.x, command->dispatch.y, command->dispatch.z);
-		// Note(Moustapha): not sure about this barrier
-		glMemoryBarrier(GL_ALL_BARRIER_BITS);
+		auto h = command->conditional_begin.handle;
+		auto id = h->query.ids[command->conditional_begin.slot][0];
+		glBeginConditionalRender(id, command->conditional_begin.wait ? GL_QUERY_WAIT : GL_QUERY_NO_WAIT);
 		assert(_renoir_gl450_check());
 		break;
 	}
-	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END:
 	{
-		auto h = command->timer_begin.handle;
-		glQueryCounter(h->timer.timepoints[0], GL_TIMESTAMP);
+		glEndConditionalRender();
 		assert(_renoir_gl450_check());
 		break;
 	}
-	case RENOIR_COMMAND_KIND_TIMER_END:
+	case RENOIR_COMMAND_KIND_UNIFORM_WRITE:
 	{
-		auto h = command->timer_begin.handle;
-		glQueryCounter(h->timer.timepoints[1], GL_TIMESTAMP);
+		auto& ring = self->uniform_ring;
+		assert(ring.ptr != nullptr);
+		::memcpy(ring.ptr + command->uniform_write.offset, command->uniform_write.bytes, command->uniform_write.bytes_size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_FRAME_FENCE:
+	{
+		auto& pacer = self->pacer;
+
+		// mark the end of the finished frame
+		auto& finished_fence = pacer.fences[command->frame_fence.finished_frame];
+		if (finished_fence)
+			glDeleteSync(finished_fence);
+		finished_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		// wait for the gpu to finish the oldest frame in flight before we reuse its slot
+		auto& next_fence = pacer.fences[command->frame_fence.next_frame];
+		if (next_fence)
+		{
+			Renoir_GL450_Trace_Scope wait_scope{self, "frame_wait"};
+			auto wait_start = _renoir_gl450_time_in_nanos();
+			GLenum res = GL_TIMEOUT_EXPIRED;
+			while (res != GL_ALREADY_SIGNALED && res != GL_CONDITION_SATISFIED && res != GL_WAIT_FAILED)
+				res = glClientWaitSync(next_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			assert(res != GL_WAIT_FAILED && "failed to wait on frame fence");
+			self->stats.frame_wait_time_in_nanos += _renoir_gl450_time_in_nanos() - wait_start;
+			glDeleteSync(next_fence);
+			next_fence = nullptr;
+		}
+
+		// the gpu is done with the old frame so we can destroy the handles which were freed in it
+		_renoir_gl450_retire_frame(self, command->frame_fence.next_frame);
+		pacer.execute_frame = command->frame_fence.next_frame;
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_BEGIN:
+	{
+		_renoir_gl450_profiler_scope_push(self, command->profiler_scope_begin.pass, command->profiler_scope_begin.name);
+		// the scope now owns the name
+		command->profiler_scope_begin.name = mn::Str{};
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROFILER_SCOPE_END:
+	{
+		_renoir_gl450_profiler_scope_pop(self);
+		assert(_renoir_gl450_check());
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROFILER_FRAME:
+	{
+		auto& profiler = self->profiler;
+
+		auto& current = profiler.frames[profiler.frame];
+		if (current.stack.count > 0)
+			mn::log_warning("gl450: profiler frame ended with {} open scopes", current.stack.count);
+		current.index = profiler.frame_index++;
+		// map the gpu clock to the cpu clock so that gpu events can be shown on the same timeline in the trace
+		if (self->settings.trace)
+		{
+			GLint64 gpu_now = 0;
+			glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+			self->trace.gpu_to_cpu_offset = int64_t(_renoir_gl450_time_in_nanos()) - int64_t(gpu_now);
+		}
+
+		// frames with unbalanced scopes are dropped
+		current.pending = current.last_query != 0 && current.stack.count == 0;
+
+		// collect the completed frames from the oldest to the newest so that the results hold the latest one
+		for (int i = 1; i <= profiler.frames_count; ++i)
+		{
+			auto& frame = profiler.frames[(profiler.frame + i) % profiler.frames_count];
+			if (frame.pending)
+				_renoir_gl450_profiler_frame_collect(self, frame);
+		}
+
+		// if the gpu is still behind we drop the oldest frame instead of blocking on it
+		profiler.frame = (profiler.frame + 1) % profiler.frames_count;
+		_renoir_gl450_profiler_frame_reset(self, profiler.frames[profiler.frame]);
 		assert(_renoir_gl450_check());
 		break;
 	}
@@ -2874,8 +5400,10 @@ _renoir_gl450_sampler_get(IRenoir* self, Renoir_Sampler_Desc desc)
 			self->sampler_cache[index + 1] = self->sampler_cache[index];
 		}
 		self->sampler_cache[0] = res;
+		++self->stats.sampler_cache_hits;
 		return res;
 	}
+	++self->stats.sampler_cache_misses;
 
 	// we didn't find a matching sampler, so create new one
 	size_t sampler_ix = first_empty_ix;
@@ -2891,6 +5419,7 @@ _renoir_gl450_sampler_get(IRenoir* self, Renoir_Sampler_Desc desc)
 		}
 		_renoir_gl450_sampler_free(self, to_be_evicted);
 		mn::log_warning("gl450: sampler evicted");
+		++self->stats.sampler_cache_evictions;
 		sampler_ix = 0;
 	}
 
@@ -2925,7 +5454,7 @@ _renoir_gl450_handle_leak_free(IRenoir* self, Renoir_Command* command)
 			{
 				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 				{
-					auto color = (Renoir_Handle*)h->raster_pass.offscreen.color[i].texture.handle;
+					auto color = _renoir_gl450_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
 					if (color == nullptr)
 						continue;
 
@@ -2935,7 +5464,7 @@ _renoir_gl450_handle_leak_free(IRenoir* self, Renoir_Command* command)
 					_renoir_gl450_handle_leak_free(self, command);
 				}
 
-				auto depth = (Renoir_Handle*)h->raster_pass.offscreen.depth_stencil.texture.handle;
+				auto depth = _renoir_gl450_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
 				if (depth)
 				{
 					// issue command to free the depth texture
@@ -2977,6 +5506,7 @@ _renoir_gl450_handle_leak_free(IRenoir* self, Renoir_Command* command)
 		auto h = command->program_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
+		_renoir_gl450_reflect_free(h->program.reflect);
 		_renoir_gl450_handle_free(self, h);
 		break;
 	}
@@ -2985,6 +5515,7 @@ _renoir_gl450_handle_leak_free(IRenoir* self, Renoir_Command* command)
 		auto h = command->compute_free.handle;
 		if (_renoir_gl450_handle_unref(h) == false)
 			break;
+		_renoir_gl450_reflect_free(h->compute.reflect);
 		_renoir_gl450_handle_free(self, h);
 		break;
 	}
@@ -2996,9 +5527,101 @@ _renoir_gl450_handle_leak_free(IRenoir* self, Renoir_Command* command)
 		_renoir_gl450_handle_free(self, h);
 		break;
 	}
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+	{
+		auto h = command->query_free.handle;
+		if (_renoir_gl450_handle_unref(h) == false)
+			break;
+		_renoir_gl450_handle_free(self, h);
+		break;
+	}
 	}
 }
 
+// moves the uniform ring to the next frame segment, should be called with the mutex locked
+static void
+_renoir_gl450_frame_fence(IRenoir* self)
+{
+	auto& pacer = self->pacer;
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_FRAME_FENCE);
+	command->frame_fence.finished_frame = pacer.frame;
+	pacer.frame = (pacer.frame + 1) % pacer.frames_count;
+	self->uniform_ring.segment_offset = 0;
+	command->frame_fence.next_frame = pacer.frame;
+	_renoir_gl450_command_process(self, command);
+}
+
+// snapshots the per frame stats and resets them, should be called with the mutex locked
+static void
+_renoir_gl450_stats_frame(IRenoir* self)
+{
+	auto& stats = self->stats;
+
+	// the caller holds the mutex, the time it held it so far belongs to the frame which is ending, and the rest of the
+	// hold time is counted in the next frame
+	auto now = _renoir_gl450_time_in_nanos();
+	stats.mutex_hold_time_in_nanos += now - stats.mutex_lock_time_in_nanos;
+	stats.mutex_lock_time_in_nanos = now;
+
+	Renoir_Stats res{};
+	res.frame_index = stats.frame_index++;
+	res.draws = stats.commands[RENOIR_COMMAND_KIND_DRAW];
+	res.dispatches = stats.commands[RENOIR_COMMAND_KIND_DISPATCH];
+	res.state_changes =
+		stats.commands[RENOIR_COMMAND_KIND_PASS_BEGIN] +
+		stats.commands[RENOIR_COMMAND_KIND_USE_PIPELINE] +
+		stats.commands[RENOIR_COMMAND_KIND_USE_PROGRAM] +
+		stats.commands[RENOIR_COMMAND_KIND_USE_COMPUTE] +
+		stats.commands[RENOIR_COMMAND_KIND_SCISSOR] +
+		stats.commands[RENOIR_COMMAND_KIND_BUFFER_BIND] +
+		stats.commands[RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND] +
+		stats.commands[RENOIR_COMMAND_KIND_TEXTURE_BIND] +
+		stats.commands[RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN] +
+		stats.commands[RENOIR_COMMAND_KIND_CONDITIONAL_END];
+	res.bytes_uploaded = stats.bytes_uploaded;
+	res.bytes_read = stats.bytes_read;
+	res.sampler_cache_hits = stats.sampler_cache_hits;
+	res.sampler_cache_misses = stats.sampler_cache_misses;
+	res.sampler_cache_evictions = stats.sampler_cache_evictions;
+	res.framebuffer_cache_hits = stats.framebuffer_cache_hits;
+	res.framebuffer_cache_misses = stats.framebuffer_cache_misses;
+	res.mutex_hold_time_in_nanos = stats.mutex_hold_time_in_nanos;
+	res.frame_wait_time_in_nanos = stats.frame_wait_time_in_nanos;
+	res.retired_handles = stats.retired_handles;
+
+	static_assert(RENOIR_COMMAND_KIND_COUNT <= RENOIR_CONSTANT_STATS_COUNTER_SIZE, "stats counter size is too small");
+	for (int i = 0; i < RENOIR_COMMAND_KIND_COUNT; ++i)
+	{
+		if (stats.commands[i] == 0)
+			continue;
+		res.commands[res.commands_count++] = Renoir_Stats_Counter{_renoir_command_kind_name(RENOIR_COMMAND_KIND(i)), stats.commands[i]};
+	}
+	stats.last_frame = res;
+
+	::memset(stats.commands, 0, sizeof(stats.commands));
+	stats.bytes_uploaded = 0;
+	stats.bytes_read = 0;
+	stats.sampler_cache_hits = 0;
+	stats.sampler_cache_misses = 0;
+	stats.sampler_cache_evictions = 0;
+	stats.framebuffer_cache_hits = 0;
+	stats.framebuffer_cache_misses = 0;
+	stats.mutex_hold_time_in_nanos = 0;
+	stats.frame_wait_time_in_nanos = 0;
+	stats.retired_handles = 0;
+}
+
+// ends the current profiler frame, should be called with the mutex locked
+static void
+_renoir_gl450_profiler_frame(IRenoir* self)
+{
+	if (self->settings.profiler == false)
+		return;
+
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PROFILER_FRAME);
+	_renoir_gl450_command_process(self, command);
+}
+
 // API
 static bool
 _renoir_gl450_init(Renoir* api, Renoir_Settings settings, void* display)
@@ -3010,6 +5633,12 @@ _renoir_gl450_init(Renoir* api, Renoir_Settings settings, void* display)
 		settings.sampler_cache_size = RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE;
 	if (settings.pipeline_cache_size <= 0)
 		settings.pipeline_cache_size = RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE;
+	if (settings.uniform_ring_size == 0)
+		settings.uniform_ring_size = RENOIR_CONSTANT_DEFAULT_UNIFORM_RING_SIZE;
+	if (settings.max_frames_in_flight <= 0)
+		settings.max_frames_in_flight = RENOIR_CONSTANT_DEFAULT_MAX_FRAMES_IN_FLIGHT;
+	if (settings.max_frames_in_flight > RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT)
+		settings.max_frames_in_flight = RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT;
 
 	auto ctx = renoir_gl450_context_new(&settings, display);
 	if (ctx == nullptr && settings.external_context == false)
@@ -3017,18 +5646,98 @@ _renoir_gl450_init(Renoir* api, Renoir_Settings settings, void* display)
 
 	auto self = mn::alloc_zerod<IRenoir>();
 	self->mtx = mn_mutex_new_with_srcloc("renoir gl450");
-	self->handle_pool = mn::pool_new(sizeof(Renoir_Handle), 128);
+	for (auto& table: self->handles)
+		table.free_slots = mn::ring_new<uint32_t>();
 	self->command_pool = mn::pool_new(sizeof(Renoir_Command), 128);
 	self->settings = settings;
 	self->ctx = ctx;
 	self->sampler_cache = mn::buf_new<Renoir_Handle*>();
+	self->framebuffer_cache = mn::buf_new<Renoir_GL450_Framebuffer>();
+	self->transient_pool = _renoir_transient_pool_new();
+	#if RENOIR_LEAK
 	self->alive_handles = mn::map_new<Renoir_Handle*, Renoir_Leak_Info>();
+	#endif
 	mn::buf_resize_fill(self->sampler_cache, self->settings.sampler_cache_size, nullptr);
+	self->memory.tags = mn::buf_new<Renoir_GL450_Memory_Tag>();
+	mn::buf_push(self->memory.tags, Renoir_GL450_Memory_Tag{mn::str_from_c("untagged"), Renoir_Memory_Counter{}});
+
+	static std::atomic<uint64_t> trace_id_generator{1};
+	self->trace.id = trace_id_generator.fetch_add(1);
+	self->trace.mtx = mn_mutex_new_with_srcloc("renoir gl450 trace");
+	self->trace.rings = mn::buf_new<Renoir_GL450_Trace_Ring*>();
+	self->trace.gpu_events = mn::buf_new<Renoir_GL450_Trace_Gpu_Event>();
+	if (self->settings.trace)
+		mn::buf_resize(self->trace.gpu_events, RENOIR_GL450_TRACE_GPU_RING_SIZE);
 
 	self->current_pipeline = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_PIPELINE);
 	self->current_pipeline->pipeline.desc = Renoir_Pipeline_Desc{};
 	_renoir_gl450_pipeline_desc_defaults(&self->current_pipeline->pipeline.desc);
 
+	self->pacer.frames_count = settings.max_frames_in_flight;
+	self->profiler.frames_count = self->pacer.frames_count + 1;
+	for (auto& retired: self->pacer.retired)
+		retired = mn::buf_new<Renoir_GL450_Retired_Handle>();
+	self->pacer.batch.buffers = mn::buf_new<GLuint>();
+	self->pacer.batch.textures = mn::buf_new<GLuint>();
+	self->pacer.batch.renderbuffers = mn::buf_new<GLuint>();
+	self->pacer.batch.samplers = mn::buf_new<GLuint>();
+	self->pacer.batch.queries = mn::buf_new<GLuint>();
+
+	// the actual alignment is queried from the driver at init time, we start with the most conservative one
+	self->uniform_ring.alignment = 256;
+	self->uniform_offset_alignment = 1;
+	self->storage_offset_alignment = 1;
+	self->uniform_ring.segment_size = (settings.uniform_ring_size + 255) & ~size_t(255);
+	self->uniform_ring.buffer = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_BUFFER);
+	self->uniform_ring.buffer->buffer.type = RENOIR_BUFFER_UNIFORM;
+	self->uniform_ring.buffer->buffer.usage = RENOIR_USAGE_DYNAMIC;
+	self->uniform_ring.buffer->buffer.access = RENOIR_ACCESS_WRITE;
+	self->uniform_ring.buffer->buffer.size = self->uniform_ring.segment_size * self->pacer.frames_count;
+	self->uniform_ring.buffer->buffer.memory_tag = _renoir_gl450_memory_tag(self, "uniform_ring");
+	_renoir_gl450_memory_handle(self, self->uniform_ring.buffer, true);
+
+	self->capture.record = mn::buf_new<uint8_t>();
+	if (settings.capture_path)
+	{
+		self->capture.file = ::fopen(settings.capture_path, "wb");
+		if (self->capture.file)
+		{
+			Renoir_Capture_Header header{};
+			header.magic = RENOIR_CAPTURE_MAGIC;
+			header.version = RENOIR_CAPTURE_VERSION;
+			header.pointer_size = sizeof(void*);
+			::fwrite(&header, sizeof(header), 1, self->capture.file);
+			_renoir_gl450_capture_handle(self, RENOIR_CAPTURE_UNIFORM_RING, self->uniform_ring.buffer);
+		}
+		else
+		{
+			mn::log_error("gl450: failed to open capture file '{}'", settings.capture_path);
+		}
+	}
+
+	if (settings.async_uploads)
+	{
+		// captures are written in execution order, uploads finish out of that order so they can't be captured
+		if (settings.capture_path)
+			mn::log_warning("gl450: async uploads are disabled while capturing commands");
+		else if (ctx == nullptr)
+			mn::log_warning("gl450: async uploads are not supported with an external context");
+		else if ((self->upload.ctx = renoir_gl450_context_shared_new(ctx)) == nullptr)
+			mn::log_warning("gl450: failed to create a shared context, async uploads are disabled");
+
+		if (self->upload.ctx)
+		{
+			self->upload.mtx = mn_mutex_new_with_srcloc("renoir gl450 upload");
+			self->upload.work_cv = mn::cond_var_new("renoir gl450 upload work");
+			self->upload.done_cv = mn::cond_var_new("renoir gl450 upload done");
+			self->upload.thread = mn::thread_new(_renoir_gl450_upload_main, self, "renoir gl450 upload");
+		}
+		else
+		{
+			self->settings.async_uploads = false;
+		}
+	}
+
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_INIT);
 	_renoir_gl450_command_process(self, command);
 
@@ -3041,9 +5750,73 @@ static void
 _renoir_gl450_dispose(Renoir* api)
 {
 	auto self = api->ctx;
+	if (self->upload.ctx)
+	{
+		mn::mutex_lock(self->upload.mtx);
+		self->upload.stop = true;
+		mn::cond_var_notify(self->upload.work_cv);
+		mn::mutex_unlock(self->upload.mtx);
+
+		mn::thread_join(self->upload.thread);
+		mn::thread_free(self->upload.thread);
+		_renoir_gl450_upload_retire(self);
+		mn::cond_var_free(self->upload.work_cv);
+		mn::cond_var_free(self->upload.done_cv);
+		mn::mutex_free(self->upload.mtx);
+		renoir_gl450_context_free(self->upload.ctx);
+	}
+
 	// process these commands for frees to give correct leak report
 	for (auto it = self->command_list_head; it != nullptr; it = it->next)
 		_renoir_gl450_handle_leak_free(self, it);
+	// the gl objects owned by the backend are destroyed explicitly because an external context outlives it, so we
+	// retire them with the already retired handles and destroy all of them once the gpu finishes the frames in flight
+	_renoir_gl450_handle_retire(self, self->uniform_ring.buffer);
+	for (const auto& transient: self->transient_pool.textures)
+		_renoir_gl450_handle_retire(self, transient.handle);
+	for (auto h: self->sampler_cache)
+		if (h)
+			_renoir_gl450_handle_retire(self, h);
+	if (self->glewInited)
+	{
+		renoir_gl450_context_bind(self->ctx);
+		for (auto& fence: self->pacer.fences)
+		{
+			if (fence == nullptr)
+				continue;
+			GLenum res = GL_TIMEOUT_EXPIRED;
+			while (res != GL_ALREADY_SIGNALED && res != GL_CONDITION_SATISFIED && res != GL_WAIT_FAILED)
+				res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+		for (int i = 0; i < RENOIR_CONSTANT_MAX_FRAMES_IN_FLIGHT; ++i)
+			_renoir_gl450_retire_frame(self, i);
+		for (const auto& framebuffer: self->framebuffer_cache)
+			glDeleteFramebuffers(1, &framebuffer.fb);
+		glDeleteVertexArrays(1, &self->vao);
+	}
+	else
+	{
+		// nothing was created on the gpu yet
+		for (const auto& retired: self->pacer.retired)
+			for (const auto& it: retired)
+				_renoir_gl450_handle_release(self, it.handle, it.index);
+	}
+	_renoir_gl450_profiler_free(self);
+	size_t leak_count = 0;
+	for (int kind = 0; kind < RENOIR_HANDLE_KIND_COUNT; ++kind)
+	{
+		if (_renoir_handle_kind_should_track(RENOIR_HANDLE_KIND(kind)) == false)
+			continue;
+		auto& table = self->handles[kind];
+		for (uint32_t i = 0; i < table.slots_count; ++i)
+		{
+			auto chunk = table.chunks[i / RENOIR_GL450_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+			if (chunk->handles[i % RENOIR_GL450_HANDLE_CHUNK_SIZE].id != 0)
+				++leak_count;
+		}
+	}
 	#if RENOIR_LEAK
 		for(auto[handle, info]: self->alive_handles)
 		{
@@ -3051,18 +5824,50 @@ _renoir_gl450_dispose(Renoir* api)
 			mn::callstack_print_to(info.callstack, info.callstack_size, mn::file_stderr());
 			::fprintf(stderr, "\n\n");
 		}
-		if (self->alive_handles.count > 0)
-			::fprintf(stderr, "renoir leak count: %zu\n", self->alive_handles.count);
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu\n", leak_count);
 	#else
-		if (self->alive_handles.count > 0)
-			::fprintf(stderr, "renoir leak count: %zu, for callstack turn on 'RENOIR_LEAK' flag\n", self->alive_handles.count);
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu, for callstack turn on 'RENOIR_LEAK' flag\n", leak_count);
 	#endif
 	mn::mutex_free(self->mtx);
 	renoir_gl450_context_free(self->ctx);
-	mn::pool_free(self->handle_pool);
+	for (auto& table: self->handles)
+	{
+		for (auto& chunk: table.chunks)
+			if (auto ptr = chunk.load(std::memory_order_relaxed))
+				mn::free(ptr);
+		mn::ring_free(table.free_slots);
+	}
 	mn::pool_free(self->command_pool);
 	mn::buf_free(self->sampler_cache);
+	mn::buf_free(self->framebuffer_cache);
+	_renoir_transient_pool_free(self->transient_pool);
+	for (auto& retired: self->pacer.retired)
+		mn::buf_free(retired);
+	mn::buf_free(self->pacer.batch.buffers);
+	mn::buf_free(self->pacer.batch.textures);
+	mn::buf_free(self->pacer.batch.renderbuffers);
+	mn::buf_free(self->pacer.batch.samplers);
+	mn::buf_free(self->pacer.batch.queries);
+	#if RENOIR_LEAK
 	mn::map_free(self->alive_handles);
+	#endif
+	for (auto& tag: self->memory.tags)
+		mn::str_free(tag.name);
+	mn::buf_free(self->memory.tags);
+	for (auto ring: self->trace.rings)
+	{
+		mn::free(mn::Block{ring->events, sizeof(Renoir_GL450_Trace_Event) * RENOIR_GL450_TRACE_RING_SIZE});
+		mn::mutex_free(ring->mtx);
+		mn::free(ring);
+	}
+	mn::buf_free(self->trace.rings);
+	mn::buf_free(self->trace.gpu_events);
+	mn::mutex_free(self->trace.mtx);
+	if (self->capture.file)
+		::fclose(self->capture.file);
+	mn::buf_free(self->capture.record);
 	mn::free(self);
 }
 
@@ -3078,29 +5883,117 @@ _renoir_gl450_texture_origin()
 	return RENOIR_TEXTURE_ORIGIN_BOTTOM_LEFT;
 }
 
+static Renoir_Stats
+_renoir_gl450_stats(Renoir* api)
+{
+	auto self = api->ctx;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto& stats = self->stats;
+	auto res = stats.last_frame;
+	res.command_pool_high_water_mark = stats.command_pool_high_water_mark;
+	res.handle_pool_high_water_mark = stats.handle_pool_high_water_mark;
+
+	static_assert(RENOIR_HANDLE_KIND_COUNT <= RENOIR_CONSTANT_STATS_COUNTER_SIZE, "stats counter size is too small");
+	for (int i = 0; i < RENOIR_HANDLE_KIND_COUNT; ++i)
+	{
+		if (stats.live_handles[i] == 0)
+			continue;
+		res.live_handles[res.live_handles_count++] = Renoir_Stats_Counter{_renoir_handle_kind_name(RENOIR_HANDLE_KIND(i)), stats.live_handles[i]};
+	}
+	return res;
+}
+
+static Renoir_Memory_Stats
+_renoir_gl450_memory_stats(Renoir* api)
+{
+	auto self = api->ctx;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto& memory = self->memory;
+
+	Renoir_Memory_Stats res{};
+	res.total = memory.total;
+	res.total.name = "total";
+	for (int i = 0; i < RENOIR_MEMORY_COUNT; ++i)
+	{
+		res.kinds[i] = memory.kinds[i];
+		res.kinds[i].name = _renoir_memory_name(RENOIR_MEMORY(i));
+	}
+	for (const auto& tag: memory.tags)
+	{
+		if (res.tags_count == RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			break;
+		res.tags[res.tags_count] = tag.counter;
+		res.tags[res.tags_count].name = tag.name.ptr;
+		++res.tags_count;
+	}
+	res.device_total_bytes = memory.device_total_bytes;
+	res.device_available_bytes = memory.device_available_bytes;
+	return res;
+}
+
 static void
 _renoir_gl450_handle_ref(Renoir* api, void* handle)
 {
-	auto h = (Renoir_Handle*)handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, handle);
+	if (h == nullptr)
+		return;
 	h->rc.fetch_add(1);
 }
 
+static bool
+_renoir_gl450_handle_ready(Renoir* api, void* handle)
+{
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, handle);
+	// stale handles never become ready, report them as ready so that callers which poll don't spin forever
+	if (h == nullptr)
+		return true;
+	return h->upload_pending.load(std::memory_order_acquire) == false;
+}
+
+// returns all the transient textures to the pool at the end of the frame, and frees the ones which have been
+// unused for a while, it should be called before the frame commands are processed
+static void
+_renoir_gl450_transient_frame(IRenoir* self)
+{
+	_renoir_transient_pool_frame(self->transient_pool, [self](Renoir_Handle* handle) {
+		auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+		command->texture_free.handle = handle;
+		_renoir_gl450_command_process(self, command);
+	});
+}
+
 static void
 _renoir_gl450_flush(Renoir* api, void*, void*)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	if (auto error = glGetError(); error != GL_NO_ERROR)
 	{
 		mn::log_error("external opengl context has error {:#x}", error);
 	}
 
-	if (self->glewInited)
+	// in case of deferred api calls the first flush executes the init command so there's no state to capture yet
+	bool state_captured = self->glewInited;
+	if (state_captured)
 		_renoir_gl450_state_capture(self->state);
 
+	_renoir_gl450_frame_fence(self);
+	_renoir_gl450_profiler_frame(self);
+	_renoir_gl450_upload_retire(self);
+	_renoir_gl450_transient_frame(self);
+
 	// process commands
 	for(auto it = self->command_list_head; it != nullptr; it = it->next)
 	{
@@ -3110,7 +6003,11 @@ _renoir_gl450_flush(Renoir* api, void*, void*)
 
 	assert(_renoir_gl450_check());
 
-	_renoir_gl450_state_reset(self->state);
+	if (state_captured)
+		_renoir_gl450_state_reset(self->state);
+	_renoir_gl450_stats_frame(self);
+	_renoir_gl450_memory_frame(self);
+	_renoir_gl450_capture_frame(self, nullptr);
 
 	self->command_list_head = nullptr;
 	self->command_list_tail = nullptr;
@@ -3120,9 +6017,16 @@ static Renoir_Swapchain
 _renoir_gl450_swapchain_new(Renoir* api, int width, int height, void* window, void* display)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	if (self->settings.headless)
+	{
+		mn::log_error("gl450: swapchains are not supported in headless mode, use offscreen passes instead");
+		return Renoir_Swapchain{};
+	}
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_SWAPCHAIN);
 	h->swapchain.width = width;
@@ -3133,18 +6037,21 @@ _renoir_gl450_swapchain_new(Renoir* api, int width, int height, void* window, vo
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_SWAPCHAIN_NEW);
 	command->swapchain_new.handle = h;
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Swapchain{h};
+	return Renoir_Swapchain{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_swapchain_free(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)swapchain.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_SWAPCHAIN_FREE);
 	command->swapchain_free.handle = h;
@@ -3152,10 +6059,13 @@ _renoir_gl450_swapchain_free(Renoir* api, Renoir_Swapchain swapchain)
 }
 
 static void
-_renoir_gl450_swapchain_resize(Renoir*, Renoir_Swapchain swapchain, int width, int height)
+_renoir_gl450_swapchain_resize(Renoir* api, Renoir_Swapchain swapchain, int width, int height)
 {
-	auto h = (Renoir_Handle*)swapchain.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	h->swapchain.width = width;
 	h->swapchain.height = height;
@@ -3165,11 +6075,19 @@ static void
 _renoir_gl450_swapchain_present(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)swapchain.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, swapchain.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	_renoir_gl450_frame_fence(self);
+	_renoir_gl450_profiler_frame(self);
+	_renoir_gl450_upload_retire(self);
+	_renoir_gl450_transient_frame(self);
 
 	// process commands
 	for(auto it = self->command_list_head; it != nullptr; it = it->next)
@@ -3180,7 +6098,11 @@ _renoir_gl450_swapchain_present(Renoir* api, Renoir_Swapchain swapchain)
 
 	self->command_list_head = nullptr;
 	self->command_list_tail = nullptr;
+	_renoir_gl450_stats_frame(self);
+	_renoir_gl450_memory_frame(self);
+	_renoir_gl450_capture_frame(self, h);
 
+	Renoir_GL450_Trace_Scope present_scope{self, "swap_buffers"};
 	renoir_gl450_context_window_present(self->ctx, h);
 }
 
@@ -3206,20 +6128,25 @@ _renoir_gl450_buffer_new(Renoir* api, Renoir_Buffer_Desc desc)
 	}
 
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_BUFFER);
 	h->buffer.access = desc.access;
 	h->buffer.type = desc.type;
 	h->buffer.usage = desc.usage;
 	h->buffer.size = desc.data_size;
+	h->buffer.memory_tag = _renoir_gl450_memory_tag(self, desc.tag);
+	_renoir_gl450_memory_handle(self, h, true);
+
+	bool async_upload = self->upload.ctx != nullptr && desc.data != nullptr;
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_NEW);
 	command->buffer_new.handle = h;
 	command->buffer_new.desc = desc;
-	if (self->settings.defer_api_calls)
+	if (self->settings.defer_api_calls || async_upload)
 	{
 		if (desc.data)
 		{
@@ -3228,19 +6155,26 @@ _renoir_gl450_buffer_new(Renoir* api, Renoir_Buffer_Desc desc)
 			command->buffer_new.owns_data = true;
 		}
 	}
-	_renoir_gl450_command_process(self, command);
-	return Renoir_Buffer{h};
+
+	if (async_upload)
+		_renoir_gl450_upload_push(self, h, command);
+	else
+		_renoir_gl450_command_process(self, command);
+	return Renoir_Buffer{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_buffer_free(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)buffer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_FREE);
 	command->buffer_free.handle = h;
 	_renoir_gl450_command_process(self, command);
@@ -3250,8 +6184,11 @@ static size_t
 _renoir_gl450_buffer_size(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)buffer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_BUFFER);
+	if (h == nullptr)
+		return {};
 
 	return h->buffer.size;
 }
@@ -3282,20 +6219,39 @@ _renoir_gl450_texture_new(Renoir* api, Renoir_Texture_Desc desc)
 		assert(desc.size.width == desc.size.height && "width should equal height in cube map texture");
 	}
 
+	if (desc.msaa_sampled)
+	{
+		assert(desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE && "msaa_sampled is only valid for multisampled render targets");
+		assert(desc.cube_map == false && desc.size.depth == 0 && "msaa_sampled textures should be 2D textures");
+		assert(desc.mipmaps == 1 && desc.data[0] == nullptr && "msaa_sampled textures can't have mipmaps or initial data");
+	}
+
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_TEXTURE);
 	h->texture.desc = desc;
 	::memset(h->texture.desc.data, 0, sizeof(h->texture.desc.data));
 	h->texture.desc.data_size = 0;
+	// the desc keeps the backend owned copy of the tag name
+	h->texture.memory_tag = _renoir_gl450_memory_tag(self, desc.tag);
+	h->texture.desc.tag = h->texture.memory_tag ? self->memory.tags[h->texture.memory_tag].name.ptr : nullptr;
+	_renoir_gl450_memory_handle(self, h, true);
+
+	bool async_upload = false;
+	if (self->upload.ctx != nullptr)
+	{
+		for (int i = 0; i < 6; ++i)
+			async_upload |= desc.data[i] != nullptr;
+	}
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_NEW);
 	command->texture_new.handle = h;
 	command->texture_new.desc = desc;
-	if (self->settings.defer_api_calls)
+	if (self->settings.defer_api_calls || async_upload)
 	{
 		for (int i = 0; i < 6; ++i)
 		{
@@ -3307,19 +6263,26 @@ _renoir_gl450_texture_new(Renoir* api, Renoir_Texture_Desc desc)
 			command->texture_new.owns_data = true;
 		}
 	}
-	_renoir_gl450_command_process(self, command);
-	return Renoir_Texture{h};
+
+	if (async_upload)
+		_renoir_gl450_upload_push(self, h, command);
+	else
+		_renoir_gl450_command_process(self, command);
+	return Renoir_Texture{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_texture_free(Renoir* api, Renoir_Texture texture)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)texture.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
 	command->texture_free.handle = h;
 	_renoir_gl450_command_process(self, command);
@@ -3328,32 +6291,102 @@ _renoir_gl450_texture_free(Renoir* api, Renoir_Texture texture)
 static void*
 _renoir_gl450_texture_native_handle(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return nullptr;
+	// the texture might still be uploading in the background, the caller uses the native id outside of renoir
+	_renoir_gl450_upload_wait(self, h);
 	return (void*)h->texture.id;
 }
 
 static Renoir_Size
 _renoir_gl450_texture_size(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
 	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_TEXTURE);
+	if (h == nullptr)
+		return {};
 	return h->texture.desc.size;
 }
 
 static Renoir_Texture_Desc
 _renoir_gl450_texture_desc(Renoir* api, Renoir_Texture texture)
 {
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_TEXTURE);
 	return h->texture.desc;
 }
 
+static Renoir_Texture
+_renoir_gl450_texture_transient(Renoir* api, Renoir_Texture_Desc desc)
+{
+	assert(desc.render_target && "transient textures should be render targets");
+	assert(desc.data[0] == nullptr && "transient textures can't have initial data");
+
+	desc = _renoir_transient_texture_desc_normalize(desc);
+
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+
+	{
+		_renoir_gl450_mutex_lock(self);
+		mn_defer(_renoir_gl450_mutex_unlock(self));
+
+		if (auto h = _renoir_transient_pool_acquire(self->transient_pool, desc))
+			return Renoir_Texture{_renoir_gl450_handle_public(h)};
+	}
+
+	auto texture = _renoir_gl450_texture_new(api, desc);
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+	_renoir_transient_pool_push(self->transient_pool, _renoir_gl450_handle_get(self, texture.handle), desc);
+	return texture;
+}
+
+static void
+_renoir_gl450_texture_transient_free(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+	bool pooled = _renoir_transient_pool_release(self->transient_pool, h);
+	assert(pooled && "texture is not a transient texture");
+	(void)pooled;
+}
+
 static Renoir_Program
 _renoir_gl450_program_new(Renoir* api, Renoir_Program_Desc desc)
 {
 	assert(desc.vertex.bytes != nullptr && desc.pixel.bytes != nullptr);
+	if (desc.constants_count < 0 || desc.constants_count > RENOIR_CONSTANT_SHADER_CONSTANT_SIZE)
+	{
+		mn::log_error("gl450: program constants_count {} should be in [0, {}]", desc.constants_count, int(RENOIR_CONSTANT_SHADER_CONSTANT_SIZE));
+		return Renoir_Program{};
+	}
+	if (desc.format == RENOIR_SHADER_FORMAT_SPIRV)
+	{
+		if (_renoir_gl450_spirv_blob_valid(desc.vertex) == false ||
+			_renoir_gl450_spirv_blob_valid(desc.pixel) == false ||
+			(desc.geometry.bytes != nullptr && _renoir_gl450_spirv_blob_valid(desc.geometry) == false))
+		{
+			mn::log_error("gl450: program SPIR-V blobs should have a non zero size which is a multiple of 4");
+			return Renoir_Program{};
+		}
+	}
 	if (desc.vertex.size == 0)
 		desc.vertex.size = ::strlen(desc.vertex.bytes);
 	if (desc.pixel.size == 0)
@@ -3362,9 +6395,10 @@ _renoir_gl450_program_new(Renoir* api, Renoir_Program_Desc desc)
 		desc.geometry.size = ::strlen(desc.geometry.bytes);
 
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_PROGRAM);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PROGRAM_NEW);
@@ -3387,18 +6421,21 @@ _renoir_gl450_program_new(Renoir* api, Renoir_Program_Desc desc)
 		command->program_new.owns_data = true;
 	}
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Program{h};
+	return Renoir_Program{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_program_free(Renoir* api, Renoir_Program program)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)program.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, program.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PROGRAM_FREE);
 	command->program_free.handle = h;
@@ -3409,13 +6446,24 @@ static Renoir_Compute
 _renoir_gl450_compute_new(Renoir* api, Renoir_Compute_Desc desc)
 {
 	assert(desc.compute.bytes != nullptr);
+	if (desc.constants_count < 0 || desc.constants_count > RENOIR_CONSTANT_SHADER_CONSTANT_SIZE)
+	{
+		mn::log_error("gl450: compute constants_count {} should be in [0, {}]", desc.constants_count, int(RENOIR_CONSTANT_SHADER_CONSTANT_SIZE));
+		return Renoir_Compute{};
+	}
+	if (desc.format == RENOIR_SHADER_FORMAT_SPIRV && _renoir_gl450_spirv_blob_valid(desc.compute) == false)
+	{
+		mn::log_error("gl450: compute SPIR-V blob should have a non zero size which is a multiple of 4");
+		return Renoir_Compute{};
+	}
 	if (desc.compute.size == 0)
 		desc.compute.size = ::strlen(desc.compute.bytes);
 
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_COMPUTE);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_COMPUTE_NEW);
@@ -3429,53 +6477,109 @@ _renoir_gl450_compute_new(Renoir* api, Renoir_Compute_Desc desc)
 		command->compute_new.owns_data = true;
 	}
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Compute{h};
+	return Renoir_Compute{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_compute_free(Renoir* api, Renoir_Compute compute)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)compute.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, compute.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_COMPUTE_FREE);
 	command->compute_free.handle = h;
 	_renoir_gl450_command_process(self, command);
 }
 
+static bool
+_renoir_gl450_program_reflect(Renoir* api, Renoir_Program program, Renoir_Reflect* reflect)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, program.handle);
+	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_PROGRAM);
+	if (h == nullptr)
+		return false;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	// this means that program creation didn't execute yet
+	if (h->program.reflect == nullptr)
+		return false;
+
+	if (reflect) *reflect = _renoir_gl450_reflect_desc(h->program.reflect);
+	return true;
+}
+
+static bool
+_renoir_gl450_compute_reflect(Renoir* api, Renoir_Compute compute, Renoir_Reflect* reflect)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, compute.handle);
+	assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_COMPUTE);
+	if (h == nullptr)
+		return false;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	// this means that compute creation didn't execute yet
+	if (h->compute.reflect == nullptr)
+		return false;
+
+	if (reflect) *reflect = _renoir_gl450_reflect_desc(h->compute.reflect);
+	return true;
+}
+
 static Renoir_Pass
 _renoir_gl450_pass_swapchain_new(Renoir* api, Renoir_Swapchain swapchain)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto hswapchain = _renoir_gl450_handle_get(self, swapchain.handle);
+	assert(hswapchain != nullptr);
+	if (hswapchain == nullptr)
+		return Renoir_Pass{};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_RASTER_PASS);
-	h->raster_pass.swapchain = (Renoir_Handle*)swapchain.handle;
+	h->raster_pass.swapchain = hswapchain;
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_SWAPCHAIN_NEW);
 	command->pass_swapchain_new.handle = h;
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_gl450_handle_public(h)};
 }
 
 static Renoir_Pass
 _renoir_gl450_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
 	// check that all sizes match
 	int width = -1, height = -1;
 	for (int i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
 	{
-		auto color = (Renoir_Handle*)desc.color[i].texture.handle;
+		auto color = _renoir_gl450_handle_get(self, desc.color[i].texture.handle);
 		if (color == nullptr)
+		{
+			// stale attachment
+			if (desc.color[i].texture.handle != nullptr)
+				return Renoir_Pass{};
 			continue;
+		}
 
 		// first time getting the width/height
 		if (width == -1 && height == -1)
@@ -3490,7 +6594,9 @@ _renoir_gl450_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 		}
 	}
 
-	auto depth = (Renoir_Handle*)desc.depth_stencil.texture.handle;
+	auto depth = _renoir_gl450_handle_get(self, desc.depth_stencil.texture.handle);
+	if (depth == nullptr && desc.depth_stencil.texture.handle != nullptr)
+		return Renoir_Pass{};
 	if (depth)
 	{
 		// first time getting the width/height
@@ -3506,8 +6612,8 @@ _renoir_gl450_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 		}
 	}
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_RASTER_PASS);
 	h->raster_pass.offscreen = desc;
@@ -3518,34 +6624,38 @@ _renoir_gl450_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
 	command->pass_offscreen_new.handle = h;
 	command->pass_offscreen_new.desc = desc;
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_gl450_handle_public(h)};
 }
 
 static Renoir_Pass
 _renoir_gl450_pass_compute_new(Renoir* api)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_COMPUTE_PASS);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_COMPUTE_NEW);
 	command->pass_compute_new.handle = h;
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Pass{h};
+	return Renoir_Pass{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_pass_free(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_FREE);
 	command->pass_free.handle = h;
 	_renoir_gl450_command_process(self, command);
@@ -3554,9 +6664,12 @@ _renoir_gl450_pass_free(Renoir* api, Renoir_Pass pass)
 static Renoir_Size
 _renoir_gl450_pass_size(Renoir* api, Renoir_Pass pass)
 {
+	auto self = api->ctx;
 	Renoir_Size res{};
-	auto h = (Renoir_Handle*)pass.handle;
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
 	// if this is an on screen/window
@@ -3577,8 +6690,11 @@ _renoir_gl450_pass_size(Renoir* api, Renoir_Pass pass)
 static Renoir_Pass_Offscreen_Desc
 _renoir_gl450_pass_offscreen_desc(Renoir* api, Renoir_Pass pass)
 {
-	auto h = (Renoir_Handle*)pass.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 	return h->raster_pass.offscreen;
 }
@@ -3587,27 +6703,31 @@ static Renoir_Timer
 _renoir_gl450_timer_new(Renoir* api)
 {
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_TIMER);
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TIMER_NEW);
 	command->timer_new.handle = h;
 	_renoir_gl450_command_process(self, command);
-	return Renoir_Timer{h};
+	return Renoir_Timer{_renoir_gl450_handle_public(h)};
 }
 
 static void
 _renoir_gl450_timer_free(struct Renoir* api, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)timer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, timer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TIMER_FREE);
 	command->timer_free.handle = h;
@@ -3618,8 +6738,11 @@ static bool
 _renoir_gl450_timer_elapsed(struct Renoir* api, Renoir_Timer timer, uint64_t* elapsed_time_in_nanos)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)timer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, timer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return false;
 	assert(h->kind == RENOIR_HANDLE_KIND_TIMER);
 
 	if (h->timer.state == RENOIR_TIMER_STATE_READY)
@@ -3630,10 +6753,10 @@ _renoir_gl450_timer_elapsed(struct Renoir* api, Renoir_Timer timer, uint64_t* el
 	}
 	else if (h->timer.state == RENOIR_TIMER_STATE_END)
 	{
-		mn::mutex_lock(self->mtx);
+		_renoir_gl450_mutex_lock(self);
 		auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TIMER_ELAPSED);
 		h->timer.state = RENOIR_TIMER_STATE_READ_SCHEDULED;
-		mn::mutex_unlock(self->mtx);
+		_renoir_gl450_mutex_unlock(self);
 
 		command->timer_elapsed.handle = h;
 		_renoir_gl450_command_process(self, command);
@@ -3644,20 +6767,273 @@ _renoir_gl450_timer_elapsed(struct Renoir* api, Renoir_Timer timer, uint64_t* el
 	return false;
 }
 
+static Renoir_Query
+_renoir_gl450_query_new(Renoir* api, RENOIR_QUERY kind)
+{
+	assert(kind != RENOIR_QUERY_NONE && "invalid query kind");
+
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto h = _renoir_gl450_handle_new(self, RENOIR_HANDLE_KIND_QUERY);
+	h->query.kind = kind;
+
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_QUERY_NEW);
+	command->query_new.handle = h;
+	_renoir_gl450_command_process(self, command);
+	return Renoir_Query{_renoir_gl450_handle_public(h)};
+}
+
+static void
+_renoir_gl450_query_free(Renoir* api, Renoir_Query query)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, query.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_QUERY_FREE);
+	command->query_free.handle = h;
+	_renoir_gl450_command_process(self, command);
+}
+
+static bool
+_renoir_gl450_query_result(Renoir* api, Renoir_Query query, Renoir_Query_Result* result)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, query.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return false;
+	assert(h->kind == RENOIR_HANDLE_KIND_QUERY);
+
+	if (h->query.count == 0)
+		return false;
+
+	auto slot = h->query.head;
+	auto& state = h->query.states[slot];
+	if (state == RENOIR_TIMER_STATE_READY)
+	{
+		if (result) *result = h->query.result;
+		state = RENOIR_TIMER_STATE_NONE;
+		h->query.head = (slot + 1) % RENOIR_GL450_QUERY_RING;
+		--h->query.count;
+		return true;
+	}
+	else if (state == RENOIR_TIMER_STATE_END)
+	{
+		_renoir_gl450_mutex_lock(self);
+		auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_QUERY_RESULT);
+		state = RENOIR_TIMER_STATE_READ_SCHEDULED;
+		_renoir_gl450_mutex_unlock(self);
+
+		command->query_result.handle = h;
+		command->query_result.slot = slot;
+		_renoir_gl450_command_process(self, command);
+
+		return false;
+	}
+
+	return false;
+}
+
+static bool
+_renoir_gl450_profiler_frame_results(Renoir* api, Renoir_Profiler_Frame* frame)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto& profiler = self->profiler;
+	if (self->settings.profiler == false || profiler.has_results == false)
+		return false;
+
+	if (frame)
+	{
+		frame->frame_index = profiler.results_frame_index;
+		frame->scopes = profiler.results.ptr;
+		frame->scopes_count = int(profiler.results.count);
+	}
+	return true;
+}
+
+inline static const char*
+_renoir_gl450_trace_name(const char* name)
+{
+	// api events use __func__ as name so we strip the backend prefix
+	constexpr const char prefix[] = "_renoir_gl450_";
+	if (::strncmp(name, prefix, sizeof(prefix) - 1) == 0)
+		return name + sizeof(prefix) - 1;
+	return name;
+}
+
+// copies the ring events with the ring mutex locked so the owning thread waits for the copy instead of overwriting the
+// events being copied, the end events whose begin event was already overwritten are dropped
+static Renoir_GL450_Trace_Snapshot
+_renoir_gl450_trace_ring_snapshot(Renoir_GL450_Trace_Ring* ring)
+{
+	Renoir_GL450_Trace_Snapshot self{};
+	self.thread_id = ring->thread_id;
+	self.events = mn::buf_with_capacity<Renoir_GL450_Trace_Event>(RENOIR_GL450_TRACE_RING_SIZE);
+
+	mn::mutex_lock(ring->mtx);
+	auto count = ring->count;
+	auto first = count > RENOIR_GL450_TRACE_RING_SIZE ? count - RENOIR_GL450_TRACE_RING_SIZE : 0;
+	for (auto i = first; i < count; ++i)
+		mn::buf_push(self.events, ring->events[i % RENOIR_GL450_TRACE_RING_SIZE]);
+	mn::mutex_unlock(ring->mtx);
+
+	size_t kept = 0;
+	int depth = 0;
+	for (size_t i = 0; i < self.events.count; ++i)
+	{
+		auto event = self.events[i];
+		if (event.phase == 'B')
+		{
+			++depth;
+		}
+		else if (event.phase == 'E')
+		{
+			if (depth == 0)
+				continue;
+			--depth;
+		}
+		self.events[kept++] = event;
+	}
+	mn::buf_resize(self.events, kept);
+	return self;
+}
+
+static bool
+_renoir_gl450_trace_export(Renoir* api, const char* path)
+{
+	auto self = api->ctx;
+	if (self->settings.trace == false)
+		return false;
+
+	auto file = ::fopen(path, "wb");
+	if (file == nullptr)
+	{
+		mn::log_error("gl450: failed to open trace file '{}'", path);
+		return false;
+	}
+	mn_defer(::fclose(file));
+
+	// other threads keep writing to their rings while we export, so we work on a snapshot of them
+	auto snapshots = mn::buf_new<Renoir_GL450_Trace_Snapshot>();
+	mn_defer({
+		for (auto& snapshot: snapshots)
+			mn::buf_free(snapshot.events);
+		mn::buf_free(snapshots);
+	});
+	{
+		mn::mutex_lock(self->trace.mtx);
+		mn_defer(mn::mutex_unlock(self->trace.mtx));
+		for (auto ring: self->trace.rings)
+			mn::buf_push(snapshots, _renoir_gl450_trace_ring_snapshot(ring));
+	}
+
+	uint64_t base_time = UINT64_MAX;
+	for (const auto& snapshot: snapshots)
+	{
+		if (snapshot.events.count > 0 && snapshot.events[0].time_in_nanos < base_time)
+			base_time = snapshot.events[0].time_in_nanos;
+	}
+	if (base_time == UINT64_MAX)
+		base_time = 0;
+
+	bool first_event = true;
+	auto write_separator = [&]() {
+		if (first_event == false)
+			::fprintf(file, ",\n");
+		first_event = false;
+	};
+
+	::fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+
+	// gpu events are shown in tid 0
+	write_separator();
+	::fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"gpu\"}}");
+	{
+		_renoir_gl450_mutex_lock(self);
+		mn_defer(_renoir_gl450_mutex_unlock(self));
+
+		auto& trace = self->trace;
+		auto first = trace.gpu_events_count > RENOIR_GL450_TRACE_GPU_RING_SIZE ? trace.gpu_events_count - RENOIR_GL450_TRACE_GPU_RING_SIZE : 0;
+		for (auto i = first; i < trace.gpu_events_count; ++i)
+		{
+			auto& event = trace.gpu_events[i % RENOIR_GL450_TRACE_GPU_RING_SIZE];
+			if (event.begin_in_nanos < base_time)
+				continue;
+
+			write_separator();
+			::fprintf(
+				file,
+				"{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"depth\": %d}}",
+				event.name,
+				(event.begin_in_nanos - base_time) / 1000.0,
+				event.elapsed_in_nanos / 1000.0,
+				event.depth
+			);
+		}
+	}
+
+	for (const auto& snapshot: snapshots)
+	{
+		write_separator();
+		::fprintf(
+			file,
+			"{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %u, \"args\": {\"name\": \"renoir thread %u\"}}",
+			snapshot.thread_id,
+			snapshot.thread_id
+		);
+
+		for (const auto& event: snapshot.events)
+		{
+			write_separator();
+			::fprintf(
+				file,
+				"{\"name\": \"%s\", \"ph\": \"%c\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f}",
+				_renoir_gl450_trace_name(event.name),
+				event.phase,
+				snapshot.thread_id,
+				(event.time_in_nanos - base_time) / 1000.0
+			);
+		}
+	}
+
+	::fprintf(file, "\n]}\n");
+	return true;
+}
+
 // Graphics Commands
 static void
 _renoir_gl450_pass_begin(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
 	{
 		h->raster_pass.command_list_head = nullptr;
 		h->raster_pass.command_list_tail = nullptr;
 
-		mn::mutex_lock(self->mtx);
-		mn_defer(mn::mutex_unlock(self->mtx));
+		_renoir_gl450_mutex_lock(self);
+		mn_defer(_renoir_gl450_mutex_unlock(self));
 
 		auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_BEGIN);
 		command->pass_begin.handle = h;
@@ -3668,8 +7044,8 @@ _renoir_gl450_pass_begin(Renoir* api, Renoir_Pass pass)
 		h->compute_pass.command_list_head = nullptr;
 		h->compute_pass.command_list_tail = nullptr;
 
-		mn::mutex_lock(self->mtx);
-		mn_defer(mn::mutex_unlock(self->mtx));
+		_renoir_gl450_mutex_lock(self);
+		mn_defer(_renoir_gl450_mutex_unlock(self));
 
 		auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_BEGIN);
 		command->pass_begin.handle = h;
@@ -3685,14 +7061,17 @@ static void
 _renoir_gl450_pass_end(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
 	{
 		if (h->raster_pass.command_list_head != nullptr)
 		{
-			mn::mutex_lock(self->mtx);
+			_renoir_gl450_mutex_lock(self);
 
 			// push the pass end command
 			auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_END);
@@ -3722,7 +7101,7 @@ _renoir_gl450_pass_end(Renoir* api, Renoir_Pass pass)
 					_renoir_gl450_command_free(self, it);
 				}
 			}
-			mn::mutex_unlock(self->mtx);
+			_renoir_gl450_mutex_unlock(self);
 		}
 		h->raster_pass.command_list_head = nullptr;
 		h->raster_pass.command_list_tail = nullptr;
@@ -3731,7 +7110,7 @@ _renoir_gl450_pass_end(Renoir* api, Renoir_Pass pass)
 	{
 		if (h->compute_pass.command_list_head != nullptr)
 		{
-			mn::mutex_lock(self->mtx);
+			_renoir_gl450_mutex_lock(self);
 
 			// push the pass end command
 			auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_END);
@@ -3761,7 +7140,7 @@ _renoir_gl450_pass_end(Renoir* api, Renoir_Pass pass)
 					_renoir_gl450_command_free(self, it);
 				}
 			}
-			mn::mutex_unlock(self->mtx);
+			_renoir_gl450_mutex_unlock(self);
 		}
 		h->compute_pass.command_list_head = nullptr;
 		h->compute_pass.command_list_tail = nullptr;
@@ -3776,17 +7155,20 @@ static void
 _renoir_gl450_clear(Renoir* api, Renoir_Pass pass, Renoir_Clear_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
 	if (desc.independent_clear_color == RENOIR_SWITCH_DEFAULT)
 		desc.independent_clear_color = RENOIR_SWITCH_DISABLE;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PASS_CLEAR);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->pass_clear.desc = desc;
 	_renoir_gl450_command_push(&h->raster_pass, command);
@@ -3796,15 +7178,18 @@ static void
 _renoir_gl450_use_pipeline(Renoir* api, Renoir_Pass pass, Renoir_Pipeline_Desc pipeline_desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 	_renoir_gl450_pipeline_desc_defaults(&pipeline_desc);
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_USE_PIPELINE);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->use_pipeline.pipeline_desc = pipeline_desc;
 	_renoir_gl450_command_push(&h->raster_pass, command);
@@ -3814,72 +7199,309 @@ static void
 _renoir_gl450_use_program(Renoir* api, Renoir_Pass pass, Renoir_Program program)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	auto hprogram = _renoir_gl450_handle_get(self, program.handle);
+	if (hprogram == nullptr && program.handle != nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_USE_PROGRAM);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->use_program.program = hprogram;
+	_renoir_gl450_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_gl450_use_compute(Renoir* api, Renoir_Pass pass, Renoir_Compute compute)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+
+	auto hcompute = _renoir_gl450_handle_get(self, compute.handle);
+	if (hcompute == nullptr && compute.handle != nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_USE_COMPUTE);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->use_compute.compute = hcompute;
+	_renoir_gl450_command_push(&h->compute_pass, command);
+}
+
+static void
+_renoir_gl450_scissor(Renoir* api, Renoir_Pass pass, int x, int y, int width, int height)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_SCISSOR);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->scissor.x = x;
+	command->scissor.y = y;
+	command->scissor.w = width;
+	command->scissor.h = height;
+	_renoir_gl450_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_gl450_buffer_zero(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+
+	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_CLEAR);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->buffer_clear.handle = hbuffer;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
+static void
+_renoir_gl450_query_begin(Renoir* api, Renoir_Pass pass, Renoir_Query query)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	auto hquery = _renoir_gl450_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+
+	auto& q = hquery->query;
+	if (q.count > 0 && q.states[(q.head + q.count - 1) % RENOIR_GL450_QUERY_RING] == RENOIR_TIMER_STATE_BEGIN)
+	{
+		assert(false && "query_begin called twice without a query_end");
+		return;
+	}
+	if (q.count == RENOIR_GL450_QUERY_RING)
+	{
+		mn::log_warning(
+			"gl450: query_begin is dropped, the query has {} results which are not read back by query_result yet",
+			RENOIR_GL450_QUERY_RING
+		);
+		return;
+	}
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_QUERY_BEGIN);
+	_renoir_gl450_mutex_unlock(self);
+
+	auto slot = (q.head + q.count) % RENOIR_GL450_QUERY_RING;
+	command->query_begin.handle = hquery;
+	command->query_begin.slot = slot;
+	q.states[slot] = RENOIR_TIMER_STATE_BEGIN;
+	++q.count;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "unreachable");
+	}
+}
+
+static void
+_renoir_gl450_query_end(Renoir* api, Renoir_Pass pass, Renoir_Query query)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	auto hquery = _renoir_gl450_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+
+	auto& q = hquery->query;
+	auto slot = (q.head + q.count + RENOIR_GL450_QUERY_RING - 1) % RENOIR_GL450_QUERY_RING;
+	if (q.count == 0 || q.states[slot] != RENOIR_TIMER_STATE_BEGIN)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_QUERY_END);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->query_end.handle = hquery;
+	command->query_end.slot = slot;
+	q.states[slot] = RENOIR_TIMER_STATE_END;
+	q.last = slot;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "unreachable");
+	}
+}
+
+static void
+_renoir_gl450_conditional_begin(Renoir* api, Renoir_Pass pass, Renoir_Query query, bool wait)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	auto hquery = _renoir_gl450_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+	assert(
+		hquery->query.kind != RENOIR_QUERY_PIPELINE_STATISTICS &&
+		"only occlusion queries can be used in conditional rendering"
+	);
 
-	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN);
+	_renoir_gl450_mutex_unlock(self);
 
-	mn::mutex_lock(self->mtx);
-	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_USE_PROGRAM);
-	mn::mutex_unlock(self->mtx);
+	command->conditional_begin.handle = hquery;
+	command->conditional_begin.slot = hquery->query.last;
+	command->conditional_begin.wait = wait;
 
-	command->use_program.program = (Renoir_Handle*)program.handle;
 	_renoir_gl450_command_push(&h->raster_pass, command);
 }
 
 static void
-_renoir_gl450_use_compute(Renoir* api, Renoir_Pass pass, Renoir_Compute compute)
+_renoir_gl450_conditional_end(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
-	mn::mutex_lock(self->mtx);
-	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_USE_COMPUTE);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_CONDITIONAL_END);
+	_renoir_gl450_mutex_unlock(self);
 
-	command->use_compute.compute = (Renoir_Handle*)compute.handle;
-	_renoir_gl450_command_push(&h->compute_pass, command);
+	_renoir_gl450_command_push(&h->raster_pass, command);
 }
 
 static void
-_renoir_gl450_scissor(Renoir* api, Renoir_Pass pass, int x, int y, int width, int height)
+_renoir_gl450_profiler_scope_begin(Renoir* api, Renoir_Pass pass, const char* name)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	if (self->settings.profiler == false)
+		return;
+
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PROFILER_SCOPE_BEGIN);
+	_renoir_gl450_mutex_unlock(self);
 
-	mn::mutex_lock(self->mtx);
-	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_SCISSOR);
-	mn::mutex_unlock(self->mtx);
+	command->profiler_scope_begin.pass = h;
+	command->profiler_scope_begin.name = mn::str_from_c(name ? name : "");
 
-	command->scissor.x = x;
-	command->scissor.y = y;
-	command->scissor.w = width;
-	command->scissor.h = height;
-	_renoir_gl450_command_push(&h->raster_pass, command);
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
 }
 
 static void
-_renoir_gl450_buffer_zero(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer)
+_renoir_gl450_profiler_scope_end(Renoir* api, Renoir_Pass pass)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
-	assert(h != nullptr);
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
-	assert(hbuffer != nullptr);
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	if (self->settings.profiler == false)
+		return;
 
-	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
-	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_CLEAR);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_PROFILER_SCOPE_END);
+	_renoir_gl450_mutex_unlock(self);
 
-	command->buffer_clear.handle = hbuffer;
+	command->profiler_scope_end.pass = h;
 
 	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
 	{
@@ -3903,16 +7525,21 @@ _renoir_gl450_buffer_write(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer,
 		return;
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_WRITE);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->buffer_write.handle = hbuffer;
 	command->buffer_write.offset = offset;
@@ -3942,15 +7569,22 @@ _renoir_gl450_texture_write(Renoir* api, Renoir_Pass pass, Renoir_Texture textur
 		return;
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htexture = (Renoir_Handle*)texture.handle;
+	auto htexture = _renoir_gl450_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
 	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
+	assert(htexture->texture.desc.msaa_sampled == false && "msaa_sampled textures can't be written from the cpu");
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_WRITE);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->texture_write.handle = htexture;
 	command->texture_write.desc = desc;
@@ -3975,13 +7609,16 @@ static void
 _renoir_gl450_buffer_zero_global(Renoir* api, Renoir_Buffer buffer)
 {
 	auto self = api->ctx;
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_CLEAR);
 	command->buffer_clear.handle = hbuffer;
@@ -3996,13 +7633,16 @@ _renoir_gl450_buffer_write_global(Renoir* api, Renoir_Buffer buffer, size_t offs
 		return;
 
 	auto self = api->ctx;
-	auto hbuffer = (Renoir_Handle*)buffer.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
 
 	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_WRITE);
 	command->buffer_write.handle = hbuffer;
@@ -4013,6 +7653,37 @@ _renoir_gl450_buffer_write_global(Renoir* api, Renoir_Buffer buffer, size_t offs
 	_renoir_gl450_command_process(self, command);
 }
 
+static void
+_renoir_gl450_buffer_copy_global(Renoir* api, Renoir_Buffer dst, size_t dst_offset, Renoir_Buffer src, size_t src_offset, size_t size)
+{
+	// this means he's trying to copy nothing so no-op
+	if (size == 0)
+		return;
+
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto hdst = _renoir_gl450_handle_get(self, dst.handle);
+	auto hsrc = _renoir_gl450_handle_get(self, src.handle);
+	assert(hdst != nullptr && hsrc != nullptr);
+	if (hdst == nullptr || hsrc == nullptr)
+		return;
+
+	assert(hdst->buffer.usage != RENOIR_USAGE_STATIC);
+	assert(dst_offset + size <= hdst->buffer.size && src_offset + size <= hsrc->buffer.size);
+	assert(hdst != hsrc && "buffer copy source and destination should be different buffers");
+
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
+
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_COPY);
+	command->buffer_copy.dst = hdst;
+	command->buffer_copy.dst_offset = dst_offset;
+	command->buffer_copy.src = hsrc;
+	command->buffer_copy.src_offset = src_offset;
+	command->buffer_copy.size = size;
+	_renoir_gl450_command_process(self, command);
+}
+
 static void
 _renoir_gl450_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc)
 {
@@ -4021,12 +7692,17 @@ _renoir_gl450_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_T
 		return;
 
 	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
-	auto htexture = (Renoir_Handle*)texture.handle;
+	auto htexture = _renoir_gl450_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
 	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
+	assert(htexture->texture.desc.msaa_sampled == false && "msaa_sampled textures can't be written from the cpu");
 
-	mn::mutex_lock(self->mtx);
-	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_gl450_mutex_lock(self);
+	mn_defer(_renoir_gl450_mutex_unlock(self));
 
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_WRITE);
 	command->texture_write.handle = htexture;
@@ -4036,6 +7712,53 @@ _renoir_gl450_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_T
 	_renoir_gl450_command_process(self, command);
 }
 
+static Renoir_Uniform
+_renoir_gl450_uniform_alloc(Renoir* api, Renoir_Pass pass, void* bytes, size_t bytes_size)
+{
+	assert(bytes_size > 0 && "uniform allocation size should be greater than 0");
+
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+
+	_renoir_gl450_mutex_lock(self);
+	auto& ring = self->uniform_ring;
+	auto offset = (ring.segment_offset + ring.alignment - 1) & ~(ring.alignment - 1);
+	if (offset + bytes_size > ring.segment_size)
+	{
+		_renoir_gl450_mutex_unlock(self);
+		mn::log_error("gl450: uniform ring is exhausted, consider increasing 'uniform_ring_size' setting");
+		return Renoir_Uniform{};
+	}
+	ring.segment_offset = offset + bytes_size;
+	offset += self->pacer.frame * ring.segment_size;
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_UNIFORM_WRITE);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->uniform_write.offset = offset;
+	command->uniform_write.bytes = mn::alloc(bytes_size, alignof(char)).ptr;
+	command->uniform_write.bytes_size = bytes_size;
+	::memcpy(command->uniform_write.bytes, bytes, bytes_size);
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+
+	return Renoir_Uniform{Renoir_Buffer{_renoir_gl450_handle_public(ring.buffer)}, offset, bytes_size};
+}
+
 static void
 _renoir_gl450_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size)
 {
@@ -4043,8 +7766,12 @@ _renoir_gl450_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void
 	if (bytes_size == 0)
 		return;
 
-	auto h = (Renoir_Handle*)buffer.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, buffer.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	_renoir_gl450_upload_wait(self, h);
 	// this means that buffer creation didn't execute yet
 	if (h->buffer.id == 0)
 	{
@@ -4052,7 +7779,7 @@ _renoir_gl450_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void
 		return;
 	}
 
-	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
 	Renoir_Command command{};
 	command.kind = RENOIR_COMMAND_KIND_BUFFER_READ;
@@ -4061,9 +7788,9 @@ _renoir_gl450_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void
 	command.buffer_read.bytes = bytes;
 	command.buffer_read.bytes_size = bytes_size;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	_renoir_gl450_command_execute(self, &command);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 }
 
 static void
@@ -4073,8 +7800,13 @@ _renoir_gl450_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_E
 	if (desc.bytes_size == 0)
 		return;
 
-	auto h = (Renoir_Handle*)texture.handle;
+	auto self = api->ctx;
+	auto h = _renoir_gl450_handle_get(self, texture.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->texture.desc.msaa_sampled == false && "msaa_sampled textures can't be read from the cpu");
+	_renoir_gl450_upload_wait(self, h);
 	// this means that texture creation didn't execute yet
 	if (h->texture.id == 0)
 	{
@@ -4082,34 +7814,84 @@ _renoir_gl450_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_E
 		return;
 	}
 
-	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
 
 	Renoir_Command command{};
 	command.kind = RENOIR_COMMAND_KIND_TEXTURE_READ;
 	command.texture_read.handle = h;
 	command.texture_read.desc = desc;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	_renoir_gl450_command_execute(self, &command);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 }
 
 static void
 _renoir_gl450_buffer_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
-	mn::mutex_lock(self->mtx);
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = shader;
+	command->buffer_bind.slot = slot;
+
+	_renoir_gl450_command_push(&h->raster_pass, command);
+}
+
+// returns the offset alignment glBindBufferRange requires for the given buffer type
+inline static size_t
+_renoir_gl450_buffer_offset_alignment(IRenoir* self, RENOIR_BUFFER type)
+{
+	return type == RENOIR_BUFFER_COMPUTE ? self->storage_offset_alignment : self->uniform_offset_alignment;
+}
+
+static void
+_renoir_gl450_buffer_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot, size_t offset, size_t size)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+	assert(size > 0 && "buffer range size should be greater than 0");
+	assert(offset + size <= hbuffer->buffer.size && "buffer range is out of bounds");
+	assert(
+		offset % _renoir_gl450_buffer_offset_alignment(self, hbuffer->buffer.type) == 0 &&
+		"buffer range offset should be a multiple of the device offset alignment"
+	);
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	_renoir_gl450_mutex_unlock(self);
 
-	command->buffer_bind.handle = (Renoir_Handle*)buffer.handle;
+	command->buffer_bind.handle = hbuffer;
 	command->buffer_bind.shader = shader;
 	command->buffer_bind.slot = slot;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
 
 	_renoir_gl450_command_push(&h->raster_pass, command);
 }
@@ -4118,14 +7900,17 @@ static void
 _renoir_gl450_buffer_storage_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer_Storage_Bind_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	size_t render_target_count = 0;
 	if (h->raster_pass.swapchain)
@@ -4151,9 +7936,15 @@ _renoir_gl450_buffer_storage_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer_S
 
 	for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
 	{
-		auto h = (Renoir_Handle*)desc.buffers[i].handle;
+		auto h = _renoir_gl450_handle_get(self, desc.buffers[i].handle);
 		if (h)
+		{
+			assert(desc.offsets[i] + desc.sizes[i] <= h->buffer.size && "buffer range is out of bounds");
+			assert((desc.sizes[i] > 0 || desc.offsets[i] < h->buffer.size) && "buffer range is out of bounds");
 			command->buffer_storage_bind.handle[i] = h;
+			command->buffer_storage_bind.offsets[i] = desc.offsets[i];
+			command->buffer_storage_bind.sizes[i] = desc.sizes[i];
+		}
 	}
 	command->buffer_storage_bind.start_slot = desc.start_slot;
 
@@ -4164,16 +7955,21 @@ static void
 _renoir_gl450_texture_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_gl450_handle_get(self, texture.handle);
 	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto sampler = _renoir_gl450_sampler_get(self, htex->texture.desc.sampler);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->texture_bind.handle = htex;
 	command->texture_bind.shader = shader;
@@ -4183,20 +7979,67 @@ _renoir_gl450_texture_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture
 	_renoir_gl450_command_push(&h->raster_pass, command);
 }
 
+static void
+_renoir_gl450_uniform_bind(Renoir* api, Renoir_Pass pass, Renoir_Uniform uniform, RENOIR_SHADER shader, int slot)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	// this means the allocation has failed, which is already reported by uniform_alloc
+	if (uniform.buffer.handle == nullptr)
+		return;
+
+	auto hbuffer = _renoir_gl450_handle_get(self, uniform.buffer.handle);
+	if (hbuffer == nullptr && uniform.buffer.handle != nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = shader;
+	command->buffer_bind.slot = slot;
+	command->buffer_bind.offset = uniform.offset;
+	command->buffer_bind.size = uniform.size;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
 static void
 _renoir_gl450_texture_sampler_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot, Renoir_Sampler_Desc sampler)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_gl450_handle_get(self, texture.handle);
 	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto hsampler = _renoir_gl450_sampler_get(self, sampler);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->texture_bind.handle = htex;
 	command->texture_bind.shader = shader;
@@ -4210,8 +8053,11 @@ static void
 _renoir_gl450_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 	assert(
@@ -4219,11 +8065,15 @@ _renoir_gl450_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer b
 		"gpu should read, write, or both, it has no meaning to bind a buffer that the GPU cannot read or write from"
 	);
 
-	mn::mutex_lock(self->mtx);
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
-	command->buffer_bind.handle = (Renoir_Handle*)buffer.handle;
+	command->buffer_bind.handle = hbuffer;
 	command->buffer_bind.shader = RENOIR_SHADER_COMPUTE;
 	command->buffer_bind.slot = slot;
 	command->buffer_bind.gpu_access = gpu_access;
@@ -4231,12 +8081,56 @@ _renoir_gl450_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer b
 	_renoir_gl450_command_push(&h->raster_pass, command);
 }
 
+static void
+_renoir_gl450_buffer_compute_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access, size_t offset, size_t size)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+	assert(
+		gpu_access != RENOIR_ACCESS_NONE &&
+		"gpu should read, write, or both, it has no meaning to bind a buffer that the GPU cannot read or write from"
+	);
+
+	auto hbuffer = _renoir_gl450_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+	assert(size > 0 && "buffer range size should be greater than 0");
+	assert(offset + size <= hbuffer->buffer.size && "buffer range is out of bounds");
+	assert(
+		offset % _renoir_gl450_buffer_offset_alignment(self, hbuffer->buffer.type) == 0 &&
+		"buffer range offset should be a multiple of the device offset alignment"
+	);
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	_renoir_gl450_mutex_unlock(self);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = RENOIR_SHADER_COMPUTE;
+	command->buffer_bind.slot = slot;
+	command->buffer_bind.gpu_access = gpu_access;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
+
+	_renoir_gl450_command_push(&h->compute_pass, command);
+}
+
 static void
 _renoir_gl450_texture_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, int slot, int mip_level, RENOIR_ACCESS gpu_access)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 	assert(
@@ -4249,11 +8143,13 @@ _renoir_gl450_texture_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture
 		assert(mip_level == 0 && "read only textures are bound as samplers, so you can't change mip level");
 	}
 
-	auto htex = (Renoir_Handle*)texture.handle;
+	auto htex = _renoir_gl450_handle_get(self, texture.handle);
+	if (htex == nullptr && texture.handle != nullptr)
+		return;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->texture_bind.handle = htex;
 	command->texture_bind.shader = RENOIR_SHADER_COMPUTE;
@@ -4268,14 +8164,24 @@ static void
 _renoir_gl450_draw(Renoir* api, Renoir_Pass pass, Renoir_Draw_Desc desc)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
 
-	mn::mutex_lock(self->mtx);
+	// the buffers are resolved again when the draw executes, so draws which use stale buffers are dropped here
+	for (const auto& vertex: desc.vertex_buffers)
+		if (vertex.buffer.handle != nullptr && _renoir_gl450_handle_get(self, vertex.buffer.handle) == nullptr)
+			return;
+	if (desc.index_buffer.handle != nullptr && _renoir_gl450_handle_get(self, desc.index_buffer.handle) == nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_DRAW);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->draw.desc = desc;
 
@@ -4288,14 +8194,17 @@ _renoir_gl450_dispatch(Renoir* api, Renoir_Pass pass, int x, int y, int z)
 	assert(x >= 0 && y >= 0 && z >= 0);
 
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
 	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_DISPATCH);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->dispatch.x = x;
 	command->dispatch.y = y;
@@ -4304,22 +8213,55 @@ _renoir_gl450_dispatch(Renoir* api, Renoir_Pass pass, int x, int y, int z)
 	_renoir_gl450_command_push(&h->compute_pass, command);
 }
 
+static void
+_renoir_gl450_memory_barrier(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	_renoir_gl450_mutex_lock(self);
+	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_MEMORY_BARRIER);
+	_renoir_gl450_mutex_unlock(self);
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_gl450_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_gl450_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
 static void
 _renoir_gl450_timer_begin(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htimer = (Renoir_Handle*)timer.handle;
+	auto htimer = _renoir_gl450_handle_get(self, timer.handle);
 	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
 
 	if(htimer->timer.state != RENOIR_TIMER_STATE_NONE)
 		return;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TIMER_BEGIN);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->timer_begin.handle = htimer;
 	htimer->timer.state = RENOIR_TIMER_STATE_BEGIN;
@@ -4342,17 +8284,22 @@ static void
 _renoir_gl450_timer_end(struct Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
 {
 	auto self = api->ctx;
-	auto h = (Renoir_Handle*)pass.handle;
+	Renoir_GL450_Trace_Scope trace_scope{self, __func__};
+	auto h = _renoir_gl450_handle_get(self, pass.handle);
 	assert(h != nullptr);
+	if (h == nullptr)
+		return;
 
-	auto htimer = (Renoir_Handle*)timer.handle;
+	auto htimer = _renoir_gl450_handle_get(self, timer.handle);
 	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
 	if (htimer->timer.state != RENOIR_TIMER_STATE_BEGIN)
 		return;
 
-	mn::mutex_lock(self->mtx);
+	_renoir_gl450_mutex_lock(self);
 	auto command = _renoir_gl450_command_new(self, RENOIR_COMMAND_KIND_TIMER_END);
-	mn::mutex_unlock(self->mtx);
+	_renoir_gl450_mutex_unlock(self);
 
 	command->timer_end.handle = htimer;
 	htimer->timer.state = RENOIR_TIMER_STATE_END;
@@ -4379,8 +8326,11 @@ _renoir_load_api(Renoir* api)
 
 	api->name = _renoir_gl450_name;
 	api->texture_origin = _renoir_gl450_texture_origin;
+	api->stats = _renoir_gl450_stats;
+	api->memory_stats = _renoir_gl450_memory_stats;
 
 	api->handle_ref = _renoir_gl450_handle_ref;
+	api->handle_ready = _renoir_gl450_handle_ready;
 	api->flush = _renoir_gl450_flush;
 
 	api->swapchain_new = _renoir_gl450_swapchain_new;
@@ -4397,12 +8347,16 @@ _renoir_load_api(Renoir* api)
 	api->texture_native_handle = _renoir_gl450_texture_native_handle;
 	api->texture_size = _renoir_gl450_texture_size;
 	api->texture_desc = _renoir_gl450_texture_desc;
+	api->texture_transient = _renoir_gl450_texture_transient;
+	api->texture_transient_free = _renoir_gl450_texture_transient_free;
 
 	api->program_new = _renoir_gl450_program_new;
 	api->program_free = _renoir_gl450_program_free;
 
 	api->compute_new = _renoir_gl450_compute_new;
 	api->compute_free = _renoir_gl450_compute_free;
+	api->program_reflect = _renoir_gl450_program_reflect;
+	api->compute_reflect = _renoir_gl450_compute_reflect;
 
 	api->pass_swapchain_new = _renoir_gl450_pass_swapchain_new;
 	api->pass_offscreen_new = _renoir_gl450_pass_offscreen_new;
@@ -4415,6 +8369,13 @@ _renoir_load_api(Renoir* api)
 	api->timer_free = _renoir_gl450_timer_free;
 	api->timer_elapsed = _renoir_gl450_timer_elapsed;
 
+	api->query_new = _renoir_gl450_query_new;
+	api->query_free = _renoir_gl450_query_free;
+	api->query_result = _renoir_gl450_query_result;
+
+	api->profiler_frame_results = _renoir_gl450_profiler_frame_results;
+	api->trace_export = _renoir_gl450_trace_export;
+
 	api->pass_begin = _renoir_gl450_pass_begin;
 	api->pass_end = _renoir_gl450_pass_end;
 	api->clear = _renoir_gl450_clear;
@@ -4427,19 +8388,31 @@ _renoir_load_api(Renoir* api)
 	api->texture_write = _renoir_gl450_texture_write;
 	api->buffer_zero_global = _renoir_gl450_buffer_zero_global;
 	api->buffer_write_global = _renoir_gl450_buffer_write_global;
+	api->buffer_copy_global = _renoir_gl450_buffer_copy_global;
 	api->texture_write_global = _renoir_gl450_texture_write_global;
+	api->uniform_alloc = _renoir_gl450_uniform_alloc;
 	api->buffer_read = _renoir_gl450_buffer_read;
 	api->texture_read = _renoir_gl450_texture_read;
 	api->buffer_bind = _renoir_gl450_buffer_bind;
+	api->buffer_bind_range = _renoir_gl450_buffer_bind_range;
 	api->buffer_storage_bind = _renoir_gl450_buffer_storage_bind;
 	api->texture_bind = _renoir_gl450_texture_bind;
+	api->uniform_bind = _renoir_gl450_uniform_bind;
 	api->texture_sampler_bind = _renoir_gl450_texture_sampler_bind;
 	api->buffer_compute_bind = _renoir_gl450_buffer_compute_bind;
+	api->buffer_compute_bind_range = _renoir_gl450_buffer_compute_bind_range;
 	api->texture_compute_bind = _renoir_gl450_texture_compute_bind;
 	api->draw = _renoir_gl450_draw;
 	api->dispatch = _renoir_gl450_dispatch;
+	api->memory_barrier = _renoir_gl450_memory_barrier;
 	api->timer_begin = _renoir_gl450_timer_begin;
 	api->timer_end = _renoir_gl450_timer_end;
+	api->query_begin = _renoir_gl450_query_begin;
+	api->query_end = _renoir_gl450_query_end;
+	api->conditional_begin = _renoir_gl450_conditional_begin;
+	api->conditional_end = _renoir_gl450_conditional_end;
+	api->profiler_scope_begin = _renoir_gl450_profiler_scope_begin;
+	api->profiler_scope_end = _renoir_gl450_profiler_scope_end;
 }
 
 Renoir*
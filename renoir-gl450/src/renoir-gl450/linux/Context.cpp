@@ -9,15 +9,31 @@
 #include <X11/Xlib.h>
 #include <GL/glx.h>
 #include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
 
 #include <assert.h>
+#include <string.h>
 
 struct Renoir_GL450_Context
 {
 	::Display* display;
 	bool owns_display;
 	::GLXContext context;
+	::GLXFBConfig fbconfig;
 	::Window dummy_window;
+	// shared contexts (see renoir_gl450_context_shared_new) open their own connection to the display because xlib
+	// connections can't be used from multiple threads without XInitThreads, and they have no dummy window because
+	// they're only bound to be used with offscreen framebuffers
+	bool shared;
+
+	// headless context, it's used instead of the glx context above if the headless setting is enabled
+	bool headless;
+	EGLDisplay egl_display;
+	EGLConfig egl_config;
+	EGLContext egl_context;
+	// 1x1 pbuffer, it's only created if the driver doesn't support surfaceless contexts
+	EGLSurface egl_surface;
 };
 
 inline static int
@@ -48,11 +64,165 @@ _renoir_gl450_msaa_to_int(RENOIR_MSAA_MODE mode)
 using glXCreateContextAttribsARBProc = GLXContext (*)(Display*, GLXFBConfig, GLXContext, Bool, const int*);
 using glXSwapIntervalEXTProc = void (*)(Display* display, GLXDrawable drawable, int interval);
 
+inline static bool
+_renoir_gl450_egl_has_extension(const char* extensions, const char* name)
+{
+	if (extensions == nullptr)
+		return false;
+
+	auto len = ::strlen(name);
+	for (auto it = ::strstr(extensions, name); it != nullptr; it = ::strstr(it + len, name))
+	{
+		if ((it == extensions || it[-1] == ' ') && (it[len] == ' ' || it[len] == '\0'))
+			return true;
+	}
+	return false;
+}
+
+// we first try mesa's surfaceless platform, then the first egl device, so we don't need a running x server
+static EGLDisplay
+_renoir_gl450_egl_display()
+{
+	auto client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	auto eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (eglGetPlatformDisplayEXT == nullptr)
+		return EGL_NO_DISPLAY;
+
+	if (_renoir_gl450_egl_has_extension(client_extensions, "EGL_MESA_platform_surfaceless"))
+	{
+		auto display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+			return display;
+	}
+
+	if (_renoir_gl450_egl_has_extension(client_extensions, "EGL_EXT_platform_device"))
+	{
+		auto eglQueryDevicesEXT = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+		EGLDeviceEXT devices[8];
+		EGLint devices_count = 0;
+		if (eglQueryDevicesEXT && eglQueryDevicesEXT(8, devices, &devices_count))
+		{
+			for (EGLint i = 0; i < devices_count; ++i)
+			{
+				auto display = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+				if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+					return display;
+			}
+		}
+	}
+
+	return EGL_NO_DISPLAY;
+}
+
+static Renoir_GL450_Context*
+_renoir_gl450_context_headless_new()
+{
+	auto display = _renoir_gl450_egl_display();
+	if (display == EGL_NO_DISPLAY)
+	{
+		mn::log_error("gl450: failed to find an egl display for the headless context");
+		return nullptr;
+	}
+	mn_defer(if (display != EGL_NO_DISPLAY) eglTerminate(display));
+
+	if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+		return nullptr;
+
+	const EGLint config_attribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config = nullptr;
+	EGLint config_count = 0;
+	if (eglChooseConfig(display, config_attribs, &config, 1, &config_count) == EGL_FALSE || config_count == 0)
+	{
+		// the surfaceless platform might not expose pbuffer configs, any config works with a surfaceless context
+		const EGLint surfaceless_config_attribs[] = {
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+		if (eglChooseConfig(display, surfaceless_config_attribs, &config, 1, &config_count) == EGL_FALSE || config_count == 0)
+			return nullptr;
+	}
+
+	const EGLint context_attribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 5,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	auto context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+	if (context == EGL_NO_CONTEXT)
+	{
+		mn::log_error("gl450: failed to create an opengl 4.5 core headless context");
+		return nullptr;
+	}
+	mn_defer(if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context));
+
+	EGLSurface surface = EGL_NO_SURFACE;
+	auto display_extensions = eglQueryString(display, EGL_EXTENSIONS);
+	if (_renoir_gl450_egl_has_extension(display_extensions, "EGL_KHR_surfaceless_context") == false)
+	{
+		const EGLint pbuffer_attribs[] = {
+			EGL_WIDTH, 1,
+			EGL_HEIGHT, 1,
+			EGL_NONE
+		};
+		surface = eglCreatePbufferSurface(display, config, pbuffer_attribs);
+		if (surface == EGL_NO_SURFACE)
+			return nullptr;
+	}
+	mn_defer(if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface));
+
+	if (eglMakeCurrent(display, surface, surface, context) == EGL_FALSE)
+		return nullptr;
+
+	glewExperimental = true;
+	auto glew_result = glewInit();
+	// there's no glx display in headless mode so glew fails to load glx extensions after loading the opengl functions
+	assert((glew_result == GLEW_OK || glew_result == GLEW_ERROR_NO_GLX_DISPLAY) && "glewInit failed");
+	(void) glew_result;
+
+	mn::log_info("OpenGL Renderer: {}", glGetString(GL_RENDERER));
+	mn::log_info("OpenGL Version: {}", glGetString(GL_VERSION));
+	mn::log_info("GLSL Version: {}", glGetString(GL_SHADING_LANGUAGE_VERSION));
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthRange(0.0, 1.0);
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_BACK);
+	glFrontFace(GL_CCW);
+
+	glEnable(GL_BLEND);
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+	glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	auto self = mn::alloc_zerod<Renoir_GL450_Context>();
+	self->headless = true;
+	self->egl_display = display;
+	self->egl_config = config;
+	self->egl_context = context;
+	self->egl_surface = surface;
+
+	display = EGL_NO_DISPLAY;
+	context = EGL_NO_CONTEXT;
+	surface = EGL_NO_SURFACE;
+	return self;
+}
+
 // API
 Renoir_GL450_Context*
 renoir_gl450_context_new(Renoir_Settings* settings, void* given_display)
 {
 	if (settings->external_context) return nullptr;
+	if (settings->headless) return _renoir_gl450_context_headless_new();
 
 	const int visual_attribs[] = {
 		GLX_X_RENDERABLE        , True,
@@ -183,6 +353,7 @@ renoir_gl450_context_new(Renoir_Settings* settings, void* given_display)
 
 	auto self = mn::alloc_zerod<Renoir_GL450_Context>();
 	self->context = context;
+	self->fbconfig = bestFbc;
 	self->display = display;
 	self->owns_display = given_display == nullptr;
 	self->dummy_window = dummy_window;
@@ -198,6 +369,18 @@ renoir_gl450_context_free(Renoir_GL450_Context* self)
 {
 	if (self == nullptr) return;
 
+	if (self->headless)
+	{
+		eglMakeCurrent(self->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (self->egl_surface != EGL_NO_SURFACE)
+			eglDestroySurface(self->egl_display, self->egl_surface);
+		eglDestroyContext(self->egl_display, self->egl_context);
+		if (self->shared == false)
+			eglTerminate(self->egl_display);
+		mn::free(self);
+		return;
+	}
+
 	if(self->dummy_window)
 		XDestroyWindow(self->display, self->dummy_window);
 	if (self->context)
@@ -207,10 +390,103 @@ renoir_gl450_context_free(Renoir_GL450_Context* self)
 	mn::free(self);
 }
 
+Renoir_GL450_Context*
+renoir_gl450_context_shared_new(Renoir_GL450_Context* self)
+{
+	if (self == nullptr) return nullptr;
+
+	if (self->headless)
+	{
+		const EGLint context_attribs[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 4,
+			EGL_CONTEXT_MINOR_VERSION, 5,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		auto context = eglCreateContext(self->egl_display, self->egl_config, self->egl_context, context_attribs);
+		if (context == EGL_NO_CONTEXT)
+			return nullptr;
+
+		EGLSurface surface = EGL_NO_SURFACE;
+		if (self->egl_surface != EGL_NO_SURFACE)
+		{
+			const EGLint pbuffer_attribs[] = {
+				EGL_WIDTH, 1,
+				EGL_HEIGHT, 1,
+				EGL_NONE
+			};
+			surface = eglCreatePbufferSurface(self->egl_display, self->egl_config, pbuffer_attribs);
+			if (surface == EGL_NO_SURFACE)
+			{
+				eglDestroyContext(self->egl_display, context);
+				return nullptr;
+			}
+		}
+
+		auto shared = mn::alloc_zerod<Renoir_GL450_Context>();
+		shared->headless = true;
+		shared->shared = true;
+		shared->egl_display = self->egl_display;
+		shared->egl_config = self->egl_config;
+		shared->egl_context = context;
+		shared->egl_surface = surface;
+		return shared;
+	}
+
+	const int major = 4, minor = 5;
+	int context_attribs[] = {
+		GLX_CONTEXT_MAJOR_VERSION_ARB, major,
+		GLX_CONTEXT_MINOR_VERSION_ARB, minor,
+		GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+		None
+	};
+
+	auto glXCreateContextAttribsARB = (glXCreateContextAttribsARBProc)glXGetProcAddressARB((const GLubyte*)"glXCreateContextAttribsARB");
+	if (glXCreateContextAttribsARB == nullptr)
+		return nullptr;
+
+	// the shared context is used by another thread, so it gets its own connection to the same display, fbconfigs are
+	// per connection so we look up the one which matches the main context fbconfig
+	auto display = XOpenDisplay(XDisplayString(self->display));
+	if (display == nullptr)
+		return nullptr;
+	mn_defer(if (display) XCloseDisplay(display));
+
+	int fbconfig_id = 0;
+	glXGetFBConfigAttrib(self->display, self->fbconfig, GLX_FBCONFIG_ID, &fbconfig_id);
+	const int fbconfig_attribs[] = {
+		GLX_FBCONFIG_ID, fbconfig_id,
+		None
+	};
+	int fbcount = 0;
+	auto fbc = glXChooseFBConfig(display, DefaultScreen(display), fbconfig_attribs, &fbcount);
+	if (fbc == nullptr || fbcount == 0)
+		return nullptr;
+	auto fbconfig = fbc[0];
+	XFree(fbc);
+
+	auto context = glXCreateContextAttribsARB(display, fbconfig, self->context, True, context_attribs);
+	if (context == nullptr)
+		return nullptr;
+	XSync(display, False);
+
+	auto shared = mn::alloc_zerod<Renoir_GL450_Context>();
+	shared->display = display;
+	shared->owns_display = true;
+	shared->context = context;
+	shared->fbconfig = fbconfig;
+	shared->dummy_window = None;
+	shared->shared = true;
+
+	display = nullptr;
+	return shared;
+}
+
 void
 renoir_gl450_context_window_init(Renoir_GL450_Context* self, Renoir_Handle* h, Renoir_Settings* settings)
 {
 	if (self == nullptr) return;
+	assert(self->headless == false && "headless context doesn't support swapchains");
 
 	bool result = glXMakeCurrent(self->display, (GLXDrawable)h->swapchain.handle, self->context);
 	assert(result && "glXMakeCurrent");
@@ -254,6 +530,14 @@ renoir_gl450_context_bind(Renoir_GL450_Context* self)
 {
 	if (self == nullptr) return;
 
+	if (self->headless)
+	{
+		bool result = eglMakeCurrent(self->egl_display, self->egl_surface, self->egl_surface, self->egl_context);
+		assert(result && "eglMakeCurrent failed");
+		(void) result;
+		return;
+	}
+
 	bool result = glXMakeCurrent(self->display, self->dummy_window, self->context);
 	assert(result && "glXMakeCurrent failed");
 }
@@ -263,6 +547,14 @@ renoir_gl450_context_unbind(Renoir_GL450_Context* self)
 {
 	if (self == nullptr) return;
 
+	if (self->headless)
+	{
+		bool result = eglMakeCurrent(self->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		assert(result && "eglMakeCurrent failed");
+		(void) result;
+		return;
+	}
+
 	bool result = glXMakeCurrent(self->display, None, NULL);
 	assert(result && "glXMakeCurrent failed");
 }
@@ -270,7 +562,7 @@ renoir_gl450_context_unbind(Renoir_GL450_Context* self)
 void
 renoir_gl450_context_window_present(Renoir_GL450_Context* self, Renoir_Handle* h)
 {
-	if (self == nullptr) return;
+	if (self == nullptr || self->headless) return;
 
 	glXSwapBuffers(self->display, (Window)h->swapchain.handle);
 }
@@ -280,6 +572,15 @@ renoir_gl450_context_reload(Renoir_GL450_Context* self)
 {
 	if (self == nullptr) return;
 
+	if (self->headless)
+	{
+		renoir_gl450_context_bind(self);
+		GLenum glew_result = glewInit();
+		assert((glew_result == GLEW_OK || glew_result == GLEW_ERROR_NO_GLX_DISPLAY) && "glewInit failed");
+		(void)glew_result;
+		return;
+	}
+
 	bool result = glXMakeCurrent(self->display, None, self->context);
 	assert(result && "glXMakeCurrent failed");
 	GLenum glew_result = glewInit();
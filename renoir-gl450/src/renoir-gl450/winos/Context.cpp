@@ -38,6 +38,7 @@ struct Renoir_GL450_Context
 	HGLRC context;
 	HWND dummy_window;
 	HDC dummy_dc;
+	int pixel_format_id;
 };
 
 inline static int
@@ -70,6 +71,8 @@ Renoir_GL450_Context*
 renoir_gl450_context_new(Renoir_Settings* settings, void*)
 {
 	if (settings->external_context) return nullptr;
+	// the dummy window below is never shown so windows doesn't need a separate headless path, headless mode only
+	// disables swapchains there
 
 	HGLRC fake_ctx = NULL;
 	HDC fake_dc = NULL;
@@ -245,6 +248,7 @@ renoir_gl450_context_new(Renoir_Settings* settings, void*)
 	self->context = ctx;
 	self->dummy_dc = dummy_dc;
 	self->dummy_window = dummy_window;
+	self->pixel_format_id = pixel_format_id;
 	return self;
 err:
 	if (fake_ctx) wglDeleteContext(fake_ctx);
@@ -267,6 +271,60 @@ renoir_gl450_context_free(Renoir_GL450_Context* self)
 	mn::free(self);
 }
 
+Renoir_GL450_Context*
+renoir_gl450_context_shared_new(Renoir_GL450_Context* self)
+{
+	if (self == nullptr) return nullptr;
+
+	// each context gets its own hidden window because a dc shouldn't be used by two threads at the same time
+	RECT wr = {0, 0, LONG(1), LONG(1)};
+	AdjustWindowRect(&wr, WS_OVERLAPPEDWINDOW, FALSE);
+	auto dummy_window = CreateWindowExA(
+		NULL,
+		"renoirHiddenWindowClass",
+		"GL Shared Context Window",
+		WS_OVERLAPPEDWINDOW,
+		100,
+		100,
+		wr.right - wr.left,
+		wr.bottom - wr.top,
+		NULL,
+		NULL,
+		NULL,
+		NULL);
+	if (dummy_window == NULL)
+		return nullptr;
+
+	auto dummy_dc = GetDC(dummy_window);
+
+	PIXELFORMATDESCRIPTOR pixel_format{};
+	DescribePixelFormat(dummy_dc, self->pixel_format_id, sizeof(pixel_format), &pixel_format);
+	SetPixelFormat(dummy_dc, self->pixel_format_id, &pixel_format);
+
+	const int major_min = 4, minor_min = 5;
+	int context_attribs[] = {
+		WGL_CONTEXT_MAJOR_VERSION_ARB, major_min,
+		WGL_CONTEXT_MINOR_VERSION_ARB, minor_min,
+		WGL_CONTEXT_PROFILE_MASK_ARB,  WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+		0
+	};
+
+	auto ctx = wglCreateContextAttribsARB(dummy_dc, self->context, context_attribs);
+	if (ctx == NULL)
+	{
+		ReleaseDC(dummy_window, dummy_dc);
+		DestroyWindow(dummy_window);
+		return nullptr;
+	}
+
+	auto shared = mn::alloc<Renoir_GL450_Context>();
+	shared->context = ctx;
+	shared->dummy_dc = dummy_dc;
+	shared->dummy_window = dummy_window;
+	shared->pixel_format_id = self->pixel_format_id;
+	return shared;
+}
+
 void
 renoir_gl450_context_window_init(Renoir_GL450_Context* self, Renoir_Handle* h, Renoir_Settings* settings)
 {
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "renoir-graph/Exports.h"
+#include "renoir/Renoir.h"
+
+// renoir-graph is an optional frame graph layer on top of the renoir api, each frame you declare the passes with the
+// resources they read and write, then renoir_graph_execute culls the passes which don't contribute to any output,
+// allocates the transient resources only for their lifetime so that non-overlapping resources with the same desc
+// reuse the same backend resource (the pools recycle exact desc matches, they don't alias memory), picks the
+// attachments load/store actions, and runs the passes in declaration order
+//
+// ordering guarantees:
+// - the kept passes run in the order they're declared in, culling a pass doesn't reorder the others
+// - a pass sees all the writes of the passes declared before it, the graph issues api->memory_barrier at the start of
+//   every pass which reads or writes a resource written by an earlier pass (read-after-write and write-after-write)
+// - accesses inside a single pass aren't synchronized by the graph, the pass should issue its own barriers between
+//   dependent dispatches if the backend needs them
+// - resources imported into the graph are only synchronized with the other graph passes, not with the commands
+//   recorded outside of renoir_graph_execute
+
+typedef struct Renoir_Graph Renoir_Graph;
+typedef struct Renoir_Graph_Builder Renoir_Graph_Builder;
+
+// graph resource handles are only valid until the next renoir_graph_execute call, 0 is the invalid handle
+typedef struct Renoir_Graph_Texture { int id; } Renoir_Graph_Texture;
+typedef struct Renoir_Graph_Buffer { int id; } Renoir_Graph_Buffer;
+
+typedef enum RENOIR_GRAPH_PASS {
+	RENOIR_GRAPH_PASS_RASTER,
+	RENOIR_GRAPH_PASS_COMPUTE
+} RENOIR_GRAPH_PASS;
+
+typedef struct Renoir_Graph_Attachment {
+	Renoir_Graph_Texture texture;
+	// this is used for cube maps and it should hold face index (RENOIR_CUBE_FACE), otherwise it should be 0
+	int subresource;
+	// this is used to choose which mip map level you want to be attached to the pass
+	int level;
+	// default: false, in which case the previous content is loaded, or discarded if this pass is the first user
+	bool clear;
+	Renoir_Color clear_color; // default: {0, 0, 0, 0}
+	float clear_depth; // default: 0
+	int clear_stencil; // default: 0
+} Renoir_Graph_Attachment;
+
+typedef struct Renoir_Graph_Stats {
+	int passes;
+	int culled_passes;
+	int textures;
+	int buffers;
+	// number of distinct backend resources used by the transient textures/buffers, it's less than their count
+	// when resources with the same desc have non-overlapping lifetimes and reuse each other's backend resource
+	int physical_textures;
+	int physical_buffers;
+	// number of memory barriers issued, one for each executed pass which depends on the writes of an earlier pass
+	int barriers;
+} Renoir_Graph_Stats;
+
+// setup is called inside renoir_graph_pass_new to declare the pass resources using the builder
+typedef void (*Renoir_Graph_Setup)(Renoir_Graph_Builder* builder, void* user_data);
+// execute is called inside renoir_graph_execute between pass_begin and pass_end of the given pass
+typedef void (*Renoir_Graph_Execute)(Renoir_Graph* graph, Renoir_Pass pass, void* user_data);
+
+RENOIR_GRAPH_EXPORT Renoir_Graph*
+renoir_graph_new(Renoir* api);
+
+RENOIR_GRAPH_EXPORT void
+renoir_graph_free(Renoir_Graph* self);
+
+RENOIR_GRAPH_EXPORT Renoir*
+renoir_graph_api(Renoir_Graph* self);
+
+// declares a transient texture which the graph allocates from api->texture_transient when it's used, the name
+// should outlive the renoir_graph_execute call, it's always created as a render target (desc.render_target is
+// forced to true) so that it can be used both as an attachment and by compute passes which only read/write it
+RENOIR_GRAPH_EXPORT Renoir_Graph_Texture
+renoir_graph_texture_new(Renoir_Graph* self, const char* name, Renoir_Texture_Desc desc);
+
+// imports a user owned texture, passes which write to imported resources are never culled
+RENOIR_GRAPH_EXPORT Renoir_Graph_Texture
+renoir_graph_texture_import(Renoir_Graph* self, const char* name, Renoir_Texture texture);
+
+// declares a transient buffer, desc.data should be null since its content is only defined by the passes, so it
+// should be a dynamic buffer
+RENOIR_GRAPH_EXPORT Renoir_Graph_Buffer
+renoir_graph_buffer_new(Renoir_Graph* self, const char* name, Renoir_Buffer_Desc desc);
+
+RENOIR_GRAPH_EXPORT Renoir_Graph_Buffer
+renoir_graph_buffer_import(Renoir_Graph* self, const char* name, Renoir_Buffer buffer);
+
+// declares a pass, passes execute in the same order they are declared in
+RENOIR_GRAPH_EXPORT void
+renoir_graph_pass_new(
+	Renoir_Graph* self,
+	const char* name,
+	RENOIR_GRAPH_PASS kind,
+	Renoir_Graph_Setup setup,
+	Renoir_Graph_Execute execute,
+	void* user_data
+);
+
+// builder functions, they should only be called inside the setup callback
+RENOIR_GRAPH_EXPORT void
+renoir_graph_color(Renoir_Graph_Builder* builder, int slot, Renoir_Graph_Attachment attachment);
+
+RENOIR_GRAPH_EXPORT void
+renoir_graph_depth_stencil(Renoir_Graph_Builder* builder, Renoir_Graph_Attachment attachment);
+
+RENOIR_GRAPH_EXPORT void
+renoir_graph_read_texture(Renoir_Graph_Builder* builder, Renoir_Graph_Texture texture);
+
+// writes which are not attachments (compute image writes), they keep the previous content of the texture
+RENOIR_GRAPH_EXPORT void
+renoir_graph_write_texture(Renoir_Graph_Builder* builder, Renoir_Graph_Texture texture);
+
+RENOIR_GRAPH_EXPORT void
+renoir_graph_read_buffer(Renoir_Graph_Builder* builder, Renoir_Graph_Buffer buffer);
+
+RENOIR_GRAPH_EXPORT void
+renoir_graph_write_buffer(Renoir_Graph_Builder* builder, Renoir_Graph_Buffer buffer);
+
+// marks the pass as having side effects outside of the graph (e.g. it reads back results) so it's never culled
+RENOIR_GRAPH_EXPORT void
+renoir_graph_side_effect(Renoir_Graph_Builder* builder);
+
+// returns the backend resource of the given graph resource, it should only be called inside the execute callback
+RENOIR_GRAPH_EXPORT Renoir_Texture
+renoir_graph_texture(Renoir_Graph* self, Renoir_Graph_Texture texture);
+
+RENOIR_GRAPH_EXPORT Renoir_Buffer
+renoir_graph_buffer(Renoir_Graph* self, Renoir_Graph_Buffer buffer);
+
+// compiles and executes the declared passes then clears them so you can declare the next frame
+RENOIR_GRAPH_EXPORT Renoir_Graph_Stats
+renoir_graph_execute(Renoir_Graph* self);
@@ -0,0 +1,667 @@
+#include "renoir-graph/Graph.h"
+
+#include <mn/Memory.h>
+#include <mn/Buf.h>
+
+#include <assert.h>
+
+// number of frames a pooled transient buffer can stay unused before it's freed
+constexpr uint64_t RENOIR_GRAPH_TRANSIENT_BUFFER_IDLE_FRAMES = 8;
+
+enum RENOIR_GRAPH_RESOURCE
+{
+	RENOIR_GRAPH_RESOURCE_TEXTURE,
+	RENOIR_GRAPH_RESOURCE_BUFFER
+};
+
+enum RENOIR_GRAPH_ACCESS
+{
+	RENOIR_GRAPH_ACCESS_READ,
+	// writes which keep the previous content (compute writes)
+	RENOIR_GRAPH_ACCESS_WRITE,
+	RENOIR_GRAPH_ACCESS_COLOR,
+	RENOIR_GRAPH_ACCESS_DEPTH_STENCIL
+};
+
+struct Renoir_Graph_Resource
+{
+	const char* name;
+	RENOIR_GRAPH_RESOURCE kind;
+	bool imported;
+	Renoir_Texture_Desc texture_desc;
+	Renoir_Buffer_Desc buffer_desc;
+	// backend resource, transient resources only have it between their first and last pass
+	Renoir_Texture texture;
+	Renoir_Buffer buffer;
+
+	// compile state
+	bool needed;
+	int first_pass;
+	int last_pass;
+	int last_writer;
+	int last_access;
+};
+
+struct Renoir_Graph_Access
+{
+	int resource;
+	RENOIR_GRAPH_ACCESS kind;
+	int slot;
+	Renoir_Graph_Attachment attachment;
+	// next access to the same resource in the executed passes, -1 if it's the last one
+	int next;
+};
+
+struct Renoir_Graph_Pass
+{
+	const char* name;
+	RENOIR_GRAPH_PASS kind;
+	Renoir_Graph_Execute execute;
+	void* user_data;
+	size_t access_begin;
+	size_t access_end;
+	bool side_effect;
+	bool culled;
+	// the pass accesses a resource written by an earlier pass so a memory barrier is issued before it runs
+	bool barrier;
+};
+
+struct Renoir_Graph_Pooled_Buffer
+{
+	Renoir_Buffer buffer;
+	Renoir_Buffer_Desc desc;
+	uint64_t last_used_frame;
+	bool in_use;
+};
+
+struct Renoir_Graph_Builder
+{
+	Renoir_Graph* graph;
+	size_t pass;
+};
+
+struct Renoir_Graph
+{
+	Renoir* api;
+	mn::Buf<Renoir_Graph_Resource> resources;
+	mn::Buf<Renoir_Graph_Pass> passes;
+	mn::Buf<Renoir_Graph_Access> accesses;
+	mn::Buf<Renoir_Graph_Pooled_Buffer> buffer_pool;
+	// distinct backend resources used by the transient resources in the current execute
+	mn::Buf<void*> physical_textures;
+	mn::Buf<void*> physical_buffers;
+	// compute passes have no attachments so one pass is reused by all the compute graph passes
+	Renoir_Pass compute_pass;
+	uint64_t frame;
+};
+
+inline static Renoir_Graph_Resource&
+_renoir_graph_resource(Renoir_Graph* self, int id)
+{
+	assert(id > 0 && size_t(id) <= self->resources.count && "invalid graph resource");
+	return self->resources[id - 1];
+}
+
+inline static bool
+_renoir_graph_access_writes(const Renoir_Graph_Access& access)
+{
+	return access.kind != RENOIR_GRAPH_ACCESS_READ;
+}
+
+inline static bool
+_renoir_graph_access_is_attachment(const Renoir_Graph_Access& access)
+{
+	return access.kind == RENOIR_GRAPH_ACCESS_COLOR || access.kind == RENOIR_GRAPH_ACCESS_DEPTH_STENCIL;
+}
+
+// whether the access depends on the previous content of the resource, cleared attachments overwrite it completely
+inline static bool
+_renoir_graph_access_reads(const Renoir_Graph_Access& access)
+{
+	if (_renoir_graph_access_is_attachment(access))
+		return access.attachment.clear == false;
+	return true;
+}
+
+static void
+_renoir_graph_access_push(Renoir_Graph_Builder* builder, int resource, RENOIR_GRAPH_ACCESS kind, int slot, Renoir_Graph_Attachment attachment)
+{
+	auto self = builder->graph;
+	assert(resource > 0 && size_t(resource) <= self->resources.count && "invalid graph resource");
+
+	Renoir_Graph_Access access{};
+	access.resource = resource - 1;
+	access.kind = kind;
+	access.slot = slot;
+	access.attachment = attachment;
+	access.next = -1;
+	mn::buf_push(self->accesses, access);
+}
+
+static void
+_renoir_graph_physical_push(mn::Buf<void*>& physical, void* handle)
+{
+	for (auto p: physical)
+		if (p == handle)
+			return;
+	mn::buf_push(physical, handle);
+}
+
+inline static bool
+_renoir_graph_buffer_match(const Renoir_Buffer_Desc& a, const Renoir_Buffer_Desc& b)
+{
+	return (
+		a.type == b.type &&
+		a.usage == b.usage &&
+		a.access == b.access &&
+		a.data_size == b.data_size &&
+		a.compute_buffer_stride == b.compute_buffer_stride
+	);
+}
+
+static Renoir_Buffer
+_renoir_graph_buffer_acquire(Renoir_Graph* self, Renoir_Buffer_Desc desc)
+{
+	for (auto& pooled: self->buffer_pool)
+	{
+		if (pooled.in_use == false && _renoir_graph_buffer_match(pooled.desc, desc))
+		{
+			pooled.in_use = true;
+			pooled.last_used_frame = self->frame;
+			return pooled.buffer;
+		}
+	}
+
+	Renoir_Graph_Pooled_Buffer pooled{};
+	pooled.buffer = self->api->buffer_new(self->api, desc);
+	pooled.desc = desc;
+	pooled.last_used_frame = self->frame;
+	pooled.in_use = true;
+	mn::buf_push(self->buffer_pool, pooled);
+	return pooled.buffer;
+}
+
+static void
+_renoir_graph_buffer_release(Renoir_Graph* self, Renoir_Buffer buffer)
+{
+	for (auto& pooled: self->buffer_pool)
+	{
+		if (pooled.buffer.handle == buffer.handle)
+		{
+			pooled.in_use = false;
+			pooled.last_used_frame = self->frame;
+			return;
+		}
+	}
+	assert(false && "buffer is not part of the graph pool");
+}
+
+static void
+_renoir_graph_buffer_pool_frame(Renoir_Graph* self)
+{
+	for (size_t i = 0; i < self->buffer_pool.count;)
+	{
+		auto& pooled = self->buffer_pool[i];
+		if (pooled.in_use == false && self->frame - pooled.last_used_frame > RENOIR_GRAPH_TRANSIENT_BUFFER_IDLE_FRAMES)
+		{
+			self->api->buffer_free(self->api, pooled.buffer);
+			mn::buf_remove(self->buffer_pool, i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+// walks the passes backwards keeping only the ones which write to a resource a later kept pass (or the user) needs
+static void
+_renoir_graph_cull(Renoir_Graph* self)
+{
+	for (auto& r: self->resources)
+		r.needed = r.imported;
+
+	for (size_t i = self->passes.count; i > 0; --i)
+	{
+		auto& pass = self->passes[i - 1];
+
+		bool keep = pass.side_effect;
+		for (size_t j = pass.access_begin; j < pass.access_end && keep == false; ++j)
+		{
+			const auto& access = self->accesses[j];
+			if (_renoir_graph_access_writes(access) && self->resources[access.resource].needed)
+				keep = true;
+		}
+
+		pass.culled = keep == false;
+		if (pass.culled)
+			continue;
+
+		// cleared attachments don't depend on the previous writers, then mark what this pass depends on
+		for (size_t j = pass.access_begin; j < pass.access_end; ++j)
+		{
+			const auto& access = self->accesses[j];
+			if (_renoir_graph_access_writes(access) && _renoir_graph_access_reads(access) == false)
+				self->resources[access.resource].needed = false;
+		}
+		for (size_t j = pass.access_begin; j < pass.access_end; ++j)
+		{
+			const auto& access = self->accesses[j];
+			if (_renoir_graph_access_reads(access))
+				self->resources[access.resource].needed = true;
+		}
+	}
+}
+
+// computes the resources lifetimes, the next access of every access, and marks the kept passes which depend on the
+// writes of an earlier pass (read-after-write and write-after-write hazards), returns the number of barriers
+static int
+_renoir_graph_lifetimes(Renoir_Graph* self)
+{
+	for (auto& r: self->resources)
+	{
+		r.first_pass = -1;
+		r.last_pass = -1;
+		r.last_writer = -1;
+		r.last_access = -1;
+	}
+
+	int barriers = 0;
+	for (size_t i = 0; i < self->passes.count; ++i)
+	{
+		auto& pass = self->passes[i];
+		pass.barrier = false;
+		if (pass.culled)
+			continue;
+
+		for (size_t j = pass.access_begin; j < pass.access_end; ++j)
+		{
+			auto& access = self->accesses[j];
+			auto& r = self->resources[access.resource];
+
+			if (r.first_pass == -1)
+				r.first_pass = int(i);
+			r.last_pass = int(i);
+
+			if (r.last_access != -1)
+				self->accesses[r.last_access].next = int(j);
+			r.last_access = int(j);
+
+			if (r.last_writer != -1 && r.last_writer != int(i))
+				pass.barrier = true;
+		}
+		if (pass.barrier)
+			++barriers;
+
+		for (size_t j = pass.access_begin; j < pass.access_end; ++j)
+		{
+			const auto& access = self->accesses[j];
+			if (_renoir_graph_access_writes(access))
+				self->resources[access.resource].last_writer = int(i);
+		}
+	}
+	return barriers;
+}
+
+static Renoir_Pass_Attachment
+_renoir_graph_attachment(Renoir_Graph* self, int pass, const Renoir_Graph_Access& access)
+{
+	const auto& r = self->resources[access.resource];
+
+	Renoir_Pass_Attachment res{};
+	res.texture = r.texture;
+	res.subresource = access.attachment.subresource;
+	res.level = access.attachment.level;
+	res.clear_color = access.attachment.clear_color;
+	res.clear_depth = access.attachment.clear_depth;
+	res.clear_stencil = access.attachment.clear_stencil;
+
+	if (access.attachment.clear)
+		res.load = RENOIR_LOAD_CLEAR;
+	else if (r.imported == false && r.first_pass == pass)
+		res.load = RENOIR_LOAD_DONT_CARE;
+	else
+		res.load = RENOIR_LOAD_LOAD;
+
+	// multisampled render targets which can't be sampled have to be resolved before they're read
+	bool used_later = access.next != -1 || r.imported;
+	bool resolvable = r.texture_desc.msaa != RENOIR_MSAA_MODE_NONE && r.texture_desc.msaa_sampled == false;
+	bool next_is_attachment = access.next != -1 && _renoir_graph_access_is_attachment(self->accesses[access.next]);
+	if (used_later == false)
+		res.store = RENOIR_STORE_DISCARD;
+	else if (resolvable && next_is_attachment == false)
+		res.store = RENOIR_STORE_RESOLVE;
+	else
+		res.store = RENOIR_STORE_STORE;
+	return res;
+}
+
+static void
+_renoir_graph_acquire(Renoir_Graph* self, int pass)
+{
+	const auto& p = self->passes[pass];
+	for (size_t i = p.access_begin; i < p.access_end; ++i)
+	{
+		auto& r = self->resources[self->accesses[i].resource];
+		if (r.imported || r.first_pass != pass)
+			continue;
+
+		if (r.kind == RENOIR_GRAPH_RESOURCE_TEXTURE && r.texture.handle == nullptr)
+		{
+			r.texture = self->api->texture_transient(self->api, r.texture_desc);
+			_renoir_graph_physical_push(self->physical_textures, r.texture.handle);
+		}
+		else if (r.kind == RENOIR_GRAPH_RESOURCE_BUFFER && r.buffer.handle == nullptr)
+		{
+			r.buffer = _renoir_graph_buffer_acquire(self, r.buffer_desc);
+			_renoir_graph_physical_push(self->physical_buffers, r.buffer.handle);
+		}
+	}
+}
+
+// returns the transient resources to their pools after their last pass so later resources with the same desc can reuse them
+static void
+_renoir_graph_release(Renoir_Graph* self, int pass)
+{
+	const auto& p = self->passes[pass];
+	for (size_t i = p.access_begin; i < p.access_end; ++i)
+	{
+		auto& r = self->resources[self->accesses[i].resource];
+		if (r.imported || r.last_pass != pass)
+			continue;
+
+		if (r.kind == RENOIR_GRAPH_RESOURCE_TEXTURE && r.texture.handle != nullptr)
+		{
+			self->api->texture_transient_free(self->api, r.texture);
+			r.texture = Renoir_Texture{};
+		}
+		else if (r.kind == RENOIR_GRAPH_RESOURCE_BUFFER && r.buffer.handle != nullptr)
+		{
+			_renoir_graph_buffer_release(self, r.buffer);
+			r.buffer = Renoir_Buffer{};
+		}
+	}
+}
+
+static void
+_renoir_graph_pass_run(Renoir_Graph* self, int pass)
+{
+	auto api = self->api;
+	const auto& p = self->passes[pass];
+
+	if (p.kind == RENOIR_GRAPH_PASS_RASTER)
+	{
+		Renoir_Pass_Offscreen_Desc desc{};
+		for (size_t i = p.access_begin; i < p.access_end; ++i)
+		{
+			const auto& access = self->accesses[i];
+			if (access.kind == RENOIR_GRAPH_ACCESS_COLOR)
+				desc.color[access.slot] = _renoir_graph_attachment(self, pass, access);
+			else if (access.kind == RENOIR_GRAPH_ACCESS_DEPTH_STENCIL)
+				desc.depth_stencil = _renoir_graph_attachment(self, pass, access);
+		}
+
+		// offscreen passes framebuffers are cached by the backend so creating them each frame is cheap
+		auto offscreen = api->pass_offscreen_new(api, desc);
+		api->pass_begin(api, offscreen);
+		if (p.barrier)
+			api->memory_barrier(api, offscreen);
+		if (p.execute)
+			p.execute(self, offscreen, p.user_data);
+		api->pass_end(api, offscreen);
+		api->pass_free(api, offscreen);
+	}
+	else if (p.kind == RENOIR_GRAPH_PASS_COMPUTE)
+	{
+		if (self->compute_pass.handle == nullptr)
+			self->compute_pass = api->pass_compute_new(api);
+
+		api->pass_begin(api, self->compute_pass);
+		if (p.barrier)
+			api->memory_barrier(api, self->compute_pass);
+		if (p.execute)
+			p.execute(self, self->compute_pass, p.user_data);
+		api->pass_end(api, self->compute_pass);
+	}
+	else
+	{
+		assert(false && "unreachable");
+	}
+}
+
+
+// API
+Renoir_Graph*
+renoir_graph_new(Renoir* api)
+{
+	auto self = mn::alloc_zerod<Renoir_Graph>();
+	self->api = api;
+	self->resources = mn::buf_new<Renoir_Graph_Resource>();
+	self->passes = mn::buf_new<Renoir_Graph_Pass>();
+	self->accesses = mn::buf_new<Renoir_Graph_Access>();
+	self->buffer_pool = mn::buf_new<Renoir_Graph_Pooled_Buffer>();
+	self->physical_textures = mn::buf_new<void*>();
+	self->physical_buffers = mn::buf_new<void*>();
+	return self;
+}
+
+void
+renoir_graph_free(Renoir_Graph* self)
+{
+	if (self == nullptr)
+		return;
+
+	auto api = self->api;
+	for (auto& pooled: self->buffer_pool)
+		api->buffer_free(api, pooled.buffer);
+	if (self->compute_pass.handle != nullptr)
+		api->pass_free(api, self->compute_pass);
+
+	mn::buf_free(self->resources);
+	mn::buf_free(self->passes);
+	mn::buf_free(self->accesses);
+	mn::buf_free(self->buffer_pool);
+	mn::buf_free(self->physical_textures);
+	mn::buf_free(self->physical_buffers);
+	mn::free(self);
+}
+
+Renoir*
+renoir_graph_api(Renoir_Graph* self)
+{
+	return self->api;
+}
+
+Renoir_Graph_Texture
+renoir_graph_texture_new(Renoir_Graph* self, const char* name, Renoir_Texture_Desc desc)
+{
+	assert(desc.data[0] == nullptr && "transient textures can't have initial data");
+
+	Renoir_Graph_Resource r{};
+	r.name = name;
+	r.kind = RENOIR_GRAPH_RESOURCE_TEXTURE;
+	r.texture_desc = desc;
+	// the content is only defined by the passes (attachments or compute writes) so the backends need a render
+	// target to create it without initial data
+	r.texture_desc.render_target = true;
+	mn::buf_push(self->resources, r);
+	return Renoir_Graph_Texture{int(self->resources.count)};
+}
+
+Renoir_Graph_Texture
+renoir_graph_texture_import(Renoir_Graph* self, const char* name, Renoir_Texture texture)
+{
+	assert(texture.handle != nullptr);
+
+	Renoir_Graph_Resource r{};
+	r.name = name;
+	r.kind = RENOIR_GRAPH_RESOURCE_TEXTURE;
+	r.imported = true;
+	r.texture_desc = self->api->texture_desc(self->api, texture);
+	r.texture = texture;
+	mn::buf_push(self->resources, r);
+	return Renoir_Graph_Texture{int(self->resources.count)};
+}
+
+Renoir_Graph_Buffer
+renoir_graph_buffer_new(Renoir_Graph* self, const char* name, Renoir_Buffer_Desc desc)
+{
+	assert(desc.data == nullptr && "transient buffers can't have initial data");
+
+	Renoir_Graph_Resource r{};
+	r.name = name;
+	r.kind = RENOIR_GRAPH_RESOURCE_BUFFER;
+	r.buffer_desc = desc;
+	mn::buf_push(self->resources, r);
+	return Renoir_Graph_Buffer{int(self->resources.count)};
+}
+
+Renoir_Graph_Buffer
+renoir_graph_buffer_import(Renoir_Graph* self, const char* name, Renoir_Buffer buffer)
+{
+	assert(buffer.handle != nullptr);
+
+	Renoir_Graph_Resource r{};
+	r.name = name;
+	r.kind = RENOIR_GRAPH_RESOURCE_BUFFER;
+	r.imported = true;
+	r.buffer = buffer;
+	mn::buf_push(self->resources, r);
+	return Renoir_Graph_Buffer{int(self->resources.count)};
+}
+
+void
+renoir_graph_pass_new(
+	Renoir_Graph* self,
+	const char* name,
+	RENOIR_GRAPH_PASS kind,
+	Renoir_Graph_Setup setup,
+	Renoir_Graph_Execute execute,
+	void* user_data)
+{
+	Renoir_Graph_Pass pass{};
+	pass.name = name;
+	pass.kind = kind;
+	pass.execute = execute;
+	pass.user_data = user_data;
+	pass.access_begin = self->accesses.count;
+	mn::buf_push(self->passes, pass);
+
+	Renoir_Graph_Builder builder{};
+	builder.graph = self;
+	builder.pass = self->passes.count - 1;
+	if (setup)
+		setup(&builder, user_data);
+
+	mn::buf_top(self->passes).access_end = self->accesses.count;
+}
+
+void
+renoir_graph_color(Renoir_Graph_Builder* builder, int slot, Renoir_Graph_Attachment attachment)
+{
+	assert(slot >= 0 && slot < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE);
+	assert(builder->graph->passes[builder->pass].kind == RENOIR_GRAPH_PASS_RASTER && "only raster passes have attachments");
+	assert(_renoir_graph_resource(builder->graph, attachment.texture.id).kind == RENOIR_GRAPH_RESOURCE_TEXTURE);
+	_renoir_graph_access_push(builder, attachment.texture.id, RENOIR_GRAPH_ACCESS_COLOR, slot, attachment);
+}
+
+void
+renoir_graph_depth_stencil(Renoir_Graph_Builder* builder, Renoir_Graph_Attachment attachment)
+{
+	assert(builder->graph->passes[builder->pass].kind == RENOIR_GRAPH_PASS_RASTER && "only raster passes have attachments");
+	assert(_renoir_graph_resource(builder->graph, attachment.texture.id).kind == RENOIR_GRAPH_RESOURCE_TEXTURE);
+	_renoir_graph_access_push(builder, attachment.texture.id, RENOIR_GRAPH_ACCESS_DEPTH_STENCIL, 0, attachment);
+}
+
+void
+renoir_graph_read_texture(Renoir_Graph_Builder* builder, Renoir_Graph_Texture texture)
+{
+	assert(_renoir_graph_resource(builder->graph, texture.id).kind == RENOIR_GRAPH_RESOURCE_TEXTURE);
+	_renoir_graph_access_push(builder, texture.id, RENOIR_GRAPH_ACCESS_READ, 0, Renoir_Graph_Attachment{});
+}
+
+void
+renoir_graph_write_texture(Renoir_Graph_Builder* builder, Renoir_Graph_Texture texture)
+{
+	assert(_renoir_graph_resource(builder->graph, texture.id).kind == RENOIR_GRAPH_RESOURCE_TEXTURE);
+	_renoir_graph_access_push(builder, texture.id, RENOIR_GRAPH_ACCESS_WRITE, 0, Renoir_Graph_Attachment{});
+}
+
+void
+renoir_graph_read_buffer(Renoir_Graph_Builder* builder, Renoir_Graph_Buffer buffer)
+{
+	assert(_renoir_graph_resource(builder->graph, buffer.id).kind == RENOIR_GRAPH_RESOURCE_BUFFER);
+	_renoir_graph_access_push(builder, buffer.id, RENOIR_GRAPH_ACCESS_READ, 0, Renoir_Graph_Attachment{});
+}
+
+void
+renoir_graph_write_buffer(Renoir_Graph_Builder* builder, Renoir_Graph_Buffer buffer)
+{
+	assert(_renoir_graph_resource(builder->graph, buffer.id).kind == RENOIR_GRAPH_RESOURCE_BUFFER);
+	_renoir_graph_access_push(builder, buffer.id, RENOIR_GRAPH_ACCESS_WRITE, 0, Renoir_Graph_Attachment{});
+}
+
+void
+renoir_graph_side_effect(Renoir_Graph_Builder* builder)
+{
+	builder->graph->passes[builder->pass].side_effect = true;
+}
+
+Renoir_Texture
+renoir_graph_texture(Renoir_Graph* self, Renoir_Graph_Texture texture)
+{
+	const auto& r = _renoir_graph_resource(self, texture.id);
+	assert(r.kind == RENOIR_GRAPH_RESOURCE_TEXTURE);
+	return r.texture;
+}
+
+Renoir_Buffer
+renoir_graph_buffer(Renoir_Graph* self, Renoir_Graph_Buffer buffer)
+{
+	const auto& r = _renoir_graph_resource(self, buffer.id);
+	assert(r.kind == RENOIR_GRAPH_RESOURCE_BUFFER);
+	return r.buffer;
+}
+
+Renoir_Graph_Stats
+renoir_graph_execute(Renoir_Graph* self)
+{
+	Renoir_Graph_Stats stats{};
+
+	_renoir_graph_cull(self);
+	stats.barriers = _renoir_graph_lifetimes(self);
+
+	mn::buf_clear(self->physical_textures);
+	mn::buf_clear(self->physical_buffers);
+	for (size_t i = 0; i < self->passes.count; ++i)
+	{
+		if (self->passes[i].culled)
+		{
+			++stats.culled_passes;
+			continue;
+		}
+
+		_renoir_graph_acquire(self, int(i));
+		_renoir_graph_pass_run(self, int(i));
+		_renoir_graph_release(self, int(i));
+	}
+
+	stats.passes = int(self->passes.count);
+	for (const auto& r: self->resources)
+	{
+		if (r.kind == RENOIR_GRAPH_RESOURCE_TEXTURE)
+			++stats.textures;
+		else
+			++stats.buffers;
+	}
+	stats.physical_textures = int(self->physical_textures.count);
+	stats.physical_buffers = int(self->physical_buffers.count);
+
+	++self->frame;
+	_renoir_graph_buffer_pool_frame(self);
+
+	mn::buf_clear(self->resources);
+	mn::buf_clear(self->passes);
+	mn::buf_clear(self->accesses);
+	return stats;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "renoir/Renoir.h"
+
+#include <mn/Base.h>
+
+#include <atomic>
+
+struct Renoir_Command;
+
+enum RENOIR_NULL_STATE
+{
+	// timer/query has not added begin
+	RENOIR_NULL_STATE_NONE,
+	// timer/query has added a begin but not an end yet
+	RENOIR_NULL_STATE_BEGIN,
+	// timer/query has added an end but it didn't execute yet
+	RENOIR_NULL_STATE_END,
+	// timer/query end has executed and its result is ready but not polled yet
+	RENOIR_NULL_STATE_READY,
+};
+
+enum RENOIR_HANDLE_KIND
+{
+	RENOIR_HANDLE_KIND_NONE,
+	RENOIR_HANDLE_KIND_SWAPCHAIN,
+	RENOIR_HANDLE_KIND_RASTER_PASS,
+	RENOIR_HANDLE_KIND_COMPUTE_PASS,
+	RENOIR_HANDLE_KIND_BUFFER,
+	RENOIR_HANDLE_KIND_TEXTURE,
+	RENOIR_HANDLE_KIND_PROGRAM,
+	RENOIR_HANDLE_KIND_COMPUTE,
+	RENOIR_HANDLE_KIND_TIMER,
+	RENOIR_HANDLE_KIND_QUERY,
+	RENOIR_HANDLE_KIND_COUNT,
+};
+
+struct Renoir_Handle
+{
+	RENOIR_HANDLE_KIND kind;
+	// public id of the handle (see Renoir_Null_Handle_Table), 0 once the handle is freed, it's atomic because
+	// ids are resolved without locking
+	std::atomic<uint32_t> id;
+	std::atomic<int> rc;
+	union
+	{
+		struct
+		{
+			int width;
+			int height;
+		} swapchain;
+
+		struct
+		{
+			Renoir_Command *command_list_head;
+			Renoir_Command *command_list_tail;
+			// used when rendering is done on screen/window
+			Renoir_Handle* swapchain;
+			// used when rendering is done off screen
+			int width, height;
+			Renoir_Pass_Offscreen_Desc offscreen;
+		} raster_pass;
+
+		struct
+		{
+			Renoir_Command *command_list_head;
+			Renoir_Command *command_list_tail;
+		} compute_pass;
+
+		struct
+		{
+			// cpu memory which stands in for the gpu buffer, it's empty until the buffer new command executes
+			mn::Block data;
+			RENOIR_BUFFER type;
+			RENOIR_USAGE usage;
+			RENOIR_ACCESS access;
+			size_t size;
+			// index of the memory stats tag
+			int memory_tag;
+		} buffer;
+
+		struct
+		{
+			// cpu memory of the first mip level, faces of cube maps are stored one after the other
+			mn::Block data;
+			Renoir_Texture_Desc desc;
+			// index of the memory stats tag
+			int memory_tag;
+		} texture;
+
+		struct
+		{
+			RENOIR_NULL_STATE state;
+		} timer;
+
+		struct
+		{
+			RENOIR_QUERY kind;
+			// state of the last issued begin/end pair, it never reaches ready because the results are counted below
+			RENOIR_NULL_STATE state;
+			// number of begin/end pairs whose results are not read yet, it's bounded like the gl450 query ring
+			int pending;
+			// number of pending pairs whose end has executed
+			int ready;
+		} query;
+	};
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "renoir-null/Exports.h"
+#include "renoir/Renoir.h"
+
+extern "C" RENOIR_NULL_EXPORT Renoir*
+renoir_api();
@@ -0,0 +1,3406 @@
+#include "renoir-null/Renoir-null.h"
+#include "renoir-null/Handle.h"
+
+#include <renoir-backend/Transient.h>
+
+#include <mn/Memory.h>
+#include <mn/Thread.h>
+#include <mn/Pool.h>
+#include <mn/Defer.h>
+#include <mn/IO.h>
+#include <mn/Log.h>
+#include <mn/Map.h>
+#include <mn/Buf.h>
+#include <mn/Ring.h>
+#include <mn/Str.h>
+#include <mn/Debug.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// the null backend records and executes commands exactly like the other backends but it never talks to a gpu,
+// buffers and textures are backed by cpu memory so reads return what was written, which makes it useful for
+// headless tests, tools, and servers which need to run the same rendering code without a gpu
+
+inline static size_t
+_renoir_pixelformat_size(RENOIR_PIXELFORMAT format)
+{
+	switch (format)
+	{
+	case RENOIR_PIXELFORMAT_RGBA8: return 4;
+	case RENOIR_PIXELFORMAT_R16I: return 2;
+	case RENOIR_PIXELFORMAT_R16UI: return 2;
+	case RENOIR_PIXELFORMAT_R16F: return 2;
+	case RENOIR_PIXELFORMAT_R32F: return 4;
+	case RENOIR_PIXELFORMAT_R16G16B16A16F: return 8;
+	case RENOIR_PIXELFORMAT_R32G32F: return 8;
+	case RENOIR_PIXELFORMAT_R32G32B32A32F: return 16;
+	case RENOIR_PIXELFORMAT_D24S8: return 4;
+	case RENOIR_PIXELFORMAT_D32: return 4;
+	case RENOIR_PIXELFORMAT_R8: return 1;
+	default: assert(false && "unreachable"); return 0;
+	}
+}
+
+inline static size_t
+_renoir_type_size(RENOIR_TYPE type)
+{
+	switch (type)
+	{
+	case RENOIR_TYPE_UINT8: return 1;
+	case RENOIR_TYPE_UINT8_4: return 4;
+	case RENOIR_TYPE_UINT8_4N: return 4;
+	case RENOIR_TYPE_UINT16: return 2;
+	case RENOIR_TYPE_UINT32: return 4;
+	case RENOIR_TYPE_INT16: return 2;
+	case RENOIR_TYPE_INT32: return 4;
+	case RENOIR_TYPE_FLOAT: return 4;
+	case RENOIR_TYPE_FLOAT_2: return 8;
+	case RENOIR_TYPE_FLOAT_3: return 12;
+	case RENOIR_TYPE_FLOAT_4: return 16;
+	default: assert(false && "unreachable"); return 0;
+	}
+}
+
+inline static const char*
+_renoir_handle_kind_name(RENOIR_HANDLE_KIND kind)
+{
+	switch(kind)
+	{
+	case RENOIR_HANDLE_KIND_NONE: return "none";
+	case RENOIR_HANDLE_KIND_SWAPCHAIN: return "swapchain";
+	case RENOIR_HANDLE_KIND_RASTER_PASS: return "raster_pass";
+	case RENOIR_HANDLE_KIND_COMPUTE_PASS: return "compute_pass";
+	case RENOIR_HANDLE_KIND_BUFFER: return "buffer";
+	case RENOIR_HANDLE_KIND_TEXTURE: return "texture";
+	case RENOIR_HANDLE_KIND_PROGRAM: return "program";
+	case RENOIR_HANDLE_KIND_COMPUTE: return "compute";
+	case RENOIR_HANDLE_KIND_TIMER: return "timer";
+	case RENOIR_HANDLE_KIND_QUERY: return "query";
+	default: assert(false && "unreachable"); return "<UNKNOWN>";
+	}
+}
+
+inline static const char*
+_renoir_memory_name(RENOIR_MEMORY kind)
+{
+	switch(kind)
+	{
+	case RENOIR_MEMORY_BUFFER: return "buffer";
+	case RENOIR_MEMORY_TEXTURE: return "texture";
+	case RENOIR_MEMORY_RENDERBUFFER: return "renderbuffer";
+	case RENOIR_MEMORY_FRAMEBUFFER: return "framebuffer";
+	default: assert(false && "invalid memory kind"); return "<INVALID>";
+	}
+}
+
+inline static bool
+_renoir_handle_kind_should_track(RENOIR_HANDLE_KIND kind)
+{
+	return kind != RENOIR_HANDLE_KIND_NONE;
+}
+
+enum RENOIR_COMMAND_KIND
+{
+	RENOIR_COMMAND_KIND_NONE,
+	RENOIR_COMMAND_KIND_SWAPCHAIN_FREE,
+	RENOIR_COMMAND_KIND_PASS_FREE,
+	RENOIR_COMMAND_KIND_BUFFER_NEW,
+	RENOIR_COMMAND_KIND_BUFFER_FREE,
+	RENOIR_COMMAND_KIND_TEXTURE_NEW,
+	RENOIR_COMMAND_KIND_TEXTURE_FREE,
+	RENOIR_COMMAND_KIND_PROGRAM_FREE,
+	RENOIR_COMMAND_KIND_COMPUTE_FREE,
+	RENOIR_COMMAND_KIND_TIMER_FREE,
+	RENOIR_COMMAND_KIND_QUERY_FREE,
+	RENOIR_COMMAND_KIND_PASS_BEGIN,
+	RENOIR_COMMAND_KIND_PASS_END,
+	RENOIR_COMMAND_KIND_PASS_CLEAR,
+	RENOIR_COMMAND_KIND_USE_PIPELINE,
+	RENOIR_COMMAND_KIND_USE_PROGRAM,
+	RENOIR_COMMAND_KIND_USE_COMPUTE,
+	RENOIR_COMMAND_KIND_SCISSOR,
+	RENOIR_COMMAND_KIND_BUFFER_CLEAR,
+	RENOIR_COMMAND_KIND_BUFFER_WRITE,
+	RENOIR_COMMAND_KIND_BUFFER_COPY,
+	RENOIR_COMMAND_KIND_TEXTURE_WRITE,
+	RENOIR_COMMAND_KIND_BUFFER_READ,
+	RENOIR_COMMAND_KIND_TEXTURE_READ,
+	RENOIR_COMMAND_KIND_BUFFER_BIND,
+	RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND,
+	RENOIR_COMMAND_KIND_TEXTURE_BIND,
+	RENOIR_COMMAND_KIND_DRAW,
+	RENOIR_COMMAND_KIND_DISPATCH,
+	RENOIR_COMMAND_KIND_MEMORY_BARRIER,
+	RENOIR_COMMAND_KIND_TIMER_BEGIN,
+	RENOIR_COMMAND_KIND_TIMER_END,
+	RENOIR_COMMAND_KIND_QUERY_BEGIN,
+	RENOIR_COMMAND_KIND_QUERY_END,
+	RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN,
+	RENOIR_COMMAND_KIND_CONDITIONAL_END,
+	RENOIR_COMMAND_KIND_COUNT,
+};
+
+inline static const char*
+_renoir_command_kind_name(RENOIR_COMMAND_KIND kind)
+{
+	switch(kind)
+	{
+	case RENOIR_COMMAND_KIND_NONE: return "none";
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE: return "swapchain_free";
+	case RENOIR_COMMAND_KIND_PASS_FREE: return "pass_free";
+	case RENOIR_COMMAND_KIND_BUFFER_NEW: return "buffer_new";
+	case RENOIR_COMMAND_KIND_BUFFER_FREE: return "buffer_free";
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW: return "texture_new";
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE: return "texture_free";
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE: return "program_free";
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE: return "compute_free";
+	case RENOIR_COMMAND_KIND_TIMER_FREE: return "timer_free";
+	case RENOIR_COMMAND_KIND_QUERY_FREE: return "query_free";
+	case RENOIR_COMMAND_KIND_PASS_BEGIN: return "pass_begin";
+	case RENOIR_COMMAND_KIND_PASS_END: return "pass_end";
+	case RENOIR_COMMAND_KIND_PASS_CLEAR: return "pass_clear";
+	case RENOIR_COMMAND_KIND_USE_PIPELINE: return "use_pipeline";
+	case RENOIR_COMMAND_KIND_USE_PROGRAM: return "use_program";
+	case RENOIR_COMMAND_KIND_USE_COMPUTE: return "use_compute";
+	case RENOIR_COMMAND_KIND_SCISSOR: return "scissor";
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR: return "buffer_clear";
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE: return "buffer_write";
+	case RENOIR_COMMAND_KIND_BUFFER_COPY: return "buffer_copy";
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE: return "texture_write";
+	case RENOIR_COMMAND_KIND_BUFFER_READ: return "buffer_read";
+	case RENOIR_COMMAND_KIND_TEXTURE_READ: return "texture_read";
+	case RENOIR_COMMAND_KIND_BUFFER_BIND: return "buffer_bind";
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND: return "buffer_storage_bind";
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND: return "texture_bind";
+	case RENOIR_COMMAND_KIND_DRAW: return "draw";
+	case RENOIR_COMMAND_KIND_DISPATCH: return "dispatch";
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER: return "memory_barrier";
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN: return "timer_begin";
+	case RENOIR_COMMAND_KIND_TIMER_END: return "timer_end";
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN: return "query_begin";
+	case RENOIR_COMMAND_KIND_QUERY_END: return "query_end";
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN: return "conditional_begin";
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END: return "conditional_end";
+	default: assert(false && "unreachable"); return "<UNKNOWN>";
+	}
+}
+
+struct Renoir_Command
+{
+	Renoir_Command *prev, *next;
+	RENOIR_COMMAND_KIND kind;
+	union
+	{
+		struct
+		{
+			Renoir_Handle* handle;
+		} swapchain_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} pass_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			Renoir_Buffer_Desc desc;
+			bool owns_data;
+		} buffer_new;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} buffer_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			Renoir_Texture_Desc desc;
+			bool owns_data;
+		} texture_new;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} texture_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} program_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} compute_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} timer_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} query_free;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} pass_begin;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} pass_end;
+
+		struct
+		{
+			Renoir_Clear_Desc desc;
+		} pass_clear;
+
+		struct
+		{
+			Renoir_Pipeline_Desc pipeline_desc;
+		} use_pipeline;
+
+		struct
+		{
+			Renoir_Handle* program;
+		} use_program;
+
+		struct
+		{
+			Renoir_Handle* compute;
+		} use_compute;
+
+		struct
+		{
+			int x, y, w, h;
+		} scissor;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} buffer_clear;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			size_t offset;
+			void* bytes;
+			size_t bytes_size;
+		} buffer_write;
+
+		struct
+		{
+			Renoir_Handle* dst;
+			size_t dst_offset;
+			Renoir_Handle* src;
+			size_t src_offset;
+			size_t size;
+		} buffer_copy;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			Renoir_Texture_Edit_Desc desc;
+		} texture_write;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			size_t offset;
+			void* bytes;
+			size_t bytes_size;
+		} buffer_read;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			Renoir_Texture_Edit_Desc desc;
+		} texture_read;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			RENOIR_SHADER shader;
+			int slot;
+			RENOIR_ACCESS gpu_access;
+			// a size of 0 binds the whole buffer
+			size_t offset;
+			size_t size;
+		} buffer_bind;
+
+		struct
+		{
+			Renoir_Buffer_Storage_Bind_Desc desc;
+		} buffer_storage_bind;
+
+		struct
+		{
+			Renoir_Handle* handle;
+			RENOIR_SHADER shader;
+			int slot;
+			int level;
+			RENOIR_ACCESS gpu_access;
+		} texture_bind;
+
+		struct
+		{
+			Renoir_Draw_Desc desc;
+		} draw;
+
+		struct
+		{
+			int x, y, z;
+		} dispatch;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} timer_begin;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} timer_end;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} query_begin;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} query_end;
+
+		struct
+		{
+			Renoir_Handle* handle;
+		} conditional_begin;
+	};
+};
+
+struct Renoir_Leak_Info
+{
+	void* callstack[20];
+	size_t callstack_size;
+};
+
+// per-frame uniform allocator, there's no gpu frames in flight so a single segment is enough
+struct Renoir_Null_Uniform_Ring
+{
+	Renoir_Handle* buffer;
+	size_t alignment;
+	size_t offset;
+};
+
+// number of begin/end pairs a query can have before its results are read, it matches RENOIR_GL450_QUERY_RING
+constexpr int RENOIR_NULL_QUERY_RING = 4;
+
+struct Renoir_Null_Memory_Tag
+{
+	mn::Str name;
+	Renoir_Memory_Counter counter;
+};
+
+// estimated gpu memory footprint of the alive resources, it's computed like the gl450 one so the numbers match,
+// and it's updated with the mutex locked
+struct Renoir_Null_Memory
+{
+	Renoir_Memory_Counter total;
+	Renoir_Memory_Counter kinds[RENOIR_MEMORY_COUNT];
+	// tags are never removed so that handles can refer to them by index, the first one is for untagged resources
+	mn::Buf<Renoir_Null_Memory_Tag> tags;
+};
+
+struct Renoir_Null_Stats
+{
+	// current frame counters, they are moved to last_frame in flush/swapchain_present
+	Renoir_Stats frame;
+	int command_counts[RENOIR_COMMAND_KIND_COUNT];
+	Renoir_Stats last_frame;
+
+	// lifetime counters
+	int live_handles[RENOIR_HANDLE_KIND_COUNT];
+	size_t alive_handles;
+	size_t alive_commands;
+	size_t command_pool_high_water_mark;
+	size_t handle_pool_high_water_mark;
+};
+
+// public handles are 32-bit ids which pack the handle kind, the slot index and the slot generation, it's the same
+// layout as the gl450 one so stale ids are detected the same way
+constexpr uint32_t RENOIR_NULL_HANDLE_INDEX_BITS = 18;
+constexpr uint32_t RENOIR_NULL_HANDLE_GENERATION_BITS = 10;
+constexpr uint32_t RENOIR_NULL_HANDLE_KIND_SHIFT = RENOIR_NULL_HANDLE_INDEX_BITS + RENOIR_NULL_HANDLE_GENERATION_BITS;
+constexpr uint32_t RENOIR_NULL_HANDLE_INDEX_MASK = (1u << RENOIR_NULL_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t RENOIR_NULL_HANDLE_GENERATION_MASK = (1u << RENOIR_NULL_HANDLE_GENERATION_BITS) - 1;
+// freed slots are reused in fifo order once there are RENOIR_NULL_HANDLE_MIN_FREE_SLOTS of them like in gl450, so the
+// generation of a slot doesn't wrap after a few seconds of create/free churn
+constexpr uint32_t RENOIR_NULL_HANDLE_MIN_FREE_SLOTS = 1024;
+constexpr uint32_t RENOIR_NULL_HANDLE_CHUNK_SIZE = 128;
+constexpr uint32_t RENOIR_NULL_HANDLE_CHUNKS_COUNT = (1u << RENOIR_NULL_HANDLE_INDEX_BITS) / RENOIR_NULL_HANDLE_CHUNK_SIZE;
+static_assert(RENOIR_HANDLE_KIND_COUNT <= (1u << (32 - RENOIR_NULL_HANDLE_KIND_SHIFT)), "handle kind doesn't fit in the id");
+
+struct Renoir_Null_Handle_Chunk
+{
+	Renoir_Handle handles[RENOIR_NULL_HANDLE_CHUNK_SIZE];
+	// generations live outside of the handles because the handles are cleared when they're reused
+	uint32_t generations[RENOIR_NULL_HANDLE_CHUNK_SIZE];
+};
+
+// dense table of the handles of one kind, chunks never move once they're allocated and the chunk pointers and the
+// handle ids are atomic so ids can be resolved without locking the mutex, free slots are reused in fifo order
+struct Renoir_Null_Handle_Table
+{
+	std::atomic<Renoir_Null_Handle_Chunk*> chunks[RENOIR_NULL_HANDLE_CHUNKS_COUNT];
+	uint32_t slots_count;
+	mn::Ring<uint32_t> free_slots;
+};
+
+struct IRenoir
+{
+	mn::Mutex mtx;
+	Renoir_Null_Handle_Table handles[RENOIR_HANDLE_KIND_COUNT];
+	mn::Pool command_pool;
+	Renoir_Settings settings;
+
+	// global command list
+	Renoir_Command *command_list_head;
+	Renoir_Command *command_list_tail;
+
+	// command execution context
+	Renoir_Handle* current_program;
+	Renoir_Handle* current_compute;
+	Renoir_Handle* current_pass;
+	Renoir_Handle* current_conditional;
+
+	// per-frame transient uniform allocator
+	Renoir_Null_Uniform_Ring uniform_ring;
+
+	// per-frame transient render targets
+	Renoir_Transient_Pool transient_pool;
+
+	// most recently used sampler descs first, there are no sampler objects to create but the cache is
+	// modelled so that the sampler cache stats match the gpu backends
+	mn::Buf<Renoir_Sampler_Desc> sampler_cache;
+
+	// backend statistics, they are updated with the mutex locked
+	Renoir_Null_Stats stats;
+
+	// resources memory accounting
+	Renoir_Null_Memory memory;
+
+	// leak detection callstacks, alive handles are found by walking the handle tables
+	#if RENOIR_LEAK
+	mn::Map<Renoir_Handle*, Renoir_Leak_Info> alive_handles;
+	#endif
+};
+
+inline static void
+_renoir_null_memory_counter_update(Renoir_Memory_Counter& counter, size_t bytes, bool alloc)
+{
+	if (alloc)
+	{
+		++counter.count;
+		counter.bytes += bytes;
+		if (counter.bytes > counter.high_water_mark)
+			counter.high_water_mark = counter.bytes;
+	}
+	else
+	{
+		--counter.count;
+		counter.bytes -= bytes;
+	}
+}
+
+// returns the index of the given memory tag, null is the untagged resources tag
+static int
+_renoir_null_memory_tag(IRenoir* self, const char* tag)
+{
+	if (tag == nullptr)
+		return 0;
+
+	auto& tags = self->memory.tags;
+	for (size_t i = 1; i < tags.count; ++i)
+		if (::strcmp(tags[i].name.ptr, tag) == 0)
+			return int(i);
+
+	mn::buf_push(tags, Renoir_Null_Memory_Tag{mn::str_from_c(tag), Renoir_Memory_Counter{}});
+	return int(tags.count - 1);
+}
+
+// estimated footprint of the texture storage (all mipmaps and cube faces), and of its msaa renderbuffers
+static void
+_renoir_null_texture_memory(const Renoir_Texture_Desc& desc, size_t& texture_bytes, size_t& renderbuffer_bytes)
+{
+	auto pixel_size = _renoir_pixelformat_size(desc.pixel_format);
+	size_t width = desc.size.width;
+	size_t height = desc.size.height > 0 ? desc.size.height : 1;
+	size_t depth = desc.size.depth > 0 ? desc.size.depth : 1;
+	size_t faces = desc.cube_map ? 6 : 1;
+
+	texture_bytes = 0;
+	renderbuffer_bytes = 0;
+
+	if (desc.msaa_sampled)
+	{
+		texture_bytes = width * height * pixel_size * size_t(desc.msaa);
+		return;
+	}
+
+	if (desc.render_target && desc.msaa != RENOIR_MSAA_MODE_NONE && desc.size.height > 0 && desc.size.depth == 0)
+		renderbuffer_bytes = width * height * pixel_size * size_t(desc.msaa) * faces;
+
+	for (int i = 0; i < desc.mipmaps; ++i)
+	{
+		texture_bytes += width * height * depth * pixel_size * faces;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		depth = depth > 1 ? depth / 2 : 1;
+	}
+}
+
+// accounts the memory of buffer and texture handles, alloc is true when they're created and false when they're freed
+static void
+_renoir_null_memory_handle(IRenoir* self, Renoir_Handle* h, bool alloc)
+{
+	auto& memory = self->memory;
+
+	size_t bytes = 0;
+	int tag = 0;
+	if (h->kind == RENOIR_HANDLE_KIND_BUFFER)
+	{
+		bytes = h->buffer.size;
+		tag = h->buffer.memory_tag;
+		_renoir_null_memory_counter_update(memory.kinds[RENOIR_MEMORY_BUFFER], bytes, alloc);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_TEXTURE)
+	{
+		size_t texture_bytes = 0, renderbuffer_bytes = 0;
+		_renoir_null_texture_memory(h->texture.desc, texture_bytes, renderbuffer_bytes);
+		_renoir_null_memory_counter_update(memory.kinds[RENOIR_MEMORY_TEXTURE], texture_bytes, alloc);
+		if (renderbuffer_bytes > 0)
+			_renoir_null_memory_counter_update(memory.kinds[RENOIR_MEMORY_RENDERBUFFER], renderbuffer_bytes, alloc);
+		bytes = texture_bytes + renderbuffer_bytes;
+		tag = h->texture.memory_tag;
+	}
+	else
+	{
+		return;
+	}
+
+	_renoir_null_memory_counter_update(memory.total, bytes, alloc);
+	_renoir_null_memory_counter_update(memory.tags[tag].counter, bytes, alloc);
+}
+
+static Renoir_Handle*
+_renoir_null_handle_new(IRenoir* self, RENOIR_HANDLE_KIND kind)
+{
+	auto& table = self->handles[kind];
+	uint32_t index = 0;
+	// the queue is drained below its minimum depth only when the table is full
+	if (table.free_slots.count >= RENOIR_NULL_HANDLE_MIN_FREE_SLOTS || (table.free_slots.count > 0 && table.slots_count > RENOIR_NULL_HANDLE_INDEX_MASK))
+	{
+		index = mn::ring_front(table.free_slots);
+		mn::ring_pop_front(table.free_slots);
+	}
+	else
+	{
+		assert(table.slots_count <= RENOIR_NULL_HANDLE_INDEX_MASK && "renoir handle table is full");
+		index = table.slots_count++;
+		auto& chunk = table.chunks[index / RENOIR_NULL_HANDLE_CHUNK_SIZE];
+		if (chunk == nullptr)
+			chunk.store(mn::alloc_zerod<Renoir_Null_Handle_Chunk>(), std::memory_order_release);
+	}
+
+	auto chunk = table.chunks[index / RENOIR_NULL_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_NULL_HANDLE_CHUNK_SIZE;
+	// generation 0 is never used so that no id is 0
+	if (chunk->generations[slot] == 0)
+		chunk->generations[slot] = 1;
+
+	auto handle = &chunk->handles[slot];
+	memset(handle, 0, sizeof(*handle));
+	handle->kind = kind;
+	handle->rc = 1;
+	// the id is published last so that a concurrent handle_get never sees a half initialized handle
+	handle->id.store((uint32_t(kind) << RENOIR_NULL_HANDLE_KIND_SHIFT) | (chunk->generations[slot] << RENOIR_NULL_HANDLE_INDEX_BITS) | index, std::memory_order_release);
+
+	++self->stats.live_handles[kind];
+	if (++self->stats.alive_handles > self->stats.handle_pool_high_water_mark)
+		self->stats.handle_pool_high_water_mark = self->stats.alive_handles;
+
+	#if RENOIR_LEAK
+	if (_renoir_handle_kind_should_track(kind))
+	{
+		Renoir_Leak_Info info{};
+		info.callstack_size = mn::callstack_capture(info.callstack, 20);
+		mn::map_insert(self->alive_handles, handle, info);
+	}
+	#endif
+
+	return handle;
+}
+
+// resolves a public id to its handle, it returns null for the null id and for stale ids of freed handles
+static Renoir_Handle*
+_renoir_null_handle_get(IRenoir* self, const void* handle)
+{
+	if (handle == nullptr)
+		return nullptr;
+
+	auto value = uintptr_t(handle);
+	auto id = uint32_t(value);
+	auto kind = id >> RENOIR_NULL_HANDLE_KIND_SHIFT;
+	auto index = id & RENOIR_NULL_HANDLE_INDEX_MASK;
+	Renoir_Handle* res = nullptr;
+	if (value == id && kind < RENOIR_HANDLE_KIND_COUNT)
+	{
+		if (auto chunk = self->handles[kind].chunks[index / RENOIR_NULL_HANDLE_CHUNK_SIZE].load(std::memory_order_acquire))
+			res = &chunk->handles[index % RENOIR_NULL_HANDLE_CHUNK_SIZE];
+	}
+
+	if (res == nullptr || res->id.load(std::memory_order_acquire) != id)
+	{
+		mn::log_error("null: invalid renoir handle {:#x}, it might have been freed already", value);
+		assert(false && "invalid renoir handle");
+		return nullptr;
+	}
+	return res;
+}
+
+inline static void*
+_renoir_null_handle_public(Renoir_Handle* h)
+{
+	if (h == nullptr)
+		return nullptr;
+	return (void*)uintptr_t(h->id);
+}
+
+static void
+_renoir_null_handle_free(IRenoir* self, Renoir_Handle* h)
+{
+	auto index = h->id & RENOIR_NULL_HANDLE_INDEX_MASK;
+	auto& table = self->handles[h->kind];
+	auto chunk = table.chunks[index / RENOIR_NULL_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+	auto slot = index % RENOIR_NULL_HANDLE_CHUNK_SIZE;
+	assert(h->id != 0 && chunk != nullptr && &chunk->handles[slot] == h && "free was called with an invalid renoir handle");
+
+	_renoir_null_memory_handle(self, h, false);
+	#if RENOIR_LEAK
+	if (_renoir_handle_kind_should_track(h->kind))
+		mn::map_remove(self->alive_handles, h);
+	#endif
+	--self->stats.live_handles[h->kind];
+	--self->stats.alive_handles;
+
+	chunk->generations[slot] = (chunk->generations[slot] + 1) & RENOIR_NULL_HANDLE_GENERATION_MASK;
+	h->id.store(0, std::memory_order_release);
+	mn::ring_push_back(table.free_slots, index);
+}
+
+static Renoir_Handle*
+_renoir_null_handle_ref(Renoir_Handle* h)
+{
+	h->rc.fetch_add(1);
+	return h;
+}
+
+static bool
+_renoir_null_handle_unref(Renoir_Handle* h)
+{
+	return h->rc.fetch_sub(1) == 1;
+}
+
+static Renoir_Command*
+_renoir_null_command_new(IRenoir* self, RENOIR_COMMAND_KIND kind)
+{
+	auto command = (Renoir_Command*)mn::pool_get(self->command_pool);
+	memset(command, 0, sizeof(*command));
+	command->kind = kind;
+	if (++self->stats.alive_commands > self->stats.command_pool_high_water_mark)
+		self->stats.command_pool_high_water_mark = self->stats.alive_commands;
+	return command;
+}
+
+static void
+_renoir_null_command_free(IRenoir* self, Renoir_Command* command)
+{
+	switch(command->kind)
+	{
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+	{
+		if(command->buffer_new.owns_data)
+			mn::free(mn::Block{(void*)command->buffer_new.desc.data, command->buffer_new.desc.data_size});
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+	{
+		if(command->texture_new.owns_data)
+		{
+			for (int i = 0; i < 6; ++i)
+			{
+				if (command->texture_new.desc.data[i] == nullptr)
+					continue;
+
+				mn::free(mn::Block{(void*)command->texture_new.desc.data[i], command->texture_new.desc.data_size});
+			}
+		}
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+	{
+		mn::free(mn::Block{(void*)command->buffer_write.bytes, command->buffer_write.bytes_size});
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+	{
+		mn::free(mn::Block{(void*)command->texture_write.desc.bytes, command->texture_write.desc.bytes_size});
+		break;
+	}
+	case RENOIR_COMMAND_KIND_NONE:
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+	case RENOIR_COMMAND_KIND_PASS_FREE:
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE:
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE:
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE:
+	case RENOIR_COMMAND_KIND_TIMER_FREE:
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+	case RENOIR_COMMAND_KIND_PASS_BEGIN:
+	case RENOIR_COMMAND_KIND_PASS_END:
+	case RENOIR_COMMAND_KIND_PASS_CLEAR:
+	case RENOIR_COMMAND_KIND_USE_PIPELINE:
+	case RENOIR_COMMAND_KIND_USE_PROGRAM:
+	case RENOIR_COMMAND_KIND_USE_COMPUTE:
+	case RENOIR_COMMAND_KIND_SCISSOR:
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+	case RENOIR_COMMAND_KIND_DRAW:
+	case RENOIR_COMMAND_KIND_DISPATCH:
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER:
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
+	case RENOIR_COMMAND_KIND_TIMER_END:
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN:
+	case RENOIR_COMMAND_KIND_QUERY_END:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN:
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END:
+	default:
+		// do nothing
+		break;
+	}
+	--self->stats.alive_commands;
+	mn::pool_put(self->command_pool, command);
+}
+
+template<typename T>
+static void
+_renoir_null_command_push(T* self, Renoir_Command* command)
+{
+	if(self->command_list_tail == nullptr)
+	{
+		self->command_list_tail = command;
+		self->command_list_head = command;
+		return;
+	}
+
+	self->command_list_tail->next = command;
+	command->prev = self->command_list_tail;
+	self->command_list_tail = command;
+}
+
+static void _renoir_null_command_execute(IRenoir* self, Renoir_Command* command);
+
+static void
+_renoir_null_command_process(IRenoir* self, Renoir_Command* command)
+{
+	if (self->settings.defer_api_calls)
+	{
+		_renoir_null_command_push(self, command);
+	}
+	else
+	{
+		_renoir_null_command_execute(self, command);
+		_renoir_null_command_free(self, command);
+	}
+}
+
+// size of a single texture face (or the whole texture if it's not a cube map) in bytes
+inline static size_t
+_renoir_null_texture_face_size(const Renoir_Texture_Desc& desc)
+{
+	size_t width = desc.size.width;
+	size_t height = desc.size.height > 0 ? desc.size.height : 1;
+	size_t depth = desc.size.depth > 0 ? desc.size.depth : 1;
+	return width * height * depth * _renoir_pixelformat_size(desc.pixel_format);
+}
+
+// copies a texture region from/to the texture cpu memory, in case of cube maps desc.z is the face index
+static void
+_renoir_null_texture_region_copy(Renoir_Handle* h, Renoir_Texture_Edit_Desc desc, bool write)
+{
+	auto& tdesc = h->texture.desc;
+	auto pixel_size = _renoir_pixelformat_size(tdesc.pixel_format);
+	size_t width = tdesc.size.width;
+	size_t height = tdesc.size.height > 0 ? tdesc.size.height : 1;
+	size_t depth = tdesc.size.depth > 0 ? tdesc.size.depth : 1;
+
+	size_t region_height = desc.height > 0 ? desc.height : 1;
+	size_t region_depth = desc.depth > 0 ? desc.depth : 1;
+	size_t z = desc.z;
+	size_t face = 0;
+	if (tdesc.cube_map)
+	{
+		assert(desc.z >= 0 && desc.z < 6 && "cube map face is out of range");
+		face = desc.z;
+		z = 0;
+		region_depth = 1;
+	}
+
+	assert(desc.x >= 0 && desc.y >= 0 && desc.z >= 0);
+	assert(size_t(desc.x + desc.width) <= width && "texture region is out of range");
+	assert(desc.y + region_height <= height && "texture region is out of range");
+	assert(z + region_depth <= depth && "texture region is out of range");
+	auto row_size = desc.width * pixel_size;
+	assert(desc.bytes_size >= row_size * region_height * region_depth && "texture region is larger than the given bytes");
+
+	auto base = (uint8_t*)h->texture.data.ptr + face * _renoir_null_texture_face_size(tdesc);
+	for (size_t k = 0; k < region_depth; ++k)
+	{
+		for (size_t j = 0; j < region_height; ++j)
+		{
+			auto texels = base + (((z + k) * height + (desc.y + j)) * width + desc.x) * pixel_size;
+			auto bytes = (uint8_t*)desc.bytes + (k * region_height + j) * row_size;
+			if (write)
+				::memcpy(texels, bytes, row_size);
+			else
+				::memcpy(bytes, texels, row_size);
+		}
+	}
+}
+
+// fills the given level 0 attachment with the clear value, formats which we can't encode are left untouched
+static void
+_renoir_null_attachment_clear(IRenoir* self, Renoir_Pass_Attachment attachment, const void* value, size_t value_size)
+{
+	auto h = _renoir_null_handle_get(self, attachment.texture.handle);
+	if (h == nullptr || attachment.level != 0 || value_size == 0)
+		return;
+
+	assert(value_size == _renoir_pixelformat_size(h->texture.desc.pixel_format));
+	auto face_size = _renoir_null_texture_face_size(h->texture.desc);
+	auto face = h->texture.desc.cube_map ? attachment.subresource : 0;
+	auto ptr = (uint8_t*)h->texture.data.ptr + face * face_size;
+	for (size_t i = 0; i < face_size; i += value_size)
+		::memcpy(ptr + i, value, value_size);
+}
+
+static size_t
+_renoir_null_color_encode(RENOIR_PIXELFORMAT format, Renoir_Color color, uint8_t* out)
+{
+	auto unorm8 = [](float v) -> uint8_t {
+		if (v < 0.0f) v = 0.0f;
+		if (v > 1.0f) v = 1.0f;
+		return uint8_t(v * 255.0f + 0.5f);
+	};
+
+	switch (format)
+	{
+	case RENOIR_PIXELFORMAT_RGBA8:
+		out[0] = unorm8(color.r);
+		out[1] = unorm8(color.g);
+		out[2] = unorm8(color.b);
+		out[3] = unorm8(color.a);
+		return 4;
+	case RENOIR_PIXELFORMAT_R8:
+		out[0] = unorm8(color.r);
+		return 1;
+	case RENOIR_PIXELFORMAT_R32F:
+		::memcpy(out, &color.r, sizeof(float));
+		return 4;
+	case RENOIR_PIXELFORMAT_R32G32F:
+		::memcpy(out, &color.r, sizeof(float) * 2);
+		return 8;
+	case RENOIR_PIXELFORMAT_R32G32B32A32F:
+		::memcpy(out, &color, sizeof(float) * 4);
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+static void
+_renoir_null_stats_command(IRenoir* self, Renoir_Command* command)
+{
+	auto& stats = self->stats.frame;
+	++self->stats.command_counts[command->kind];
+
+	switch (command->kind)
+	{
+	case RENOIR_COMMAND_KIND_DRAW:
+		++stats.draws;
+		break;
+	case RENOIR_COMMAND_KIND_DISPATCH:
+		++stats.dispatches;
+		break;
+	case RENOIR_COMMAND_KIND_PASS_BEGIN:
+	case RENOIR_COMMAND_KIND_USE_PIPELINE:
+	case RENOIR_COMMAND_KIND_USE_PROGRAM:
+	case RENOIR_COMMAND_KIND_USE_COMPUTE:
+	case RENOIR_COMMAND_KIND_SCISSOR:
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+		++stats.state_changes;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+		if (command->buffer_new.desc.data)
+			stats.bytes_uploaded += command->buffer_new.desc.data_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+		for (int i = 0; i < 6; ++i)
+			if (command->texture_new.desc.data[i])
+				stats.bytes_uploaded += command->texture_new.desc.data_size;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+		stats.bytes_uploaded += command->buffer_write.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+		stats.bytes_uploaded += command->texture_write.desc.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+		stats.bytes_read += command->buffer_read.bytes_size;
+		break;
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+		stats.bytes_read += command->texture_read.desc.bytes_size;
+		break;
+	default:
+		// do nothing
+		break;
+	}
+}
+
+// snapshots the current frame counters, should be called with the mutex locked
+static void
+_renoir_null_stats_frame(IRenoir* self)
+{
+	auto& stats = self->stats;
+	for (int i = 0; i < RENOIR_COMMAND_KIND_COUNT; ++i)
+	{
+		if (stats.command_counts[i] == 0 || stats.frame.commands_count >= RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			continue;
+		stats.frame.commands[stats.frame.commands_count++] = Renoir_Stats_Counter{
+			_renoir_command_kind_name(RENOIR_COMMAND_KIND(i)),
+			stats.command_counts[i]
+		};
+	}
+
+	auto frame_index = stats.frame.frame_index;
+	stats.last_frame = stats.frame;
+	stats.frame = Renoir_Stats{};
+	stats.frame.frame_index = frame_index + 1;
+	::memset(stats.command_counts, 0, sizeof(stats.command_counts));
+}
+
+// resets the per-frame uniform allocator, should be called with the mutex locked
+static void
+_renoir_null_uniform_ring_frame(IRenoir* self)
+{
+	self->uniform_ring.offset = 0;
+}
+
+static void
+_renoir_null_handle_leak_free(IRenoir* self, Renoir_Command* command);
+
+static void
+_renoir_null_command_execute(IRenoir* self, Renoir_Command* command)
+{
+	_renoir_null_stats_command(self, command);
+
+	switch(command->kind)
+	{
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+	{
+		auto h = command->swapchain_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_FREE:
+	{
+		auto h = command->pass_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+
+		if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+		{
+			// free all the bound textures if it's an offscreen pass
+			if (h->raster_pass.swapchain == nullptr)
+			{
+				for (size_t i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+				{
+					auto color = _renoir_null_handle_get(self, h->raster_pass.offscreen.color[i].texture.handle);
+					if (color == nullptr)
+						continue;
+
+					// issue command to free the color texture
+					auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+					command->texture_free.handle = color;
+					_renoir_null_command_process(self, command);
+				}
+
+				auto depth = _renoir_null_handle_get(self, h->raster_pass.offscreen.depth_stencil.texture.handle);
+				if (depth)
+				{
+					// issue command to free the depth texture
+					auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+					command->texture_free.handle = depth;
+					_renoir_null_command_process(self, command);
+				}
+			}
+		}
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_NEW:
+	{
+		auto h = command->buffer_new.handle;
+		auto& desc = command->buffer_new.desc;
+
+		if (desc.type == RENOIR_BUFFER_COMPUTE)
+		{
+			assert(
+				desc.compute_buffer_stride > 0 && desc.compute_buffer_stride % 4 == 0 &&
+				"compute buffer stride should be greater than 0, no greater than 2048, and a multiple of 4"
+			);
+		}
+
+		h->buffer.data = mn::alloc(desc.data_size, alignof(max_align_t));
+		if (desc.data)
+			::memcpy(h->buffer.data.ptr, desc.data, desc.data_size);
+		else
+			::memset(h->buffer.data.ptr, 0, desc.data_size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+	{
+		auto h = command->buffer_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		mn::free(h->buffer.data);
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_NEW:
+	{
+		auto h = command->texture_new.handle;
+		auto& desc = command->texture_new.desc;
+
+		auto face_size = _renoir_null_texture_face_size(desc);
+		auto faces = desc.cube_map ? 6 : 1;
+		h->texture.data = mn::alloc(face_size * faces, alignof(max_align_t));
+		::memset(h->texture.data.ptr, 0, h->texture.data.size);
+		for (int i = 0; i < faces; ++i)
+		{
+			if (desc.data[i] == nullptr)
+				continue;
+
+			assert(desc.data_size <= face_size && "texture data is larger than the texture");
+			::memcpy((uint8_t*)h->texture.data.ptr + i * face_size, desc.data[i], desc.data_size);
+		}
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE:
+	{
+		auto h = command->texture_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		mn::free(h->texture.data);
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE:
+	{
+		auto h = command->program_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		if (self->current_program == h)
+			self->current_program = nullptr;
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE:
+	{
+		auto h = command->compute_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		if (self->current_compute == h)
+			self->current_compute = nullptr;
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TIMER_FREE:
+	{
+		auto h = command->timer_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+	{
+		auto h = command->query_free.handle;
+		if (_renoir_null_handle_unref(h) == false)
+			break;
+		_renoir_null_handle_free(self, h);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_BEGIN:
+	{
+		auto h = command->pass_begin.handle;
+		assert(self->current_pass == nullptr && "you can't begin a pass inside another pass");
+		self->current_pass = h;
+		self->current_program = nullptr;
+		self->current_compute = nullptr;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_END:
+	{
+		assert(self->current_pass == command->pass_end.handle && "pass end doesn't match the current pass");
+		assert(self->current_conditional == nullptr && "conditional_begin without a matching conditional_end");
+		self->current_pass = nullptr;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_PASS_CLEAR:
+	{
+		auto& desc = command->pass_clear.desc;
+		auto h = self->current_pass;
+		assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+		// swapchain passes have no memory to clear
+		if (h->raster_pass.swapchain != nullptr)
+			break;
+
+		if (desc.flags & RENOIR_CLEAR_COLOR)
+		{
+			for (int i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+			{
+				auto attachment = h->raster_pass.offscreen.color[i];
+				auto color = _renoir_null_handle_get(self, attachment.texture.handle);
+				if (color == nullptr)
+					continue;
+
+				auto clear_color = desc.independent_clear_color == RENOIR_SWITCH_ENABLE ? desc.color[i] : desc.color[0];
+				uint8_t value[16];
+				auto value_size = _renoir_null_color_encode(color->texture.desc.pixel_format, clear_color, value);
+				_renoir_null_attachment_clear(self, attachment, value, value_size);
+			}
+		}
+
+		if (desc.flags & RENOIR_CLEAR_DEPTH)
+		{
+			auto attachment = h->raster_pass.offscreen.depth_stencil;
+			if (auto depth = _renoir_null_handle_get(self, attachment.texture.handle))
+			{
+				if (depth->texture.desc.pixel_format == RENOIR_PIXELFORMAT_D32)
+				{
+					_renoir_null_attachment_clear(self, attachment, &desc.depth, sizeof(desc.depth));
+				}
+				else if (depth->texture.desc.pixel_format == RENOIR_PIXELFORMAT_D24S8)
+				{
+					// same layout as GL_UNSIGNED_INT_24_8, depth in the high 24 bits and stencil in the low 8 bits
+					auto d = desc.depth < 0.0f ? 0.0f : (desc.depth > 1.0f ? 1.0f : desc.depth);
+					uint32_t value = (uint32_t(d * 0xFFFFFF) << 8) | desc.stencil;
+					_renoir_null_attachment_clear(self, attachment, &value, sizeof(value));
+				}
+			}
+		}
+		break;
+	}
+	case RENOIR_COMMAND_KIND_USE_PIPELINE:
+	{
+		// there's no fixed function state to apply
+		break;
+	}
+	case RENOIR_COMMAND_KIND_USE_PROGRAM:
+	{
+		auto h = command->use_program.program;
+		assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_PROGRAM);
+		self->current_program = h;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_USE_COMPUTE:
+	{
+		auto h = command->use_compute.compute;
+		assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_COMPUTE);
+		self->current_compute = h;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_SCISSOR:
+	{
+		assert(command->scissor.w >= 0 && command->scissor.h >= 0);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_CLEAR:
+	{
+		auto h = command->buffer_clear.handle;
+		::memset(h->buffer.data.ptr, 0, h->buffer.size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_WRITE:
+	{
+		auto h = command->buffer_write.handle;
+		assert(command->buffer_write.offset + command->buffer_write.bytes_size <= h->buffer.size && "buffer write is out of range");
+		::memcpy((uint8_t*)h->buffer.data.ptr + command->buffer_write.offset, command->buffer_write.bytes, command->buffer_write.bytes_size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_COPY:
+	{
+		auto& copy = command->buffer_copy;
+		assert(copy.dst_offset + copy.size <= copy.dst->buffer.size && "buffer copy destination is out of range");
+		assert(copy.src_offset + copy.size <= copy.src->buffer.size && "buffer copy source is out of range");
+		::memcpy((uint8_t*)copy.dst->buffer.data.ptr + copy.dst_offset, (uint8_t*)copy.src->buffer.data.ptr + copy.src_offset, copy.size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_WRITE:
+	{
+		auto h = command->texture_write.handle;
+		_renoir_null_texture_region_copy(h, command->texture_write.desc, true);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_READ:
+	{
+		auto h = command->buffer_read.handle;
+		assert(command->buffer_read.offset + command->buffer_read.bytes_size <= h->buffer.size && "buffer read is out of range");
+		::memcpy(command->buffer_read.bytes, (uint8_t*)h->buffer.data.ptr + command->buffer_read.offset, command->buffer_read.bytes_size);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_READ:
+	{
+		auto h = command->texture_read.handle;
+		_renoir_null_texture_region_copy(h, command->texture_read.desc, false);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_BIND:
+	{
+		auto h = command->buffer_bind.handle;
+		assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_BUFFER);
+		assert(command->buffer_bind.slot >= 0);
+		assert(command->buffer_bind.offset + command->buffer_bind.size <= h->buffer.size && "buffer bind range is out of range");
+		assert(h->buffer.type == RENOIR_BUFFER_UNIFORM || h->buffer.type == RENOIR_BUFFER_COMPUTE);
+		break;
+	}
+	case RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND:
+	{
+		auto& desc = command->buffer_storage_bind.desc;
+		for (int i = 0; i < RENOIR_CONSTANT_BUFFER_STORAGE_SIZE; ++i)
+		{
+			auto h = _renoir_null_handle_get(self, desc.buffers[i].handle);
+			if (h == nullptr)
+				continue;
+
+			assert(h->kind == RENOIR_HANDLE_KIND_BUFFER);
+			assert(h->buffer.type == RENOIR_BUFFER_UNIFORM || h->buffer.type == RENOIR_BUFFER_COMPUTE);
+			assert(desc.offsets[i] + desc.sizes[i] <= h->buffer.size && "buffer bind range is out of range");
+		}
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TEXTURE_BIND:
+	{
+		auto h = command->texture_bind.handle;
+		assert(h != nullptr && h->kind == RENOIR_HANDLE_KIND_TEXTURE);
+		assert(command->texture_bind.slot >= 0);
+		assert(command->texture_bind.level < h->texture.desc.mipmaps && "out of range mip level");
+		break;
+	}
+	case RENOIR_COMMAND_KIND_DRAW:
+	{
+		auto& desc = command->draw.desc;
+		assert(self->current_pass != nullptr && self->current_pass->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+		assert(self->current_program != nullptr && "you should use a program before issuing draw commands");
+		assert(desc.base_element >= 0 && desc.elements_count >= 0 && desc.instances_count >= 0);
+
+		for (int i = 0; i < RENOIR_CONSTANT_DRAW_VERTEX_BUFFER_SIZE; ++i)
+		{
+			auto& vertex = desc.vertex_buffers[i];
+			auto h = _renoir_null_handle_get(self, vertex.buffer.handle);
+			if (h == nullptr)
+				continue;
+
+			assert(h->kind == RENOIR_HANDLE_KIND_BUFFER && h->buffer.type == RENOIR_BUFFER_VERTEX);
+			assert(vertex.offset <= h->buffer.size && "vertex buffer offset is out of range");
+
+			// without an index buffer we know exactly which vertices are going to be fetched
+			if (desc.index_buffer.handle == nullptr && desc.elements_count > 0 && desc.instances_count == 0)
+			{
+				auto stride = vertex.stride > 0 ? vertex.stride : _renoir_type_size(vertex.type);
+				assert(
+					vertex.offset + (desc.base_element + desc.elements_count - 1) * stride + _renoir_type_size(vertex.type) <= h->buffer.size &&
+					"draw reads past the end of the vertex buffer"
+				);
+			}
+		}
+
+		if (auto h = _renoir_null_handle_get(self, desc.index_buffer.handle))
+		{
+			assert(h->kind == RENOIR_HANDLE_KIND_BUFFER && h->buffer.type == RENOIR_BUFFER_INDEX);
+			assert(desc.index_type == RENOIR_TYPE_UINT16 || desc.index_type == RENOIR_TYPE_UINT32);
+			assert(
+				(desc.base_element + desc.elements_count) * _renoir_type_size(desc.index_type) <= h->buffer.size &&
+				"draw reads past the end of the index buffer"
+			);
+		}
+		break;
+	}
+	case RENOIR_COMMAND_KIND_DISPATCH:
+	{
+		assert(self->current_pass != nullptr && self->current_pass->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+		assert(self->current_compute != nullptr && "you should use a compute before issuing dispatch commands");
+		break;
+	}
+	case RENOIR_COMMAND_KIND_MEMORY_BARRIER:
+	{
+		assert(self->current_pass != nullptr && "memory barriers should be issued inside a pass");
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TIMER_BEGIN:
+	{
+		// do nothing, the timer result is ready once it ends
+		break;
+	}
+	case RENOIR_COMMAND_KIND_TIMER_END:
+	{
+		command->timer_end.handle->timer.state = RENOIR_NULL_STATE_READY;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_BEGIN:
+	{
+		// do nothing, the query result is ready once it ends
+		break;
+	}
+	case RENOIR_COMMAND_KIND_QUERY_END:
+	{
+		++command->query_end.handle->query.ready;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN:
+	{
+		assert(self->current_conditional == nullptr && "conditional rendering can't be nested");
+		self->current_conditional = command->conditional_begin.handle;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_CONDITIONAL_END:
+	{
+		assert(self->current_conditional != nullptr && "conditional_end without a matching conditional_begin");
+		self->current_conditional = nullptr;
+		break;
+	}
+	case RENOIR_COMMAND_KIND_NONE:
+	case RENOIR_COMMAND_KIND_COUNT:
+	default:
+		assert(false && "unreachable");
+		break;
+	}
+}
+
+static void
+_renoir_null_handle_leak_free(IRenoir* self, Renoir_Command* command)
+{
+	switch(command->kind)
+	{
+	case RENOIR_COMMAND_KIND_SWAPCHAIN_FREE:
+	case RENOIR_COMMAND_KIND_PASS_FREE:
+	case RENOIR_COMMAND_KIND_BUFFER_FREE:
+	case RENOIR_COMMAND_KIND_TEXTURE_FREE:
+	case RENOIR_COMMAND_KIND_PROGRAM_FREE:
+	case RENOIR_COMMAND_KIND_COMPUTE_FREE:
+	case RENOIR_COMMAND_KIND_TIMER_FREE:
+	case RENOIR_COMMAND_KIND_QUERY_FREE:
+		_renoir_null_command_execute(self, command);
+		break;
+	default:
+		// do nothing
+		break;
+	}
+}
+
+// API
+static bool
+_renoir_null_init(Renoir* api, Renoir_Settings settings, void*)
+{
+	if (settings.sampler_cache_size <= 0)
+		settings.sampler_cache_size = RENOIR_CONSTANT_DEFAULT_SAMPLER_CACHE_SIZE;
+	if (settings.pipeline_cache_size <= 0)
+		settings.pipeline_cache_size = RENOIR_CONSTANT_DEFAULT_PIPELINE_CACHE_SIZE;
+	if (settings.uniform_ring_size == 0)
+		settings.uniform_ring_size = RENOIR_CONSTANT_DEFAULT_UNIFORM_RING_SIZE;
+	// there's no gpu to profile or to trace
+	settings.profiler = false;
+	settings.trace = false;
+	// commands are only captured by the gl450 backend, null is the usual replay target
+	settings.capture_path = nullptr;
+	// resources are created in cpu memory so there's nothing to upload in the background
+	settings.async_uploads = false;
+
+	auto self = mn::alloc_zerod<IRenoir>();
+	self->mtx = mn_mutex_new_with_srcloc("renoir null");
+	for (auto& table: self->handles)
+		table.free_slots = mn::ring_new<uint32_t>();
+	self->command_pool = mn::pool_new(sizeof(Renoir_Command), 128);
+	self->settings = settings;
+	#if RENOIR_LEAK
+	self->alive_handles = mn::map_new<Renoir_Handle*, Renoir_Leak_Info>();
+	#endif
+	self->transient_pool = _renoir_transient_pool_new();
+	self->sampler_cache = mn::buf_with_capacity<Renoir_Sampler_Desc>(settings.sampler_cache_size);
+	self->memory.tags = mn::buf_new<Renoir_Null_Memory_Tag>();
+	mn::buf_push(self->memory.tags, Renoir_Null_Memory_Tag{mn::str_from_c("untagged"), Renoir_Memory_Counter{}});
+
+	self->uniform_ring.alignment = 256;
+	self->uniform_ring.buffer = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_BUFFER);
+	self->uniform_ring.buffer->buffer.type = RENOIR_BUFFER_UNIFORM;
+	self->uniform_ring.buffer->buffer.usage = RENOIR_USAGE_DYNAMIC;
+	self->uniform_ring.buffer->buffer.access = RENOIR_ACCESS_WRITE;
+	self->uniform_ring.buffer->buffer.size = settings.uniform_ring_size;
+	self->uniform_ring.buffer->buffer.data = mn::alloc(settings.uniform_ring_size, alignof(max_align_t));
+	self->uniform_ring.buffer->buffer.memory_tag = _renoir_null_memory_tag(self, "uniform_ring");
+	_renoir_null_memory_handle(self, self->uniform_ring.buffer, true);
+
+	api->ctx = self;
+
+	return true;
+}
+
+static void
+_renoir_null_dispose(Renoir* api)
+{
+	auto self = api->ctx;
+	// process these commands for frees to give correct leak report
+	for (auto it = self->command_list_head; it != nullptr;)
+	{
+		_renoir_null_handle_leak_free(self, it);
+		// read next after execution because free commands could push new commands to the list
+		auto next = it->next;
+		_renoir_null_command_free(self, it);
+		it = next;
+	}
+	mn::free(self->uniform_ring.buffer->buffer.data);
+	_renoir_null_handle_free(self, self->uniform_ring.buffer);
+	for (const auto& transient: self->transient_pool.textures)
+	{
+		mn::free(transient.handle->texture.data);
+		_renoir_null_handle_free(self, transient.handle);
+	}
+	size_t leak_count = 0;
+	for (int kind = 0; kind < RENOIR_HANDLE_KIND_COUNT; ++kind)
+	{
+		if (_renoir_handle_kind_should_track(RENOIR_HANDLE_KIND(kind)) == false)
+			continue;
+		auto& table = self->handles[kind];
+		for (uint32_t i = 0; i < table.slots_count; ++i)
+		{
+			auto chunk = table.chunks[i / RENOIR_NULL_HANDLE_CHUNK_SIZE].load(std::memory_order_relaxed);
+			if (chunk->handles[i % RENOIR_NULL_HANDLE_CHUNK_SIZE].id != 0)
+				++leak_count;
+		}
+	}
+	#if RENOIR_LEAK
+		for(auto[handle, info]: self->alive_handles)
+		{
+			::fprintf(stderr, "renoir handle to '%s' leaked, callstack:\n", _renoir_handle_kind_name(handle->kind));
+			mn::callstack_print_to(info.callstack, info.callstack_size, mn::file_stderr());
+			::fprintf(stderr, "\n\n");
+		}
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu\n", leak_count);
+	#else
+		if (leak_count > 0)
+			::fprintf(stderr, "renoir leak count: %zu, for callstack turn on 'RENOIR_LEAK' flag\n", leak_count);
+	#endif
+	mn::mutex_free(self->mtx);
+	for (auto& table: self->handles)
+	{
+		for (auto& chunk: table.chunks)
+			if (auto ptr = chunk.load(std::memory_order_relaxed))
+				mn::free(ptr);
+		mn::ring_free(table.free_slots);
+	}
+	mn::pool_free(self->command_pool);
+	#if RENOIR_LEAK
+	mn::map_free(self->alive_handles);
+	#endif
+	_renoir_transient_pool_free(self->transient_pool);
+	mn::buf_free(self->sampler_cache);
+	for (auto& tag: self->memory.tags)
+		mn::str_free(tag.name);
+	mn::buf_free(self->memory.tags);
+	mn::free(self);
+}
+
+static const char*
+_renoir_null_name()
+{
+	return "null";
+}
+
+static RENOIR_TEXTURE_ORIGIN
+_renoir_null_texture_origin()
+{
+	// match the gl450 backend so the same code produces the same texture reads
+	return RENOIR_TEXTURE_ORIGIN_BOTTOM_LEFT;
+}
+
+static Renoir_Stats
+_renoir_null_stats(Renoir* api)
+{
+	auto self = api->ctx;
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto res = self->stats.last_frame;
+	res.command_pool_high_water_mark = self->stats.command_pool_high_water_mark;
+	res.handle_pool_high_water_mark = self->stats.handle_pool_high_water_mark;
+	for (int i = 0; i < RENOIR_HANDLE_KIND_COUNT; ++i)
+	{
+		if (self->stats.live_handles[i] == 0 || res.live_handles_count >= RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			continue;
+		res.live_handles[res.live_handles_count++] = Renoir_Stats_Counter{
+			_renoir_handle_kind_name(RENOIR_HANDLE_KIND(i)),
+			self->stats.live_handles[i]
+		};
+	}
+	return res;
+}
+
+static Renoir_Memory_Stats
+_renoir_null_memory_stats(Renoir* api)
+{
+	auto self = api->ctx;
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto& memory = self->memory;
+
+	// there's no device to query so device_total_bytes and device_available_bytes stay 0
+	Renoir_Memory_Stats res{};
+	res.total = memory.total;
+	res.total.name = "total";
+	for (int i = 0; i < RENOIR_MEMORY_COUNT; ++i)
+	{
+		res.kinds[i] = memory.kinds[i];
+		res.kinds[i].name = _renoir_memory_name(RENOIR_MEMORY(i));
+	}
+	for (const auto& tag: memory.tags)
+	{
+		if (res.tags_count == RENOIR_CONSTANT_STATS_COUNTER_SIZE)
+			break;
+		res.tags[res.tags_count] = tag.counter;
+		res.tags[res.tags_count].name = tag.name.ptr;
+		++res.tags_count;
+	}
+	return res;
+}
+
+static void
+_renoir_null_handle_ref(Renoir* api, void* handle)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, handle);
+	if (h == nullptr)
+		return;
+	h->rc.fetch_add(1);
+}
+
+static bool
+_renoir_null_handle_ready(Renoir*, void*)
+{
+	return true;
+}
+
+// returns all the transient textures to the pool, and frees the ones which have been unused for a while
+static void
+_renoir_null_transient_frame(IRenoir* self)
+{
+	_renoir_transient_pool_frame(self->transient_pool, [self](Renoir_Handle* handle) {
+		auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+		command->texture_free.handle = handle;
+		_renoir_null_command_process(self, command);
+	});
+}
+
+// executes all the deferred commands, should be called with the mutex locked
+static void
+_renoir_null_frame(IRenoir* self)
+{
+	_renoir_null_uniform_ring_frame(self);
+	_renoir_null_transient_frame(self);
+
+	// process commands
+	for(auto it = self->command_list_head; it != nullptr;)
+	{
+		_renoir_null_command_execute(self, it);
+		auto next = it->next;
+		_renoir_null_command_free(self, it);
+		it = next;
+	}
+
+	self->command_list_head = nullptr;
+	self->command_list_tail = nullptr;
+	_renoir_null_stats_frame(self);
+}
+
+static void
+_renoir_null_flush(Renoir* api, void*, void*)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	_renoir_null_frame(self);
+}
+
+static Renoir_Swapchain
+_renoir_null_swapchain_new(Renoir* api, int width, int height, void*, void*)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_SWAPCHAIN);
+	h->swapchain.width = width;
+	h->swapchain.height = height;
+	return Renoir_Swapchain{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_swapchain_free(Renoir* api, Renoir_Swapchain swapchain)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, swapchain.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_SWAPCHAIN_FREE);
+	command->swapchain_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static void
+_renoir_null_swapchain_resize(Renoir* api, Renoir_Swapchain swapchain, int width, int height)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, swapchain.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	h->swapchain.width = width;
+	h->swapchain.height = height;
+}
+
+static void
+_renoir_null_swapchain_present(Renoir* api, Renoir_Swapchain swapchain)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, swapchain.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	_renoir_null_frame(self);
+}
+
+static Renoir_Buffer
+_renoir_null_buffer_new(Renoir* api, Renoir_Buffer_Desc desc)
+{
+	if (desc.usage == RENOIR_USAGE_NONE)
+		desc.usage = RENOIR_USAGE_STATIC;
+
+	if (desc.usage == RENOIR_USAGE_DYNAMIC && desc.access == RENOIR_ACCESS_NONE)
+	{
+		assert(false && "a dynamic buffer with cpu access set to none is a static buffer");
+	}
+
+	if (desc.usage == RENOIR_USAGE_STATIC && desc.data == nullptr)
+	{
+		assert(false && "a static buffer should have data to initialize it");
+	}
+
+	if (desc.type == RENOIR_BUFFER_UNIFORM && desc.data_size % 16 != 0)
+	{
+		assert(false && "uniform buffers should be aligned to 16 bytes");
+	}
+
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_BUFFER);
+	h->buffer.type = desc.type;
+	h->buffer.usage = desc.usage;
+	h->buffer.access = desc.access;
+	h->buffer.size = desc.data_size;
+	h->buffer.memory_tag = _renoir_null_memory_tag(self, desc.tag);
+	_renoir_null_memory_handle(self, h, true);
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_NEW);
+	command->buffer_new.handle = h;
+	command->buffer_new.desc = desc;
+	if (self->settings.defer_api_calls && desc.data != nullptr)
+	{
+		command->buffer_new.desc.data = mn::alloc(desc.data_size, alignof(char)).ptr;
+		::memcpy(command->buffer_new.desc.data, desc.data, desc.data_size);
+		command->buffer_new.owns_data = true;
+	}
+	_renoir_null_command_process(self, command);
+	return Renoir_Buffer{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_buffer_free(Renoir* api, Renoir_Buffer buffer)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, buffer.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_FREE);
+	command->buffer_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static size_t
+_renoir_null_buffer_size(Renoir* api, Renoir_Buffer buffer)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, buffer.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+	return h->buffer.size;
+}
+
+static Renoir_Texture
+_renoir_null_texture_new(Renoir* api, Renoir_Texture_Desc desc)
+{
+	assert(desc.size.width > 0 && "a texture must have at least width");
+	assert(desc.pixel_format != RENOIR_PIXELFORMAT_NONE && "a texture must have a pixel format");
+
+	if (desc.usage == RENOIR_USAGE_NONE)
+		desc.usage = RENOIR_USAGE_STATIC;
+
+	if (desc.mipmaps == 0)
+		desc.mipmaps = 1;
+
+	if (desc.usage == RENOIR_USAGE_DYNAMIC && desc.access == RENOIR_ACCESS_NONE)
+	{
+		assert(false && "a dynamic texture with cpu access set to none is a static texture");
+	}
+
+	if (desc.render_target == false && desc.usage == RENOIR_USAGE_STATIC && desc.data[0] == nullptr)
+	{
+		assert(false && "a static texture should have data to initialize it");
+	}
+
+	if (desc.cube_map)
+	{
+		assert(desc.size.width == desc.size.height && "width should equal height in cube map texture");
+	}
+
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_TEXTURE);
+	h->texture.desc = desc;
+	::memset(h->texture.desc.data, 0, sizeof(h->texture.desc.data));
+	h->texture.desc.data_size = 0;
+	// the desc keeps the backend owned copy of the tag name
+	h->texture.memory_tag = _renoir_null_memory_tag(self, desc.tag);
+	h->texture.desc.tag = h->texture.memory_tag ? self->memory.tags[h->texture.memory_tag].name.ptr : nullptr;
+	_renoir_null_memory_handle(self, h, true);
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_NEW);
+	command->texture_new.handle = h;
+	command->texture_new.desc = desc;
+	if (self->settings.defer_api_calls)
+	{
+		for (int i = 0; i < 6; ++i)
+		{
+			if (desc.data[i] == nullptr)
+				continue;
+
+			command->texture_new.desc.data[i] = mn::alloc(desc.data_size, alignof(char)).ptr;
+			::memcpy(command->texture_new.desc.data[i], desc.data[i], desc.data_size);
+			command->texture_new.owns_data = true;
+		}
+	}
+	_renoir_null_command_process(self, command);
+	return Renoir_Texture{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_texture_free(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_FREE);
+	command->texture_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static void*
+_renoir_null_texture_native_handle(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return nullptr;
+	// the native handle of a null texture is its cpu memory
+	return h->texture.data.ptr;
+}
+
+static Renoir_Size
+_renoir_null_texture_size(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+	return h->texture.desc.size;
+}
+
+static Renoir_Texture_Desc
+_renoir_null_texture_desc(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+	return h->texture.desc;
+}
+
+static Renoir_Texture
+_renoir_null_texture_transient(Renoir* api, Renoir_Texture_Desc desc)
+{
+	assert(desc.render_target && "transient textures should be render targets");
+	assert(desc.data[0] == nullptr && "transient textures can't have initial data");
+
+	desc = _renoir_transient_texture_desc_normalize(desc);
+
+	auto self = api->ctx;
+
+	{
+		mn::mutex_lock(self->mtx);
+		mn_defer(mn::mutex_unlock(self->mtx));
+
+		if (auto h = _renoir_transient_pool_acquire(self->transient_pool, desc))
+			return Renoir_Texture{_renoir_null_handle_public(h)};
+	}
+
+	auto texture = _renoir_null_texture_new(api, desc);
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+	_renoir_transient_pool_push(self->transient_pool, _renoir_null_handle_get(self, texture.handle), desc);
+	return texture;
+}
+
+static void
+_renoir_null_texture_transient_free(Renoir* api, Renoir_Texture texture)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+	bool pooled = _renoir_transient_pool_release(self->transient_pool, h);
+	assert(pooled && "texture is not a transient texture");
+	(void)pooled;
+}
+
+static Renoir_Program
+_renoir_null_program_new(Renoir* api, Renoir_Program_Desc desc)
+{
+	assert(desc.vertex.bytes != nullptr && desc.pixel.bytes != nullptr);
+	assert(desc.constants_count >= 0 && desc.constants_count <= RENOIR_CONSTANT_SHADER_CONSTANT_SIZE);
+	if (desc.format == RENOIR_SHADER_FORMAT_SPIRV)
+	{
+		assert(desc.vertex.size > 0 && desc.vertex.size % 4 == 0 && "SPIR-V blobs should have a size which is a multiple of 4");
+		assert(desc.pixel.size > 0 && desc.pixel.size % 4 == 0 && "SPIR-V blobs should have a size which is a multiple of 4");
+		assert((desc.geometry.bytes == nullptr || (desc.geometry.size > 0 && desc.geometry.size % 4 == 0)) && "SPIR-V blobs should have a size which is a multiple of 4");
+	}
+
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	// shaders are not compiled, so there's nothing to record
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_PROGRAM);
+	return Renoir_Program{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_program_free(Renoir* api, Renoir_Program program)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, program.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PROGRAM_FREE);
+	command->program_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static Renoir_Compute
+_renoir_null_compute_new(Renoir* api, Renoir_Compute_Desc desc)
+{
+	assert(desc.compute.bytes != nullptr);
+	assert(desc.constants_count >= 0 && desc.constants_count <= RENOIR_CONSTANT_SHADER_CONSTANT_SIZE);
+	if (desc.format == RENOIR_SHADER_FORMAT_SPIRV)
+	{
+		assert(desc.compute.size > 0 && desc.compute.size % 4 == 0 && "SPIR-V blobs should have a size which is a multiple of 4");
+	}
+
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_COMPUTE);
+	return Renoir_Compute{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_compute_free(Renoir* api, Renoir_Compute compute)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, compute.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_COMPUTE_FREE);
+	command->compute_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static bool
+_renoir_null_program_reflect(Renoir*, Renoir_Program, Renoir_Reflect*)
+{
+	// shaders are never compiled so there's nothing to reflect
+	return false;
+}
+
+static bool
+_renoir_null_compute_reflect(Renoir*, Renoir_Compute, Renoir_Reflect*)
+{
+	// shaders are never compiled so there's nothing to reflect
+	return false;
+}
+
+static Renoir_Pass
+_renoir_null_pass_swapchain_new(Renoir* api, Renoir_Swapchain swapchain)
+{
+	auto self = api->ctx;
+	auto hswapchain = _renoir_null_handle_get(self, swapchain.handle);
+	assert(hswapchain != nullptr);
+	if (hswapchain == nullptr)
+		return Renoir_Pass{};
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_RASTER_PASS);
+	h->raster_pass.swapchain = hswapchain;
+	return Renoir_Pass{_renoir_null_handle_public(h)};
+}
+
+static Renoir_Pass
+_renoir_null_pass_offscreen_new(Renoir* api, Renoir_Pass_Offscreen_Desc desc)
+{
+	auto self = api->ctx;
+
+	// check that all sizes match
+	int width = -1, height = -1;
+	for (int i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+	{
+		auto color = _renoir_null_handle_get(self, desc.color[i].texture.handle);
+		if (color == nullptr)
+		{
+			// stale attachment
+			if (desc.color[i].texture.handle != nullptr)
+				return Renoir_Pass{};
+			continue;
+		}
+
+		assert(color->texture.desc.render_target && "pass attachments should be render targets");
+		assert(desc.color[i].level < color->texture.desc.mipmaps && "out of range mip level");
+
+		// first time getting the width/height
+		if (width == -1 && height == -1)
+		{
+			width = color->texture.desc.size.width * ::powf(0.5f, desc.color[i].level);
+			height = color->texture.desc.size.height * ::powf(0.5f, desc.color[i].level);
+		}
+		else
+		{
+			assert(color->texture.desc.size.width * ::powf(0.5f, desc.color[i].level) == width);
+			assert(color->texture.desc.size.height * ::powf(0.5f, desc.color[i].level) == height);
+		}
+	}
+
+	auto depth = _renoir_null_handle_get(self, desc.depth_stencil.texture.handle);
+	if (depth == nullptr && desc.depth_stencil.texture.handle != nullptr)
+		return Renoir_Pass{};
+	if (depth)
+	{
+		assert(depth->texture.desc.render_target && "pass attachments should be render targets");
+
+		// first time getting the width/height
+		if (width == -1 && height == -1)
+		{
+			width = depth->texture.desc.size.width * ::powf(0.5f, desc.depth_stencil.level);
+			height = depth->texture.desc.size.height * ::powf(0.5f, desc.depth_stencil.level);
+		}
+		else
+		{
+			assert(depth->texture.desc.size.width * ::powf(0.5f, desc.depth_stencil.level) == width);
+			assert(depth->texture.desc.size.height * ::powf(0.5f, desc.depth_stencil.level) == height);
+		}
+	}
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_RASTER_PASS);
+	h->raster_pass.offscreen = desc;
+	h->raster_pass.width = width;
+	h->raster_pass.height = height;
+
+	// the pass keeps its attachments alive, they are released in pass free
+	for (int i = 0; i < RENOIR_CONSTANT_COLOR_ATTACHMENT_SIZE; ++i)
+		if (auto color = _renoir_null_handle_get(self, desc.color[i].texture.handle))
+			_renoir_null_handle_ref(color);
+	if (depth)
+		_renoir_null_handle_ref(depth);
+
+	return Renoir_Pass{_renoir_null_handle_public(h)};
+}
+
+static Renoir_Pass
+_renoir_null_pass_compute_new(Renoir* api)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_COMPUTE_PASS);
+	return Renoir_Pass{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_pass_free(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PASS_FREE);
+	command->pass_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static Renoir_Size
+_renoir_null_pass_size(Renoir* api, Renoir_Pass pass)
+{
+	Renoir_Size res{};
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	// if this is an on screen/window
+	if (auto swapchain = h->raster_pass.swapchain)
+	{
+		res.width = swapchain->swapchain.width;
+		res.height = swapchain->swapchain.height;
+	}
+	// this must be an offscreen pass then
+	else
+	{
+		res.width = h->raster_pass.width;
+		res.height = h->raster_pass.height;
+	}
+	return res;
+}
+
+static Renoir_Pass_Offscreen_Desc
+_renoir_null_pass_offscreen_desc(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+	return h->raster_pass.offscreen;
+}
+
+static Renoir_Timer
+_renoir_null_timer_new(Renoir* api)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_TIMER);
+	return Renoir_Timer{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_timer_free(Renoir* api, Renoir_Timer timer)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, timer.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TIMER_FREE);
+	command->timer_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static bool
+_renoir_null_timer_elapsed(Renoir* api, Renoir_Timer timer, uint64_t* elapsed_time_in_nanos)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, timer.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return false;
+	assert(h->kind == RENOIR_HANDLE_KIND_TIMER);
+
+	if (h->timer.state == RENOIR_NULL_STATE_READY)
+	{
+		// no gpu work takes no time
+		if (elapsed_time_in_nanos) *elapsed_time_in_nanos = 0;
+		h->timer.state = RENOIR_NULL_STATE_NONE;
+		return true;
+	}
+	return false;
+}
+
+static Renoir_Query
+_renoir_null_query_new(Renoir* api, RENOIR_QUERY kind)
+{
+	assert(kind != RENOIR_QUERY_NONE && "invalid query kind");
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_new(self, RENOIR_HANDLE_KIND_QUERY);
+	h->query.kind = kind;
+	return Renoir_Query{_renoir_null_handle_public(h)};
+}
+
+static void
+_renoir_null_query_free(Renoir* api, Renoir_Query query)
+{
+	auto self = api->ctx;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto h = _renoir_null_handle_get(self, query.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_QUERY_FREE);
+	command->query_free.handle = h;
+	_renoir_null_command_process(self, command);
+}
+
+static bool
+_renoir_null_query_result(Renoir* api, Renoir_Query query, Renoir_Query_Result* result)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, query.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return false;
+	assert(h->kind == RENOIR_HANDLE_KIND_QUERY);
+
+	if (h->query.ready > 0)
+	{
+		// nothing is rasterized so all the counters are zero
+		if (result) *result = Renoir_Query_Result{};
+		--h->query.ready;
+		--h->query.pending;
+		return true;
+	}
+	return false;
+}
+
+static bool
+_renoir_null_profiler_frame_results(Renoir*, Renoir_Profiler_Frame*)
+{
+	// the profiler is always disabled in the null backend
+	return false;
+}
+
+static bool
+_renoir_null_trace_export(Renoir*, const char*)
+{
+	// the trace is always disabled in the null backend
+	return false;
+}
+
+// Graphics Commands
+static void
+_renoir_null_pass_begin(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		h->raster_pass.command_list_head = nullptr;
+		h->raster_pass.command_list_tail = nullptr;
+
+		mn::mutex_lock(self->mtx);
+		mn_defer(mn::mutex_unlock(self->mtx));
+
+		auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PASS_BEGIN);
+		command->pass_begin.handle = h;
+		_renoir_null_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		h->compute_pass.command_list_head = nullptr;
+		h->compute_pass.command_list_tail = nullptr;
+
+		mn::mutex_lock(self->mtx);
+		mn_defer(mn::mutex_unlock(self->mtx));
+
+		auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PASS_BEGIN);
+		command->pass_begin.handle = h;
+		_renoir_null_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
+template<typename T>
+static void
+_renoir_null_pass_submit(IRenoir* self, Renoir_Handle* h, T* pass)
+{
+	if (pass->command_list_head == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	// push the pass end command
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PASS_END);
+	command->pass_end.handle = h;
+	_renoir_null_command_push(pass, command);
+
+	// push the commands to the end of command list, if the user requested to defer api calls
+	if (self->settings.defer_api_calls)
+	{
+		if (self->command_list_tail == nullptr)
+		{
+			self->command_list_head = pass->command_list_head;
+			self->command_list_tail = pass->command_list_tail;
+		}
+		else
+		{
+			self->command_list_tail->next = pass->command_list_head;
+			self->command_list_tail = pass->command_list_tail;
+		}
+	}
+	// other than this just process the command
+	else
+	{
+		for(auto it = pass->command_list_head; it != nullptr;)
+		{
+			_renoir_null_command_execute(self, it);
+			auto next = it->next;
+			_renoir_null_command_free(self, it);
+			it = next;
+		}
+	}
+}
+
+static void
+_renoir_null_pass_end(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_null_pass_submit(self, h, &h->raster_pass);
+		h->raster_pass.command_list_head = nullptr;
+		h->raster_pass.command_list_tail = nullptr;
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_null_pass_submit(self, h, &h->compute_pass);
+		h->compute_pass.command_list_head = nullptr;
+		h->compute_pass.command_list_tail = nullptr;
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
+// pushes the command to the given pass, it's used by the commands which are valid in both raster and compute passes
+static void
+_renoir_null_pass_command_push(Renoir_Handle* h, Renoir_Command* command)
+{
+	if (h->kind == RENOIR_HANDLE_KIND_RASTER_PASS)
+	{
+		_renoir_null_command_push(&h->raster_pass, command);
+	}
+	else if (h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS)
+	{
+		_renoir_null_command_push(&h->compute_pass, command);
+	}
+	else
+	{
+		assert(false && "invalid pass");
+	}
+}
+
+static void
+_renoir_null_clear(Renoir* api, Renoir_Pass pass, Renoir_Clear_Desc desc)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	if (desc.independent_clear_color == RENOIR_SWITCH_DEFAULT)
+		desc.independent_clear_color = RENOIR_SWITCH_DISABLE;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_PASS_CLEAR);
+	mn::mutex_unlock(self->mtx);
+
+	command->pass_clear.desc = desc;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_use_pipeline(Renoir* api, Renoir_Pass pass, Renoir_Pipeline_Desc pipeline_desc)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_USE_PIPELINE);
+	mn::mutex_unlock(self->mtx);
+
+	command->use_pipeline.pipeline_desc = pipeline_desc;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_use_program(Renoir* api, Renoir_Pass pass, Renoir_Program program)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	auto hprogram = _renoir_null_handle_get(self, program.handle);
+	if (hprogram == nullptr && program.handle != nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_USE_PROGRAM);
+	mn::mutex_unlock(self->mtx);
+
+	command->use_program.program = hprogram;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_use_compute(Renoir* api, Renoir_Pass pass, Renoir_Compute compute)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+
+	auto hcompute = _renoir_null_handle_get(self, compute.handle);
+	if (hcompute == nullptr && compute.handle != nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_USE_COMPUTE);
+	mn::mutex_unlock(self->mtx);
+
+	command->use_compute.compute = hcompute;
+	_renoir_null_command_push(&h->compute_pass, command);
+}
+
+static void
+_renoir_null_scissor(Renoir* api, Renoir_Pass pass, int x, int y, int width, int height)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_SCISSOR);
+	mn::mutex_unlock(self->mtx);
+
+	command->scissor.x = x;
+	command->scissor.y = y;
+	command->scissor.w = width;
+	command->scissor.h = height;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_buffer_zero(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+
+	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_CLEAR);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_clear.handle = hbuffer;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_buffer_write(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size)
+{
+	// this means he's trying to write nothing so no-op
+	if (bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+
+	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_WRITE);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_write.handle = hbuffer;
+	command->buffer_write.offset = offset;
+	command->buffer_write.bytes = mn::alloc(bytes_size, alignof(char)).ptr;
+	command->buffer_write.bytes_size = bytes_size;
+	::memcpy(command->buffer_write.bytes, bytes, bytes_size);
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_texture_write(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc)
+{
+	// this means he's trying to write nothing so no-op
+	if (desc.bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	auto htexture = _renoir_null_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
+	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_WRITE);
+	mn::mutex_unlock(self->mtx);
+
+	command->texture_write.handle = htexture;
+	command->texture_write.desc = desc;
+	command->texture_write.desc.bytes = mn::alloc(desc.bytes_size, alignof(char)).ptr;
+	::memcpy(command->texture_write.desc.bytes, desc.bytes, desc.bytes_size);
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_buffer_zero_global(Renoir* api, Renoir_Buffer buffer)
+{
+	auto self = api->ctx;
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+
+	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_CLEAR);
+	command->buffer_clear.handle = hbuffer;
+	_renoir_null_command_process(self, command);
+}
+
+static void
+_renoir_null_buffer_write_global(Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size)
+{
+	// this means he's trying to write nothing so no-op
+	if (bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	assert(hbuffer != nullptr);
+	if (hbuffer == nullptr)
+		return;
+
+	assert(hbuffer->buffer.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_WRITE);
+	command->buffer_write.handle = hbuffer;
+	command->buffer_write.offset = offset;
+	command->buffer_write.bytes = mn::alloc(bytes_size, alignof(char)).ptr;
+	command->buffer_write.bytes_size = bytes_size;
+	::memcpy(command->buffer_write.bytes, bytes, bytes_size);
+	_renoir_null_command_process(self, command);
+}
+
+static void
+_renoir_null_buffer_copy_global(Renoir* api, Renoir_Buffer dst, size_t dst_offset, Renoir_Buffer src, size_t src_offset, size_t size)
+{
+	// this means he's trying to copy nothing so no-op
+	if (size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto hdst = _renoir_null_handle_get(self, dst.handle);
+	auto hsrc = _renoir_null_handle_get(self, src.handle);
+	assert(hdst != nullptr && hsrc != nullptr);
+	if (hdst == nullptr || hsrc == nullptr)
+		return;
+
+	assert(hdst->buffer.usage != RENOIR_USAGE_STATIC);
+	assert(hdst != hsrc && "buffer copy source and destination should be different buffers");
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_COPY);
+	command->buffer_copy.dst = hdst;
+	command->buffer_copy.dst_offset = dst_offset;
+	command->buffer_copy.src = hsrc;
+	command->buffer_copy.src_offset = src_offset;
+	command->buffer_copy.size = size;
+	_renoir_null_command_process(self, command);
+}
+
+static void
+_renoir_null_texture_write_global(Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc)
+{
+	// this means he's trying to write nothing so no-op
+	if (desc.bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto htexture = _renoir_null_handle_get(self, texture.handle);
+	assert(htexture != nullptr);
+	if (htexture == nullptr)
+		return;
+	assert(htexture->texture.desc.usage != RENOIR_USAGE_STATIC);
+
+	mn::mutex_lock(self->mtx);
+	mn_defer(mn::mutex_unlock(self->mtx));
+
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_WRITE);
+	command->texture_write.handle = htexture;
+	command->texture_write.desc = desc;
+	command->texture_write.desc.bytes = mn::alloc(desc.bytes_size, alignof(char)).ptr;
+	::memcpy(command->texture_write.desc.bytes, desc.bytes, desc.bytes_size);
+	_renoir_null_command_process(self, command);
+}
+
+static Renoir_Uniform
+_renoir_null_uniform_alloc(Renoir* api, Renoir_Pass pass, void* bytes, size_t bytes_size)
+{
+	assert(bytes_size > 0 && "uniform allocation size should be greater than 0");
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return {};
+
+	mn::mutex_lock(self->mtx);
+	auto& ring = self->uniform_ring;
+	auto offset = (ring.offset + ring.alignment - 1) & ~(ring.alignment - 1);
+	if (offset + bytes_size > ring.buffer->buffer.size)
+	{
+		mn::mutex_unlock(self->mtx);
+		mn::log_error("null: uniform ring is exhausted, consider increasing 'uniform_ring_size' setting");
+		return Renoir_Uniform{};
+	}
+	ring.offset = offset + bytes_size;
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_WRITE);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_write.handle = ring.buffer;
+	command->buffer_write.offset = offset;
+	command->buffer_write.bytes = mn::alloc(bytes_size, alignof(char)).ptr;
+	command->buffer_write.bytes_size = bytes_size;
+	::memcpy(command->buffer_write.bytes, bytes, bytes_size);
+	_renoir_null_pass_command_push(h, command);
+
+	return Renoir_Uniform{Renoir_Buffer{_renoir_null_handle_public(ring.buffer)}, offset, bytes_size};
+}
+
+static void
+_renoir_null_buffer_read(Renoir* api, Renoir_Buffer buffer, size_t offset, void* bytes, size_t bytes_size)
+{
+	// this means he's trying to read nothing so no-op
+	if (bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, buffer.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	// this means that buffer creation didn't execute yet
+	if (h->buffer.data.ptr == nullptr)
+	{
+		::memset(bytes, 0, bytes_size);
+		return;
+	}
+
+	Renoir_Command command{};
+	command.kind = RENOIR_COMMAND_KIND_BUFFER_READ;
+	command.buffer_read.handle = h;
+	command.buffer_read.offset = offset;
+	command.buffer_read.bytes = bytes;
+	command.buffer_read.bytes_size = bytes_size;
+
+	mn::mutex_lock(self->mtx);
+	_renoir_null_command_execute(self, &command);
+	mn::mutex_unlock(self->mtx);
+}
+
+static void
+_renoir_null_texture_read(Renoir* api, Renoir_Texture texture, Renoir_Texture_Edit_Desc desc)
+{
+	// this means he's trying to read nothing so no-op
+	if (desc.bytes_size == 0)
+		return;
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, texture.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	// this means that texture creation didn't execute yet
+	if (h->texture.data.ptr == nullptr)
+	{
+		::memset(desc.bytes, 0, desc.bytes_size);
+		return;
+	}
+
+	Renoir_Command command{};
+	command.kind = RENOIR_COMMAND_KIND_TEXTURE_READ;
+	command.texture_read.handle = h;
+	command.texture_read.desc = desc;
+
+	mn::mutex_lock(self->mtx);
+	_renoir_null_command_execute(self, &command);
+	mn::mutex_unlock(self->mtx);
+}
+
+static void
+_renoir_null_buffer_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot, size_t offset, size_t size)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = shader;
+	command->buffer_bind.slot = slot;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_buffer_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, RENOIR_SHADER shader, int slot)
+{
+	_renoir_null_buffer_bind_range(api, pass, buffer, shader, slot, 0, 0);
+}
+
+static void
+_renoir_null_buffer_storage_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer_Storage_Bind_Desc desc)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_STORAGE_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_storage_bind.desc = desc;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_texture_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+	auto htex = _renoir_null_handle_get(self, texture.handle);
+	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->texture_bind.handle = htex;
+	command->texture_bind.shader = shader;
+	command->texture_bind.slot = slot;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_uniform_bind(Renoir* api, Renoir_Pass pass, Renoir_Uniform uniform, RENOIR_SHADER shader, int slot)
+{
+	assert(uniform.buffer.handle != nullptr && uniform.size > 0 && "invalid uniform, it should be allocated using uniform_alloc");
+	_renoir_null_buffer_bind_range(api, pass, uniform.buffer, shader, slot, uniform.offset, uniform.size);
+}
+
+inline static void
+_renoir_null_sampler_get(IRenoir* self, Renoir_Sampler_Desc desc)
+{
+	size_t best_ix = self->sampler_cache.count;
+	for (size_t i = 0; i < self->sampler_cache.count; ++i)
+	{
+		if (::memcmp(&self->sampler_cache[i], &desc, sizeof(desc)) == 0)
+		{
+			best_ix = i;
+			break;
+		}
+	}
+
+	if (best_ix < self->sampler_cache.count)
+	{
+		++self->stats.frame.sampler_cache_hits;
+	}
+	else
+	{
+		++self->stats.frame.sampler_cache_misses;
+		// evict the least recently used sampler to make room for the new one
+		if (self->sampler_cache.count == (size_t)self->settings.sampler_cache_size)
+		{
+			++self->stats.frame.sampler_cache_evictions;
+			mn::log_warning("sampler evicted");
+			best_ix = self->sampler_cache.count - 1;
+		}
+		else
+		{
+			mn::buf_push(self->sampler_cache, desc);
+			best_ix = self->sampler_cache.count - 1;
+		}
+	}
+
+	// reorder the cache
+	for (size_t i = 0; i < best_ix; ++i)
+	{
+		auto index = best_ix - i - 1;
+		self->sampler_cache[index + 1] = self->sampler_cache[index];
+	}
+	self->sampler_cache[0] = desc;
+}
+
+static void
+_renoir_null_texture_sampler_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, RENOIR_SHADER shader, int slot, Renoir_Sampler_Desc sampler)
+{
+	auto self = api->ctx;
+
+	// there are no samplers to create, the sampler state has no effect without a gpu
+	mn::mutex_lock(self->mtx);
+	_renoir_null_sampler_get(self, sampler);
+	mn::mutex_unlock(self->mtx);
+
+	_renoir_null_texture_bind(api, pass, texture, shader, slot);
+}
+
+static void
+_renoir_null_buffer_compute_bind_range(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access, size_t offset, size_t size)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+	assert(
+		gpu_access != RENOIR_ACCESS_NONE &&
+		"gpu should read, write, or both, it has no meaning to bind a buffer that the GPU cannot read or write from"
+	);
+
+	auto hbuffer = _renoir_null_handle_get(self, buffer.handle);
+	if (hbuffer == nullptr && buffer.handle != nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_BUFFER_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->buffer_bind.handle = hbuffer;
+	command->buffer_bind.shader = RENOIR_SHADER_COMPUTE;
+	command->buffer_bind.slot = slot;
+	command->buffer_bind.gpu_access = gpu_access;
+	command->buffer_bind.offset = offset;
+	command->buffer_bind.size = size;
+	_renoir_null_command_push(&h->compute_pass, command);
+}
+
+static void
+_renoir_null_buffer_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Buffer buffer, int slot, RENOIR_ACCESS gpu_access)
+{
+	_renoir_null_buffer_compute_bind_range(api, pass, buffer, slot, gpu_access, 0, 0);
+}
+
+static void
+_renoir_null_texture_compute_bind(Renoir* api, Renoir_Pass pass, Renoir_Texture texture, int slot, int mip_level, RENOIR_ACCESS gpu_access)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+	assert(
+		gpu_access != RENOIR_ACCESS_NONE &&
+		"gpu should read, write, or both, it has no meaning to bind a texture that the GPU cannot read or write from"
+	);
+
+	if (gpu_access == RENOIR_ACCESS_READ)
+	{
+		assert(mip_level == 0 && "read only textures are bound as samplers, so you can't change mip level");
+	}
+
+	auto htex = _renoir_null_handle_get(self, texture.handle);
+	assert(htex != nullptr);
+	if (htex == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TEXTURE_BIND);
+	mn::mutex_unlock(self->mtx);
+
+	command->texture_bind.handle = htex;
+	command->texture_bind.shader = RENOIR_SHADER_COMPUTE;
+	command->texture_bind.slot = slot;
+	command->texture_bind.level = mip_level;
+	command->texture_bind.gpu_access = gpu_access;
+	_renoir_null_command_push(&h->compute_pass, command);
+}
+
+static void
+_renoir_null_draw(Renoir* api, Renoir_Pass pass, Renoir_Draw_Desc desc)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	if (desc.index_buffer.handle != nullptr && desc.index_type == RENOIR_TYPE_NONE)
+		desc.index_type = RENOIR_TYPE_UINT16;
+
+	// the buffers are resolved again when the draw executes, so draws which use stale buffers are dropped here
+	for (const auto& vertex: desc.vertex_buffers)
+		if (vertex.buffer.handle != nullptr && _renoir_null_handle_get(self, vertex.buffer.handle) == nullptr)
+			return;
+	if (desc.index_buffer.handle != nullptr && _renoir_null_handle_get(self, desc.index_buffer.handle) == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_DRAW);
+	mn::mutex_unlock(self->mtx);
+
+	command->draw.desc = desc;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_dispatch(Renoir* api, Renoir_Pass pass, int x, int y, int z)
+{
+	assert(x >= 0 && y >= 0 && z >= 0);
+
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_COMPUTE_PASS);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_DISPATCH);
+	mn::mutex_unlock(self->mtx);
+
+	command->dispatch.x = x;
+	command->dispatch.y = y;
+	command->dispatch.z = z;
+	_renoir_null_command_push(&h->compute_pass, command);
+}
+
+static void
+_renoir_null_memory_barrier(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_MEMORY_BARRIER);
+	mn::mutex_unlock(self->mtx);
+
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_timer_begin(Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto htimer = _renoir_null_handle_get(self, timer.handle);
+	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
+
+	if (htimer->timer.state != RENOIR_NULL_STATE_NONE)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TIMER_BEGIN);
+	mn::mutex_unlock(self->mtx);
+
+	command->timer_begin.handle = htimer;
+	htimer->timer.state = RENOIR_NULL_STATE_BEGIN;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_timer_end(Renoir* api, Renoir_Pass pass, Renoir_Timer timer)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto htimer = _renoir_null_handle_get(self, timer.handle);
+	assert(htimer != nullptr && htimer->kind == RENOIR_HANDLE_KIND_TIMER);
+	if (htimer == nullptr)
+		return;
+
+	if (htimer->timer.state != RENOIR_NULL_STATE_BEGIN)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_TIMER_END);
+	mn::mutex_unlock(self->mtx);
+
+	command->timer_end.handle = htimer;
+	htimer->timer.state = RENOIR_NULL_STATE_END;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_query_begin(Renoir* api, Renoir_Pass pass, Renoir_Query query)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto hquery = _renoir_null_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+
+	if (hquery->query.state == RENOIR_NULL_STATE_BEGIN)
+	{
+		assert(false && "query_begin called twice without a query_end");
+		return;
+	}
+	if (hquery->query.pending == RENOIR_NULL_QUERY_RING)
+	{
+		mn::log_warning(
+			"null: query_begin is dropped, the query has {} results which are not read back by query_result yet",
+			RENOIR_NULL_QUERY_RING
+		);
+		return;
+	}
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_QUERY_BEGIN);
+	mn::mutex_unlock(self->mtx);
+
+	command->query_begin.handle = hquery;
+	hquery->query.state = RENOIR_NULL_STATE_BEGIN;
+	++hquery->query.pending;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_query_end(Renoir* api, Renoir_Pass pass, Renoir_Query query)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	auto hquery = _renoir_null_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+
+	if (hquery->query.state != RENOIR_NULL_STATE_BEGIN)
+		return;
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_QUERY_END);
+	mn::mutex_unlock(self->mtx);
+
+	command->query_end.handle = hquery;
+	hquery->query.state = RENOIR_NULL_STATE_END;
+	_renoir_null_pass_command_push(h, command);
+}
+
+static void
+_renoir_null_conditional_begin(Renoir* api, Renoir_Pass pass, Renoir_Query query, bool)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+	auto hquery = _renoir_null_handle_get(self, query.handle);
+	assert(hquery != nullptr && hquery->kind == RENOIR_HANDLE_KIND_QUERY);
+	if (hquery == nullptr)
+		return;
+	assert(
+		hquery->query.kind != RENOIR_QUERY_PIPELINE_STATISTICS &&
+		"only occlusion queries can be used in conditional rendering"
+	);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_CONDITIONAL_BEGIN);
+	mn::mutex_unlock(self->mtx);
+
+	command->conditional_begin.handle = hquery;
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_conditional_end(Renoir* api, Renoir_Pass pass)
+{
+	auto self = api->ctx;
+	auto h = _renoir_null_handle_get(self, pass.handle);
+	assert(h != nullptr);
+	if (h == nullptr)
+		return;
+	assert(h->kind == RENOIR_HANDLE_KIND_RASTER_PASS);
+
+	mn::mutex_lock(self->mtx);
+	auto command = _renoir_null_command_new(self, RENOIR_COMMAND_KIND_CONDITIONAL_END);
+	mn::mutex_unlock(self->mtx);
+
+	_renoir_null_command_push(&h->raster_pass, command);
+}
+
+static void
+_renoir_null_profiler_scope_begin(Renoir*, Renoir_Pass, const char*)
+{
+	// the profiler is always disabled in the null backend
+}
+
+static void
+_renoir_null_profiler_scope_end(Renoir*, Renoir_Pass)
+{
+	// the profiler is always disabled in the null backend
+}
+
+inline static void
+_renoir_load_api(Renoir* api)
+{
+	api->init = _renoir_null_init;
+	api->dispose = _renoir_null_dispose;
+
+	api->name = _renoir_null_name;
+	api->texture_origin = _renoir_null_texture_origin;
+	api->stats = _renoir_null_stats;
+	api->memory_stats = _renoir_null_memory_stats;
+
+	api->handle_ref = _renoir_null_handle_ref;
+	api->handle_ready = _renoir_null_handle_ready;
+	api->flush = _renoir_null_flush;
+
+	api->swapchain_new = _renoir_null_swapchain_new;
+	api->swapchain_free = _renoir_null_swapchain_free;
+	api->swapchain_resize = _renoir_null_swapchain_resize;
+	api->swapchain_present = _renoir_null_swapchain_present;
+
+	api->buffer_new = _renoir_null_buffer_new;
+	api->buffer_free = _renoir_null_buffer_free;
+	api->buffer_size = _renoir_null_buffer_size;
+
+	api->texture_new = _renoir_null_texture_new;
+	api->texture_free = _renoir_null_texture_free;
+	api->texture_native_handle = _renoir_null_texture_native_handle;
+	api->texture_size = _renoir_null_texture_size;
+	api->texture_desc = _renoir_null_texture_desc;
+	api->texture_transient = _renoir_null_texture_transient;
+	api->texture_transient_free = _renoir_null_texture_transient_free;
+
+	api->program_new = _renoir_null_program_new;
+	api->program_free = _renoir_null_program_free;
+
+	api->compute_new = _renoir_null_compute_new;
+	api->compute_free = _renoir_null_compute_free;
+
+	api->program_reflect = _renoir_null_program_reflect;
+	api->compute_reflect = _renoir_null_compute_reflect;
+
+	api->pass_swapchain_new = _renoir_null_pass_swapchain_new;
+	api->pass_offscreen_new = _renoir_null_pass_offscreen_new;
+	api->pass_compute_new = _renoir_null_pass_compute_new;
+	api->pass_free = _renoir_null_pass_free;
+	api->pass_size = _renoir_null_pass_size;
+	api->pass_offscreen_desc = _renoir_null_pass_offscreen_desc;
+
+	api->timer_new = _renoir_null_timer_new;
+	api->timer_free = _renoir_null_timer_free;
+	api->timer_elapsed = _renoir_null_timer_elapsed;
+
+	api->query_new = _renoir_null_query_new;
+	api->query_free = _renoir_null_query_free;
+	api->query_result = _renoir_null_query_result;
+
+	api->profiler_frame_results = _renoir_null_profiler_frame_results;
+	api->trace_export = _renoir_null_trace_export;
+
+	api->pass_begin = _renoir_null_pass_begin;
+	api->pass_end = _renoir_null_pass_end;
+	api->clear = _renoir_null_clear;
+	api->use_pipeline = _renoir_null_use_pipeline;
+	api->use_program = _renoir_null_use_program;
+	api->use_compute = _renoir_null_use_compute;
+	api->scissor = _renoir_null_scissor;
+	api->buffer_zero = _renoir_null_buffer_zero;
+	api->buffer_write = _renoir_null_buffer_write;
+	api->texture_write = _renoir_null_texture_write;
+	api->buffer_zero_global = _renoir_null_buffer_zero_global;
+	api->buffer_write_global = _renoir_null_buffer_write_global;
+	api->buffer_copy_global = _renoir_null_buffer_copy_global;
+	api->texture_write_global = _renoir_null_texture_write_global;
+	api->uniform_alloc = _renoir_null_uniform_alloc;
+	api->buffer_read = _renoir_null_buffer_read;
+	api->texture_read = _renoir_null_texture_read;
+	api->buffer_bind = _renoir_null_buffer_bind;
+	api->buffer_bind_range = _renoir_null_buffer_bind_range;
+	api->buffer_storage_bind = _renoir_null_buffer_storage_bind;
+	api->texture_bind = _renoir_null_texture_bind;
+	api->uniform_bind = _renoir_null_uniform_bind;
+	api->texture_sampler_bind = _renoir_null_texture_sampler_bind;
+	api->buffer_compute_bind = _renoir_null_buffer_compute_bind;
+	api->buffer_compute_bind_range = _renoir_null_buffer_compute_bind_range;
+	api->texture_compute_bind = _renoir_null_texture_compute_bind;
+	api->draw = _renoir_null_draw;
+	api->dispatch = _renoir_null_dispatch;
+	api->memory_barrier = _renoir_null_memory_barrier;
+	api->timer_begin = _renoir_null_timer_begin;
+	api->timer_end = _renoir_null_timer_end;
+	api->query_begin = _renoir_null_query_begin;
+	api->query_end = _renoir_null_query_end;
+	api->conditional_begin = _renoir_null_conditional_begin;
+	api->conditional_end = _renoir_null_conditional_end;
+	api->profiler_scope_begin = _renoir_null_profiler_scope_begin;
+	api->profiler_scope_end = _renoir_null_profiler_scope_end;
+}
+
+Renoir*
+renoir_api()
+{
+	static Renoir _api;
+	_renoir_load_api(&_api);
+	return &_api;
+}
+
+extern "C" RENOIR_NULL_EXPORT void*
+rad_api(void* api, bool reload)
+{
+	if (api == nullptr)
+	{
+		auto self = mn::alloc_zerod<Renoir>();
+		_renoir_load_api(self);
+		return self;
+	}
+	else if (api != nullptr && reload)
+	{
+		auto self = (Renoir*)api;
+		_renoir_load_api(self);
+		return api;
+	}
+	else if (api != nullptr && reload == false)
+	{
+		mn::free((Renoir*)api);
+		return nullptr;
+	}
+	return nullptr;
+}
@@ -172,6 +172,8 @@ typedef struct Renoir_Window {
 	int width, height;
 	const char* title;
 	void* userdata;
+	// default: false, keeps the events coalesced by renoir_window_poll_all (see renoir_window_poll_history)
+	bool poll_history;
 } Renoir_Window;
 
 RENOIR_WINDOW_EXPORT Renoir_Window*
@@ -183,5 +185,24 @@ renoir_window_free(Renoir_Window* self);
 RENOIR_WINDOW_EXPORT Renoir_Event
 renoir_window_poll(Renoir_Window* self);
 
+// drains the pending events into out and returns the number of written events, consecutive mouse move and window
+// resize events are coalesced into the latest one, events which don't fit in cap are kept for the next call
+RENOIR_WINDOW_EXPORT int
+renoir_window_poll_all(Renoir_Window* self, Renoir_Event* out, int cap);
+
+// returns the events which were coalesced by the last renoir_window_poll_all call in the order they were received,
+// it's empty unless poll_history is enabled, the pointer is valid until the next renoir_window_poll_all call
+RENOIR_WINDOW_EXPORT const Renoir_Event*
+renoir_window_poll_history(Renoir_Window* self, int* count);
+
+// blocks until there are pending events, the timeout expires, or renoir_window_wake is called, a negative timeout
+// waits forever, it returns true if there are pending events so on-demand rendering loops don't spin when idle
+RENOIR_WINDOW_EXPORT bool
+renoir_window_wait(Renoir_Window* self, int timeout_ms);
+
+// wakes up a blocked renoir_window_wait call, it can be called from any thread
+RENOIR_WINDOW_EXPORT void
+renoir_window_wake(Renoir_Window* self);
+
 RENOIR_WINDOW_EXPORT void
 renoir_window_native_handles(Renoir_Window* self, void** handle, void** display);
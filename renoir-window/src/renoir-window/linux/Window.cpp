@@ -6,9 +6,14 @@
 
 #include <mn/Memory.h>
 #include <mn/Defer.h>
+#include <mn/Buf.h>
 
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 struct Renoir_Window_Linux
 {
@@ -19,6 +24,10 @@ struct Renoir_Window_Linux
 	bool running;
 	// old mouse position
 	int old_x, old_y;
+	// events coalesced by the last renoir_window_poll_all call
+	mn::Buf<Renoir_Event> history;
+	// signaled by renoir_window_wake to interrupt renoir_window_wait
+	int wake_fd;
 };
 
 inline static int
@@ -282,12 +291,17 @@ renoir_window_new(int width, int height, const char* title, RENOIR_WINDOW_MSAA_M
 		KeyReleaseMask|
 		ButtonPressMask|
 		ButtonReleaseMask|
+		PointerMotionMask|
 		ExposureMask
 	);
 
 	XStoreName(display, handle, title);
 	XMapWindow(display, handle);
 
+	auto wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (wake_fd == -1)
+		return nullptr;
+
 	auto self = mn::alloc_zerod<Renoir_Window_Linux>();
 
 	self->window.width = width;
@@ -296,6 +310,8 @@ renoir_window_new(int width, int height, const char* title, RENOIR_WINDOW_MSAA_M
 	self->running = true;
 	self->display = display;
 	self->handle = handle;
+	self->history = mn::buf_new<Renoir_Event>();
+	self->wake_fd = wake_fd;
 
 	display = nullptr;
 	handle = None;
@@ -312,144 +328,260 @@ renoir_window_free(Renoir_Window* window)
 		XDestroyWindow(self->display, self->handle);
 	if (self->display)
 		XCloseDisplay(self->display);
+	mn::buf_free(self->history);
+	::close(self->wake_fd);
 	mn::free(self);
 }
 
-Renoir_Event
-renoir_window_poll(Renoir_Window* window)
+// translates the x event into self->event, it's left untouched if the x event has no renoir equivalent
+static void
+_renoir_window_translate(Renoir_Window_Linux* self, XEvent& event)
 {
-	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
-
-	XEvent event{};
-	self->event = Renoir_Event{};
-
-	if(XPending(self->display))
+	switch(event.type)
 	{
-		XNextEvent(self->display, &event);
-		if(XFilterEvent(&event, None))
-			return self->event;
-
-		switch(event.type)
+		case ClientMessage:
 		{
-			case ClientMessage:
-			{
-				if ((Atom)event.xclient.data.l[0] == *_wm_delete_window(self->display))
-				{
-					self->running = false;
-					memset(&self->event, 0, sizeof(self->event));
-					self->event.kind = RENOIR_EVENT_KIND_WINDOW_CLOSE;
-				}
-			}
-			break;
-
-			case KeyPress:
+			if ((Atom)event.xclient.data.l[0] == *_wm_delete_window(self->display))
 			{
+				self->running = false;
 				memset(&self->event, 0, sizeof(self->event));
-				self->event.kind = RENOIR_EVENT_KIND_KEYBOARD_KEY;
-				self->event.keyboard.key = _renoir_map_keyboard_key(XLookupKeysym(&event.xkey, 0));
-				self->event.keyboard.state = RENOIR_KEY_STATE_DOWN;
+				self->event.kind = RENOIR_EVENT_KIND_WINDOW_CLOSE;
 			}
-			break;
+		}
+		break;
 
-			case KeyRelease:
-			{
-				memset(&self->event, 0, sizeof(self->event));
-				self->event.kind = RENOIR_EVENT_KIND_KEYBOARD_KEY;
-				self->event.keyboard.key = _renoir_map_keyboard_key(XLookupKeysym(&event.xkey, 0));
-				self->event.keyboard.state = RENOIR_KEY_STATE_UP;
-			}
-			break;
+		case KeyPress:
+		{
+			memset(&self->event, 0, sizeof(self->event));
+			self->event.kind = RENOIR_EVENT_KIND_KEYBOARD_KEY;
+			self->event.keyboard.key = _renoir_map_keyboard_key(XLookupKeysym(&event.xkey, 0));
+			self->event.keyboard.state = RENOIR_KEY_STATE_DOWN;
+		}
+		break;
 
-			case ButtonPress:
+		case KeyRelease:
+		{
+			memset(&self->event, 0, sizeof(self->event));
+			self->event.kind = RENOIR_EVENT_KIND_KEYBOARD_KEY;
+			self->event.keyboard.key = _renoir_map_keyboard_key(XLookupKeysym(&event.xkey, 0));
+			self->event.keyboard.state = RENOIR_KEY_STATE_UP;
+		}
+		break;
+
+		case ButtonPress:
+		{
+			// Button4 = scroll up
+			// Button5 = scroll down
+			if (event.xbutton.button == Button4 || event.xbutton.button == Button5)
 			{
-				// Button4 = scroll up
-				// Button5 = scroll down
-				if (event.xbutton.button == Button4 || event.xbutton.button == Button5)
-				{
-					memset(&self->event, 0, sizeof(self->event));
-					self->event.kind = RENOIR_EVENT_KIND_MOUSE_WHEEL;
-					self->event.wheel = event.xbutton.button == Button4 ? -120.0f : 120.0f;
-				}
-				else
-				{
-					memset(&self->event, 0, sizeof(self->event));
-					self->event.kind = RENOIR_EVENT_KIND_MOUSE_BUTTON;
-					self->event.mouse.button = _renoir_map_mouse_button(event.xbutton.button);
-					self->event.mouse.state = RENOIR_KEY_STATE_DOWN;
-				}
+				memset(&self->event, 0, sizeof(self->event));
+				self->event.kind = RENOIR_EVENT_KIND_MOUSE_WHEEL;
+				self->event.wheel = event.xbutton.button == Button4 ? -120.0f : 120.0f;
 			}
-			break;
-
-			case ButtonRelease:
+			else
 			{
 				memset(&self->event, 0, sizeof(self->event));
 				self->event.kind = RENOIR_EVENT_KIND_MOUSE_BUTTON;
 				self->event.mouse.button = _renoir_map_mouse_button(event.xbutton.button);
-				self->event.mouse.state = RENOIR_KEY_STATE_UP;
+				self->event.mouse.state = RENOIR_KEY_STATE_DOWN;
 			}
-			break;
+		}
+		break;
 
-			case MotionNotify:
-			{
-				
-			}
-			break;
+		case ButtonRelease:
+		{
+			memset(&self->event, 0, sizeof(self->event));
+			self->event.kind = RENOIR_EVENT_KIND_MOUSE_BUTTON;
+			self->event.mouse.button = _renoir_map_mouse_button(event.xbutton.button);
+			self->event.mouse.state = RENOIR_KEY_STATE_UP;
+		}
+		break;
+
+		case MotionNotify:
+		{
+			memset(&self->event, 0, sizeof(self->event));
+			self->event.kind = RENOIR_EVENT_KIND_MOUSE_MOVE;
+			self->event.mouse_move.x = event.xmotion.x;
+			self->event.mouse_move.y = event.xmotion.y;
+			self->old_x = event.xmotion.x;
+			self->old_y = event.xmotion.y;
+		}
+		break;
 
-			case ConfigureNotify:
+		case ConfigureNotify:
+		{
+			if (self->window.width != event.xconfigure.width ||
+				self->window.height != event.xconfigure.height)
 			{
-				if (self->window.width != event.xconfigure.width ||
-					self->window.height != event.xconfigure.height)
-				{
-					memset(&self->event, 0, sizeof(self->event));
-					self->event.kind = RENOIR_EVENT_KIND_WINDOW_RESIZE;
-					self->event.resize.width = event.xconfigure.width;
-					self->event.resize.height = event.xconfigure.height;
-
-					self->window.width = event.xconfigure.width;
-					self->window.height = event.xconfigure.height;
-				}
+				memset(&self->event, 0, sizeof(self->event));
+				self->event.kind = RENOIR_EVENT_KIND_WINDOW_RESIZE;
+				self->event.resize.width = event.xconfigure.width;
+				self->event.resize.height = event.xconfigure.height;
+
+				self->window.width = event.xconfigure.width;
+				self->window.height = event.xconfigure.height;
 			}
+		}
+		break;
+
+		default:
 			break;
+	}
+}
 
-			default:
-				break;
+// reports the pointer position as a mouse move if it changed since the last reported one
+static void
+_renoir_window_query_pointer(Renoir_Window_Linux* self)
+{
+	Window root_return, child_return;
+	int root_x, root_y, win_x, win_y;
+	unsigned int mask_return;
+	XQueryPointer(
+		self->display,
+		self->handle,
+		&root_return,
+		&child_return,
+		&root_x,
+		&root_y,
+		&win_x,
+		&win_y,
+		&mask_return
+	);
+
+	if (win_x >= 0 && win_x < self->window.width && win_y >= 0 && win_y < self->window.height)
+	{
+		if (win_x != self->old_x || win_y != self->old_y)
+		{
+			memset(&self->event, 0, sizeof(self->event));
+			self->event.kind = RENOIR_EVENT_KIND_MOUSE_MOVE;
+			self->event.mouse_move.x = win_x;
+			self->event.mouse_move.y = win_y;
+			self->old_x = win_x;
+			self->old_y = win_y;
 		}
 	}
+}
+
+// appends the event to out, consecutive mouse move and window resize events are coalesced into the latest one
+static int
+_renoir_window_push_event(Renoir_Window_Linux* self, Renoir_Event* out, int count, const Renoir_Event& event)
+{
+	bool coalescable = event.kind == RENOIR_EVENT_KIND_MOUSE_MOVE || event.kind == RENOIR_EVENT_KIND_WINDOW_RESIZE;
+	if (coalescable && count > 0 && out[count - 1].kind == event.kind)
+	{
+		if (self->window.poll_history)
+			mn::buf_push(self->history, out[count - 1]);
+		out[count - 1] = event;
+		return count;
+	}
+
+	out[count] = event;
+	return count + 1;
+}
+
+Renoir_Event
+renoir_window_poll(Renoir_Window* window)
+{
+	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
+
+	XEvent event{};
+	self->event = Renoir_Event{};
+
+	if(XPending(self->display))
+	{
+		XNextEvent(self->display, &event);
+		if(XFilterEvent(&event, None))
+			return self->event;
+
+		_renoir_window_translate(self, event);
+	}
 	else
 	{
-		Window root_return, child_return;
-		int root_x, root_y, win_x, win_y;
-		unsigned int mask_return;
-		XQueryPointer(
-			self->display,
-			self->handle,
-			&root_return,
-			&child_return,
-			&root_x,
-			&root_y,
-			&win_x,
-			&win_y,
-			&mask_return
-		);
-
-		if (win_x >= 0 && win_x < self->window.width && win_y >= 0 && win_y < self->window.height)
-		{
-			if (win_x != self->old_x || win_y != self->old_y)
-			{
-				memset(&self->event, 0, sizeof(self->event));
-				self->event.kind = RENOIR_EVENT_KIND_MOUSE_MOVE;
-				self->event.mouse_move.x = win_x;
-				self->event.mouse_move.y = win_y;
-				self->old_x = win_x;
-				self->old_y = win_y;
-			}
-		}
+		_renoir_window_query_pointer(self);
 	}
-	
 
 	return self->event;
 }
 
+int
+renoir_window_poll_all(Renoir_Window* window, Renoir_Event* out, int cap)
+{
+	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
+	assert(out != nullptr || cap == 0);
+
+	mn::buf_clear(self->history);
+
+	// XPending reads whatever arrived on the connection once, the rest is drained from the already queued events
+	// without going back to the server, events which don't fit in out are left in the queue for the next call
+	int count = 0;
+	int queued = XPending(self->display);
+	while (queued > 0 && count < cap)
+	{
+		XEvent event{};
+		XNextEvent(self->display, &event);
+		queued = XEventsQueued(self->display, QueuedAlready);
+		if (XFilterEvent(&event, None))
+			continue;
+
+		self->event = Renoir_Event{};
+		_renoir_window_translate(self, event);
+		if (self->event.kind != RENOIR_EVENT_KIND_NONE)
+			count = _renoir_window_push_event(self, out, count, self->event);
+	}
+
+	// the pointer isn't queried here, XQueryPointer is a server round trip and MotionNotify already reports the moves
+	return count;
+}
+
+const Renoir_Event*
+renoir_window_poll_history(Renoir_Window* window, int* count)
+{
+	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
+	if (count)
+		*count = int(self->history.count);
+	return self->history.ptr;
+}
+
+bool
+renoir_window_wait(Renoir_Window* window, int timeout_ms)
+{
+	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
+
+	// XPending flushes our requests and reads what's already on the connection, so we only sleep when it's empty
+	if (XPending(self->display) > 0)
+		return true;
+
+	pollfd fds[2]{};
+	fds[0].fd = ConnectionNumber(self->display);
+	fds[0].events = POLLIN;
+	fds[1].fd = self->wake_fd;
+	fds[1].events = POLLIN;
+
+	int res = 0;
+	do
+		res = ::poll(fds, 2, timeout_ms < 0 ? -1 : timeout_ms);
+	while (res == -1 && errno == EINTR);
+
+	if (fds[1].revents & POLLIN)
+	{
+		uint64_t value = 0;
+		auto read_size = ::read(self->wake_fd, &value, sizeof(value));
+		(void) read_size;
+	}
+
+	return XPending(self->display) > 0;
+}
+
+void
+renoir_window_wake(Renoir_Window* window)
+{
+	Renoir_Window_Linux* self = (Renoir_Window_Linux*)window;
+
+	uint64_t value = 1;
+	auto write_size = ::write(self->wake_fd, &value, sizeof(value));
+	(void) write_size;
+}
+
 void
 renoir_window_native_handles(Renoir_Window* window, void** handle, void** display)
 {
@@ -1,6 +1,7 @@
 #include "renoir-window/Window.h"
 
 #include <mn/Memory.h>
+#include <mn/Buf.h>
 
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -16,6 +17,10 @@ typedef struct Renoir_Window_WinOS {
 	HDC hdc;
 	Renoir_Event event;
 	bool running;
+	// events coalesced by the last renoir_window_poll_all call
+	mn::Buf<Renoir_Event> history;
+	// signaled by renoir_window_wake to interrupt renoir_window_wait
+	HANDLE wake_event;
 } Renoir_Window_WinOS;
 
 inline static RENOIR_KEY
@@ -366,6 +371,23 @@ _renoir_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 	return DefWindowProcA(hwnd, msg, wparam, lparam);
 }
 
+// appends the event to out, consecutive mouse move and window resize events are coalesced into the latest one
+static int
+_renoir_window_push_event(Renoir_Window_WinOS* self, Renoir_Event* out, int count, const Renoir_Event& event)
+{
+	bool coalescable = event.kind == RENOIR_EVENT_KIND_MOUSE_MOVE || event.kind == RENOIR_EVENT_KIND_WINDOW_RESIZE;
+	if (coalescable && count > 0 && out[count - 1].kind == event.kind)
+	{
+		if (self->window.poll_history)
+			mn::buf_push(self->history, out[count - 1]);
+		out[count - 1] = event;
+		return count;
+	}
+
+	out[count] = event;
+	return count + 1;
+}
+
 // API
 Renoir_Window*
 renoir_window_new(int width, int height, const char* title, RENOIR_WINDOW_MSAA_MODE)
@@ -378,6 +400,8 @@ renoir_window_new(int width, int height, const char* title, RENOIR_WINDOW_MSAA_M
 	self->window.height = height;
 	self->window.title = title;
 	self->running = true;
+	self->history = mn::buf_new<Renoir_Event>();
+	self->wake_event = CreateEventA(NULL, FALSE, FALSE, NULL);
 
 	WNDCLASSEXA wc;
 	ZeroMemory(&wc, sizeof(wc));
@@ -407,6 +431,8 @@ renoir_window_new(int width, int height, const char* title, RENOIR_WINDOW_MSAA_M
 		NULL);
 	if (self->handle == INVALID_HANDLE_VALUE)
 	{
+		CloseHandle(self->wake_event);
+		mn::buf_free(self->history);
 		free(self);
 		return nullptr;
 	}
@@ -428,6 +454,8 @@ renoir_window_free(Renoir_Window* window)
 	assert(result && "ReleaseDC Failed");
 	result = DestroyWindow(self->handle);
 	assert(result && "DestroyWindow Failed");
+	CloseHandle(self->wake_event);
+	mn::buf_free(self->history);
 	mn::free(self);
 }
 
@@ -446,6 +474,67 @@ renoir_window_poll(Renoir_Window* window)
 	return self->event;
 }
 
+int
+renoir_window_poll_all(Renoir_Window* window, Renoir_Event* out, int cap)
+{
+	Renoir_Window_WinOS* self = (Renoir_Window_WinOS*)window;
+	assert(out != nullptr || cap == 0);
+
+	mn::buf_clear(self->history);
+
+	// the window proc translates the dispatched message into self->event, messages which don't fit in out are left
+	// in the queue for the next call
+	int count = 0;
+	MSG msg;
+	ZeroMemory(&msg, sizeof(msg));
+	while (count < cap && PeekMessageA(&msg, self->handle, 0, 0, PM_REMOVE))
+	{
+		memset(&self->event, 0, sizeof(self->event));
+		TranslateMessage(&msg);
+		DispatchMessageA(&msg);
+		if (self->event.kind != RENOIR_EVENT_KIND_NONE)
+			count = _renoir_window_push_event(self, out, count, self->event);
+	}
+	return count;
+}
+
+const Renoir_Event*
+renoir_window_poll_history(Renoir_Window* window, int* count)
+{
+	Renoir_Window_WinOS* self = (Renoir_Window_WinOS*)window;
+	if (count)
+		*count = int(self->history.count);
+	return self->history.ptr;
+}
+
+bool
+renoir_window_wait(Renoir_Window* window, int timeout_ms)
+{
+	Renoir_Window_WinOS* self = (Renoir_Window_WinOS*)window;
+
+	MSG msg;
+	if (PeekMessageA(&msg, self->handle, 0, 0, PM_NOREMOVE))
+		return true;
+
+	// MWMO_INPUTAVAILABLE wakes up for input which was already in the queue but has been seen by an earlier peek
+	MsgWaitForMultipleObjectsEx(
+		1,
+		&self->wake_event,
+		timeout_ms < 0 ? INFINITE : DWORD(timeout_ms),
+		QS_ALLINPUT,
+		MWMO_INPUTAVAILABLE
+	);
+
+	return PeekMessageA(&msg, self->handle, 0, 0, PM_NOREMOVE);
+}
+
+void
+renoir_window_wake(Renoir_Window* window)
+{
+	Renoir_Window_WinOS* self = (Renoir_Window_WinOS*)window;
+	SetEvent(self->wake_event);
+}
+
 void
 renoir_window_native_handles(Renoir_Window* window, void** handle, void** display)
 {
@@ -0,0 +1,744 @@
+#include <renoir/Renoir.h>
+#include <renoir/Capture.h>
+
+#if RENOIR_REPLAY_BACKEND_GL450
+#include <renoir-window/Window.h>
+#include <renoir-gl450/Renoir-gl450.h>
+#else
+#include <renoir-null/Renoir-null.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+// renoir-replay plays back a capture file (see capture_path setting and renoir/Capture.h) as fast as possible and
+// reports the cpu time of every frame, a frame is measured from its first record until swapchain_present/flush returns
+//
+// usage: renoir-replay capture.rcap [--out path.json] [--loop n] [--immediate]
+
+struct Replay_Handle
+{
+	RENOIR_CAPTURE kind;
+	void* handle;
+};
+
+struct Replay
+{
+	Renoir* gfx;
+	std::vector<uint8_t> data;
+	uint64_t uniform_ring_id;
+	// capture ids to the handles created by this replay
+	std::unordered_map<uint64_t, Replay_Handle> handles;
+	// uniform ring offsets at capture time to the uniforms allocated in the current frame
+	std::unordered_map<uint64_t, Renoir_Uniform> uniforms;
+	Renoir_Pass pass;
+	int skipped_records;
+	std::vector<uint64_t> frames;
+#if RENOIR_REPLAY_BACKEND_GL450
+	Renoir_Window* window;
+#endif
+};
+
+struct Replay_Reader
+{
+	const uint8_t* ptr;
+	size_t size;
+	size_t offset;
+	// set when a read goes past the end of the record
+	bool truncated;
+};
+
+static uint64_t
+replay_now()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+template<typename T>
+static T
+replay_read(Replay_Reader& reader)
+{
+	T res{};
+	if (reader.offset + sizeof(T) <= reader.size)
+		::memcpy(&res, reader.ptr + reader.offset, sizeof(T));
+	else
+		reader.truncated = true;
+	reader.offset += sizeof(T);
+	return res;
+}
+
+// returns a pointer to the next size bytes of the record, the rest of the record if size is SIZE_MAX, if the record
+// doesn't have size bytes left it returns nullptr and marks the reader as truncated
+static void*
+replay_read_bytes(Replay_Reader& reader, size_t& size)
+{
+	auto left = reader.offset < reader.size ? reader.size - reader.offset : 0;
+	if (size == SIZE_MAX)
+		size = left;
+	if (size > left)
+	{
+		reader.truncated = true;
+		reader.offset = reader.size;
+		size = 0;
+		return nullptr;
+	}
+	auto res = (void*)(reader.ptr + reader.offset);
+	reader.offset += size;
+	return res;
+}
+
+// returns true and counts the record as skipped if its reads went past its end, the record is corrupted and should
+// not reach the api
+static bool
+replay_truncated(Replay& self, RENOIR_CAPTURE kind, const Replay_Reader& reader)
+{
+	if (reader.truncated == false)
+		return false;
+	fprintf(stderr, "record %d is truncated, skipping it\n", int(kind));
+	++self.skipped_records;
+	return true;
+}
+
+static void*
+replay_handle(Replay& self, uint64_t id)
+{
+	if (id == 0)
+		return nullptr;
+	auto it = self.handles.find(id);
+	if (it == self.handles.end())
+		return nullptr;
+	return it->second.handle;
+}
+
+template<typename T>
+static void
+replay_handle_map(Replay& self, T& handle)
+{
+	handle.handle = replay_handle(self, uint64_t(uintptr_t(handle.handle)));
+}
+
+static void
+replay_handle_new(Replay& self, uint64_t id, RENOIR_CAPTURE kind, void* handle)
+{
+	self.handles[id] = Replay_Handle{kind, handle};
+}
+
+static void
+replay_handle_free(Replay& self, const Replay_Handle& h)
+{
+	auto gfx = self.gfx;
+	switch (h.kind)
+	{
+	case RENOIR_CAPTURE_SWAPCHAIN_NEW: gfx->swapchain_free(gfx, Renoir_Swapchain{h.handle}); break;
+	case RENOIR_CAPTURE_PASS_SWAPCHAIN_NEW:
+	case RENOIR_CAPTURE_PASS_OFFSCREEN_NEW:
+	case RENOIR_CAPTURE_PASS_COMPUTE_NEW: gfx->pass_free(gfx, Renoir_Pass{h.handle}); break;
+	case RENOIR_CAPTURE_BUFFER_NEW: gfx->buffer_free(gfx, Renoir_Buffer{h.handle}); break;
+	case RENOIR_CAPTURE_TEXTURE_NEW: gfx->texture_free(gfx, Renoir_Texture{h.handle}); break;
+	case RENOIR_CAPTURE_PROGRAM_NEW: gfx->program_free(gfx, Renoir_Program{h.handle}); break;
+	case RENOIR_CAPTURE_COMPUTE_NEW: gfx->compute_free(gfx, Renoir_Compute{h.handle}); break;
+	case RENOIR_CAPTURE_TIMER_NEW: gfx->timer_free(gfx, Renoir_Timer{h.handle}); break;
+	case RENOIR_CAPTURE_QUERY_NEW: gfx->query_free(gfx, Renoir_Query{h.handle}); break;
+	default: break;
+	}
+}
+
+// frees the handle which has the given id and removes it from the handles map
+static void
+replay_handle_free(Replay& self, uint64_t id)
+{
+	auto it = self.handles.find(id);
+	if (it == self.handles.end())
+		return;
+	replay_handle_free(self, it->second);
+	self.handles.erase(it);
+}
+
+static void
+replay_frame(Replay& self, uint64_t swapchain_id)
+{
+	auto gfx = self.gfx;
+	if (auto swapchain = replay_handle(self, swapchain_id))
+	{
+#if RENOIR_REPLAY_BACKEND_GL450
+		renoir_window_poll(self.window);
+#endif
+		gfx->swapchain_present(gfx, Renoir_Swapchain{swapchain});
+	}
+	else
+	{
+		gfx->flush(gfx, nullptr, nullptr);
+	}
+	self.uniforms.clear();
+}
+
+// returns true if the record ended a frame
+static bool
+replay_record(Replay& self, RENOIR_CAPTURE kind, Replay_Reader& reader)
+{
+	auto gfx = self.gfx;
+	auto pass = self.pass;
+	// records which should be inside a pass are skipped if the capture starts or ends in the middle of a pass
+	bool in_pass = pass.handle != nullptr;
+
+	switch (kind)
+	{
+	case RENOIR_CAPTURE_UNIFORM_RING:
+		self.uniform_ring_id = replay_read<uint64_t>(reader);
+		break;
+	case RENOIR_CAPTURE_FRAME:
+		replay_frame(self, replay_read<uint64_t>(reader));
+		return true;
+	case RENOIR_CAPTURE_SWAPCHAIN_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto width = replay_read<int32_t>(reader);
+		auto height = replay_read<int32_t>(reader);
+		void *handle = nullptr, *display = nullptr;
+#if RENOIR_REPLAY_BACKEND_GL450
+		renoir_window_native_handles(self.window, &handle, &display);
+#endif
+		auto swapchain = gfx->swapchain_new(gfx, width, height, handle, display);
+		replay_handle_new(self, id, kind, swapchain.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_PASS_SWAPCHAIN_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto swapchain = replay_handle(self, replay_read<uint64_t>(reader));
+		auto res = gfx->pass_swapchain_new(gfx, Renoir_Swapchain{swapchain});
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_PASS_OFFSCREEN_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto desc = replay_read<Renoir_Pass_Offscreen_Desc>(reader);
+		for (auto& color: desc.color)
+			replay_handle_map(self, color.texture);
+		replay_handle_map(self, desc.depth_stencil.texture);
+		auto res = gfx->pass_offscreen_new(gfx, desc);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_PASS_COMPUTE_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto res = gfx->pass_compute_new(gfx);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_BUFFER_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto desc = replay_read<Renoir_Buffer_Desc>(reader);
+		if (desc.data)
+			desc.data = replay_read_bytes(reader, desc.data_size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		auto res = gfx->buffer_new(gfx, desc);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_TEXTURE_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto desc = replay_read<Renoir_Texture_Desc>(reader);
+		for (auto& data: desc.data)
+		{
+			if (data)
+				data = replay_read_bytes(reader, desc.data_size);
+		}
+		if (replay_truncated(self, kind, reader))
+			break;
+		auto res = gfx->texture_new(gfx, desc);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_PROGRAM_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto desc = replay_read<Renoir_Program_Desc>(reader);
+		desc.vertex.bytes = (const char*)replay_read_bytes(reader, desc.vertex.size);
+		desc.pixel.bytes = (const char*)replay_read_bytes(reader, desc.pixel.size);
+		if (desc.geometry.bytes)
+			desc.geometry.bytes = (const char*)replay_read_bytes(reader, desc.geometry.size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		auto res = gfx->program_new(gfx, desc);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_COMPUTE_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto desc = replay_read<Renoir_Compute_Desc>(reader);
+		desc.compute.bytes = (const char*)replay_read_bytes(reader, desc.compute.size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		auto res = gfx->compute_new(gfx, desc);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_TIMER_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto res = gfx->timer_new(gfx);
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_QUERY_NEW:
+	{
+		auto id = replay_read<uint64_t>(reader);
+		auto query_kind = replay_read<int32_t>(reader);
+		auto res = gfx->query_new(gfx, RENOIR_QUERY(query_kind));
+		replay_handle_new(self, id, kind, res.handle);
+		break;
+	}
+	case RENOIR_CAPTURE_SWAPCHAIN_FREE:
+	case RENOIR_CAPTURE_PASS_FREE:
+	case RENOIR_CAPTURE_BUFFER_FREE:
+	case RENOIR_CAPTURE_TEXTURE_FREE:
+	case RENOIR_CAPTURE_PROGRAM_FREE:
+	case RENOIR_CAPTURE_COMPUTE_FREE:
+	case RENOIR_CAPTURE_TIMER_FREE:
+	case RENOIR_CAPTURE_QUERY_FREE:
+		replay_handle_free(self, replay_read<uint64_t>(reader));
+		break;
+	case RENOIR_CAPTURE_PASS_BEGIN:
+	{
+		auto h = replay_handle(self, replay_read<uint64_t>(reader));
+		if (h == nullptr || in_pass)
+		{
+			++self.skipped_records;
+			break;
+		}
+		self.pass = Renoir_Pass{h};
+		gfx->pass_begin(gfx, self.pass);
+		break;
+	}
+	case RENOIR_CAPTURE_PASS_END:
+		if (in_pass == false)
+		{
+			++self.skipped_records;
+			break;
+		}
+		gfx->pass_end(gfx, pass);
+		self.pass = Renoir_Pass{};
+		break;
+	case RENOIR_CAPTURE_BUFFER_CLEAR:
+	{
+		auto buffer = Renoir_Buffer{replay_handle(self, replay_read<uint64_t>(reader))};
+		if (in_pass)
+			gfx->buffer_zero(gfx, pass, buffer);
+		else
+			gfx->buffer_zero_global(gfx, buffer);
+		break;
+	}
+	case RENOIR_CAPTURE_BUFFER_WRITE:
+	{
+		auto buffer = Renoir_Buffer{replay_handle(self, replay_read<uint64_t>(reader))};
+		auto offset = replay_read<uint64_t>(reader);
+		size_t size = SIZE_MAX;
+		auto bytes = replay_read_bytes(reader, size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		if (in_pass)
+			gfx->buffer_write(gfx, pass, buffer, offset, bytes, size);
+		else
+			gfx->buffer_write_global(gfx, buffer, offset, bytes, size);
+		break;
+	}
+	case RENOIR_CAPTURE_BUFFER_COPY:
+	{
+		auto dst = Renoir_Buffer{replay_handle(self, replay_read<uint64_t>(reader))};
+		auto dst_offset = replay_read<uint64_t>(reader);
+		auto src = Renoir_Buffer{replay_handle(self, replay_read<uint64_t>(reader))};
+		auto src_offset = replay_read<uint64_t>(reader);
+		auto size = replay_read<uint64_t>(reader);
+		gfx->buffer_copy_global(gfx, dst, dst_offset, src, src_offset, size);
+		break;
+	}
+	case RENOIR_CAPTURE_TEXTURE_WRITE:
+	{
+		auto texture = Renoir_Texture{replay_handle(self, replay_read<uint64_t>(reader))};
+		auto desc = replay_read<Renoir_Texture_Edit_Desc>(reader);
+		desc.bytes = replay_read_bytes(reader, desc.bytes_size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		if (in_pass)
+			gfx->texture_write(gfx, pass, texture, desc);
+		else
+			gfx->texture_write_global(gfx, texture, desc);
+		break;
+	}
+	case RENOIR_CAPTURE_UNIFORM_WRITE:
+	{
+		auto offset = replay_read<uint64_t>(reader);
+		size_t size = SIZE_MAX;
+		auto bytes = replay_read_bytes(reader, size);
+		if (replay_truncated(self, kind, reader))
+			break;
+		if (in_pass == false)
+		{
+			++self.skipped_records;
+			break;
+		}
+		self.uniforms[offset] = gfx->uniform_alloc(gfx, pass, bytes, size);
+		break;
+	}
+	default:
+	{
+		// the rest of the records are pass commands
+		if (in_pass == false)
+		{
+			++self.skipped_records;
+			break;
+		}
+
+		switch (kind)
+		{
+		case RENOIR_CAPTURE_PASS_CLEAR:
+			gfx->clear(gfx, pass, replay_read<Renoir_Clear_Desc>(reader));
+			break;
+		case RENOIR_CAPTURE_USE_PIPELINE:
+			gfx->use_pipeline(gfx, pass, replay_read<Renoir_Pipeline_Desc>(reader));
+			break;
+		case RENOIR_CAPTURE_USE_PROGRAM:
+			gfx->use_program(gfx, pass, Renoir_Program{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_USE_COMPUTE:
+			gfx->use_compute(gfx, pass, Renoir_Compute{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_SCISSOR:
+		{
+			auto x = replay_read<int32_t>(reader);
+			auto y = replay_read<int32_t>(reader);
+			auto width = replay_read<int32_t>(reader);
+			auto height = replay_read<int32_t>(reader);
+			gfx->scissor(gfx, pass, x, y, width, height);
+			break;
+		}
+		case RENOIR_CAPTURE_BUFFER_BIND:
+		{
+			auto id = replay_read<uint64_t>(reader);
+			auto shader = RENOIR_SHADER(replay_read<int32_t>(reader));
+			auto slot = replay_read<int32_t>(reader);
+			auto gpu_access = RENOIR_ACCESS(replay_read<int32_t>(reader));
+			auto offset = replay_read<uint64_t>(reader);
+			auto size = replay_read<uint64_t>(reader);
+			if (id == self.uniform_ring_id)
+			{
+				auto it = self.uniforms.find(offset);
+				if (it == self.uniforms.end())
+				{
+					++self.skipped_records;
+					break;
+				}
+				gfx->uniform_bind(gfx, pass, it->second, shader, slot);
+				break;
+			}
+
+			auto buffer = Renoir_Buffer{replay_handle(self, id)};
+			if (shader == RENOIR_SHADER_COMPUTE)
+			{
+				if (size == 0)
+					gfx->buffer_compute_bind(gfx, pass, buffer, slot, gpu_access);
+				else
+					gfx->buffer_compute_bind_range(gfx, pass, buffer, slot, gpu_access, offset, size);
+			}
+			else
+			{
+				if (size == 0)
+					gfx->buffer_bind(gfx, pass, buffer, shader, slot);
+				else
+					gfx->buffer_bind_range(gfx, pass, buffer, shader, slot, offset, size);
+			}
+			break;
+		}
+		case RENOIR_CAPTURE_BUFFER_STORAGE_BIND:
+		{
+			auto desc = replay_read<Renoir_Buffer_Storage_Bind_Desc>(reader);
+			for (auto& buffer: desc.buffers)
+				replay_handle_map(self, buffer);
+			gfx->buffer_storage_bind(gfx, pass, desc);
+			break;
+		}
+		case RENOIR_CAPTURE_TEXTURE_BIND:
+		{
+			auto texture = Renoir_Texture{replay_handle(self, replay_read<uint64_t>(reader))};
+			auto shader = RENOIR_SHADER(replay_read<int32_t>(reader));
+			auto slot = replay_read<int32_t>(reader);
+			auto level = replay_read<int32_t>(reader);
+			auto gpu_access = RENOIR_ACCESS(replay_read<int32_t>(reader));
+			auto has_sampler = replay_read<int32_t>(reader);
+			auto sampler = replay_read<Renoir_Sampler_Desc>(reader);
+			if (has_sampler)
+				gfx->texture_sampler_bind(gfx, pass, texture, shader, slot, sampler);
+			else
+				gfx->texture_compute_bind(gfx, pass, texture, slot, level, gpu_access);
+			break;
+		}
+		case RENOIR_CAPTURE_DRAW:
+		{
+			auto desc = replay_read<Renoir_Draw_Desc>(reader);
+			for (auto& vertex: desc.vertex_buffers)
+				replay_handle_map(self, vertex.buffer);
+			replay_handle_map(self, desc.index_buffer);
+			gfx->draw(gfx, pass, desc);
+			break;
+		}
+		case RENOIR_CAPTURE_DISPATCH:
+		{
+			auto x = replay_read<int32_t>(reader);
+			auto y = replay_read<int32_t>(reader);
+			auto z = replay_read<int32_t>(reader);
+			gfx->dispatch(gfx, pass, x, y, z);
+			break;
+		}
+		case RENOIR_CAPTURE_MEMORY_BARRIER:
+			gfx->memory_barrier(gfx, pass);
+			break;
+		case RENOIR_CAPTURE_TIMER_BEGIN:
+			gfx->timer_begin(gfx, pass, Renoir_Timer{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_TIMER_END:
+			gfx->timer_end(gfx, pass, Renoir_Timer{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_QUERY_BEGIN:
+			gfx->query_begin(gfx, pass, Renoir_Query{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_QUERY_END:
+			gfx->query_end(gfx, pass, Renoir_Query{replay_handle(self, replay_read<uint64_t>(reader))});
+			break;
+		case RENOIR_CAPTURE_CONDITIONAL_BEGIN:
+		{
+			auto query = Renoir_Query{replay_handle(self, replay_read<uint64_t>(reader))};
+			auto wait = replay_read<int32_t>(reader);
+			gfx->conditional_begin(gfx, pass, query, wait != 0);
+			break;
+		}
+		case RENOIR_CAPTURE_CONDITIONAL_END:
+			gfx->conditional_end(gfx, pass);
+			break;
+		default:
+			++self.skipped_records;
+			break;
+		}
+		break;
+	}
+	}
+	return false;
+}
+
+// plays the whole capture once, handles which are still alive at the end of the capture are freed
+static bool
+replay_run(Replay& self)
+{
+	Replay_Reader file{self.data.data(), self.data.size(), 0, false};
+	auto header = replay_read<Renoir_Capture_Header>(file);
+	if (header.magic != RENOIR_CAPTURE_MAGIC || header.version != RENOIR_CAPTURE_VERSION)
+	{
+		fprintf(stderr, "invalid capture file, expected version %d\n", RENOIR_CAPTURE_VERSION);
+		return false;
+	}
+	if (header.pointer_size != sizeof(void*))
+	{
+		fprintf(stderr, "capture was written by a %u-bit build\n", header.pointer_size * 8);
+		return false;
+	}
+
+	auto frame_start = replay_now();
+	while (file.offset + sizeof(Renoir_Capture_Record) <= file.size)
+	{
+		auto record = replay_read<Renoir_Capture_Record>(file);
+		if (file.offset + record.size > file.size)
+		{
+			fprintf(stderr, "capture file is truncated\n");
+			break;
+		}
+
+		Replay_Reader reader{file.ptr + file.offset, record.size, 0, false};
+		file.offset += record.size;
+		if (replay_record(self, RENOIR_CAPTURE(record.kind), reader))
+		{
+			auto now = replay_now();
+			self.frames.push_back(now - frame_start);
+			frame_start = now;
+		}
+	}
+
+	if (self.pass.handle)
+	{
+		self.gfx->pass_end(self.gfx, self.pass);
+		self.pass = Renoir_Pass{};
+	}
+
+	// passes hold references to their attachments so we free them first
+	for (auto& [id, h]: self.handles)
+	{
+		if (h.kind == RENOIR_CAPTURE_PASS_SWAPCHAIN_NEW ||
+			h.kind == RENOIR_CAPTURE_PASS_OFFSCREEN_NEW ||
+			h.kind == RENOIR_CAPTURE_PASS_COMPUTE_NEW)
+		{
+			replay_handle_free(self, h);
+			h.kind = RENOIR_CAPTURE_NONE;
+		}
+	}
+	for (auto& [id, h]: self.handles)
+		replay_handle_free(self, h);
+	self.handles.clear();
+	self.uniforms.clear();
+	self.gfx->flush(self.gfx, nullptr, nullptr);
+	return true;
+}
+
+static void
+replay_write_json(Replay& self, const char* capture_path, int loops, FILE* out)
+{
+	auto sorted = self.frames;
+	std::sort(sorted.begin(), sorted.end());
+
+	uint64_t total = 0;
+	for (auto frame: sorted)
+		total += frame;
+
+	uint64_t min = sorted.empty() ? 0 : sorted.front();
+	uint64_t max = sorted.empty() ? 0 : sorted.back();
+	uint64_t median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+	uint64_t avg = sorted.empty() ? 0 : total / sorted.size();
+
+	fprintf(out, "{\n");
+	fprintf(out, "\t\"backend\": \"%s\",\n", self.gfx->name());
+	fprintf(out, "\t\"capture\": \"%s\",\n", capture_path);
+	fprintf(out, "\t\"loops\": %d,\n", loops);
+	fprintf(out, "\t\"skipped_records\": %d,\n", self.skipped_records);
+	fprintf(out, "\t\"frames_count\": %zu,\n", self.frames.size());
+	fprintf(out, "\t\"total_ns\": %llu,\n", (unsigned long long)total);
+	fprintf(out, "\t\"min_ns\": %llu,\n", (unsigned long long)min);
+	fprintf(out, "\t\"median_ns\": %llu,\n", (unsigned long long)median);
+	fprintf(out, "\t\"avg_ns\": %llu,\n", (unsigned long long)avg);
+	fprintf(out, "\t\"max_ns\": %llu,\n", (unsigned long long)max);
+	fprintf(out, "\t\"frames_ns\": [");
+	for (size_t i = 0; i < self.frames.size(); ++i)
+		fprintf(out, "%s%llu", i > 0 ? ", " : "", (unsigned long long)self.frames[i]);
+	fprintf(out, "]\n");
+	fprintf(out, "}\n");
+
+	fprintf(stderr, "%zu frames, min %.3f ms, median %.3f ms, avg %.3f ms, max %.3f ms\n",
+		self.frames.size(), min / 1e6, median / 1e6, avg / 1e6, max / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+	Replay self{};
+	bool defer_api_calls = true;
+	int loops = 1;
+	const char* capture_path = nullptr;
+	const char* out_path = nullptr;
+	bool usage = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			out_path = argv[++i];
+		else if (strcmp(argv[i], "--loop") == 0 && i + 1 < argc)
+			loops = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--immediate") == 0)
+			defer_api_calls = false;
+		else if (argv[i][0] != '-' && capture_path == nullptr)
+			capture_path = argv[i];
+		else
+			usage = true;
+	}
+	if (usage || capture_path == nullptr)
+	{
+		fprintf(stderr, "usage: %s capture.rcap [--out path.json] [--loop n] [--immediate]\n", argv[0]);
+		return 1;
+	}
+	if (loops < 1)
+		loops = 1;
+
+	auto file = fopen(capture_path, "rb");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "failed to open '%s'\n", capture_path);
+		return 1;
+	}
+	fseek(file, 0, SEEK_END);
+	auto file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	self.data.resize(file_size > 0 ? size_t(file_size) : 0);
+	auto read_size = fread(self.data.data(), 1, self.data.size(), file);
+	fclose(file);
+	if (read_size != self.data.size())
+	{
+		fprintf(stderr, "failed to read '%s'\n", capture_path);
+		return 1;
+	}
+
+	auto gfx = renoir_api();
+	self.gfx = gfx;
+
+	Renoir_Settings settings{};
+	settings.defer_api_calls = defer_api_calls;
+
+	void* display = nullptr;
+#if RENOIR_REPLAY_BACKEND_GL450
+	// all the captured swapchains are presented to this window
+	self.window = renoir_window_new(800, 600, "renoir-replay", RENOIR_WINDOW_MSAA_MODE_NONE);
+	void* handle = nullptr;
+	renoir_window_native_handles(self.window, &handle, &display);
+#endif
+
+	bool ok = gfx->init(gfx, settings, display);
+	if (ok == false)
+	{
+		fprintf(stderr, "failed to initialize '%s' backend\n", gfx->name());
+		return 1;
+	}
+
+	for (int i = 0; i < loops; ++i)
+	{
+		if (replay_run(self) == false)
+		{
+			ok = false;
+			break;
+		}
+	}
+
+	if (ok)
+	{
+		if (out_path)
+		{
+			auto out = fopen(out_path, "w");
+			if (out == nullptr)
+			{
+				fprintf(stderr, "failed to open '%s'\n", out_path);
+				ok = false;
+			}
+			else
+			{
+				replay_write_json(self, capture_path, loops, out);
+				fclose(out);
+			}
+		}
+		else
+		{
+			replay_write_json(self, capture_path, loops, stdout);
+		}
+	}
+
+	gfx->dispose(gfx);
+
+#if RENOIR_REPLAY_BACKEND_GL450
+	renoir_window_free(self.window);
+#endif
+	return ok ? 0 : 1;
+}
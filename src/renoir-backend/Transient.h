@@ -0,0 +1,144 @@
+#pragma once
+
+#include "renoir/Renoir.h"
+
+#include <mn/Buf.h>
+
+#include <assert.h>
+#include <stdint.h>
+
+// Transient texture pool shared by the backends to implement texture_transient, it's not part of the public api
+// the pool recycles physical textures across frames, a pooled texture is only handed out again to a request with
+// the exact same desc, textures with different descs never alias each other's memory even if their lifetimes don't
+// overlap, and textures which stay unused for RENOIR_TRANSIENT_TEXTURE_IDLE_FRAMES frames are freed
+// the pool doesn't lock anything, the backends should only touch it with their mutex locked
+
+// each backend defines its own handle type
+struct Renoir_Handle;
+
+// number of frames a pooled transient texture can stay unused before it's freed
+constexpr uint64_t RENOIR_TRANSIENT_TEXTURE_IDLE_FRAMES = 8;
+
+struct Renoir_Transient_Texture
+{
+	Renoir_Handle* handle;
+	// normalized desc the texture was created with
+	Renoir_Texture_Desc desc;
+	uint64_t last_used_frame;
+	bool in_use;
+};
+
+struct Renoir_Transient_Pool
+{
+	mn::Buf<Renoir_Transient_Texture> textures;
+	uint64_t frame;
+};
+
+inline static Renoir_Transient_Pool
+_renoir_transient_pool_new()
+{
+	Renoir_Transient_Pool self{};
+	self.textures = mn::buf_new<Renoir_Transient_Texture>();
+	return self;
+}
+
+inline static void
+_renoir_transient_pool_free(Renoir_Transient_Pool& self)
+{
+	mn::buf_free(self.textures);
+}
+
+// normalizes the desc the same way texture_new does so that it can be compared to the pooled textures
+inline static Renoir_Texture_Desc
+_renoir_transient_texture_desc_normalize(Renoir_Texture_Desc desc)
+{
+	if (desc.usage == RENOIR_USAGE_NONE)
+		desc.usage = RENOIR_USAGE_STATIC;
+	if (desc.mipmaps == 0)
+		desc.mipmaps = 1;
+	return desc;
+}
+
+inline static bool
+_renoir_transient_texture_desc_match(const Renoir_Texture_Desc& a, const Renoir_Texture_Desc& b)
+{
+	return (
+		a.size.width == b.size.width &&
+		a.size.height == b.size.height &&
+		a.size.depth == b.size.depth &&
+		a.usage == b.usage &&
+		a.access == b.access &&
+		a.pixel_format == b.pixel_format &&
+		a.mipmaps == b.mipmaps &&
+		a.msaa == b.msaa &&
+		a.msaa_sampled == b.msaa_sampled &&
+		a.cube_map == b.cube_map &&
+		a.sampler.filter == b.sampler.filter &&
+		a.sampler.u == b.sampler.u &&
+		a.sampler.v == b.sampler.v &&
+		a.sampler.w == b.sampler.w &&
+		a.sampler.compare == b.sampler.compare &&
+		a.sampler.border.r == b.sampler.border.r &&
+		a.sampler.border.g == b.sampler.border.g &&
+		a.sampler.border.b == b.sampler.border.b &&
+		a.sampler.border.a == b.sampler.border.a
+	);
+}
+
+// returns an unused pooled texture with the given normalized desc and marks it as used, or nullptr if there's none
+inline static Renoir_Handle*
+_renoir_transient_pool_acquire(Renoir_Transient_Pool& self, const Renoir_Texture_Desc& desc)
+{
+	for (auto& transient: self.textures)
+	{
+		if (transient.in_use || _renoir_transient_texture_desc_match(transient.desc, desc) == false)
+			continue;
+
+		transient.in_use = true;
+		transient.last_used_frame = self.frame;
+		return transient.handle;
+	}
+	return nullptr;
+}
+
+// adds a newly created texture to the pool, it's used until the end of the frame
+inline static void
+_renoir_transient_pool_push(Renoir_Transient_Pool& self, Renoir_Handle* handle, const Renoir_Texture_Desc& desc)
+{
+	mn::buf_push(self.textures, Renoir_Transient_Texture{handle, desc, self.frame, true});
+}
+
+// returns the texture to the pool before the end of the frame, returns false if it's not a pooled texture
+inline static bool
+_renoir_transient_pool_release(Renoir_Transient_Pool& self, Renoir_Handle* handle)
+{
+	for (auto& transient: self.textures)
+	{
+		if (transient.handle != handle)
+			continue;
+
+		assert(transient.in_use && "transient texture is already returned to the pool");
+		transient.in_use = false;
+		return true;
+	}
+	return false;
+}
+
+// returns all the textures to the pool at the end of the frame, and calls free_texture(handle) for the ones which
+// have been unused for more than RENOIR_TRANSIENT_TEXTURE_IDLE_FRAMES frames before removing them from the pool
+template<typename TFree>
+inline static void
+_renoir_transient_pool_frame(Renoir_Transient_Pool& self, TFree&& free_texture)
+{
+	++self.frame;
+	for (size_t i = self.textures.count; i > 0; --i)
+	{
+		auto& transient = self.textures[i - 1];
+		transient.in_use = false;
+		if (self.frame - transient.last_used_frame <= RENOIR_TRANSIENT_TEXTURE_IDLE_FRAMES)
+			continue;
+
+		free_texture(transient.handle);
+		mn::buf_remove(self.textures, i - 1);
+	}
+}